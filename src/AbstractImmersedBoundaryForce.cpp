@@ -35,8 +35,16 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractImmersedBoundaryForce.hpp"
 
+#include <climits>
+
 template<unsigned DIM>
 AbstractImmersedBoundaryForce<DIM>::AbstractImmersedBoundaryForce()
+    : mInstrumentationEnabled(false),
+      mNumInstrumentedCalls(0u),
+      mCumulativeThreadTime(0.0),
+      mNumElementsProcessed(0u),
+      mNumPairsExamined(0u),
+      mNumPairsInteracting(0u)
 {
 }
 
@@ -45,6 +53,37 @@ AbstractImmersedBoundaryForce<DIM>::~AbstractImmersedBoundaryForce()
 {
 }
 
+template<unsigned DIM>
+bool AbstractImmersedBoundaryForce<DIM>::SupportsForcePipeline()
+{
+    return false;
+}
+
+template<unsigned DIM>
+void AbstractImmersedBoundaryForce<DIM>::SetupForcePipelineStep(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                                                ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)
+{
+}
+
+template<unsigned DIM>
+unsigned AbstractImmersedBoundaryForce<DIM>::GetMaxNodesPerElementKernelCall()
+{
+    return UINT_MAX;
+}
+
+template<unsigned DIM>
+void AbstractImmersedBoundaryForce<DIM>::AddElementKernelContributions(unsigned elemIndex, unsigned firstNode, unsigned endNode, double* pForces)
+{
+}
+
+template<unsigned DIM>
+void AbstractImmersedBoundaryForce<DIM>::AddPairKernelContributions(const std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                                                    unsigned begin,
+                                                                    unsigned end,
+                                                                    double* pForces)
+{
+}
+
 template<unsigned DIM>
 void AbstractImmersedBoundaryForce<DIM>::OutputImmersedBoundaryForceInfo(out_stream& rParamsFile)
 {
@@ -52,9 +91,109 @@ void AbstractImmersedBoundaryForce<DIM>::OutputImmersedBoundaryForceInfo(out_str
 
     *rParamsFile << "\t\t<" << force_type << ">\n";
     OutputImmersedBoundaryForceParameters(rParamsFile);
+
+    if (mInstrumentationEnabled)
+    {
+        *rParamsFile << "\t\t\t<NumInstrumentedCalls>" << mNumInstrumentedCalls << "</NumInstrumentedCalls>\n";
+        *rParamsFile << "\t\t\t<CumulativeThreadTime>" << mCumulativeThreadTime << "</CumulativeThreadTime>\n";
+        *rParamsFile << "\t\t\t<NumElementsProcessed>" << mNumElementsProcessed << "</NumElementsProcessed>\n";
+        *rParamsFile << "\t\t\t<NumPairsExamined>" << mNumPairsExamined << "</NumPairsExamined>\n";
+        *rParamsFile << "\t\t\t<NumPairsInteracting>" << mNumPairsInteracting << "</NumPairsInteracting>\n";
+    }
+
     *rParamsFile << "\t\t</" << force_type << ">\n";
 }
 
+template<unsigned DIM>
+void AbstractImmersedBoundaryForce<DIM>::AddInstrumentedWork(unsigned long numElements,
+                                                            unsigned long numPairsExamined,
+                                                            unsigned long numPairsInteracting)
+{
+    if (mInstrumentationEnabled)
+    {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        mNumElementsProcessed += numElements;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        mNumPairsExamined += numPairsExamined;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        mNumPairsInteracting += numPairsInteracting;
+    }
+}
+
+template<unsigned DIM>
+void AbstractImmersedBoundaryForce<DIM>::SetInstrumentationEnabled(bool instrumentationEnabled)
+{
+    mInstrumentationEnabled = instrumentationEnabled;
+}
+
+template<unsigned DIM>
+bool AbstractImmersedBoundaryForce<DIM>::GetInstrumentationEnabled()
+{
+    return mInstrumentationEnabled;
+}
+
+template<unsigned DIM>
+void AbstractImmersedBoundaryForce<DIM>::ResetInstrumentation()
+{
+    mNumInstrumentedCalls = 0u;
+    mCumulativeThreadTime = 0.0;
+    mNumElementsProcessed = 0u;
+    mNumPairsExamined = 0u;
+    mNumPairsInteracting = 0u;
+}
+
+template<unsigned DIM>
+void AbstractImmersedBoundaryForce<DIM>::AddInstrumentedCall(double threadTime)
+{
+    mNumInstrumentedCalls++;
+    AddInstrumentedThreadTime(threadTime);
+}
+
+template<unsigned DIM>
+void AbstractImmersedBoundaryForce<DIM>::AddInstrumentedThreadTime(double threadTime)
+{
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    mCumulativeThreadTime += threadTime;
+}
+
+template<unsigned DIM>
+unsigned AbstractImmersedBoundaryForce<DIM>::GetNumInstrumentedCalls()
+{
+    return mNumInstrumentedCalls;
+}
+
+template<unsigned DIM>
+double AbstractImmersedBoundaryForce<DIM>::GetCumulativeThreadTime()
+{
+    return mCumulativeThreadTime;
+}
+
+template<unsigned DIM>
+unsigned long AbstractImmersedBoundaryForce<DIM>::GetNumElementsProcessed()
+{
+    return mNumElementsProcessed;
+}
+
+template<unsigned DIM>
+unsigned long AbstractImmersedBoundaryForce<DIM>::GetNumPairsExamined()
+{
+    return mNumPairsExamined;
+}
+
+template<unsigned DIM>
+unsigned long AbstractImmersedBoundaryForce<DIM>::GetNumPairsInteracting()
+{
+    return mNumPairsInteracting;
+}
+
 template<unsigned DIM>
 void AbstractImmersedBoundaryForce<DIM>::OutputImmersedBoundaryForceParameters(out_stream& rParamsFile)
 {
@@ -64,8 +64,49 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
+        archive & mInstrumentationEnabled;
     }
 
+protected:
+
+    /**
+     * Whether this force records its thread time and work counters.  The counters are updated only if this is true, so
+     * that there is negligible overhead when it is false.
+     *
+     * Initialised to false in the constructor.
+     */
+    bool mInstrumentationEnabled;
+
+    /** The number of time steps on which this force has been evaluated while instrumented. */
+    unsigned mNumInstrumentedCalls;
+
+    /**
+     * The total time spent evaluating this force while instrumented, summed over the threads that evaluated it.  When
+     * the force is evaluated on one thread this is its elapsed wall time; when the force pipeline sweeps in parallel it
+     * is the total of each thread's wall time in the kernels of this force, which may exceed the elapsed wall time.
+     */
+    double mCumulativeThreadTime;
+
+    /** The total number of elements processed by this force while instrumented. */
+    unsigned long mNumElementsProcessed;
+
+    /** The total number of node pairs examined by this force while instrumented. */
+    unsigned long mNumPairsExamined;
+
+    /** The total number of node pairs found by this force to be within the interaction distance while instrumented. */
+    unsigned long mNumPairsInteracting;
+
+    /**
+     * Add to the work counters of this force, if instrumentation is enabled.
+     *
+     * This method may be called concurrently from several threads.
+     *
+     * @param numElements the number of elements processed
+     * @param numPairsExamined the number of node pairs examined
+     * @param numPairsInteracting the number of node pairs within the interaction distance
+     */
+    void AddInstrumentedWork(unsigned long numElements, unsigned long numPairsExamined, unsigned long numPairsInteracting);
+
 public:
 
     /**
@@ -90,14 +131,141 @@ public:
     virtual void AddImmersedBoundaryForceContribution(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
             ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)=0;
 
+    /**
+     * Whether this force implements the force pipeline methods SetupForcePipelineStep(),
+     * AddElementKernelContributions() and AddPairKernelContributions().
+     *
+     * If every force passed to an ImmersedBoundarySimulationModifier supports the pipeline, and
+     * the modifier is set to use it, then instead of calling AddImmersedBoundaryForceContribution()
+     * on each force in turn the modifier makes a single sweep over elements, and a single sweep
+     * over node pairs, in which every force adds its contributions to a flat array of node forces.
+     *
+     * By default, this method returns false.
+     *
+     * @return whether this force supports the force pipeline
+     */
+    virtual bool SupportsForcePipeline();
+
+    /**
+     * Carry out any work that must be done once per time step, serially, before the kernel methods
+     * AddElementKernelContributions() and AddPairKernelContributions() are called.
+     *
+     * By default, this method does nothing.
+     *
+     * @param rNodePairs reference to a vector set of node pairs between which to contribute the force
+     * @param rCellPopulation an immersed boundary cell population
+     */
+    virtual void SetupForcePipelineStep(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                        ImmersedBoundaryCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * @return the largest number of consecutive nodes of an element to pass to a single call of
+     * AddElementKernelContributions(), so that large elements may be shared between threads.
+     *
+     * By default, this method returns UINT_MAX, so that each element is processed by a single call.
+     */
+    virtual unsigned GetMaxNodesPerElementKernelCall();
+
+    /**
+     * Add the contribution of this force acting on a range of consecutive nodes of a single element
+     * to the node forces.  Every node of the element is covered by exactly one call in each sweep.
+     *
+     * This method may be called concurrently for different elements, and for disjoint ranges of
+     * nodes of the same element, so must write only to the entries of pForces belonging to the
+     * nodes in the given range.
+     *
+     * By default, this method does nothing.
+     *
+     * @param elemIndex the index of the element
+     * @param firstNode the local index of the first node in the range
+     * @param endNode one past the local index of the last node in the range
+     * @param pForces the node forces, stored with the DIM components for node i at pForces[DIM*i]
+     */
+    virtual void AddElementKernelContributions(unsigned elemIndex, unsigned firstNode, unsigned endNode, double* pForces);
+
+    /**
+     * Add the contribution of this force acting between a range of node pairs to the node forces.
+     *
+     * This method may be called concurrently for disjoint ranges of pairs, each with its own array
+     * of node forces.
+     *
+     * By default, this method does nothing.
+     *
+     * @param rNodePairs reference to the vector of node pairs
+     * @param begin the index of the first pair in the range
+     * @param end one past the index of the last pair in the range
+     * @param pForces the node forces, stored with the DIM components for node i at pForces[DIM*i]
+     */
+    virtual void AddPairKernelContributions(const std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                            unsigned begin,
+                                            unsigned end,
+                                            double* pForces);
+
+    /**
+     * Set #mInstrumentationEnabled.
+     *
+     * @param instrumentationEnabled whether to record wall time and work counters for this force
+     */
+    void SetInstrumentationEnabled(bool instrumentationEnabled);
+
+    /**
+     * @return #mInstrumentationEnabled
+     */
+    bool GetInstrumentationEnabled();
+
+    /**
+     * Reset the thread time and all work counters of this force to zero.
+     */
+    void ResetInstrumentation();
+
+    /**
+     * Record one evaluation of this force, taking the given time on the calling thread.  Called by the simulation
+     * modifier.
+     *
+     * @param threadTime the wall time spent by the calling thread
+     */
+    void AddInstrumentedCall(double threadTime);
+
+    /**
+     * Add to the thread time spent evaluating this force, without recording a new evaluation.  Called by the
+     * simulation modifier, possibly concurrently from several threads.
+     *
+     * @param threadTime the wall time spent by the calling thread
+     */
+    void AddInstrumentedThreadTime(double threadTime);
+
+    /**
+     * @return #mNumInstrumentedCalls
+     */
+    unsigned GetNumInstrumentedCalls();
+
+    /**
+     * @return #mCumulativeThreadTime
+     */
+    double GetCumulativeThreadTime();
+
+    /**
+     * @return #mNumElementsProcessed
+     */
+    unsigned long GetNumElementsProcessed();
+
+    /**
+     * @return #mNumPairsExamined
+     */
+    unsigned long GetNumPairsExamined();
+
+    /**
+     * @return #mNumPairsInteracting
+     */
+    unsigned long GetNumPairsInteracting();
+
     /**
      * Outputs the name of the immersed boundary force used in 
      * the simulation to file and then calls OutputImmersedBoundaryForceParameters()
-     * to output all relevant parameters.
+     * to output all relevant parameters, followed by the instrumentation counters
+     * if instrumentation is enabled.
      *
-     * \todo At present, this method is not used in simulations. In contrast, the force method
-     * OutputForceInfo is called in OffLatticeSimulation::OutputAdditionalSimulationSetup().
-     * Call this method in simulations, or else remove it.
+     * This method is called for each force by ImmersedBoundarySimulationModifier::OutputSimulationModifierParameters().
      *
      * @param rParamsFile the file stream to which the parameters are output
      */
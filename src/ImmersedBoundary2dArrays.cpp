@@ -190,6 +190,22 @@ bool ImmersedBoundary2dArrays<DIM>::HasActiveSources()
     return mActiveSources;
 }
 
+template<unsigned DIM>
+std::map<std::string, std::size_t> ImmersedBoundary2dArrays<DIM>::GetMemoryUsage() const
+{
+    std::map<std::string, std::size_t> memory_usage;
+
+    memory_usage["ForceGrids"] = mForceGrids.num_elements() * sizeof(double);
+    memory_usage["RightHandSideGrids"] = mRightHandSideGrids.num_elements() * sizeof(double);
+    memory_usage["SourceGradientGrids"] = mSourceGradientGrids.num_elements() * sizeof(double);
+    memory_usage["FourierGrids"] = mFourierGrids.num_elements() * sizeof(std::complex<double>);
+    memory_usage["PressureGrid"] = mPressureGrid.num_elements() * sizeof(std::complex<double>);
+    memory_usage["Operators"] = (mOperator1.num_elements() + mOperator2.num_elements()) * sizeof(double);
+    memory_usage["SineTables"] = (mSin2x.capacity() + mSin2y.capacity()) * sizeof(double);
+
+    return memory_usage;
+}
+
 // Explicit instantiation
 template class ImmersedBoundary2dArrays<1>;
 template class ImmersedBoundary2dArrays<2>;
@@ -37,6 +37,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define IMMERSEDBOUNDARY2DARRAYS_HPP_
 
 #include <complex>
+#include <map>
+#include <string>
 #include "ImmersedBoundaryArray.hpp"
 #include "ImmersedBoundaryMesh.hpp"
 
@@ -140,6 +142,12 @@ public:
 
     /** @return #mActiveSources. */
     bool HasActiveSources();
+
+    /**
+     * @return the number of bytes used by each group of arrays, indexed by name: the force, right-hand-side, source
+     * gradient, Fourier and pressure grids, the two operators, and the sine tables
+     */
+    std::map<std::string, std::size_t> GetMemoryUsage() const;
 };
 
 #endif /*IMMERSEDBOUNDARY2DARRAYS_HPP_*/
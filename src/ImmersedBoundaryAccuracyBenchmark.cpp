@@ -0,0 +1,300 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ImmersedBoundaryAccuracyBenchmark.hpp"
+
+#include <cmath>
+#include <sstream>
+
+#include "CellsGenerator.hpp"
+#include "CsvWriter.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "Exception.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+#include "Timer.hpp"
+#include "UniformlyDistributedCellCycleModel.hpp"
+
+#include "ImmersedBoundaryCellPopulation.hpp"
+#include "ImmersedBoundaryMembraneElasticityForce.hpp"
+#include "ImmersedBoundaryMesh.hpp"
+#include "ImmersedBoundarySimulationModifier.hpp"
+#include "SuperellipseGenerator.hpp"
+
+const double ImmersedBoundaryAccuracyBenchmark::TAYLOR_GREEN_REYNOLDS_NUMBER = 10.0;
+
+ImmersedBoundaryAccuracyBenchmark::ImmersedBoundaryAccuracyBenchmark(std::string caseName,
+                                                                     unsigned numGridPts,
+                                                                     double dt,
+                                                                     double endTime)
+    : mCaseName(caseName),
+      mNumGridPts(numGridPts),
+      mDt(dt),
+      mNumTimeSteps(0),
+      mError(0.0),
+      mWallTime(0.0),
+      mElongationShapeFactor(0.0)
+{
+    if (mCaseName != "taylor_green" && mCaseName != "relaxing_membrane")
+    {
+        EXCEPTION("Unknown case " << mCaseName << ": must be taylor_green or relaxing_membrane.");
+    }
+    if (mNumGridPts == 0 || mNumGridPts % 2 != 0)
+    {
+        EXCEPTION("The number of grid points must be positive and even.");
+    }
+    if (mDt <= 0.0 || endTime < mDt)
+    {
+        EXCEPTION("The time step must be positive and no longer than the end time.");
+    }
+
+    mNumTimeSteps = unsigned(floor(endTime / mDt + 0.5));
+}
+
+void ImmersedBoundaryAccuracyBenchmark::SetTaylorGreenVelocity(multi_array<double, 3>& rVelocityGrids, double time)
+{
+    unsigned num_grid_pts_x = rVelocityGrids.shape()[1];
+    unsigned num_grid_pts_y = rVelocityGrids.shape()[2];
+    double decay = exp(-8.0 * M_PI * M_PI * time / TAYLOR_GREEN_REYNOLDS_NUMBER);
+
+    for (unsigned x = 0; x < num_grid_pts_x; x++)
+    {
+        double two_pi_x = 2.0 * M_PI * double(x) / double(num_grid_pts_x);
+        for (unsigned y = 0; y < num_grid_pts_y; y++)
+        {
+            double two_pi_y = 2.0 * M_PI * double(y) / double(num_grid_pts_y);
+            rVelocityGrids[0][x][y] = sin(two_pi_x) * cos(two_pi_y) * decay;
+            rVelocityGrids[1][x][y] = -cos(two_pi_x) * sin(two_pi_y) * decay;
+        }
+    }
+}
+
+void ImmersedBoundaryAccuracyBenchmark::Run(std::string outputDirectory)
+{
+    bool is_taylor_green = (mCaseName == "taylor_green");
+
+    /*
+     * For the Taylor-Green vortex, a single small cell is needed to set up the population; it feels no force, so
+     * it does not disturb the flow.  Otherwise, an ellipse of aspect ratio 5:3 is resolved with roughly two nodes
+     * per grid spacing along its boundary.
+     */
+    SuperellipseGenerator* p_gen = NULL;
+    if (is_taylor_green)
+    {
+        p_gen = new SuperellipseGenerator(16, 1.0, 0.05, 0.05, 0.475, 0.475);
+    }
+    else
+    {
+        p_gen = new SuperellipseGenerator(2 * mNumGridPts, 1.0, 0.3, 0.5, 0.35, 0.25);
+    }
+    std::vector<c_vector<double, 2> > locations = p_gen->GetPointsAsVectors();
+    delete p_gen;
+
+    std::vector<Node<2>*> nodes;
+    for (unsigned location = 0; location < locations.size(); location++)
+    {
+        nodes.push_back(new Node<2>(location, locations[location], true));
+    }
+
+    std::vector<ImmersedBoundaryElement<2,2>*> elements;
+    elements.push_back(new ImmersedBoundaryElement<2,2>(0, nodes));
+
+    ImmersedBoundaryMesh<2,2> mesh(nodes, elements, mNumGridPts, mNumGridPts);
+
+    std::vector<CellPtr> cells;
+    MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+    CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+    cells_generator.GenerateBasicRandom(cells, mesh.GetNumElements(), p_diff_type);
+
+    ImmersedBoundaryCellPopulation<2> cell_population(mesh, cells);
+    cell_population.SetIfPopulationHasActiveSources(false);
+
+    OffLatticeSimulation<2> simulator(cell_population);
+
+    MAKE_PTR(ImmersedBoundarySimulationModifier<2>, p_main_modifier);
+    simulator.AddSimulationModifier(p_main_modifier);
+
+    double initial_area = mesh.GetVolumeOfElement(0);
+    if (is_taylor_green)
+    {
+        p_main_modifier->SetReynoldsNumber(TAYLOR_GREEN_REYNOLDS_NUMBER);
+        SetTaylorGreenVelocity(mesh.rGetModifiable2dVelocityGrids(), 0.0);
+    }
+    else
+    {
+        MAKE_PTR(ImmersedBoundaryMembraneElasticityForce<2>, p_boundary_force);
+        p_main_modifier->AddImmersedBoundaryForce(p_boundary_force);
+        p_boundary_force->SetSpringConstant(1.0 * 1e7);
+    }
+
+    // Carry on from the current simulation time, so that several benchmarks can be run one after another
+    double start_time = SimulationTime::Instance()->GetTime();
+    simulator.SetOutputDirectory(outputDirectory + "/" + GetName());
+    simulator.SetDt(mDt);
+    simulator.SetSamplingTimestepMultiple(mNumTimeSteps);
+    simulator.SetEndTime(start_time + mNumTimeSteps * mDt);
+
+    double wall_start_time = Timer::GetWallTime();
+    simulator.Solve();
+    mWallTime = Timer::GetWallTime() - wall_start_time;
+
+    if (is_taylor_green)
+    {
+        /*
+         * The fluid is solved once in SetupSolve() and once at the end of each time step, so the velocity grids
+         * hold the solution one time step beyond the end time.
+         */
+        multi_array<double, 3> exact_velocity(mesh.rGet2dVelocityGrids());
+        SetTaylorGreenVelocity(exact_velocity, (mNumTimeSteps + 1) * mDt);
+
+        const multi_array<double, 3>& r_velocity = mesh.rGet2dVelocityGrids();
+        double sum_squared_errors = 0.0;
+        double sum_squared_exact = 0.0;
+        for (unsigned dim = 0; dim < 2; dim++)
+        {
+            for (unsigned x = 0; x < mNumGridPts; x++)
+            {
+                for (unsigned y = 0; y < mNumGridPts; y++)
+                {
+                    double difference = r_velocity[dim][x][y] - exact_velocity[dim][x][y];
+                    sum_squared_errors += difference * difference;
+                    sum_squared_exact += exact_velocity[dim][x][y] * exact_velocity[dim][x][y];
+                }
+            }
+        }
+        mError = sqrt(sum_squared_errors / sum_squared_exact);
+    }
+    else
+    {
+        mError = fabs(mesh.GetVolumeOfElement(0) - initial_area) / initial_area;
+    }
+
+    mElongationShapeFactor = mesh.GetElongationShapeFactorOfElement(0);
+}
+
+std::string ImmersedBoundaryAccuracyBenchmark::GetName() const
+{
+    std::stringstream name;
+    name << mCaseName << "_g" << mNumGridPts << "_s" << mNumTimeSteps;
+    return name.str();
+}
+
+const std::string& ImmersedBoundaryAccuracyBenchmark::rGetCaseName() const
+{
+    return mCaseName;
+}
+
+unsigned ImmersedBoundaryAccuracyBenchmark::GetNumGridPts() const
+{
+    return mNumGridPts;
+}
+
+double ImmersedBoundaryAccuracyBenchmark::GetDt() const
+{
+    return mDt;
+}
+
+unsigned ImmersedBoundaryAccuracyBenchmark::GetNumTimeSteps() const
+{
+    return mNumTimeSteps;
+}
+
+double ImmersedBoundaryAccuracyBenchmark::GetError() const
+{
+    return mError;
+}
+
+double ImmersedBoundaryAccuracyBenchmark::GetWallTime() const
+{
+    return mWallTime;
+}
+
+double ImmersedBoundaryAccuracyBenchmark::GetElongationShapeFactor() const
+{
+    return mElongationShapeFactor;
+}
+
+void ImmersedBoundaryAccuracyBenchmark::WriteResults(const std::vector<ImmersedBoundaryAccuracyBenchmark>& rBenchmarks,
+                                                     std::string outputDirectory,
+                                                     std::string fileName)
+{
+    if (rBenchmarks.empty())
+    {
+        EXCEPTION("There are no benchmark results to write.");
+    }
+
+    std::vector<unsigned> num_grid_pts;
+    std::vector<unsigned> num_time_steps;
+    std::vector<double> dts;
+    std::vector<double> wall_times;
+    std::vector<double> errors;
+    std::vector<double> elongation_shape_factors;
+    std::vector<std::string> case_names;
+
+    for (unsigned i = 0; i < rBenchmarks.size(); i++)
+    {
+        num_grid_pts.push_back(rBenchmarks[i].GetNumGridPts());
+        num_time_steps.push_back(rBenchmarks[i].GetNumTimeSteps());
+        dts.push_back(rBenchmarks[i].GetDt());
+        wall_times.push_back(rBenchmarks[i].GetWallTime());
+        errors.push_back(rBenchmarks[i].GetError());
+        elongation_shape_factors.push_back(rBenchmarks[i].GetElongationShapeFactor());
+        case_names.push_back(rBenchmarks[i].rGetCaseName());
+    }
+
+    // The writer outputs unsigned data, then doubles, then strings
+    std::vector<std::string> headers;
+    headers.push_back("NumGridPts");
+    headers.push_back("NumTimeSteps");
+    headers.push_back("Dt");
+    headers.push_back("WallTime");
+    headers.push_back("Error");
+    headers.push_back("ElongationShapeFactor");
+    headers.push_back("Case");
+
+    CsvWriter writer;
+    writer.SetDirectoryName(outputDirectory);
+    writer.SetFileName(fileName);
+    writer.AddHeaders(headers);
+    writer.AddData(num_grid_pts);
+    writer.AddData(num_time_steps);
+    writer.AddData(dts);
+    writer.AddData(wall_times);
+    writer.AddData(errors);
+    writer.AddData(elongation_shape_factors);
+    writer.AddData(case_names);
+    writer.WriteDataToFile();
+}
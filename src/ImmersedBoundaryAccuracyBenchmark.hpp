@@ -0,0 +1,170 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYACCURACYBENCHMARK_HPP_
+#define IMMERSEDBOUNDARYACCURACYBENCHMARK_HPP_
+
+#include <string>
+#include <vector>
+
+#include "ImmersedBoundaryArray.hpp"
+
+/**
+ * Runs an immersed boundary simulation for which the correct result is known, and records both the error at the end
+ * of the simulation and the wall time taken, so that configurations can be compared by their cost for a given
+ * accuracy.  Two cases are available:
+ *
+ * "taylor_green": a decaying Taylor-Green vortex, u = sin(2 pi x) cos(2 pi y) exp(-8 pi^2 t / Re), v = -cos(2 pi x)
+ * sin(2 pi y) exp(-8 pi^2 t / Re), with Re = 10.  A single small passive cell, with no forces, is carried by the
+ * flow.  The error is the relative L2 error of the fluid velocity against this exact solution.
+ *
+ * "relaxing_membrane": an elliptical cell, generated by SuperellipseGenerator, relaxing towards a circle under a
+ * membrane elasticity force.  Since the fluid is incompressible, the area enclosed by the membrane is exactly
+ * conserved, so the error is the relative change in the area of the cell.  The elongation shape factor at the end
+ * of the simulation is also recorded, to show how far the relaxation has progressed.
+ *
+ * SimulationTime must have been set up before Run() is called, as it is by AbstractCellBasedTestSuite.
+ */
+class ImmersedBoundaryAccuracyBenchmark
+{
+private:
+
+    /** The case: "taylor_green" or "relaxing_membrane". */
+    std::string mCaseName;
+
+    /** The number of fluid grid points in each direction. */
+    unsigned mNumGridPts;
+
+    /** The time step. */
+    double mDt;
+
+    /** The number of time steps to run. */
+    unsigned mNumTimeSteps;
+
+    /** The error at the end of the most recent run. */
+    double mError;
+
+    /** The wall time of the most recent run. */
+    double mWallTime;
+
+    /** The elongation shape factor of the cell at the end of the most recent run. */
+    double mElongationShapeFactor;
+
+    /**
+     * Set the fluid velocity grids to the exact Taylor-Green solution.
+     *
+     * @param rVelocityGrids the velocity grids
+     * @param time the time at which to evaluate the solution
+     */
+    static void SetTaylorGreenVelocity(multi_array<double, 3>& rVelocityGrids, double time);
+
+public:
+
+    /** The Reynolds number used for the Taylor-Green case. */
+    static const double TAYLOR_GREEN_REYNOLDS_NUMBER;
+
+    /**
+     * Constructor.
+     *
+     * @param caseName the case: "taylor_green" or "relaxing_membrane"
+     * @param numGridPts the number of fluid grid points in each direction
+     * @param dt the time step
+     * @param endTime the simulated time, which is rounded to a whole number of time steps
+     */
+    ImmersedBoundaryAccuracyBenchmark(std::string caseName, unsigned numGridPts, double dt, double endTime);
+
+    /**
+     * Run the simulation, replacing any results from a previous run.  The simulation output is written to a
+     * subdirectory named by GetName().
+     *
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    void Run(std::string outputDirectory);
+
+    /**
+     * @return a name identifying the case and parameters, such as taylor_green_g64_s100
+     */
+    std::string GetName() const;
+
+    /**
+     * @return #mCaseName
+     */
+    const std::string& rGetCaseName() const;
+
+    /**
+     * @return #mNumGridPts
+     */
+    unsigned GetNumGridPts() const;
+
+    /**
+     * @return #mDt
+     */
+    double GetDt() const;
+
+    /**
+     * @return #mNumTimeSteps
+     */
+    unsigned GetNumTimeSteps() const;
+
+    /**
+     * @return #mError
+     */
+    double GetError() const;
+
+    /**
+     * @return #mWallTime
+     */
+    double GetWallTime() const;
+
+    /**
+     * @return #mElongationShapeFactor
+     */
+    double GetElongationShapeFactor() const;
+
+    /**
+     * Write the results of several runs to a CSV file, with one row per run giving the case, number of grid points,
+     * number of time steps, time step, wall time, error and elongation shape factor.  Plotting the error against the
+     * wall time for each case gives the cost of reaching a given accuracy.
+     *
+     * @param rBenchmarks the benchmarks, each of which must have been run
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     * @param fileName the file name (defaults to time_to_accuracy.csv)
+     */
+    static void WriteResults(const std::vector<ImmersedBoundaryAccuracyBenchmark>& rBenchmarks,
+                             std::string outputDirectory,
+                             std::string fileName="time_to_accuracy.csv");
+};
+
+#endif /*IMMERSEDBOUNDARYACCURACYBENCHMARK_HPP_*/
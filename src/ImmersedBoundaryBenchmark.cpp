@@ -0,0 +1,214 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ImmersedBoundaryBenchmark.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "Exception.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+#include "Timer.hpp"
+#include "UniformlyDistributedCellCycleModel.hpp"
+
+#include "ImmersedBoundaryCellCellInteractionForce.hpp"
+#include "ImmersedBoundaryCellPopulation.hpp"
+#include "ImmersedBoundaryHoneycombMeshGenerator.hpp"
+#include "ImmersedBoundaryMembraneElasticityForce.hpp"
+#include "ImmersedBoundaryPalisadeMeshGenerator.hpp"
+#include "ImmersedBoundaryProfiler.hpp"
+#include "ImmersedBoundarySimulationModifier.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+ImmersedBoundaryBenchmark::ImmersedBoundaryBenchmark(std::string meshType,
+                                                     unsigned numCells,
+                                                     unsigned numNodesPerCell,
+                                                     unsigned numGridPts,
+                                                     unsigned numThreads,
+                                                     unsigned numTimeSteps)
+    : mMeshType(meshType),
+      mNumCells(numCells),
+      mNumNodesPerCell(numNodesPerCell),
+      mNumGridPts(numGridPts),
+      mNumThreads(numThreads),
+      mNumTimeSteps(numTimeSteps),
+      mMeanStepTime(0.0)
+{
+    if (mMeshType != "palisade" && mMeshType != "honeycomb")
+    {
+        EXCEPTION("Unknown mesh type " << mMeshType << ": must be palisade or honeycomb.");
+    }
+    if (mNumCells == 0 || mNumNodesPerCell == 0 || mNumGridPts == 0 || mNumThreads == 0 || mNumTimeSteps == 0)
+    {
+        EXCEPTION("All benchmark parameters must be positive.");
+    }
+
+    // A honeycomb is square with hexagonal cells, so record the numbers of cells and nodes per cell actually generated
+    if (mMeshType == "honeycomb")
+    {
+        unsigned num_cells_each_way = std::max(1u, unsigned(floor(sqrt(double(mNumCells)) + 0.5)));
+        mNumCells = num_cells_each_way * num_cells_each_way;
+        mNumNodesPerCell = 6 * std::max(1u, mNumNodesPerCell / 6);
+    }
+}
+
+void ImmersedBoundaryBenchmark::Run(std::string outputDirectory)
+{
+#ifdef _OPENMP
+    int previous_num_threads = omp_get_max_threads();
+    omp_set_num_threads(mNumThreads);
+#endif
+
+    // Only one of the generators is used; each deletes its mesh on destruction
+    ImmersedBoundaryPalisadeMeshGenerator* p_palisade_gen = NULL;
+    ImmersedBoundaryHoneycombMeshGenerator* p_honeycomb_gen = NULL;
+    ImmersedBoundaryMesh<2,2>* p_mesh = NULL;
+
+    if (mMeshType == "palisade")
+    {
+        p_palisade_gen = new ImmersedBoundaryPalisadeMeshGenerator(mNumCells, mNumNodesPerCell, 0.1, 2.5, 0.0, true);
+        p_mesh = p_palisade_gen->GetMesh();
+    }
+    else
+    {
+        unsigned num_cells_each_way = unsigned(floor(sqrt(double(mNumCells)) + 0.5));
+        p_honeycomb_gen = new ImmersedBoundaryHoneycombMeshGenerator(num_cells_each_way, num_cells_each_way, mNumNodesPerCell / 6, 0.05, 0.1);
+        p_mesh = p_honeycomb_gen->GetMesh();
+        assert(p_mesh->GetNumElements() == mNumCells);
+    }
+
+    p_mesh->SetNumGridPtsXAndY(mNumGridPts);
+
+    std::vector<CellPtr> cells;
+    MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+    CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+    cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+
+    {
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+        cell_population.SetIfPopulationHasActiveSources(false);
+
+        OffLatticeSimulation<2> simulator(cell_population);
+
+        MAKE_PTR(ImmersedBoundarySimulationModifier<2>, p_main_modifier);
+        p_main_modifier->SetProfilingEnabled(true);
+        simulator.AddSimulationModifier(p_main_modifier);
+
+        MAKE_PTR(ImmersedBoundaryMembraneElasticityForce<2>, p_boundary_force);
+        p_main_modifier->AddImmersedBoundaryForce(p_boundary_force);
+        p_boundary_force->SetSpringConstant(1.0 * 1e7);
+
+        MAKE_PTR(ImmersedBoundaryCellCellInteractionForce<2>, p_cell_cell_force);
+        p_main_modifier->AddImmersedBoundaryForce(p_cell_cell_force);
+        p_cell_cell_force->SetSpringConstant(1.0 * 1e6);
+
+        // Carry on from the current simulation time, so that several benchmarks can be run one after another
+        double dt = 0.05;
+        simulator.SetOutputDirectory(outputDirectory + "/" + GetName());
+        simulator.SetDt(dt);
+        simulator.SetSamplingTimestepMultiple(mNumTimeSteps);
+        simulator.SetEndTime(SimulationTime::Instance()->GetTime() + mNumTimeSteps * dt);
+
+        double start_time = Timer::GetWallTime();
+        simulator.Solve();
+        mMeanStepTime = (Timer::GetWallTime() - start_time) / double(mNumTimeSteps);
+    }
+
+    ImmersedBoundaryProfiler* p_profiler = ImmersedBoundaryProfiler::Instance();
+    std::vector<std::string> phase_names = p_profiler->GetPhaseNames();
+
+    mMedianPhaseTimes.clear();
+    for (unsigned i = 0; i < phase_names.size(); i++)
+    {
+        mMedianPhaseTimes[phase_names[i]] = p_profiler->GetPercentile(phase_names[i], 50.0);
+    }
+
+    delete p_palisade_gen;
+    delete p_honeycomb_gen;
+
+#ifdef _OPENMP
+    omp_set_num_threads(previous_num_threads);
+#endif
+}
+
+std::string ImmersedBoundaryBenchmark::GetName() const
+{
+    std::stringstream name;
+    name << mMeshType << "_c" << mNumCells << "_n" << mNumNodesPerCell << "_g" << mNumGridPts << "_t" << mNumThreads;
+    return name.str();
+}
+
+const std::map<std::string, double>& ImmersedBoundaryBenchmark::rGetMedianPhaseTimes() const
+{
+    return mMedianPhaseTimes;
+}
+
+double ImmersedBoundaryBenchmark::GetMeanStepTime() const
+{
+    return mMeanStepTime;
+}
+
+void ImmersedBoundaryBenchmark::AddResultsToPropertyTree(boost::property_tree::ptree& rTree) const
+{
+    boost::property_tree::ptree results;
+    results.put("MeshType", mMeshType);
+    results.put("NumCells", mNumCells);
+    results.put("NumNodesPerCell", mNumNodesPerCell);
+    results.put("NumGridPts", mNumGridPts);
+    results.put("NumThreads", mNumThreads);
+    results.put("NumTimeSteps", mNumTimeSteps);
+    results.put("MeanStepTime", mMeanStepTime);
+
+    boost::property_tree::ptree phases;
+    for (std::map<std::string, double>::const_iterator iter = mMedianPhaseTimes.begin();
+         iter != mMedianPhaseTimes.end();
+         ++iter)
+    {
+        phases.put(iter->first, iter->second);
+    }
+    results.add_child("MedianPhaseTimes", phases);
+
+    // Use an explicit path so that names are never split on the default '.' separator
+    rTree.add_child(boost::property_tree::ptree::path_type(GetName(), '/'), results);
+}
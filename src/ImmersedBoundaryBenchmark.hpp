@@ -0,0 +1,131 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYBENCHMARK_HPP_
+#define IMMERSEDBOUNDARYBENCHMARK_HPP_
+
+#include <map>
+#include <string>
+#include <boost/property_tree/ptree.hpp>
+
+/**
+ * Runs a short immersed boundary simulation on a generated mesh and records the median wall time of each phase of
+ * the time step, as measured by ImmersedBoundaryProfiler, together with the mean wall time of a full step.
+ *
+ * The mesh is either a palisade (ImmersedBoundaryPalisadeMeshGenerator, with a basement membrane) or a honeycomb
+ * (ImmersedBoundaryHoneycombMeshGenerator), and the simulation uses a membrane elasticity force and a cell-cell
+ * interaction force.  SimulationTime must have been set up before Run() is called, as it is by
+ * AbstractCellBasedTestSuite.
+ */
+class ImmersedBoundaryBenchmark
+{
+private:
+
+    /** The mesh type: "palisade" or "honeycomb". */
+    std::string mMeshType;
+
+    /** The number of cells; for a honeycomb this is rounded to a square number. */
+    unsigned mNumCells;
+
+    /** The number of nodes per cell; for a honeycomb this is rounded down to a multiple of six. */
+    unsigned mNumNodesPerCell;
+
+    /** The number of fluid grid points in each direction. */
+    unsigned mNumGridPts;
+
+    /** The number of OpenMP threads. */
+    unsigned mNumThreads;
+
+    /** The number of time steps to run. */
+    unsigned mNumTimeSteps;
+
+    /** The median wall time of each profiled phase in the most recent run, indexed by phase name. */
+    std::map<std::string, double> mMedianPhaseTimes;
+
+    /** The mean wall time of a full time step in the most recent run. */
+    double mMeanStepTime;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param meshType the mesh type: "palisade" or "honeycomb"
+     * @param numCells the number of cells, which for a honeycomb is rounded to the nearest square number
+     * @param numNodesPerCell the number of nodes per cell, which for a honeycomb is rounded down to a multiple of six
+     * @param numGridPts the number of fluid grid points in each direction
+     * @param numThreads the number of OpenMP threads (defaults to 1, and is ignored without OpenMP)
+     * @param numTimeSteps the number of time steps to run (defaults to 20)
+     */
+    ImmersedBoundaryBenchmark(std::string meshType,
+                              unsigned numCells,
+                              unsigned numNodesPerCell,
+                              unsigned numGridPts,
+                              unsigned numThreads=1,
+                              unsigned numTimeSteps=20);
+
+    /**
+     * Run the simulation, replacing any results from a previous run.  The simulation output, including the phase
+     * timings in profile.csv, is written to a subdirectory named by GetName().
+     *
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    void Run(std::string outputDirectory);
+
+    /**
+     * @return a name identifying the mesh type and parameters, such as palisade_c8_n128_g256_t1
+     */
+    std::string GetName() const;
+
+    /**
+     * @return #mMedianPhaseTimes
+     */
+    const std::map<std::string, double>& rGetMedianPhaseTimes() const;
+
+    /**
+     * @return #mMeanStepTime
+     */
+    double GetMeanStepTime() const;
+
+    /**
+     * Add the parameters and results of the most recent run to a property tree, as a child named by GetName(), so that
+     * results can be written as JSON.
+     *
+     * @param rTree the property tree
+     */
+    void AddResultsToPropertyTree(boost::property_tree::ptree& rTree) const;
+};
+
+#endif /*IMMERSEDBOUNDARYBENCHMARK_HPP_*/
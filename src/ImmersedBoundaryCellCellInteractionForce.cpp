@@ -35,6 +35,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ImmersedBoundaryCellCellInteractionForce.hpp"
 #include "ImmersedBoundaryElement.hpp"
+#include "SimulationTime.hpp"
 
 template<unsigned DIM>
 ImmersedBoundaryCellCellInteractionForce<DIM>::ImmersedBoundaryCellCellInteractionForce()
@@ -42,7 +43,18 @@ ImmersedBoundaryCellCellInteractionForce<DIM>::ImmersedBoundaryCellCellInteracti
           mpMesh(NULL),
           mSpringConst(1e3),
           mRestLength(DOUBLE_UNSET),
-          mNumProteins(3)
+          mNumProteins(3),
+          mPairLaw(LINEAR_SPRING_LAW),
+          mUseLookupTable(false),
+          mNumLookupTableIntervals(1000),
+          mLookupTableIsStale(true),
+          mLookupTableCutoff(DOUBLE_UNSET),
+          mSpringConstPerSpacing(DOUBLE_UNSET),
+          mInteractionDistance(DOUBLE_UNSET),
+          mProteinDiffusionCoefficient(0.0),
+          mProteinBindingRate(0.0),
+          mProteinUnbindingRate(0.0),
+          mMaxProteinLevel(2.0)
 {
 }
 
@@ -54,144 +66,255 @@ ImmersedBoundaryCellCellInteractionForce<DIM>::~ImmersedBoundaryCellCellInteract
 template<unsigned DIM>
 void ImmersedBoundaryCellCellInteractionForce<DIM>::AddImmersedBoundaryForceContribution(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
         ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)
+{
+    SetupForcePipelineStep(rNodePairs, rCellPopulation);
+
+    // Accumulate the forces from all pairs into contiguous storage, then add them to the nodes
+    unsigned num_nodes = mpMesh->GetNumNodes();
+    mNodeForceScratch.assign(DIM * num_nodes, 0.0);
+
+    if (num_nodes > 0)
+    {
+        AddPairKernelContributions(rNodePairs, 0, rNodePairs.size(), &mNodeForceScratch[0]);
+    }
+
+    c_vector<double, DIM> force;
+    for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
+    {
+        for (unsigned dim = 0; dim < DIM; dim++)
+        {
+            force[dim] = mNodeForceScratch[DIM * node_idx + dim];
+        }
+        mpMesh->GetNode(node_idx)->AddAppliedForceContribution(force);
+    }
+}
+
+template<unsigned DIM>
+bool ImmersedBoundaryCellCellInteractionForce<DIM>::SupportsForcePipeline()
+{
+    return true;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::SetupForcePipelineStep(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                                                           ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)
 {
     /*
      * This force class calculates the force between pairs of nodes in different immersed boundaries.  Each node must
      * therefore store a dimensionless parameter representing the quantity of different transmembrane proteins at that
-     * location.  We attach these quantities as node attributes, and keep track of where in the node attributes vector
-     * each protein concentration is stored.
+     * location.  These are stored by the mesh, as one contiguous vector of levels per protein, and we keep track of
+     * which protein species in the mesh represents each protein.
      */
 
-    // This will be triggered only once - during simulation set up
-    if (mProteinNodeAttributeLocations.empty())
-    {
-        mpMesh = &(rCellPopulation.rGetMesh());
+    // The mesh is not archived with this force, so is found here, including after a checkpoint has been loaded
+    mpMesh = &(rCellPopulation.rGetMesh());
 
+    // This will be triggered only once - during simulation set up; the protein levels are archived by the mesh
+    if (mProteinSpeciesIndices.empty())
+    {
         mRestLength = 0.25 * rCellPopulation.GetInteractionDistance();
+        mLookupTableIsStale = true;
 
-        // First verify that all nodes have the same number of attributes
-        unsigned num_node_attributes = rCellPopulation.GetNode(0)->GetNumNodeAttributes();
-        for (unsigned node_idx = 0; node_idx < rCellPopulation.GetNumNodes(); node_idx++ )
-        {
-            if (num_node_attributes != rCellPopulation.GetNode(node_idx)->GetNumNodeAttributes())
-            {
-                EXCEPTION("All nodes must have the same number of attributes to use this force class.");
-            }
-        }
-
-        // Set up the number of proteins and keep track of where they will be stored in the node attributes vector
+        // Set up the number of proteins and keep track of where they are stored in the mesh
         for (unsigned protein_idx = 0; protein_idx < mNumProteins; protein_idx++)
         {
-            mProteinNodeAttributeLocations.push_back(num_node_attributes + protein_idx);
+            mProteinSpeciesIndices.push_back(mpMesh->AddProteinSpecies());
         }
 
-        // Add protein attributes to each node
-        for (unsigned node_idx = 0; node_idx < rCellPopulation.GetNumNodes(); node_idx++)
+        // Initialize protein levels
+        InitializeProteinLevels();
+    }
+
+    // The spring constant will be scaled by an amount determined by the intrinsic spacing
+    mSpringConstPerSpacing = mSpringConst / rCellPopulation.GetIntrinsicSpacing();
+    mInteractionDistance = rCellPopulation.GetInteractionDistance();
+
+    UpdateParameterCache();
+    UpdateProteinLevels(rNodePairs, rCellPopulation);
+
+    if (mUseLookupTable && (mLookupTableIsStale || mLookupTableCutoff != mInteractionDistance))
+    {
+        switch (mPairLaw)
         {
-            for (unsigned protein_idx = 0; protein_idx < mNumProteins; protein_idx++)
-            {
-                rCellPopulation.GetNode(node_idx)->AddNodeAttribute(0.0);
-            }
+            case LINEAR_SPRING_LAW:
+                mTabulatedPairLaw.Tabulate(LinearSpringPairLaw(mRestLength), mInteractionDistance, mNumLookupTableIntervals);
+                break;
+
+            case MORSE_POTENTIAL:
+                mTabulatedPairLaw.Tabulate(MorsePairLaw(mRestLength, 0.25 * mInteractionDistance), mInteractionDistance, mNumLookupTableIntervals);
+                break;
+
+            case LENNARD_JONES_POTENTIAL:
+                mTabulatedPairLaw.Tabulate(LennardJonesPairLaw(mRestLength), mInteractionDistance, mNumLookupTableIntervals);
+                break;
+
+            case PIECEWISE_LINEAR_LAW:
+                mTabulatedPairLaw.Tabulate(PiecewiseLinearPairLaw(mRestLength, mInteractionDistance), mInteractionDistance, mNumLookupTableIntervals);
+                break;
+
+            default:
+                NEVER_REACHED;
         }
 
-        // Initialize protein levels
-        InitializeProteinLevels();
+        mLookupTableCutoff = mInteractionDistance;
+        mLookupTableIsStale = false;
     }
+}
 
-    UpdateProteinLevels();
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::AddPairKernelContributions(const std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                                                               unsigned begin,
+                                                                               unsigned end,
+                                                                               double* pForces)
+{
+    if (mUseLookupTable)
+    {
+        AddPairLawContributions(mTabulatedPairLaw, rNodePairs, begin, end, pForces);
+        return;
+    }
 
-    // Helper variables for loop
-    unsigned e_cad_idx = mProteinNodeAttributeLocations[0];
-    unsigned p_cad_idx = mProteinNodeAttributeLocations[1];
-    unsigned integrin_idx = mProteinNodeAttributeLocations[2];
+    // Select the pair law once, so that the pair loop itself is compiled separately for each law
+    switch (mPairLaw)
+    {
+        case LINEAR_SPRING_LAW:
+            AddPairLawContributions(LinearSpringPairLaw(mRestLength), rNodePairs, begin, end, pForces);
+            break;
 
-    double normed_dist;
-    double protein_mult;
+        case MORSE_POTENTIAL:
+            AddPairLawContributions(MorsePairLaw(mRestLength, 0.25 * mInteractionDistance), rNodePairs, begin, end, pForces);
+            break;
 
-    // The spring constant will be scaled by an amount determined by the intrinsic spacing
-    double intrinsic_spacing = rCellPopulation.GetIntrinsicSpacing();
-    double node_a_elem_spacing;
-    double node_b_elem_spacing;
-    double elem_spacing;
+        case LENNARD_JONES_POTENTIAL:
+            AddPairLawContributions(LennardJonesPairLaw(mRestLength), rNodePairs, begin, end, pForces);
+            break;
 
-    // The effective spring constant will be a scaled version of mSpringConst
-    double effective_spring_const;
+        case PIECEWISE_LINEAR_LAW:
+            AddPairLawContributions(PiecewiseLinearPairLaw(mRestLength, mInteractionDistance), rNodePairs, begin, end, pForces);
+            break;
 
-    c_vector<double, DIM> vector_between_nodes;
-    c_vector<double, DIM> force_a_to_b;
-    c_vector<double, DIM> force_b_to_a;
+        default:
+            NEVER_REACHED;
+    }
+}
+
+template<unsigned DIM>
+template<class LAW>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::AddPairLawContributions(const LAW& rLaw,
+                                                                            const std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                                                            unsigned begin,
+                                                                            unsigned end,
+                                                                            double* pForces)
+{
+    const std::vector<unsigned>& r_node_element_indices = mpMesh->rGetNodeElementIndices();
+
+    // Pointers to the level of each protein at the first node
+    const double* p_e_cad = &(mpMesh->rGetProteinLevels(mProteinSpeciesIndices[0])[0]);
+    const double* p_p_cad = &(mpMesh->rGetProteinLevels(mProteinSpeciesIndices[1])[0]);
+    const double* p_integrin = &(mpMesh->rGetProteinLevels(mProteinSpeciesIndices[2])[0]);
 
-    Node<DIM>* p_node_a;
-    Node<DIM>* p_node_b;
+    // Storage for the interacting pairs found in each block
+    const unsigned block_size = 256;
+    unsigned block_pair_indices[block_size];
+    double block_distances[block_size];
+    double block_magnitudes[block_size];
+    c_vector<double, DIM> block_vectors[block_size];
 
-    // If using Morse potential, this can be pre-calculated
-    double well_width = 0.25 * rCellPopulation.GetInteractionDistance();
+    // Count the interacting pairs, for instrumentation
+    unsigned long num_pairs_interacting = 0;
 
-    // Loop over all pairs of nodes that might be interacting
-    for (unsigned pair = 0; pair < rNodePairs.size(); pair++)
+    // Loop over the given range of pairs of nodes that might be interacting, a block at a time
+    for (unsigned block_start = begin; block_start < end; block_start += block_size)
     {
-        /*
-         * Interactions only occur between different cells.  Since each node is only ever in a single cell, we can test
-         * equality of the first ContainingElement.
-         */
-        if ( *(rNodePairs[pair].first->ContainingElementsBegin()) !=
-             *(rNodePairs[pair].second->ContainingElementsBegin()) )
+        unsigned block_end = std::min(block_start + block_size, end);
+
+        // Gather the pairs in this block that are in different cells and within the interaction distance
+        unsigned num_interacting = 0;
+        for (unsigned pair = block_start; pair < block_end; pair++)
         {
-            p_node_a = rNodePairs[pair].first;
-            p_node_b = rNodePairs[pair].second;
+            Node<DIM>* p_node_a = rNodePairs[pair].first;
+            Node<DIM>* p_node_b = rNodePairs[pair].second;
 
-            std::vector<double>& r_a_attribs = p_node_a->rGetNodeAttributes();
-            std::vector<double>& r_b_attribs = p_node_b->rGetNodeAttributes();
+            // Interactions only occur between different cells
+            if (r_node_element_indices[p_node_a->GetIndex()] == r_node_element_indices[p_node_b->GetIndex()])
+            {
+                continue;
+            }
 
-            vector_between_nodes = mpMesh->GetVectorFromAtoB(p_node_a->rGetLocation(), p_node_b->rGetLocation());
-            normed_dist = norm_2(vector_between_nodes);
+            c_vector<double, DIM> vector_between_nodes = mpMesh->GetVectorFromAtoB(p_node_a->rGetLocation(), p_node_b->rGetLocation());
+            double normed_dist = norm_2(vector_between_nodes);
 
-            if (normed_dist < rCellPopulation.GetInteractionDistance())
+            if (normed_dist < mInteractionDistance)
             {
-                // Get the element spacing for each of the nodes concerned and calculate the effective spring constant
-                node_a_elem_spacing = mpMesh->GetAverageNodeSpacingOfElement(*(p_node_a->rGetContainingElementIndices().begin()), false);
-                node_b_elem_spacing = mpMesh->GetAverageNodeSpacingOfElement(*(p_node_b->rGetContainingElementIndices().begin()), false);
-                elem_spacing = 0.5 * (node_a_elem_spacing + node_b_elem_spacing);
+                block_pair_indices[num_interacting] = pair;
+                block_distances[num_interacting] = normed_dist;
+                block_vectors[num_interacting] = vector_between_nodes;
+                num_interacting++;
+            }
+        }
+
+        num_pairs_interacting += num_interacting;
 
-                effective_spring_const = mSpringConst * elem_spacing / intrinsic_spacing;
+        // Evaluate the pair law for every interacting pair in the block at once
+        rLaw.EvaluateBatch(block_distances, block_magnitudes, num_interacting);
 
-                // The protein multiplier is a function of the levels of each protein in the current and comparison nodes
-                protein_mult = std::min(r_a_attribs[e_cad_idx], r_b_attribs[e_cad_idx]) +
-                               std::min(r_a_attribs[p_cad_idx], r_b_attribs[p_cad_idx]) +
-                               std::max(r_a_attribs[integrin_idx], r_b_attribs[integrin_idx]);
+        // Apply the resulting forces
+        for (unsigned i = 0; i < num_interacting; i++)
+        {
+            unsigned node_a_idx = rNodePairs[block_pair_indices[i]].first->GetIndex();
+            unsigned node_b_idx = rNodePairs[block_pair_indices[i]].second->GetIndex();
 
-                /*
-                 * We must scale each applied force by a factor of elem_spacing / local spacing, so that forces
-                 * balance when spread to the grid later (where the multiplicative factor is the local spacing)
-                 */
+            unsigned elem_a_idx = r_node_element_indices[node_a_idx];
+            unsigned elem_b_idx = r_node_element_indices[node_b_idx];
 
-                if (mLinearSpring)
-                {
-                    vector_between_nodes *=
-                            effective_spring_const * protein_mult * (normed_dist - mRestLength) / normed_dist;
-                }
-                else // Morse potential
-                {
-                    double morse_exp = exp((mRestLength - normed_dist) / well_width);
-                    vector_between_nodes *= 2.0 * well_width * effective_spring_const * protein_mult * morse_exp *
-                                            (1.0 - morse_exp) / normed_dist;
+            // The effective spring constant is scaled by the mean spacing of the two elements concerned
+            double elem_spacing = 0.5 * (mElementSpacings[elem_a_idx] + mElementSpacings[elem_b_idx]);
+            double effective_spring_const = mSpringConstPerSpacing * elem_spacing;
 
-                }
+            // The protein multiplier is a function of the levels of each protein in the current and comparison nodes
+            double protein_mult = std::min(p_e_cad[node_a_idx], p_e_cad[node_b_idx]) +
+                                  std::min(p_p_cad[node_a_idx], p_p_cad[node_b_idx]) +
+                                  std::max(p_integrin[node_a_idx], p_integrin[node_b_idx]);
+
+            double force_scale = effective_spring_const * protein_mult * block_magnitudes[i] / block_distances[i];
 
-                force_a_to_b = vector_between_nodes * elem_spacing / node_a_elem_spacing;
-                p_node_a->AddAppliedForceContribution(force_a_to_b);
+            /*
+             * We must scale each applied force by a factor of elem_spacing / local spacing, so that forces
+             * balance when spread to the grid later (where the multiplicative factor is the local spacing)
+             */
+            double scale_a = force_scale * elem_spacing * mElementSpacingReciprocals[elem_a_idx];
+            double scale_b = -force_scale * elem_spacing * mElementSpacingReciprocals[elem_b_idx];
 
-                force_b_to_a = -1.0 * vector_between_nodes * elem_spacing / node_b_elem_spacing;
-                p_node_b->AddAppliedForceContribution(force_b_to_a);
+            for (unsigned dim = 0; dim < DIM; dim++)
+            {
+                pForces[DIM * node_a_idx + dim] += block_vectors[i][dim] * scale_a;
+                pForces[DIM * node_b_idx + dim] += block_vectors[i][dim] * scale_b;
             }
         }
     }
+
+    this->AddInstrumentedWork(0, end - begin, num_pairs_interacting);
 }
 
 template<unsigned DIM>
-const std::vector<unsigned>& ImmersedBoundaryCellCellInteractionForce<DIM>::rGetProteinNodeAttributeLocations() const
+void ImmersedBoundaryCellCellInteractionForce<DIM>::UpdateParameterCache()
 {
-    return mProteinNodeAttributeLocations;
+    unsigned num_elements = mpMesh->GetNumAllElements();
+
+    mElementSpacings.resize(num_elements);
+    mElementSpacingReciprocals.resize(num_elements);
+
+    for (unsigned elem_idx = 0; elem_idx < num_elements; elem_idx++)
+    {
+        double spacing = mpMesh->GetAverageNodeSpacingOfElement(elem_idx, false);
+        mElementSpacings[elem_idx] = spacing;
+        mElementSpacingReciprocals[elem_idx] = 1.0 / spacing;
+    }
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& ImmersedBoundaryCellCellInteractionForce<DIM>::rGetProteinSpeciesIndices() const
+{
+    return mProteinSpeciesIndices;
 }
 
 template<unsigned DIM>
@@ -203,6 +326,13 @@ void ImmersedBoundaryCellCellInteractionForce<DIM>::InitializeProteinLevels()
      *  * 1: P-cadherin
      *  * 2: Integrins
      */
+    mBaselineProteinLevels.assign(mNumProteins, 0.0);
+    mBaselineProteinLevels[0] = 1.0;
+
+    std::vector<double>& r_e_cad = mpMesh->rGetModifiableProteinLevels(mProteinSpeciesIndices[0]);
+    std::vector<double>& r_p_cad = mpMesh->rGetModifiableProteinLevels(mProteinSpeciesIndices[1]);
+    std::vector<double>& r_integrin = mpMesh->rGetModifiableProteinLevels(mProteinSpeciesIndices[2]);
+
     for (unsigned elem_idx = 0; elem_idx < mpMesh->GetNumElements(); elem_idx++)
     {
         double e_cad = 0.0;
@@ -220,19 +350,123 @@ void ImmersedBoundaryCellCellInteractionForce<DIM>::InitializeProteinLevels()
 
         for (unsigned node_idx = 0; node_idx < mpMesh->GetElement(elem_idx)->GetNumNodes(); node_idx++)
         {
-            std::vector<double>& r_node_attributes = mpMesh->GetElement(elem_idx)->GetNode(node_idx)->rGetNodeAttributes();
+            unsigned global_idx = mpMesh->GetElement(elem_idx)->GetNodeGlobalIndex(node_idx);
 
-            r_node_attributes[mProteinNodeAttributeLocations[0]] += e_cad;
-            r_node_attributes[mProteinNodeAttributeLocations[1]] += p_cad;
-            r_node_attributes[mProteinNodeAttributeLocations[2]] += integrin;
+            r_e_cad[global_idx] = e_cad;
+            r_p_cad[global_idx] = p_cad;
+            r_integrin[global_idx] = integrin;
         }
     }
 }
 
 template<unsigned DIM>
-void ImmersedBoundaryCellCellInteractionForce<DIM>::UpdateProteinLevels()
+void ImmersedBoundaryCellCellInteractionForce<DIM>::UpdateProteinLevels(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                                                        ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)
 {
-    ///\todo Do something in this method?
+    bool diffusion = mProteinDiffusionCoefficient > 0.0;
+    bool binding = (mProteinBindingRate > 0.0) || (mProteinUnbindingRate > 0.0);
+
+    if (!diffusion && !binding)
+    {
+        return;
+    }
+
+    double dt = SimulationTime::Instance()->GetTimeStep();
+    int num_nodes = (int)mpMesh->GetNumNodes();
+    int num_elements = (int)mpMesh->GetNumAllElements();
+
+    if (diffusion)
+    {
+        // The explicit scheme is only stable if D dt / h^2 <= 1/2 in every element
+        double min_spacing = *std::min_element(mElementSpacings.begin(), mElementSpacings.end());
+        if (mProteinDiffusionCoefficient * dt > 0.5 * min_spacing * min_spacing)
+        {
+            EXCEPTION("Protein diffusion is unstable: reduce the timestep or the protein diffusion coefficient.");
+        }
+
+        for (unsigned protein_idx = 0; protein_idx < mNumProteins; protein_idx++)
+        {
+            std::vector<double>& r_levels = mpMesh->rGetModifiableProteinLevels(mProteinSpeciesIndices[protein_idx]);
+
+            // Nodes which are not in any element, such as those added singly to the mesh, keep their levels
+            mProteinLevelScratch.assign(r_levels.begin(), r_levels.end());
+
+            // Each node is in at most one element, so the elements can be updated independently
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (int elem_idx = 0; elem_idx < num_elements; elem_idx++)
+            {
+                ImmersedBoundaryElement<DIM, DIM>* p_elem = mpMesh->GetElement(elem_idx);
+                unsigned num_elem_nodes = p_elem->GetNumNodes();
+
+                double diffusion_number = mProteinDiffusionCoefficient * dt * mElementSpacingReciprocals[elem_idx] * mElementSpacingReciprocals[elem_idx];
+
+                unsigned prev_idx = p_elem->GetNodeGlobalIndex(num_elem_nodes - 1);
+                unsigned this_idx = p_elem->GetNodeGlobalIndex(0);
+
+                for (unsigned local_idx = 0; local_idx < num_elem_nodes; local_idx++)
+                {
+                    unsigned next_idx = p_elem->GetNodeGlobalIndex((local_idx + 1) % num_elem_nodes);
+
+                    mProteinLevelScratch[this_idx] = r_levels[this_idx] +
+                            diffusion_number * (r_levels[prev_idx] - 2.0 * r_levels[this_idx] + r_levels[next_idx]);
+
+                    prev_idx = this_idx;
+                    this_idx = next_idx;
+                }
+            }
+
+            r_levels.swap(mProteinLevelScratch);
+        }
+    }
+
+    if (binding)
+    {
+        // Find the pairs of nodes in contact: those in different cells and within the interaction distance
+        const std::vector<unsigned>& r_node_element_indices = mpMesh->rGetNodeElementIndices();
+        double interaction_distance = rCellPopulation.GetInteractionDistance();
+
+        mContactNodeIndices.clear();
+        for (unsigned pair = 0; pair < rNodePairs.size(); pair++)
+        {
+            unsigned node_a_idx = rNodePairs[pair].first->GetIndex();
+            unsigned node_b_idx = rNodePairs[pair].second->GetIndex();
+
+            if (r_node_element_indices[node_a_idx] != r_node_element_indices[node_b_idx] &&
+                norm_2(mpMesh->GetVectorFromAtoB(rNodePairs[pair].first->rGetLocation(),
+                                                 rNodePairs[pair].second->rGetLocation())) < interaction_distance)
+            {
+                mContactNodeIndices.push_back(node_a_idx);
+                mContactNodeIndices.push_back(node_b_idx);
+            }
+        }
+
+        // Only the cadherins (proteins 0 and 1) bind at contacts between cells
+        for (unsigned protein_idx = 0; protein_idx < 2; protein_idx++)
+        {
+            std::vector<double>& r_levels = mpMesh->rGetModifiableProteinLevels(mProteinSpeciesIndices[protein_idx]);
+            double baseline = mBaselineProteinLevels[protein_idx];
+
+            // Each contact contributes to two nodes, so the partner levels are accumulated serially
+            mPartnerProteinLevels.assign(num_nodes, 0.0);
+            for (unsigned i = 0; i < mContactNodeIndices.size(); i += 2)
+            {
+                mPartnerProteinLevels[mContactNodeIndices[i]] += r_levels[mContactNodeIndices[i + 1]];
+                mPartnerProteinLevels[mContactNodeIndices[i + 1]] += r_levels[mContactNodeIndices[i]];
+            }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int node_idx = 0; node_idx < num_nodes; node_idx++)
+            {
+                double level = r_levels[node_idx];
+                r_levels[node_idx] = level + dt * (mProteinBindingRate * mPartnerProteinLevels[node_idx] * (mMaxProteinLevel - level)
+                                                   - mProteinUnbindingRate * (level - baseline));
+            }
+        }
+    }
 }
 
 template<unsigned DIM>
@@ -251,6 +485,7 @@ template<unsigned DIM>
 void ImmersedBoundaryCellCellInteractionForce<DIM>::SetRestLength(double restLength)
 {
     mRestLength = restLength;
+    mLookupTableIsStale = true;
 }
 
 template<unsigned DIM>
@@ -262,27 +497,133 @@ double ImmersedBoundaryCellCellInteractionForce<DIM>::GetRestLength()
 template<unsigned DIM>
 void ImmersedBoundaryCellCellInteractionForce<DIM>::UseLinearSpringLaw()
 {
-    mLinearSpring = true;
-    mMorse = false;
+    mPairLaw = LINEAR_SPRING_LAW;
+    mLookupTableIsStale = true;
 }
 
 template<unsigned DIM>
 void ImmersedBoundaryCellCellInteractionForce<DIM>::UseMorsePotential()
 {
-    mLinearSpring = false;
-    mMorse = true;
+    mPairLaw = MORSE_POTENTIAL;
+    mLookupTableIsStale = true;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::UseLennardJonesPotential()
+{
+    mPairLaw = LENNARD_JONES_POTENTIAL;
+    mLookupTableIsStale = true;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::UsePiecewiseLinearLaw()
+{
+    mPairLaw = PIECEWISE_LINEAR_LAW;
+    mLookupTableIsStale = true;
 }
 
 template<unsigned DIM>
 bool ImmersedBoundaryCellCellInteractionForce<DIM>::IsLinearSpringLaw()
 {
-    return mLinearSpring;
+    return mPairLaw == LINEAR_SPRING_LAW;
 }
 
 template<unsigned DIM>
 bool ImmersedBoundaryCellCellInteractionForce<DIM>::IsMorsePotential()
 {
-    return mMorse;
+    return mPairLaw == MORSE_POTENTIAL;
+}
+
+template<unsigned DIM>
+bool ImmersedBoundaryCellCellInteractionForce<DIM>::IsLennardJonesPotential()
+{
+    return mPairLaw == LENNARD_JONES_POTENTIAL;
+}
+
+template<unsigned DIM>
+bool ImmersedBoundaryCellCellInteractionForce<DIM>::IsPiecewiseLinearLaw()
+{
+    return mPairLaw == PIECEWISE_LINEAR_LAW;
+}
+
+template<unsigned DIM>
+PairLawType ImmersedBoundaryCellCellInteractionForce<DIM>::GetPairLaw()
+{
+    return mPairLaw;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::SetUseLookupTable(bool useLookupTable)
+{
+    mUseLookupTable = useLookupTable;
+}
+
+template<unsigned DIM>
+bool ImmersedBoundaryCellCellInteractionForce<DIM>::GetUseLookupTable()
+{
+    return mUseLookupTable;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::SetNumLookupTableIntervals(unsigned numLookupTableIntervals)
+{
+    assert(numLookupTableIntervals > 0);
+    mNumLookupTableIntervals = numLookupTableIntervals;
+    mLookupTableIsStale = true;
+}
+
+template<unsigned DIM>
+unsigned ImmersedBoundaryCellCellInteractionForce<DIM>::GetNumLookupTableIntervals()
+{
+    return mNumLookupTableIntervals;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::SetProteinDiffusionCoefficient(double proteinDiffusionCoefficient)
+{
+    mProteinDiffusionCoefficient = proteinDiffusionCoefficient;
+}
+
+template<unsigned DIM>
+double ImmersedBoundaryCellCellInteractionForce<DIM>::GetProteinDiffusionCoefficient()
+{
+    return mProteinDiffusionCoefficient;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::SetProteinBindingRate(double proteinBindingRate)
+{
+    mProteinBindingRate = proteinBindingRate;
+}
+
+template<unsigned DIM>
+double ImmersedBoundaryCellCellInteractionForce<DIM>::GetProteinBindingRate()
+{
+    return mProteinBindingRate;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::SetProteinUnbindingRate(double proteinUnbindingRate)
+{
+    mProteinUnbindingRate = proteinUnbindingRate;
+}
+
+template<unsigned DIM>
+double ImmersedBoundaryCellCellInteractionForce<DIM>::GetProteinUnbindingRate()
+{
+    return mProteinUnbindingRate;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryCellCellInteractionForce<DIM>::SetMaxProteinLevel(double maxProteinLevel)
+{
+    mMaxProteinLevel = maxProteinLevel;
+}
+
+template<unsigned DIM>
+double ImmersedBoundaryCellCellInteractionForce<DIM>::GetMaxProteinLevel()
+{
+    return mMaxProteinLevel;
 }
 
 template<unsigned DIM>
@@ -291,8 +632,16 @@ void ImmersedBoundaryCellCellInteractionForce<DIM>::OutputImmersedBoundaryForceP
     *rParamsFile << "\t\t\t<SpringConst>" << mSpringConst << "</SpringConst>\n";
     *rParamsFile << "\t\t\t<RestLength>" << mRestLength << "</RestLength>\n";
     *rParamsFile << "\t\t\t<NumProteins>" << mNumProteins << "</NumProteins>\n";
-    *rParamsFile << "\t\t\t<LinearSpring>" << mLinearSpring << "</LinearSpring>\n";
-    *rParamsFile << "\t\t\t<Morse>" << mMorse << "</Morse>\n";
+    *rParamsFile << "\t\t\t<LinearSpring>" << IsLinearSpringLaw() << "</LinearSpring>\n";
+    *rParamsFile << "\t\t\t<Morse>" << IsMorsePotential() << "</Morse>\n";
+    *rParamsFile << "\t\t\t<LennardJones>" << IsLennardJonesPotential() << "</LennardJones>\n";
+    *rParamsFile << "\t\t\t<PiecewiseLinear>" << IsPiecewiseLinearLaw() << "</PiecewiseLinear>\n";
+    *rParamsFile << "\t\t\t<UseLookupTable>" << mUseLookupTable << "</UseLookupTable>\n";
+    *rParamsFile << "\t\t\t<NumLookupTableIntervals>" << mNumLookupTableIntervals << "</NumLookupTableIntervals>\n";
+    *rParamsFile << "\t\t\t<ProteinDiffusionCoefficient>" << mProteinDiffusionCoefficient << "</ProteinDiffusionCoefficient>\n";
+    *rParamsFile << "\t\t\t<ProteinBindingRate>" << mProteinBindingRate << "</ProteinBindingRate>\n";
+    *rParamsFile << "\t\t\t<ProteinUnbindingRate>" << mProteinUnbindingRate << "</ProteinUnbindingRate>\n";
+    *rParamsFile << "\t\t\t<MaxProteinLevel>" << mMaxProteinLevel << "</MaxProteinLevel>\n";
 
     // Call method on direct parent class
     AbstractImmersedBoundaryForce<DIM>::OutputImmersedBoundaryForceParameters(rParamsFile);
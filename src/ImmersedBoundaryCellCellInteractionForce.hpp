@@ -38,11 +38,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
+#include <boost/serialization/vector.hpp>
 #include "Exception.hpp"
 
 #include "AbstractImmersedBoundaryForce.hpp"
 #include "ImmersedBoundaryCellPopulation.hpp"
 #include "ImmersedBoundaryMesh.hpp"
+#include "ImmersedBoundaryPairPotentials.hpp"
 
 #include <iostream>
 
@@ -69,8 +71,15 @@ private:
         archive & boost::serialization::base_object<AbstractImmersedBoundaryForce<DIM> >(*this);
         archive & mSpringConst;
         archive & mRestLength;
-        archive & mLinearSpring;
-        archive & mMorse;
+        archive & mPairLaw;
+        archive & mUseLookupTable;
+        archive & mNumLookupTableIntervals;
+        archive & mProteinDiffusionCoefficient;
+        archive & mProteinBindingRate;
+        archive & mProteinUnbindingRate;
+        archive & mMaxProteinLevel;
+        archive & mProteinSpeciesIndices;
+        archive & mBaselineProteinLevels;
     }
 
 protected:
@@ -95,14 +104,93 @@ protected:
     /** The number of transmembrane proteins represented in this force class. */
     unsigned mNumProteins;
 
-    /** Whether to use linear spring forces. */
-    bool mLinearSpring;
+    /** The pair law used to calculate the force between interacting nodes.  Defaults to a linear spring. */
+    PairLawType mPairLaw;
 
-    /** Whether to use a force derived from the Morse potential. */
-    bool mMorse;
+    /** Whether to evaluate the pair law by interpolation in a lookup table.  Defaults to false. */
+    bool mUseLookupTable;
 
-    /** A vector storing in which position of the node attributes vector each protein is represented. */
-    std::vector<unsigned> mProteinNodeAttributeLocations;
+    /** The number of intervals into which the lookup table divides the interaction distance.  Defaults to 1000. */
+    unsigned mNumLookupTableIntervals;
+
+    /** The lookup table for the current pair law, used if #mUseLookupTable is true. */
+    TabulatedPairLaw mTabulatedPairLaw;
+
+    /** Whether #mTabulatedPairLaw needs rebuilding because the pair law or its parameters have changed. */
+    bool mLookupTableIsStale;
+
+    /** The interaction distance used when #mTabulatedPairLaw was last built. */
+    double mLookupTableCutoff;
+
+    /** The index, in the mesh's table of protein levels, of the species representing each protein in this class. */
+    std::vector<unsigned> mProteinSpeciesIndices;
+
+    /** The level of each protein to which unbinding relaxes, set in InitializeProteinLevels(). */
+    std::vector<double> mBaselineProteinLevels;
+
+    /** The diffusion coefficient of each protein along the membrane of each cell.  Defaults to 0.0. */
+    double mProteinDiffusionCoefficient;
+
+    /** The rate at which cadherins are recruited to contacts with other cells.  Defaults to 0.0. */
+    double mProteinBindingRate;
+
+    /** The rate at which cadherin levels relax back to their baseline levels.  Defaults to 0.0. */
+    double mProteinUnbindingRate;
+
+    /** The level at which recruitment of cadherins to contacts saturates.  Defaults to 2.0. */
+    double mMaxProteinLevel;
+
+    /** Storage for the updated protein levels during diffusion. */
+    std::vector<double> mProteinLevelScratch;
+
+    /** Storage for the total level of a protein in the contact partners of each node. */
+    std::vector<double> mPartnerProteinLevels;
+
+    /** Storage for the node indices of interacting pairs, stored consecutively, used in the binding update. */
+    std::vector<unsigned> mContactNodeIndices;
+
+    /** The average node spacing of each element, refreshed each timestep by UpdateParameterCache(). */
+    std::vector<double> mElementSpacings;
+
+    /** The reciprocal of the average node spacing of each element, refreshed each timestep by UpdateParameterCache(). */
+    std::vector<double> mElementSpacingReciprocals;
+
+    /** The spring constant divided by the intrinsic spacing of the population, refreshed each timestep. */
+    double mSpringConstPerSpacing;
+
+    /** The interaction distance of the population, refreshed each timestep. */
+    double mInteractionDistance;
+
+    /** Storage for the force on each node, used by AddImmersedBoundaryForceContribution(). */
+    std::vector<double> mNodeForceScratch;
+
+    /**
+     * Helper method for SetupForcePipelineStep().
+     *
+     * Refreshes the per-element tables used in the pair loop, so that the loop itself need only index into contiguous
+     * arrays rather than query the mesh for every pair.  The element containing each node, and the protein levels at
+     * each node, are read directly from the mesh, which maintains them.
+     */
+    void UpdateParameterCache();
+
+    /**
+     * Helper method for AddPairKernelContributions().
+     *
+     * Loops over the node pairs in blocks.  The pairs in each block that interact are first gathered, then the pair
+     * law is evaluated for the whole block at once, and finally the resulting forces are added to the node forces.
+     *
+     * @param rLaw the pair law, which must provide EvaluateBatch()
+     * @param rNodePairs reference to the vector of node pairs
+     * @param begin the index of the first pair to consider
+     * @param end one past the index of the last pair to consider
+     * @param pForces the node forces, stored with the DIM components for node i at pForces[DIM*i]
+     */
+    template<class LAW>
+    void AddPairLawContributions(const LAW& rLaw,
+                                 const std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                 unsigned begin,
+                                 unsigned end,
+                                 double* pForces);
 
 public:
 
@@ -128,23 +216,64 @@ public:
             ImmersedBoundaryCellPopulation<DIM>& rCellPopulation);
 
     /**
-     * @return mProteinNodeAttributeLocations
+     * Overridden SupportsForcePipeline() method.
+     *
+     * @return true, as this force implements the force pipeline methods
+     */
+    bool SupportsForcePipeline();
+
+    /**
+     * Overridden SetupForcePipelineStep() method.
+     *
+     * Initialises the protein levels on the first call, then refreshes the per-element parameters, updates the protein
+     * levels, and rebuilds the lookup table if it is in use and stale.
+     *
+     * @param rNodePairs reference to a vector set of node pairs between which to contribute the force
+     * @param rCellPopulation reference to the cell population
+     */
+    void SetupForcePipelineStep(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                ImmersedBoundaryCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Overridden AddPairKernelContributions() method.
+     *
+     * @param rNodePairs reference to the vector of node pairs
+     * @param begin the index of the first pair in the range
+     * @param end one past the index of the last pair in the range
+     * @param pForces the node forces, stored with the DIM components for node i at pForces[DIM*i]
+     */
+    void AddPairKernelContributions(const std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                    unsigned begin,
+                                    unsigned end,
+                                    double* pForces);
+
+    /**
+     * @return #mProteinSpeciesIndices
      */
-    const std::vector<unsigned>& rGetProteinNodeAttributeLocations() const;
+    const std::vector<unsigned>& rGetProteinSpeciesIndices() const;
 
     /**
-     * Helper method for the constructor.
+     * Helper method for SetupForcePipelineStep().
      *
-     * Initializes the levels of each protein.
+     * Initializes the levels of each protein, on the first call only.
      */
     void InitializeProteinLevels();
 
     /**
-     * Helper method for AddImmersedBoundaryForceContribution().
+     * Helper method for SetupForcePipelineStep().
+     *
+     * Updates the levels of each protein at each timestep by a forward Euler step of two processes:
+     *  * diffusion of every protein along the membrane of each cell, discretised on the ring of nodes;
+     *  * binding of cadherins at contacts between cells, with each node recruiting cadherin in proportion to the level
+     *    in its contact partners, saturating at #mMaxProteinLevel, together with relaxation to the baseline level.
+     *
+     * Nothing is done if all the rates are zero, as they are by default.
      *
-     * Updates the levels of each protein at each timestep.
+     * @param rNodePairs reference to a vector set of node pairs that might be in contact
+     * @param rCellPopulation reference to the cell population
      */
-    void UpdateProteinLevels();
+    void UpdateProteinLevels(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                             ImmersedBoundaryCellPopulation<DIM>& rCellPopulation);
 
     /**
      * Set the spring constant.
@@ -158,6 +287,9 @@ public:
 
     /**
      * Set the rest length.
+     *
+     * Note that this is overwritten with 0.25 times the interaction distance on the first call to
+     * AddImmersedBoundaryForceContribution().
      */
     void SetRestLength(double restLength);
 
@@ -177,15 +309,103 @@ public:
     void UseMorsePotential();
 
     /**
-     * @return #mLinearSpring
+     * Set the force law to be based on a Lennard-Jones potential
+     */
+    void UseLennardJonesPotential();
+
+    /**
+     * Set the force law to be piecewise linear, vanishing at the interaction distance
+     */
+    void UsePiecewiseLinearLaw();
+
+    /**
+     * @return whether the force law is a linear spring
      */
     bool IsLinearSpringLaw();
 
     /**
-     * @return #mMorse
+     * @return whether the force law is based on the Morse potential
      */
     bool IsMorsePotential();
 
+    /**
+     * @return whether the force law is based on a Lennard-Jones potential
+     */
+    bool IsLennardJonesPotential();
+
+    /**
+     * @return whether the force law is piecewise linear
+     */
+    bool IsPiecewiseLinearLaw();
+
+    /**
+     * @return #mPairLaw
+     */
+    PairLawType GetPairLaw();
+
+    /**
+     * Set whether to evaluate the force law by linear interpolation in a lookup table over [0, interaction distance],
+     * rather than evaluating it directly for each pair.
+     *
+     * @param useLookupTable whether to use a lookup table
+     */
+    void SetUseLookupTable(bool useLookupTable);
+
+    /**
+     * @return #mUseLookupTable
+     */
+    bool GetUseLookupTable();
+
+    /**
+     * @param numLookupTableIntervals the number of intervals into which the lookup table divides the interaction distance
+     */
+    void SetNumLookupTableIntervals(unsigned numLookupTableIntervals);
+
+    /**
+     * @return #mNumLookupTableIntervals
+     */
+    unsigned GetNumLookupTableIntervals();
+
+    /**
+     * @param proteinDiffusionCoefficient the new value of #mProteinDiffusionCoefficient
+     */
+    void SetProteinDiffusionCoefficient(double proteinDiffusionCoefficient);
+
+    /**
+     * @return #mProteinDiffusionCoefficient
+     */
+    double GetProteinDiffusionCoefficient();
+
+    /**
+     * @param proteinBindingRate the new value of #mProteinBindingRate
+     */
+    void SetProteinBindingRate(double proteinBindingRate);
+
+    /**
+     * @return #mProteinBindingRate
+     */
+    double GetProteinBindingRate();
+
+    /**
+     * @param proteinUnbindingRate the new value of #mProteinUnbindingRate
+     */
+    void SetProteinUnbindingRate(double proteinUnbindingRate);
+
+    /**
+     * @return #mProteinUnbindingRate
+     */
+    double GetProteinUnbindingRate();
+
+    /**
+     * @param maxProteinLevel the new value of #mMaxProteinLevel
+     */
+    void SetMaxProteinLevel(double maxProteinLevel);
+
+    /**
+     * @return #mMaxProteinLevel
+     */
+    double GetMaxProteinLevel();
+
     /**
      * Overridden OutputImmersedBoundaryForceParameters() method.
      *
@@ -43,6 +43,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/multi_array.hpp>
 #include "CellPopulationElementWriter.hpp"
 #include "RandomNumberGenerator.hpp"
+#include "ImmersedBoundaryProfiler.hpp"
+
+#include <algorithm>
+#include <cfloat>
 
 template<unsigned DIM>
 ImmersedBoundaryCellPopulation<DIM>::ImmersedBoundaryCellPopulation(ImmersedBoundaryMesh<DIM, DIM>& rMesh,
@@ -51,7 +55,11 @@ ImmersedBoundaryCellPopulation<DIM>::ImmersedBoundaryCellPopulation(ImmersedBoun
                                           bool validate,
                                           const std::vector<unsigned> locationIndices)
     : AbstractOffLatticeCellPopulation<DIM>(rMesh, rCells, locationIndices),
-      mDeleteMesh(deleteMesh)
+      mDeleteMesh(deleteMesh),
+      mNumNodesClamped(0),
+      mNumSourcesClamped(0),
+      mMaxRelativeDisplacement(0.0),
+      mSuggestedTimeStep(DBL_MAX)
 {
     mpImmersedBoundaryMesh = static_cast<ImmersedBoundaryMesh<DIM, DIM>* >(&(this->mrMesh));
     mpVertexBasedDivisionRule.reset(new ShortAxisVertexBasedDivisionRule<DIM>());
@@ -86,7 +94,11 @@ ImmersedBoundaryCellPopulation<DIM>::ImmersedBoundaryCellPopulation(ImmersedBoun
 template<unsigned DIM>
 ImmersedBoundaryCellPopulation<DIM>::ImmersedBoundaryCellPopulation(ImmersedBoundaryMesh<DIM, DIM>& rMesh)
     : AbstractOffLatticeCellPopulation<DIM>(rMesh),
-      mDeleteMesh(true)
+      mDeleteMesh(true),
+      mNumNodesClamped(0),
+      mNumSourcesClamped(0),
+      mMaxRelativeDisplacement(0.0),
+      mSuggestedTimeStep(DBL_MAX)
 {
     mpImmersedBoundaryMesh = static_cast<ImmersedBoundaryMesh<DIM, DIM>* >(&(this->mrMesh));
 }
@@ -133,7 +145,8 @@ unsigned ImmersedBoundaryCellPopulation<DIM>::GetNumNodes()
 template<unsigned DIM>
 c_vector<double, DIM> ImmersedBoundaryCellPopulation<DIM>::GetLocationOfCellCentre(CellPtr pCell)
 {
-    return mpImmersedBoundaryMesh->GetCentroidOfElement(this->mCellLocationMap[pCell.get()]);
+    // Use the element geometry table, so that the centroids of all cells are found in one pass per time step
+    return mpImmersedBoundaryMesh->rGetElementGeometry(this->mCellLocationMap[pCell.get()]).mCentroid;
 }
 
 template<unsigned DIM>
@@ -161,20 +174,41 @@ double ImmersedBoundaryCellPopulation<DIM>::GetIntrinsicSpacing()
     return mIntrinsicSpacing;
 }
 
-//\todo: implement this method. Decide what "neighbouring" should be for IB cells
+template<unsigned DIM>
+unsigned ImmersedBoundaryCellPopulation<DIM>::GetNumNodesClamped()
+{
+    return mNumNodesClamped;
+}
+
+template<unsigned DIM>
+unsigned ImmersedBoundaryCellPopulation<DIM>::GetNumSourcesClamped()
+{
+    return mNumSourcesClamped;
+}
+
+template<unsigned DIM>
+double ImmersedBoundaryCellPopulation<DIM>::GetMaxRelativeDisplacement()
+{
+    return mMaxRelativeDisplacement;
+}
+
+template<unsigned DIM>
+double ImmersedBoundaryCellPopulation<DIM>::GetSuggestedTimeStep()
+{
+    return mSuggestedTimeStep;
+}
+
 template<unsigned DIM>
 std::set<unsigned> ImmersedBoundaryCellPopulation<DIM>::GetNeighbouringLocationIndices(CellPtr pCell)
 {
-    // The set to return
-    std::set<unsigned> neighbouring_indices;
-    return neighbouring_indices;
+    // Two cells are neighbours if any of their nodes form one of the node pairs used for cell-cell interactions
+    return mpImmersedBoundaryMesh->GetNeighbouringElementIndices(this->GetLocationIndexUsingCell(pCell));
 }
 
 template<unsigned DIM>
 unsigned ImmersedBoundaryCellPopulation<DIM>::AddNode(Node<DIM>* pNewNode)
 {
-    std::cout << "Trying to add new node from within cell population\n";
-    return 0;//mpImmersedBoundaryMesh->AddNode(pNewNode);
+    return mpImmersedBoundaryMesh->AddNode(pNewNode);
 }
 
 template<unsigned DIM>
@@ -221,9 +255,8 @@ template<unsigned DIM>
 unsigned ImmersedBoundaryCellPopulation<DIM>::RemoveDeadCells()
 {
     unsigned num_removed = 0;
-    //\todo: may need to implement this
 
-    /*for (std::list<CellPtr>::iterator it = this->mCells.begin();
+    for (std::list<CellPtr>::iterator it = this->mCells.begin();
          it != this->mCells.end();
          )
     {
@@ -232,15 +265,8 @@ unsigned ImmersedBoundaryCellPopulation<DIM>::RemoveDeadCells()
             // Count the cell as dead
             num_removed++;
 
-            // Remove the element from the mesh if it is not deleted yet
-            ///\todo (#2489) this should cause an error - we should fix this!
-            if (!(this->GetElement(this->GetLocationIndexUsingCell((*it)))->IsDeleted()))
-            {
-                // This warning relies on the fact that there is only one other possibility for
-                // vertex elements to be marked as deleted: a T2 swap
-                WARN_ONCE_ONLY("A Cell is removed without performing a T2 swap. This could leave a void in the mesh.");
-                mpImmersedBoundaryMesh->DeleteElementPriorToReMesh(this->GetLocationIndexUsingCell((*it)));
-            }
+            // Remove the element from the mesh; it is removed for good, and the indices compacted, in Update()
+            mpImmersedBoundaryMesh->DeleteElementPriorToReMesh(this->GetLocationIndexUsingCell((*it)));
 
             // Delete the cell
             it = this->mCells.erase(it);
@@ -249,13 +275,15 @@ unsigned ImmersedBoundaryCellPopulation<DIM>::RemoveDeadCells()
         {
             ++it;
         }
-    }*/
+    }
     return num_removed;
 }
 
 template<unsigned DIM>
 void ImmersedBoundaryCellPopulation<DIM>::UpdateNodeLocations(double dt)
 {
+    ImmersedBoundaryProfiler::Instance()->BeginPhase("UpdateNodeLocations");
+
     // Helper variables, pre-declared for efficiency
     unsigned num_grid_pts_x = this->rGetMesh().GetNumGridPtsX();
     unsigned num_grid_pts_y = this->rGetMesh().GetNumGridPtsY();
@@ -281,6 +309,12 @@ void ImmersedBoundaryCellPopulation<DIM>::UpdateNodeLocations(double dt)
     // Get references to the fluid velocity grid
     const multi_array<double, 3>& vel_grids = this->rGetMesh().rGet2dVelocityGrids();
 
+    // Reset the health counters, which describe only the most recent update
+    mNumNodesClamped = 0;
+    mNumSourcesClamped = 0;
+    mMaxRelativeDisplacement = 0.0;
+    mSuggestedTimeStep = DBL_MAX;
+
     // Iterate over all nodes
     for (typename ImmersedBoundaryMesh<DIM, DIM>::NodeIterator node_iter = this->rGetMesh().GetNodeIteratorBegin(false);
             node_iter != this->rGetMesh().GetNodeIteratorEnd();
@@ -319,10 +353,16 @@ void ImmersedBoundaryCellPopulation<DIM>::UpdateNodeLocations(double dt)
         displacement *= dt;
 
         //If the displacement is too big, warn the user once and scale it back
-        if (norm_2(displacement) > characteristic_spacing)
+        double length = norm_2(displacement);
+        mMaxRelativeDisplacement = std::max(mMaxRelativeDisplacement, length / characteristic_spacing);
+
+        if (length > characteristic_spacing)
         {
             WARN_ONCE_ONLY("Nodes are moving more than half the CharacteristicNodeSpacing. This could cause elements to become inverted so the motion has been restricted. Use a smaller timestep to avoid these warnings.");
-            displacement *= characteristic_spacing / norm_2(displacement);
+            displacement *= characteristic_spacing / length;
+
+            mNumNodesClamped++;
+            mSuggestedTimeStep = std::min(mSuggestedTimeStep, 0.95 * dt * characteristic_spacing / length);
         }
 
         // Get new node location
@@ -390,10 +430,16 @@ void ImmersedBoundaryCellPopulation<DIM>::UpdateNodeLocations(double dt)
             displacement *= dt;
 
             //If the displacement is too big, warn the user once and scale it back
-            if (norm_2(displacement) > characteristic_spacing)
+            double length = norm_2(displacement);
+            mMaxRelativeDisplacement = std::max(mMaxRelativeDisplacement, length / characteristic_spacing);
+
+            if (length > characteristic_spacing)
             {
                 WARN_ONCE_ONLY("Sources are moving more than half the CharacteristicNodeSpacing. This could cause elements to become inverted so the motion has been restricted. Use a smaller timestep to avoid these warnings.");
-                displacement *= characteristic_spacing / norm_2(displacement);
+                displacement *= characteristic_spacing / length;
+
+                mNumSourcesClamped++;
+                mSuggestedTimeStep = std::min(mSuggestedTimeStep, 0.95 * dt * characteristic_spacing / length);
             }
 
             // Get new node location
@@ -409,6 +455,8 @@ void ImmersedBoundaryCellPopulation<DIM>::UpdateNodeLocations(double dt)
             combined_sources[source_idx]->rGetModifiableLocation() = source_location;
         }
     }
+
+    ImmersedBoundaryProfiler::Instance()->EndPhase("UpdateNodeLocations");
 }
 
 template<unsigned DIM>
@@ -426,7 +474,34 @@ bool ImmersedBoundaryCellPopulation<DIM>::IsCellAssociatedWithADeletedLocation(C
 template<unsigned DIM>
 void ImmersedBoundaryCellPopulation<DIM>::Update(bool hasHadBirthsOrDeaths)
 {
-    // I don't think this is needed for IB
+    if (!mpImmersedBoundaryMesh->HasDeletedNodesOrElements())
+    {
+        return;
+    }
+
+    // Compact the mesh, so that the rest of the time step never sees deleted nodes or elements
+    VertexElementMap element_map(mpImmersedBoundaryMesh->GetNumAllElements());
+    mpImmersedBoundaryMesh->ReMesh(element_map);
+
+    if (!element_map.IsIdentityMap())
+    {
+        // Fix up the mappings between CellPtrs and elements
+        std::map<Cell*, unsigned> old_map = this->mCellLocationMap;
+
+        this->mCellLocationMap.clear();
+        this->mLocationCellMap.clear();
+
+        for (std::list<CellPtr>::iterator cell_iter = this->mCells.begin();
+             cell_iter != this->mCells.end();
+             ++cell_iter)
+        {
+            // The cell list only contains living cells, whose elements have not been deleted
+            unsigned old_elem_index = old_map[(*cell_iter).get()];
+            assert(!element_map.IsDeleted(old_elem_index));
+
+            this->SetCellUsingLocationIndex(element_map.GetNewIndex(old_elem_index), *cell_iter);
+        }
+    }
 }
 
 template<unsigned DIM>
@@ -475,6 +550,9 @@ void ImmersedBoundaryCellPopulation<DIM>::CheckForStepSizeException(unsigned nod
         double suggestedStep = 0.95 * dt * characteristic_spacing / length;
         bool terminate = false;
 
+        // Until the exception is thrown, keep the suggested step so that it can be reported
+        mSuggestedTimeStep = std::min(mSuggestedTimeStep, suggestedStep);
+
         //\todo: uncomment the next line
 //        throw new StepSizeException(length, suggestedStep, message.str(), terminate);
     }
@@ -504,8 +582,8 @@ double ImmersedBoundaryCellPopulation<DIM>::GetVolumeOfCell(CellPtr pCell)
     // Get the vertex element index corresponding to this cell
     unsigned elem_index = this->GetLocationIndexUsingCell(pCell);
 
-    // Get the cell's volume from the vertex mesh
-    double cell_volume = mpImmersedBoundaryMesh->GetVolumeOfElement(elem_index);
+    // Get the cell's volume from the element geometry table of the immersed boundary mesh
+    double cell_volume = mpImmersedBoundaryMesh->rGetElementGeometry(elem_index).mArea;
 
     return cell_volume;
 }
@@ -513,6 +591,8 @@ double ImmersedBoundaryCellPopulation<DIM>::GetVolumeOfCell(CellPtr pCell)
 template<unsigned DIM>
 void ImmersedBoundaryCellPopulation<DIM>::WriteVtkResultsToFile(const std::string& rDirectory)
 {
+    ImmersedBoundaryProfiler::Instance()->BeginPhase("WriteVtkResultsToFile");
+
 //#ifdef CHASTE_VTK
     // Create mesh writer for VTK output
     ImmersedBoundaryMeshWriter<DIM, DIM> mesh_writer(rDirectory, "results", false);
@@ -602,6 +682,8 @@ void ImmersedBoundaryCellPopulation<DIM>::WriteVtkResultsToFile(const std::strin
     *(this->mpVtkMetaFile) << num_timesteps;
     *(this->mpVtkMetaFile) << ".vtu\"/>\n";
 //#endif //CHASTE_VTK
+
+    ImmersedBoundaryProfiler::Instance()->EndPhase("WriteVtkResultsToFile");
 }
 
 template<unsigned DIM>
@@ -637,12 +719,10 @@ double ImmersedBoundaryCellPopulation<DIM>::GetWidth(const unsigned& rDimension)
     return width;
 }
 
-///\todo: implement this.  May need to put method back in to mesh class
 template<unsigned DIM>
 std::set<unsigned> ImmersedBoundaryCellPopulation<DIM>::GetNeighbouringNodeIndices(unsigned index)
 {
-    std::set<unsigned> neighbouring_indices;
-    return neighbouring_indices;
+    return mpImmersedBoundaryMesh->GetNeighbouringNodeIndices(index);
 }
 
 template<unsigned DIM>
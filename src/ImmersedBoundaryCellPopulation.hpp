@@ -93,6 +93,24 @@ private:
     /** Whether the simulation has active fluid sources */
     bool mPopulationHasActiveSources;
 
+    /** The number of nodes whose displacement was scaled back in the most recent call to UpdateNodeLocations(). */
+    unsigned mNumNodesClamped;
+
+    /** The number of fluid sources whose displacement was scaled back in the most recent call to UpdateNodeLocations(). */
+    unsigned mNumSourcesClamped;
+
+    /**
+     * The largest displacement of any node or source in the most recent call to UpdateNodeLocations(), before any
+     * scaling back, relative to the characteristic node spacing.
+     */
+    double mMaxRelativeDisplacement;
+
+    /**
+     * The largest time step for which no displacement in the most recent call to UpdateNodeLocations() would have
+     * been scaled back, with a 5% margin, or DBL_MAX if no displacement was scaled back.
+     */
+    double mSuggestedTimeStep;
+
     /**
      * Overridden WriteVtkResultsToFile() method.
      *
@@ -217,6 +235,26 @@ public:
      */
     double GetIntrinsicSpacing();
 
+    /**
+     * @return #mNumNodesClamped
+     */
+    unsigned GetNumNodesClamped();
+
+    /**
+     * @return #mNumSourcesClamped
+     */
+    unsigned GetNumSourcesClamped();
+
+    /**
+     * @return #mMaxRelativeDisplacement
+     */
+    double GetMaxRelativeDisplacement();
+
+    /**
+     * @return #mSuggestedTimeStep
+     */
+    double GetSuggestedTimeStep();
+
     /**
      * Overridden GetLocationOfCellCentre() method.
      *
@@ -242,9 +280,9 @@ public:
     /**
      * Overridden GetNeighbouringLocationIndices() method.
      *
-     * Given a cell, returns the set of location indices corresponding to neighbouring cells.
-     *
-     * At least once per timestep, UpdateCellCentroids() should be called before this function.
+     * Given a cell, returns the set of location indices corresponding to neighbouring cells.  Two cells are
+     * neighbours if any of their nodes form one of the node pairs last found by ImmersedBoundarySimulationModifier,
+     * as given by ImmersedBoundaryMesh::GetNeighbouringElementIndices().
      *
      * @param pCell a cell
      * @return the set of neighbouring location indices.
@@ -391,6 +429,9 @@ public:
     /**
      * Overridden GetNeighbouringNodeIndices() method.
      *
+     * Two nodes are neighbours if they form one of the node pairs last found by ImmersedBoundarySimulationModifier,
+     * as given by ImmersedBoundaryMesh::GetNeighbouringNodeIndices().
+     *
      * @param index the node index
      * @return the set of neighbouring node indices.
      */
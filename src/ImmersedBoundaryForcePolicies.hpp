@@ -0,0 +1,380 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYFORCEPOLICIES_HPP_
+#define IMMERSEDBOUNDARYFORCEPOLICIES_HPP_
+
+#include <vector>
+#include <algorithm>
+
+#include "ImmersedBoundaryCellPopulation.hpp"
+#include "ImmersedBoundaryMesh.hpp"
+#include "ImmersedBoundaryPairPotentials.hpp"
+#include "ImmersedBoundaryRingKernel.hpp"
+
+/*
+ * This file provides force policies for use with ImmersedBoundaryStaticForceSimulationModifier.  A force policy is a
+ * class, used as a template parameter rather than through a base class pointer, so that its methods can be inlined into
+ * the loops of the modifier.  Every policy must provide the following methods:
+ *
+ *  * SetupStep(rNodePairs, rCellPopulation), called serially once per time step before any contributions are added;
+ *  * AddElementContributions(elemIndex, pForces), adding the force within an element to the nodes of that element;
+ *  * AddPairContribution(nodeAIndex, nodeBIndex, pVector, distance, pForces), adding the force between a pair of nodes
+ *    closer than the interaction distance, where pVector is the minimum image vector from node A to node B.
+ *
+ * Forces are stored with the DIM components for node i at pForces[DIM*i].
+ *
+ * The policies here implement the same force laws as ImmersedBoundaryMembraneElasticityForce and
+ * ImmersedBoundaryCellCellInteractionForce, without the features of those classes that need state beyond the mesh.
+ */
+
+/**
+ * A force policy contributing no force, used as the default for unused policy slots.  Its empty methods are
+ * removed entirely by the compiler.
+ */
+template<unsigned DIM>
+class NullForcePolicy
+{
+public:
+
+    /**
+     * Do nothing.
+     *
+     * @param rNodePairs reference to the vector of node pairs
+     * @param rCellPopulation reference to the cell population
+     */
+    inline void SetupStep(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                          ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)
+    {
+    }
+
+    /**
+     * Do nothing.
+     *
+     * @param elemIndex the index of the element
+     * @param pForces the node forces
+     */
+    inline void AddElementContributions(unsigned elemIndex, double* pForces)
+    {
+    }
+
+    /**
+     * Do nothing.
+     *
+     * @param nodeAIndex the index of the first node
+     * @param nodeBIndex the index of the second node
+     * @param pVector the minimum image vector from the first node to the second
+     * @param distance the distance between the nodes
+     * @param pForces the node forces
+     */
+    inline void AddPairContribution(unsigned nodeAIndex,
+                                    unsigned nodeBIndex,
+                                    const double* pVector,
+                                    double distance,
+                                    double* pForces)
+    {
+    }
+};
+
+/**
+ * A force policy for the membrane elasticity force, with the same linear springs between neighbouring nodes of each
+ * element as ImmersedBoundaryMembraneElasticityForce.
+ */
+template<unsigned DIM>
+class MembraneElasticityForcePolicy
+{
+private:
+
+    /** The maximum number of nodes processed at once by AddElementContributions(). */
+    const static unsigned msChunkSize = 64;
+
+    /** The immersed boundary mesh. */
+    ImmersedBoundaryMesh<DIM,DIM>* mpMesh;
+
+    /** The membrane spring constant. */
+    double mSpringConstant;
+
+    /** The membrane rest length, as a multiple of the average node spacing of each element. */
+    double mRestLengthMultiplier;
+
+    /** The multiplicative quantity by which we alter the spring constant of the basement lamina, if present. */
+    double mBasementSpringConstantModifier;
+
+    /** The multiplicative quantity by which we alter the rest length of the basement lamina, if present. */
+    double mBasementRestLengthModifier;
+
+    /** The spring constant for each element, calculated each time step. */
+    std::vector<double> mElementSpringConstants;
+
+    /** The spring rest length for each element, calculated each time step. */
+    std::vector<double> mElementRestLengths;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param springConstant the membrane spring constant (defaults to 1e6)
+     * @param restLengthMultiplier the membrane rest length multiplier (defaults to 0.5)
+     */
+    MembraneElasticityForcePolicy(double springConstant=1e6, double restLengthMultiplier=0.5)
+        : mpMesh(NULL),
+          mSpringConstant(springConstant),
+          mRestLengthMultiplier(restLengthMultiplier),
+          mBasementSpringConstantModifier(5.0),
+          mBasementRestLengthModifier(0.5)
+    {
+    }
+
+    /**
+     * Calculate the spring properties of each element.
+     *
+     * @param rNodePairs reference to the vector of node pairs
+     * @param rCellPopulation reference to the cell population
+     */
+    void SetupStep(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                   ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)
+    {
+        mpMesh = &(rCellPopulation.rGetMesh());
+
+        double intrinsic_spacing_squared = rCellPopulation.GetIntrinsicSpacing() * rCellPopulation.GetIntrinsicSpacing();
+
+        mElementSpringConstants.resize(mpMesh->GetNumAllElements());
+        mElementRestLengths.resize(mpMesh->GetNumAllElements());
+
+        for (typename ImmersedBoundaryMesh<DIM, DIM>::ImmersedBoundaryElementIterator elem_it = mpMesh->GetElementIteratorBegin();
+             elem_it != mpMesh->GetElementIteratorEnd();
+             ++elem_it)
+        {
+            unsigned elem_idx = elem_it->GetIndex();
+            double spacing_ratio = mpMesh->GetAverageNodeSpacingOfElement(elem_idx, false);
+
+            mElementSpringConstants[elem_idx] = mSpringConstant * intrinsic_spacing_squared / (spacing_ratio * spacing_ratio);
+            mElementRestLengths[elem_idx] = mRestLengthMultiplier * spacing_ratio;
+
+            if (elem_idx == mpMesh->GetMembraneIndex())
+            {
+                mElementSpringConstants[elem_idx] *= mBasementSpringConstantModifier;
+                mElementRestLengths[elem_idx] *= mBasementRestLengthModifier;
+            }
+        }
+    }
+
+    /**
+     * Add the elastic force on each node of an element.
+     *
+     * @param elemIndex the index of the element
+     * @param pForces the node forces
+     */
+    inline void AddElementContributions(unsigned elemIndex, double* pForces)
+    {
+        ImmersedBoundaryElement<DIM, DIM>* p_elem = mpMesh->GetElement(elemIndex);
+        unsigned num_nodes = p_elem->GetNumNodes();
+
+        double locations[DIM * (msChunkSize + 2)];
+        double forces[DIM * msChunkSize];
+
+        for (unsigned first_node = 0; first_node < num_nodes; first_node += msChunkSize)
+        {
+            unsigned num_chain_nodes = std::min(num_nodes - first_node, unsigned(msChunkSize));
+
+            // Gather the locations of the chain, together with the halo node at either end
+            for (unsigned i = 0; i < num_chain_nodes + 2; i++)
+            {
+                unsigned local_idx = (first_node + num_nodes + i - 1) % num_nodes;
+                const c_vector<double, DIM>& r_location = p_elem->GetNode(local_idx)->rGetLocation();
+
+                for (unsigned dim = 0; dim < DIM; dim++)
+                {
+                    locations[DIM * i + dim] = r_location[dim];
+                }
+            }
+
+            ImmersedBoundaryRingKernel<DIM>::CalculateChainForces(locations,
+                                                                  num_chain_nodes,
+                                                                  mElementSpringConstants[elemIndex],
+                                                                  mElementRestLengths[elemIndex],
+                                                                  forces);
+
+            for (unsigned i = 0; i < num_chain_nodes; i++)
+            {
+                unsigned global_idx = p_elem->GetNodeGlobalIndex(first_node + i);
+                for (unsigned dim = 0; dim < DIM; dim++)
+                {
+                    pForces[DIM * global_idx + dim] += forces[DIM * i + dim];
+                }
+            }
+        }
+    }
+
+    /**
+     * Do nothing, as this force acts only within elements.
+     *
+     * @param nodeAIndex the index of the first node
+     * @param nodeBIndex the index of the second node
+     * @param pVector the minimum image vector from the first node to the second
+     * @param distance the distance between the nodes
+     * @param pForces the node forces
+     */
+    inline void AddPairContribution(unsigned nodeAIndex,
+                                    unsigned nodeBIndex,
+                                    const double* pVector,
+                                    double distance,
+                                    double* pForces)
+    {
+    }
+};
+
+/**
+ * A force policy for the cell-cell interaction force, with the same force between nodes in different elements as
+ * ImmersedBoundaryCellCellInteractionForce, for a pair law given as a template parameter.
+ *
+ * No transmembrane proteins are modelled, so the force is that of ImmersedBoundaryCellCellInteractionForce with its
+ * initial protein levels, for which the protein multiplier is 1.
+ */
+template<unsigned DIM, class LAW>
+class CellCellInteractionForcePolicy
+{
+private:
+
+    /** The pair law. */
+    LAW mLaw;
+
+    /** The cell-cell spring constant. */
+    double mSpringConst;
+
+    /** The spring constant divided by the intrinsic spacing of the population, refreshed each time step. */
+    double mSpringConstPerSpacing;
+
+    /** Pointer to the index of the element containing each node, held by the mesh. */
+    const unsigned* mpNodeElementIndices;
+
+    /** The average node spacing of each element, refreshed each time step. */
+    std::vector<double> mElementSpacings;
+
+    /** The reciprocal of the average node spacing of each element, refreshed each time step. */
+    std::vector<double> mElementSpacingReciprocals;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rLaw the pair law
+     * @param springConst the cell-cell spring constant (defaults to 1e3)
+     */
+    CellCellInteractionForcePolicy(const LAW& rLaw, double springConst=1e3)
+        : mLaw(rLaw),
+          mSpringConst(springConst),
+          mSpringConstPerSpacing(0.0),
+          mpNodeElementIndices(NULL)
+    {
+    }
+
+    /**
+     * Refresh the per-element parameters.
+     *
+     * @param rNodePairs reference to the vector of node pairs
+     * @param rCellPopulation reference to the cell population
+     */
+    void SetupStep(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                   ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)
+    {
+        ImmersedBoundaryMesh<DIM,DIM>& r_mesh = rCellPopulation.rGetMesh();
+
+        mSpringConstPerSpacing = mSpringConst / rCellPopulation.GetIntrinsicSpacing();
+        mpNodeElementIndices = r_mesh.rGetNodeElementIndices().empty() ? NULL : &(r_mesh.rGetNodeElementIndices()[0]);
+
+        unsigned num_elements = r_mesh.GetNumAllElements();
+        mElementSpacings.resize(num_elements);
+        mElementSpacingReciprocals.resize(num_elements);
+
+        for (unsigned elem_idx = 0; elem_idx < num_elements; elem_idx++)
+        {
+            double spacing = r_mesh.GetAverageNodeSpacingOfElement(elem_idx, false);
+            mElementSpacings[elem_idx] = spacing;
+            mElementSpacingReciprocals[elem_idx] = 1.0 / spacing;
+        }
+    }
+
+    /**
+     * Do nothing, as this force acts only between elements.
+     *
+     * @param elemIndex the index of the element
+     * @param pForces the node forces
+     */
+    inline void AddElementContributions(unsigned elemIndex, double* pForces)
+    {
+    }
+
+    /**
+     * Add the force between a pair of nodes, if they are in different elements.
+     *
+     * @param nodeAIndex the index of the first node
+     * @param nodeBIndex the index of the second node
+     * @param pVector the minimum image vector from the first node to the second
+     * @param distance the distance between the nodes
+     * @param pForces the node forces
+     */
+    inline void AddPairContribution(unsigned nodeAIndex,
+                                    unsigned nodeBIndex,
+                                    const double* pVector,
+                                    double distance,
+                                    double* pForces)
+    {
+        unsigned elem_a_idx = mpNodeElementIndices[nodeAIndex];
+        unsigned elem_b_idx = mpNodeElementIndices[nodeBIndex];
+
+        // Interactions only occur between different cells
+        if (elem_a_idx == elem_b_idx)
+        {
+            return;
+        }
+
+        double elem_spacing = 0.5 * (mElementSpacings[elem_a_idx] + mElementSpacings[elem_b_idx]);
+        double force_scale = mSpringConstPerSpacing * elem_spacing * mLaw.Evaluate(distance) / distance;
+
+        double scale_a = force_scale * elem_spacing * mElementSpacingReciprocals[elem_a_idx];
+        double scale_b = -force_scale * elem_spacing * mElementSpacingReciprocals[elem_b_idx];
+
+        for (unsigned dim = 0; dim < DIM; dim++)
+        {
+            pForces[DIM * nodeAIndex + dim] += pVector[dim] * scale_a;
+            pForces[DIM * nodeBIndex + dim] += pVector[dim] * scale_b;
+        }
+    }
+};
+
+#endif /*IMMERSEDBOUNDARYFORCEPOLICIES_HPP_*/
@@ -0,0 +1,201 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ImmersedBoundaryHardwareCounters.hpp"
+#include "Exception.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+const unsigned ImmersedBoundaryHardwareCounters::CYCLES;
+const unsigned ImmersedBoundaryHardwareCounters::INSTRUCTIONS;
+const unsigned ImmersedBoundaryHardwareCounters::CACHE_MISSES;
+const unsigned ImmersedBoundaryHardwareCounters::BRANCH_MISSES;
+const unsigned ImmersedBoundaryHardwareCounters::NUM_COUNTERS;
+
+ImmersedBoundaryHardwareCounters::ImmersedBoundaryHardwareCounters()
+    : mWasMultiplexed(false)
+{
+}
+
+ImmersedBoundaryHardwareCounters::~ImmersedBoundaryHardwareCounters()
+{
+    Close();
+}
+
+bool ImmersedBoundaryHardwareCounters::Open()
+{
+    if (IsOpen())
+    {
+        return true;
+    }
+
+#ifdef __linux__
+    const __u64 configs[NUM_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES,
+                                         PERF_COUNT_HW_INSTRUCTIONS,
+                                         PERF_COUNT_HW_CACHE_MISSES,
+                                         PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (unsigned counter_idx = 0; counter_idx < NUM_COUNTERS; counter_idx++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = configs[counter_idx];
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // Excluding the kernel and hypervisor lets the counters be used at the default perf_event_paranoid level
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // The group starts disabled, so that all counters are enabled together below
+        attr.disabled = (counter_idx == 0) ? 1 : 0;
+
+        int group_fd = (counter_idx == 0) ? -1 : mFileDescriptors[0];
+        int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+        if (fd < 0)
+        {
+            Close();
+            return false;
+        }
+        mFileDescriptors.push_back(fd);
+    }
+
+    ioctl(mFileDescriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(mFileDescriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    mWasMultiplexed = false;
+
+    // Check that the group was actually scheduled, which fails on some virtual machines: Read() fails if it never ran
+    std::vector<double> values;
+    if (!Read(values))
+    {
+        Close();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ImmersedBoundaryHardwareCounters::Close()
+{
+#ifdef __linux__
+    for (unsigned counter_idx = 0; counter_idx < mFileDescriptors.size(); counter_idx++)
+    {
+        close(mFileDescriptors[counter_idx]);
+    }
+#endif
+    mFileDescriptors.clear();
+}
+
+bool ImmersedBoundaryHardwareCounters::IsOpen() const
+{
+    return !mFileDescriptors.empty();
+}
+
+bool ImmersedBoundaryHardwareCounters::WasMultiplexed() const
+{
+    return mWasMultiplexed;
+}
+
+bool ImmersedBoundaryHardwareCounters::Read(std::vector<double>& rValues) const
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+#ifdef __linux__
+    /*
+     * Reading the leader gives the number of counters, the times for which the group has been enabled and running,
+     * then the value of each counter.  A group which has never run was not scheduled onto the hardware, so its zero
+     * counts are not measurements.  A group which ran for only part of the time it was enabled was multiplexed with
+     * other events, and its counts are scaled up to estimate the full counts.
+     */
+    __u64 buffer[3 + NUM_COUNTERS];
+    ssize_t num_bytes = read(mFileDescriptors[0], buffer, sizeof(buffer));
+    if (num_bytes != static_cast<ssize_t>(sizeof(buffer)) || buffer[0] != NUM_COUNTERS)
+    {
+        return false;
+    }
+
+    __u64 time_enabled = buffer[1];
+    __u64 time_running = buffer[2];
+    if (time_running == 0)
+    {
+        return false;
+    }
+
+    double scale = 1.0;
+    if (time_running < time_enabled)
+    {
+        scale = static_cast<double>(time_enabled) / static_cast<double>(time_running);
+        mWasMultiplexed = true;
+    }
+
+    rValues.resize(NUM_COUNTERS);
+    for (unsigned counter_idx = 0; counter_idx < NUM_COUNTERS; counter_idx++)
+    {
+        rValues[counter_idx] = scale * static_cast<double>(buffer[3 + counter_idx]);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string ImmersedBoundaryHardwareCounters::GetCounterName(unsigned counterIndex)
+{
+    switch (counterIndex)
+    {
+        case CYCLES:
+            return "Cycles";
+        case INSTRUCTIONS:
+            return "Instructions";
+        case CACHE_MISSES:
+            return "CacheMisses";
+        case BRANCH_MISSES:
+            return "BranchMisses";
+        default:
+            EXCEPTION("There is no hardware counter with index " << counterIndex << ".");
+    }
+}
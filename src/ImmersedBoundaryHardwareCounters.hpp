@@ -0,0 +1,150 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYHARDWARECOUNTERS_HPP_
+#define IMMERSEDBOUNDARYHARDWARECOUNTERS_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * A group of hardware performance counters for the calling thread, read with the Linux perf_event_open() interface:
+ * CPU cycles, instructions, last-level cache misses and branch misses.  All counters in the group are scheduled onto
+ * the hardware together, so their values are always consistent with one another.  If the group shares the hardware
+ * with other events, the kernel multiplexes it, and the counts are scaled by the ratio of the time the group was
+ * enabled to the time it ran; WasMultiplexed() reports whether this has happened.
+ *
+ * The counters run continuously once opened, and Read() takes a snapshot of all of them, so a region of code is
+ * measured by the difference between two snapshots.  This allows measured regions to be nested.
+ *
+ * Counters are frequently unavailable, for example on other platforms, in containers, in virtual machines without
+ * a virtual performance monitoring unit, or when /proc/sys/kernel/perf_event_paranoid forbids access.  In these cases
+ * Open() returns false and the class does nothing.  Only user-space events of the calling thread are counted, so work
+ * done by other OpenMP threads is not included.
+ */
+class ImmersedBoundaryHardwareCounters
+{
+private:
+
+    /** The file descriptor of each counter, with the group leader first, or empty if the counters are not open. */
+    std::vector<int> mFileDescriptors;
+
+    /** Whether any snapshot taken by Read() since Open() was scaled because the group was multiplexed. */
+    mutable bool mWasMultiplexed;
+
+    /**
+     * Copy constructor, which is not implemented since the counters own file descriptors.
+     *
+     * @param rOther the counters to copy
+     */
+    ImmersedBoundaryHardwareCounters(const ImmersedBoundaryHardwareCounters& rOther);
+
+    /**
+     * Assignment operator, which is not implemented since the counters own file descriptors.
+     *
+     * @param rOther the counters to copy
+     * @return this object
+     */
+    ImmersedBoundaryHardwareCounters& operator=(const ImmersedBoundaryHardwareCounters& rOther);
+
+public:
+
+    /** The index of the CPU cycle counter. */
+    static const unsigned CYCLES = 0;
+
+    /** The index of the instruction counter. */
+    static const unsigned INSTRUCTIONS = 1;
+
+    /** The index of the last-level cache miss counter. */
+    static const unsigned CACHE_MISSES = 2;
+
+    /** The index of the branch miss counter. */
+    static const unsigned BRANCH_MISSES = 3;
+
+    /** The number of counters in the group. */
+    static const unsigned NUM_COUNTERS = 4;
+
+    /**
+     * Default constructor.  The counters are not opened until Open() is called.
+     */
+    ImmersedBoundaryHardwareCounters();
+
+    /**
+     * Destructor.  Closes the counters.
+     */
+    ~ImmersedBoundaryHardwareCounters();
+
+    /**
+     * Open and start the counters.  Does nothing if they are already open.
+     *
+     * @return whether all counters could be opened; if not, none are left open
+     */
+    bool Open();
+
+    /**
+     * Stop and close the counters.
+     */
+    void Close();
+
+    /**
+     * @return whether the counters are open
+     */
+    bool IsOpen() const;
+
+    /**
+     * Take a snapshot of all counters.  If the group has run for only part of the time since Open() was called, the
+     * values are scaled up to estimate the counts over the whole time.
+     *
+     * @param rValues vector to be filled with the value of each counter since Open() was called, indexed by CYCLES,
+     *     INSTRUCTIONS, CACHE_MISSES and BRANCH_MISSES
+     * @return whether the counters could be read, which is false if they are not open or the group has never been
+     *     scheduled onto the hardware
+     */
+    bool Read(std::vector<double>& rValues) const;
+
+    /**
+     * @return whether any snapshot since Open() was called was scaled because the group was multiplexed with other
+     *     events, so that the counts are estimates
+     */
+    bool WasMultiplexed() const;
+
+    /**
+     * @param counterIndex the index of a counter
+     * @return the name of the counter, as used in column headers
+     */
+    static std::string GetCounterName(unsigned counterIndex);
+};
+
+#endif /*IMMERSEDBOUNDARYHARDWARECOUNTERS_HPP_*/
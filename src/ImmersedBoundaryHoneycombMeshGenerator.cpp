@@ -102,6 +102,12 @@ ImmersedBoundaryHoneycombMeshGenerator::ImmersedBoundaryHoneycombMeshGenerator(u
 
     double scale = 1.0 - proportionalGap;
 
+    // Nodes and elements are created in pools which are handed over to the mesh, so each is contiguous in memory
+    ImmersedBoundaryObjectPool<Node<2> > node_pool;
+    ImmersedBoundaryObjectPool<ImmersedBoundaryElement<2,2> > element_pool;
+    node_pool.Reserve(offsets.size() * node_locations.size());
+    element_pool.Reserve(offsets.size());
+
     // For each calculated centre, create the nodes representing each location around that hexagon
     for (unsigned offset = 0; offset < offsets.size(); offset++)
     {
@@ -110,18 +116,19 @@ ImmersedBoundaryHoneycombMeshGenerator::ImmersedBoundaryHoneycombMeshGenerator(u
         for (unsigned location = 0; location < node_locations.size(); location++)
         {
             unsigned index = offset * node_locations.size() + location;
-            Node<2>* p_node = new Node<2>(index, offsets[offset] + scale * radius * node_locations[location], true);
+            Node<2>* p_node = new (node_pool.Allocate()) Node<2>(index, offsets[offset] + scale * radius * node_locations[location], true);
 
             nodes_this_elem.push_back(p_node);
             nodes.push_back(p_node);
         }
 
-        ImmersedBoundaryElement<2,2>* p_elem = new ImmersedBoundaryElement<2,2>(offset, nodes_this_elem);
+        ImmersedBoundaryElement<2,2>* p_elem = new (element_pool.Allocate()) ImmersedBoundaryElement<2,2>(offset, nodes_this_elem);
         elements.push_back(p_elem);
     }
 
     // Create the mesh, cells, cell population, and simulation
     mpMesh = new ImmersedBoundaryMesh<2,2>(nodes, elements);
+    mpMesh->AdoptObjectPools(node_pool, element_pool);
 }
 
 ImmersedBoundaryHoneycombMeshGenerator::~ImmersedBoundaryHoneycombMeshGenerator()
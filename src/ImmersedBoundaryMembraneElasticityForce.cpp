@@ -42,7 +42,8 @@ ImmersedBoundaryMembraneElasticityForce<DIM>::ImmersedBoundaryMembraneElasticity
       mSpringConstant(1e6),
       mRestLengthMultiplier(0.5),
       mBasementSpringConstantModifier(5.0),
-      mBasementRestLengthModifier(0.5)
+      mBasementRestLengthModifier(0.5),
+      mMaxNodesPerWorkItem(256)
 {
 }
 
@@ -78,6 +79,62 @@ double ImmersedBoundaryMembraneElasticityForce<DIM>::GetBasalLengthForElement(un
 template<unsigned DIM>
 void ImmersedBoundaryMembraneElasticityForce<DIM>::AddImmersedBoundaryForceContribution(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
         ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)
+{
+    SetupForcePipelineStep(rNodePairs, rCellPopulation);
+    this->AddInstrumentedWork(mpMesh->GetNumElements(), 0, 0);
+
+    /*
+     * Each work item is a chain of consecutive nodes in one element.  Every node belongs to exactly one element and
+     * one work item, so the work items write to disjoint nodes and may be processed in parallel.
+     */
+    int num_work_items = mWorkItems.size() / 3;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        // Scratch storage for the contiguous node locations and forces, reused across work items on each thread
+        std::vector<double> locations;
+        std::vector<double> forces;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int item_idx = 0; item_idx < num_work_items; item_idx++)
+        {
+            unsigned elem_idx = mWorkItems[3 * item_idx];
+            unsigned first_node = mWorkItems[3 * item_idx + 1];
+            unsigned num_chain_nodes = mWorkItems[3 * item_idx + 2] - first_node;
+
+            locations.resize(DIM * (num_chain_nodes + 2));
+            forces.resize(DIM * num_chain_nodes);
+
+            CalculateForcesOnChain(elem_idx, first_node, num_chain_nodes, &locations[0], &forces[0]);
+
+            // Add the aggregate force contribution to each node in the chain
+            ImmersedBoundaryElement<DIM, DIM>* p_elem = mpMesh->GetElement(elem_idx);
+            c_vector<double, DIM> aggregate_force;
+            for (unsigned i = 0; i < num_chain_nodes; i++)
+            {
+                for (unsigned dim = 0; dim < DIM; dim++)
+                {
+                    aggregate_force[dim] = forces[DIM * i + dim];
+                }
+                p_elem->GetNode(first_node + i)->AddAppliedForceContribution(aggregate_force);
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+bool ImmersedBoundaryMembraneElasticityForce<DIM>::SupportsForcePipeline()
+{
+    return true;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryMembraneElasticityForce<DIM>::SetupForcePipelineStep(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                                                          ImmersedBoundaryCellPopulation<DIM>& rCellPopulation)
 {
     if (mpMesh == NULL)
     {
@@ -143,20 +200,18 @@ void ImmersedBoundaryMembraneElasticityForce<DIM>::AddImmersedBoundaryForceContr
     // Used in the calculation of the spring constant
     double intrinsic_spacing_squared = rCellPopulation.GetIntrinsicSpacing() * rCellPopulation.GetIntrinsicSpacing();
 
+    /*
+     * The spring properties of each element are calculated serially, before the parallel loop below, as the first
+     * call to GetAverageNodeSpacingOfElement() for each element caches the spacing on the element.
+     */
+    mElementSpringConstants.resize(mpMesh->GetNumElements());
+    mElementRestLengths.resize(mpMesh->GetNumElements());
+
     for (typename ImmersedBoundaryMesh<DIM, DIM>::ImmersedBoundaryElementIterator elem_it = mpMesh->GetElementIteratorBegin();
          elem_it != mpMesh->GetElementIteratorEnd();
          ++elem_it)
     {
-        // Get index and number of nodes of current element
         unsigned elem_idx = elem_it->GetIndex();
-        unsigned num_nodes = elem_it->GetNumNodes();
-
-        // Helper variables
-        double normed_dist;
-        c_vector<double, DIM> aggregate_force;
-
-        // Make a vector to store the force on node i+1 from node i
-        std::vector<c_vector<double, DIM> > elastic_force_to_next_node(num_nodes);
 
         /*
          * Get the node spacing ratio for this element.  The rest length and spring constant are derived from this
@@ -185,32 +240,8 @@ void ImmersedBoundaryMembraneElasticityForce<DIM>::AddImmersedBoundaryForceContr
             rest_length *= mBasementRestLengthModifier;
         }
 
-        // Loop over nodes and calculate the force exerted on node i+1 by node i
-        for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
-        {
-            // Index of the next node, calculated modulo number of nodes in this element
-            unsigned next_idx = (node_idx + 1) % num_nodes;
-
-            double modified_spring_constant = spring_constant;
-            double modified_rest_length = rest_length;
-
-            // Hooke's law linear spring force
-            elastic_force_to_next_node[node_idx] = mpMesh->GetVectorFromAtoB(elem_it->GetNodeLocation(node_idx), elem_it->GetNodeLocation(next_idx));
-            normed_dist = norm_2(elastic_force_to_next_node[node_idx]);
-            elastic_force_to_next_node[node_idx] *= modified_spring_constant * (normed_dist - modified_rest_length) / normed_dist;
-        }
-
-        // Add the contributions of springs adjacent to each node
-        for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
-        {
-            // Get index of previous node
-            unsigned prev_idx = (node_idx + num_nodes - 1) % num_nodes;
-
-            aggregate_force = elastic_force_to_next_node[node_idx] - elastic_force_to_next_node[prev_idx];
-
-            // Add the aggregate force contribution to the node
-            elem_it->GetNode(node_idx)->AddAppliedForceContribution(aggregate_force);
-        }
+        mElementSpringConstants[elem_idx] = spring_constant;
+        mElementRestLengths[elem_idx] = rest_length;
 
         ///\todo Why is this code commented out?
         // If corners are present, we add on the additional functionality
@@ -246,6 +277,106 @@ void ImmersedBoundaryMembraneElasticityForce<DIM>::AddImmersedBoundaryForceContr
 //            }
 //        }
     }
+
+    UpdateWorkItems();
+}
+
+template<unsigned DIM>
+unsigned ImmersedBoundaryMembraneElasticityForce<DIM>::GetMaxNodesPerElementKernelCall()
+{
+    return mMaxNodesPerWorkItem;
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryMembraneElasticityForce<DIM>::AddElementKernelContributions(unsigned elemIndex,
+                                                                                 unsigned firstNode,
+                                                                                 unsigned endNode,
+                                                                                 double* pForces)
+{
+    // Each element is counted once, by the call which covers its first node
+    if (firstNode == 0)
+    {
+        this->AddInstrumentedWork(1, 0, 0);
+    }
+
+    ImmersedBoundaryElement<DIM, DIM>* p_elem = mpMesh->GetElement(elemIndex);
+    assert(firstNode < endNode && endNode <= p_elem->GetNumNodes());
+
+    // The range is processed in chains of bounded length, so that scratch storage may be kept on the stack
+    double locations[DIM * (msElementKernelChunkSize + 2)];
+    double forces[DIM * msElementKernelChunkSize];
+
+    for (unsigned first_node = firstNode; first_node < endNode; first_node += msElementKernelChunkSize)
+    {
+        unsigned num_chain_nodes = std::min(endNode - first_node, unsigned(msElementKernelChunkSize));
+
+        CalculateForcesOnChain(elemIndex, first_node, num_chain_nodes, locations, forces);
+
+        for (unsigned i = 0; i < num_chain_nodes; i++)
+        {
+            unsigned global_idx = p_elem->GetNodeGlobalIndex(first_node + i);
+            for (unsigned dim = 0; dim < DIM; dim++)
+            {
+                pForces[DIM * global_idx + dim] += forces[DIM * i + dim];
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryMembraneElasticityForce<DIM>::CalculateForcesOnChain(unsigned elemIndex,
+                                                                          unsigned firstNode,
+                                                                          unsigned numChainNodes,
+                                                                          double* pLocations,
+                                                                          double* pForces)
+{
+    ImmersedBoundaryElement<DIM, DIM>* p_elem = mpMesh->GetElement(elemIndex);
+    unsigned num_nodes = p_elem->GetNumNodes();
+
+    // Gather the locations of the chain, together with the halo node at either end
+    for (unsigned i = 0; i < numChainNodes + 2; i++)
+    {
+        unsigned local_idx = (firstNode + num_nodes + i - 1) % num_nodes;
+        const c_vector<double, DIM>& r_location = p_elem->GetNode(local_idx)->rGetLocation();
+
+        for (unsigned dim = 0; dim < DIM; dim++)
+        {
+            pLocations[DIM * i + dim] = r_location[dim];
+        }
+    }
+
+    ImmersedBoundaryRingKernel<DIM>::CalculateChainForces(pLocations,
+                                                          numChainNodes,
+                                                          mElementSpringConstants[elemIndex],
+                                                          mElementRestLengths[elemIndex],
+                                                          pForces);
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryMembraneElasticityForce<DIM>::UpdateWorkItems()
+{
+    assert(mpMesh != NULL);
+    assert(mMaxNodesPerWorkItem > 0);
+
+    mWorkItems.clear();
+
+    for (typename ImmersedBoundaryMesh<DIM, DIM>::ImmersedBoundaryElementIterator elem_it = mpMesh->GetElementIteratorBegin();
+         elem_it != mpMesh->GetElementIteratorEnd();
+         ++elem_it)
+    {
+        unsigned elem_idx = elem_it->GetIndex();
+        unsigned num_nodes = elem_it->GetNumNodes();
+
+        // Split large elements, such as the basement lamina, into chunks of roughly equal size
+        unsigned num_chunks = 1 + (num_nodes - 1) / mMaxNodesPerWorkItem;
+
+        for (unsigned chunk_idx = 0; chunk_idx < num_chunks; chunk_idx++)
+        {
+            mWorkItems.push_back(elem_idx);
+            mWorkItems.push_back((chunk_idx * num_nodes) / num_chunks);
+            mWorkItems.push_back(((chunk_idx + 1) * num_nodes) / num_chunks);
+        }
+    }
 }
 
 template<unsigned DIM>
@@ -356,6 +487,22 @@ double ImmersedBoundaryMembraneElasticityForce<DIM>::GetRestLengthMultiplier()
     return mRestLengthMultiplier;
 }
 
+template<unsigned DIM>
+void ImmersedBoundaryMembraneElasticityForce<DIM>::SetMaxNodesPerWorkItem(unsigned maxNodesPerWorkItem)
+{
+    if (maxNodesPerWorkItem == 0)
+    {
+        EXCEPTION("The maximum number of nodes per work item must be positive.");
+    }
+    mMaxNodesPerWorkItem = maxNodesPerWorkItem;
+}
+
+template<unsigned DIM>
+unsigned ImmersedBoundaryMembraneElasticityForce<DIM>::GetMaxNodesPerWorkItem()
+{
+    return mMaxNodesPerWorkItem;
+}
+
 template<unsigned DIM>
 void ImmersedBoundaryMembraneElasticityForce<DIM>::OutputImmersedBoundaryForceParameters(out_stream& rParamsFile)
 {
@@ -363,6 +510,7 @@ void ImmersedBoundaryMembraneElasticityForce<DIM>::OutputImmersedBoundaryForcePa
     *rParamsFile << "\t\t\t<RestLengthMultiplier>" << mRestLengthMultiplier << "</RestLengthMultiplier>\n";
     *rParamsFile << "\t\t\t<BasementSpringConstantModifier>" << mBasementSpringConstantModifier << "</BasementSpringConstantModifier>\n";
     *rParamsFile << "\t\t\t<BasementRestLengthModifier>" << mBasementRestLengthModifier << "</BasementRestLengthModifier>\n";
+    *rParamsFile << "\t\t\t<MaxNodesPerWorkItem>" << mMaxNodesPerWorkItem << "</MaxNodesPerWorkItem>\n";
 
     // Call method on direct parent class
     AbstractImmersedBoundaryForce<DIM>::OutputImmersedBoundaryForceParameters(rParamsFile);
@@ -43,7 +43,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractImmersedBoundaryForce.hpp"
 #include "ImmersedBoundaryCellPopulation.hpp"
 #include "ImmersedBoundaryMesh.hpp"
+#include "ImmersedBoundaryRingKernel.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 /**
@@ -71,6 +73,7 @@ private:
         archive & mRestLengthMultiplier;
         archive & mBasementSpringConstantModifier;
         archive & mBasementRestLengthModifier;
+        archive & mMaxNodesPerWorkItem;
     }
 
 protected:
@@ -90,6 +93,9 @@ protected:
     /** Node region code for lateral, used only by this class. */
     const static unsigned msLat = 3;
 
+    /** The maximum number of nodes processed at once by AddElementKernelContributions(). */
+    const static unsigned msElementKernelChunkSize = 64;
+
     /**
      * The membrane spring constant associated with each element.
      *
@@ -122,6 +128,26 @@ protected:
      */
     double mBasementRestLengthModifier;
 
+    /**
+     * The maximum number of nodes in each work item.  Elements with more nodes than this, such as the basement
+     * lamina, are split into several chains of consecutive nodes so that they may be processed in parallel.
+     *
+     * Initialised to 256 in the constructor.
+     */
+    unsigned mMaxNodesPerWorkItem;
+
+    /** The spring constant for each element, calculated each time step. */
+    std::vector<double> mElementSpringConstants;
+
+    /** The spring rest length for each element, calculated each time step. */
+    std::vector<double> mElementRestLengths;
+
+    /**
+     * The work items for the force calculation, stored as consecutive triples: the element index, the local index of
+     * the first node of the chain, and one past the local index of the last node of the chain.
+     */
+    std::vector<unsigned> mWorkItems;
+
     /** Whether the elements have corners tagged. */
     bool mElementsHaveCorners;
 
@@ -140,6 +166,26 @@ protected:
      */
     double GetBasalLengthForElement(unsigned elemIndex);
 
+    /**
+     * Split the elements of the mesh into work items, storing them in #mWorkItems.
+     */
+    void UpdateWorkItems();
+
+    /**
+     * Calculate the net elastic force on each node in a chain of consecutive nodes of an element.
+     *
+     * @param elemIndex the index of the element
+     * @param firstNode the local index of the first node in the chain
+     * @param numChainNodes the number of nodes in the chain
+     * @param pLocations scratch storage for the DIM * (numChainNodes + 2) coordinates of the chain and its halo nodes
+     * @param pForces on return, the DIM * numChainNodes components of the force on each node in the chain
+     */
+    void CalculateForcesOnChain(unsigned elemIndex,
+                                unsigned firstNode,
+                                unsigned numChainNodes,
+                                double* pLocations,
+                                double* pForces);
+
     /**
      * Splits the nodes into three categories: basal, apical, and lateral.  We keep this information in the node
      * attribute called region, with 0, 1, and 2 representing basal, apical, and lateral respectively.
@@ -176,6 +222,41 @@ public:
     void AddImmersedBoundaryForceContribution(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
             ImmersedBoundaryCellPopulation<DIM>& rCellPopulation);
 
+    /**
+     * Overridden SupportsForcePipeline() method.
+     *
+     * @return true, as this force implements the force pipeline methods
+     */
+    bool SupportsForcePipeline();
+
+    /**
+     * Overridden SetupForcePipelineStep() method.
+     *
+     * Tags the node regions on the first call, and calculates the spring properties of each element.
+     *
+     * @param rNodePairs reference to a vector set of node pairs between which to contribute the force
+     * @param rCellPopulation reference to the cell population
+     */
+    void SetupForcePipelineStep(std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs,
+                                ImmersedBoundaryCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Overridden GetMaxNodesPerElementKernelCall() method.
+     *
+     * @return #mMaxNodesPerWorkItem, so that the force pipeline splits large elements as AddImmersedBoundaryForceContribution() does
+     */
+    unsigned GetMaxNodesPerElementKernelCall();
+
+    /**
+     * Overridden AddElementKernelContributions() method.
+     *
+     * @param elemIndex the index of the element
+     * @param firstNode the local index of the first node in the range
+     * @param endNode one past the local index of the last node in the range
+     * @param pForces the node forces, stored with the DIM components for node i at pForces[DIM*i]
+     */
+    void AddElementKernelContributions(unsigned elemIndex, unsigned firstNode, unsigned endNode, double* pForces);
+
     /**
      * Set #mSpringConstant.
      *
@@ -200,6 +281,18 @@ public:
      */
     double GetRestLengthMultiplier();
 
+    /**
+     * Set #mMaxNodesPerWorkItem.
+     *
+     * @param maxNodesPerWorkItem the new maximum number of nodes per work item
+     */
+    void SetMaxNodesPerWorkItem(unsigned maxNodesPerWorkItem);
+
+    /**
+     * @return #mMaxNodesPerWorkItem.
+     */
+    unsigned GetMaxNodesPerWorkItem();
+
     /**
      * Overridden OutputImmersedBoundaryForceParameters() method.
      *
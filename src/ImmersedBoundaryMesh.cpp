@@ -37,6 +37,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "RandomNumberGenerator.hpp"
 #include "UblasCustomFunctions.hpp"
 #include "Warnings.hpp"
+#include "CsvWriter.hpp"
+
+#include <cfloat>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ImmersedBoundaryMesh(std::vector<Node<SPACE_DIM>*> nodes,
@@ -47,7 +54,9 @@ ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ImmersedBoundaryMesh(std::vector<N
     : mNumGridPtsX(numGridPtsX),
       mNumGridPtsY(numGridPtsY),
       mMembraneIndex(membraneIndex),
-      mElementDivisionSpacing(DOUBLE_UNSET)
+      mElementDivisionSpacing(DOUBLE_UNSET),
+      mElementGeometriesAreValid(false),
+      mNumNodeRenumberings(0u)
 {
     // Clear mNodes and mElements
     Clear();
@@ -97,6 +106,8 @@ ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ImmersedBoundaryMesh(std::vector<N
         }
     }
 
+    UpdateNodeElementIndices();
+
     // Set characteristic node spacing to the average distance between nodes
     double total_perimeter = 0.0;
     unsigned total_nodes = 0;
@@ -111,6 +122,7 @@ ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ImmersedBoundaryMesh(std::vector<N
     mCharacteristicNodeSpacing = total_perimeter / double(total_nodes);
 
     // Position fluid sources at the centroid of each cell, and set strength to zero
+    mFluidSourcePool.Reserve(elements.size());
     for (unsigned elem_it = 0; elem_it < elements.size(); elem_it++)
     {
         unsigned this_elem_idx = mElements[elem_it]->GetIndex();
@@ -121,7 +133,7 @@ ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ImmersedBoundaryMesh(std::vector<N
             // Create a new fluid source at the correct location for each element
             unsigned source_idx = mElementFluidSources.size();
             c_vector<double, SPACE_DIM> source_location = this->GetCentroidOfElement(this_elem_idx);
-            mElementFluidSources.push_back(new FluidSource<SPACE_DIM>(source_idx, source_location));
+            mElementFluidSources.push_back(new (mFluidSourcePool.Allocate()) FluidSource<SPACE_DIM>(source_idx, source_location));
 
             // Set source parameters
             mElementFluidSources.back()->SetAssociatedElementIndex(this_elem_idx);
@@ -144,7 +156,7 @@ ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ImmersedBoundaryMesh(std::vector<N
     {
         // Create a new fluid source at the current x-location and zero y-location
         unsigned source_idx = mBalancingFluidSources.size();
-        mBalancingFluidSources.push_back(new FluidSource<SPACE_DIM>(source_idx, current_location));
+        mBalancingFluidSources.push_back(new (mFluidSourcePool.Allocate()) FluidSource<SPACE_DIM>(source_idx, current_location));
 
         // Increment the current location
         current_location += balancing_source_spacing;
@@ -160,11 +172,17 @@ double ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetElongationShapeFactorOfE
 
     c_vector<double, 3> moments = CalculateMomentsOfElement(index);
 
-    double discriminant = sqrt((moments(0) - moments(1))*(moments(0) - moments(1)) + 4.0*moments(2)*moments(2));
+    return CalculateElongationShapeFactorFromMoments(moments);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::CalculateElongationShapeFactorFromMoments(const c_vector<double, 3>& rMoments)
+{
+    double discriminant = sqrt((rMoments(0) - rMoments(1))*(rMoments(0) - rMoments(1)) + 4.0*rMoments(2)*rMoments(2));
 
     // Note that as the matrix of second moments of area is symmetric, both its eigenvalues are real
-    double largest_eigenvalue = (moments(0) + moments(1) + discriminant)*0.5;
-    double smallest_eigenvalue = (moments(0) + moments(1) - discriminant)*0.5;
+    double largest_eigenvalue = (rMoments(0) + rMoments(1) + discriminant)*0.5;
+    double smallest_eigenvalue = (rMoments(0) + rMoments(1) - discriminant)*0.5;
 
     double elongation_shape_factor = sqrt(largest_eigenvalue/smallest_eigenvalue);
     return elongation_shape_factor;
@@ -453,6 +471,8 @@ ChasteCuboid<SPACE_DIM> ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::CalculateB
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ImmersedBoundaryMesh()
+    : mElementGeometriesAreValid(false),
+      mNumNodeRenumberings(0u)
 {
     this->mMeshChangesDuringSimulation = false;
     Clear();
@@ -478,6 +498,21 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::SolveElementMapping(unsig
     return index;
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::AdoptObjectPools(ImmersedBoundaryObjectPool<Node<SPACE_DIM> >& rNodePool,
+                                                                    ImmersedBoundaryObjectPool<ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM> >& rElementPool)
+{
+    assert(mNodePool.GetNumObjects() == 0);
+    assert(mElementPool.GetNumObjects() == 0);
+
+    mNodePool.Swap(rNodePool);
+    mElementPool.Swap(rElementPool);
+
+    // Any storage the mesh had allocated for itself is now held, empty, by the given pools
+    rNodePool.Release();
+    rElementPool.Release();
+}
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::SolveBoundaryElementMapping(unsigned index) const
 {
@@ -490,16 +525,45 @@ void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::Clear()
     // Delete elements
     for (unsigned i=0; i<mElements.size(); i++)
     {
-        delete mElements[i];
+        mElementPool.Free(mElements[i]);
     }
     mElements.clear();
 
     // Delete nodes
     for (unsigned i=0; i<this->mNodes.size(); i++)
     {
-        delete this->mNodes[i];
+        mNodePool.Free(this->mNodes[i]);
     }
     this->mNodes.clear();
+
+    // Delete fluid sources, which are owned by the mesh
+    for (unsigned i=0; i<mElementFluidSources.size(); i++)
+    {
+        mFluidSourcePool.Free(mElementFluidSources[i]);
+    }
+    mElementFluidSources.clear();
+
+    for (unsigned i=0; i<mBalancingFluidSources.size(); i++)
+    {
+        mFluidSourcePool.Free(mBalancingFluidSources[i]);
+    }
+    mBalancingFluidSources.clear();
+
+    // Every object created in the pools has now been destroyed, so their storage is released in one go
+    mElementPool.Release();
+    mNodePool.Release();
+    mFluidSourcePool.Release();
+
+    mDeletedNodeIndices.clear();
+    mDeletedElementIndices.clear();
+
+    mNodeElementIndices.clear();
+    mNodeProteinLevels.clear();
+
+    mElementGeometries.clear();
+    mElementGeometriesAreValid = false;
+
+    ClearNeighbourLists();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -622,6 +686,106 @@ std::vector<Node<SPACE_DIM>*>& ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::rGe
     return AbstractMesh<ELEMENT_DIM, SPACE_DIM>::mNodes;
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<unsigned>& ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::rGetNodeElementIndices() const
+{
+    return mNodeElementIndices;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetElementIndexOfNode(unsigned nodeIndex) const
+{
+    assert(nodeIndex < mNodeElementIndices.size());
+    return mNodeElementIndices[nodeIndex];
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::AddProteinSpecies(double initialLevel)
+{
+    mNodeProteinLevels.push_back(std::vector<double>(this->mNodes.size(), initialLevel));
+    return mNodeProteinLevels.size() - 1;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetNumProteinSpecies() const
+{
+    return mNodeProteinLevels.size();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<double>& ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::rGetProteinLevels(unsigned speciesIndex) const
+{
+    assert(speciesIndex < mNodeProteinLevels.size());
+    return mNodeProteinLevels[speciesIndex];
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double>& ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::rGetModifiableProteinLevels(unsigned speciesIndex)
+{
+    assert(speciesIndex < mNodeProteinLevels.size());
+    return mNodeProteinLevels[speciesIndex];
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::map<std::string, std::size_t> ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetMemoryUsage() const
+{
+    std::map<std::string, std::size_t> memory_usage;
+
+    memory_usage["VelocityGrids"] = (m2dVelocityGrids.num_elements() + m3dVelocityGrids.num_elements()) * sizeof(double);
+
+    // Each node also holds the set of indices of its containing elements, with one tree node per element
+    std::size_t set_node_size = sizeof(unsigned) + 4 * sizeof(void*);
+    std::size_t node_bytes = this->mNodes.capacity() * sizeof(Node<SPACE_DIM>*);
+    for (unsigned node_idx = 0; node_idx < this->mNodes.size(); node_idx++)
+    {
+        node_bytes += sizeof(Node<SPACE_DIM>) + this->mNodes[node_idx]->GetNumContainingElements() * set_node_size;
+    }
+    memory_usage["Nodes"] = node_bytes;
+
+    std::size_t element_bytes = mElements.capacity() * sizeof(ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>*);
+    for (unsigned elem_idx = 0; elem_idx < mElements.size(); elem_idx++)
+    {
+        element_bytes += sizeof(ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>) +
+                         mElements[elem_idx]->GetNumNodes() * sizeof(Node<SPACE_DIM>*);
+    }
+    memory_usage["Elements"] = element_bytes;
+
+    memory_usage["FluidSources"] = (mElementFluidSources.capacity() + mBalancingFluidSources.capacity()) * sizeof(FluidSource<SPACE_DIM>*) +
+                                   (mElementFluidSources.size() + mBalancingFluidSources.size()) * sizeof(FluidSource<SPACE_DIM>);
+
+    memory_usage["NodeElementIndices"] = mNodeElementIndices.capacity() * sizeof(unsigned);
+
+    std::size_t protein_bytes = mNodeProteinLevels.capacity() * sizeof(std::vector<double>);
+    for (unsigned species_idx = 0; species_idx < mNodeProteinLevels.size(); species_idx++)
+    {
+        protein_bytes += mNodeProteinLevels[species_idx].capacity() * sizeof(double);
+    }
+    memory_usage["ProteinLevels"] = protein_bytes;
+
+    memory_usage["ElementGeometries"] = mElementGeometries.capacity() * sizeof(ElementGeometry);
+
+    memory_usage["NeighbourLists"] = (mElementNeighbourOffsets.capacity() + mElementNeighbourIndices.capacity() +
+                                      mNodeNeighbourOffsets.capacity() + mNodeNeighbourIndices.capacity()) * sizeof(unsigned);
+
+    return memory_usage;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::UpdateNodeElementIndices()
+{
+    mNodeElementIndices.assign(this->mNodes.size(), UINT_MAX);
+
+    for (unsigned elem_idx = 0; elem_idx < mElements.size(); elem_idx++)
+    {
+        ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[elem_idx];
+
+        for (unsigned local_idx = 0; local_idx < p_element->GetNumNodes(); local_idx++)
+        {
+            mNodeElementIndices[p_element->GetNodeGlobalIndex(local_idx)] = p_element->GetIndex();
+        }
+    }
+}
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 c_vector<double, SPACE_DIM> ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetVectorFromAtoB(const c_vector<double, SPACE_DIM>& rLocation1, const c_vector<double, SPACE_DIM>& rLocation2)
 {
@@ -647,18 +811,19 @@ template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::SetNode(unsigned nodeIndex, ChastePoint<SPACE_DIM> point)
 {
     this->mNodes[nodeIndex]->SetPoint(point);
+    InvalidateElementGeometries();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetNumNodes() const
 {
-    return this->mNodes.size();
+    return this->mNodes.size() - mDeletedNodeIndices.size();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetNumElements() const
 {
-    return mElements.size();
+    return mElements.size() - mDeletedElementIndices.size();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -781,6 +946,7 @@ void ImmersedBoundaryMesh<2,2>::ConstructFromMeshReader(AbstractMeshReader<2,2>&
 
     // Reserve memory for nodes
     this->mNodes.reserve(num_nodes);
+    this->mNodePool.Reserve(num_nodes);
 
     rIBMeshReader.Reset();
 
@@ -791,13 +957,14 @@ void ImmersedBoundaryMesh<2,2>::ConstructFromMeshReader(AbstractMeshReader<2,2>&
         node_data = rIBMeshReader.GetNextNode();
         unsigned is_boundary_node = (bool) node_data[2];
         node_data.pop_back();
-        this->mNodes.push_back(new Node<2>(i, node_data, is_boundary_node));
+        this->mNodes.push_back(new (this->mNodePool.Allocate()) Node<2>(i, node_data, is_boundary_node));
     }
 
     rIBMeshReader.Reset();
 
     // Reserve memory for nodes
     mElements.reserve(rIBMeshReader.GetNumElements());
+    mElementPool.Reserve(rIBMeshReader.GetNumElements());
 
     // Initially ensure there is no boundary element - this will be updated in the next loop if there is
     this->mMembraneIndex = UINT_MAX;
@@ -819,7 +986,7 @@ void ImmersedBoundaryMesh<2,2>::ConstructFromMeshReader(AbstractMeshReader<2,2>&
         }
 
         // Use nodes and index to construct this element
-        ImmersedBoundaryElement<2,2>* p_element = new ImmersedBoundaryElement<2,2>(elem_index, nodes);
+        ImmersedBoundaryElement<2,2>* p_element = new (mElementPool.Allocate()) ImmersedBoundaryElement<2,2>(elem_index, nodes);
         mElements.push_back(p_element);
 
         if (element_data.MembraneElement)
@@ -836,6 +1003,9 @@ void ImmersedBoundaryMesh<2,2>::ConstructFromMeshReader(AbstractMeshReader<2,2>&
         }
     }
 
+    UpdateNodeElementIndices();
+    InvalidateElementGeometries();
+
     // Get grid dimensions from grid file and set up grids accordingly
     this->mNumGridPtsX = rIBMeshReader.GetNumGridPtsX();
     this->mNumGridPtsY = rIBMeshReader.GetNumGridPtsY();
@@ -936,6 +1106,149 @@ double ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetAverageNodeSpacingOfElem
     }
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::UpdateElementGeometries()
+{
+    assert(SPACE_DIM == 2);
+
+    int num_elements = mElements.size();
+    mElementGeometries.resize(num_elements);
+
+    /*
+     * Each element's ring of nodes is walked once, accumulating in the same order the quantities computed separately
+     * by GetVolumeOfElement(), GetSurfaceAreaOfElement(), GetCentroidOfElement() and CalculateBoundingBoxOfElement(),
+     * so that these agree exactly with the direct methods.  The moments are accumulated about the first node and
+     * shifted to the centroid with the parallel axis theorem, which agrees with CalculateMomentsOfElement() up to
+     * rounding.
+     */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int elem_idx = 0; elem_idx < num_elements; elem_idx++)
+    {
+        ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[elem_idx];
+        ElementGeometry& r_geometry = mElementGeometries[elem_idx];
+
+        unsigned num_nodes = p_element->GetNumNodes();
+
+        double signed_area = 0.0;
+        double perimeter = 0.0;
+        double centroid_x = 0.0;
+        double centroid_y = 0.0;
+        c_vector<double, 3> moments = zero_vector<double>(3);
+        c_vector<double, SPACE_DIM> bottom_left = zero_vector<double>(SPACE_DIM);
+        c_vector<double, SPACE_DIM> top_right = zero_vector<double>(SPACE_DIM);
+
+        // Map the first vertex to the origin and employ GetVectorFromAtoB() to allow for periodicity
+        c_vector<double, SPACE_DIM> first_node_location = p_element->GetNodeLocation(0);
+        c_vector<double, SPACE_DIM> this_node_location = first_node_location;
+        c_vector<double, SPACE_DIM> pos_1 = zero_vector<double>(SPACE_DIM);
+
+        for (unsigned local_index = 0; local_index < num_nodes; local_index++)
+        {
+            c_vector<double, SPACE_DIM> next_node_location = p_element->GetNodeLocation((local_index + 1) % num_nodes);
+            c_vector<double, SPACE_DIM> pos_2 = this->GetVectorFromAtoB(first_node_location, next_node_location);
+
+            perimeter += norm_2(this->GetVectorFromAtoB(this_node_location, next_node_location));
+
+            double signed_area_term = pos_1[0] * pos_2[1] - pos_1[1] * pos_2[0];
+
+            signed_area += 0.5 * signed_area_term;
+            centroid_x += (pos_1[0] + pos_2[0]) * signed_area_term;
+            centroid_y += (pos_1[1] + pos_2[1]) * signed_area_term;
+
+            moments[0] += (pos_1[1] * pos_1[1] + pos_1[1] * pos_2[1] + pos_2[1] * pos_2[1]) * signed_area_term;
+            moments[1] += (pos_1[0] * pos_1[0] + pos_1[0] * pos_2[0] + pos_2[0] * pos_2[0]) * signed_area_term;
+            moments[2] += (pos_1[0] * pos_2[1] + 2 * pos_1[0] * pos_1[1] + 2 * pos_2[0] * pos_2[1] + pos_2[0] * pos_1[1]) * signed_area_term;
+
+            for (unsigned dim = 0; dim < SPACE_DIM; dim++)
+            {
+                if (pos_2[dim] < bottom_left[dim])
+                {
+                    bottom_left[dim] = pos_2[dim];
+                }
+                else if (pos_2[dim] > top_right[dim])
+                {
+                    top_right[dim] = pos_2[dim];
+                }
+            }
+
+            this_node_location = next_node_location;
+            pos_1 = pos_2;
+        }
+
+        r_geometry.mArea = fabs(signed_area);
+        r_geometry.mPerimeter = perimeter;
+        r_geometry.mAverageNodeSpacing = perimeter / num_nodes;
+        r_geometry.mBoundingBoxMin = bottom_left + first_node_location;
+        r_geometry.mBoundingBoxMax = top_right + first_node_location;
+
+        // The membrane must be treated differently
+        if ((unsigned)elem_idx == mMembraneIndex)
+        {
+            r_geometry.mCentroid = zero_vector<double>(SPACE_DIM);
+            r_geometry.mMoments = zero_vector<double>(3);
+        }
+        else
+        {
+            assert(signed_area != 0.0);
+
+            // The centroid relative to the first node
+            double offset_x = centroid_x / (6.0 * signed_area);
+            double offset_y = centroid_y / (6.0 * signed_area);
+
+            r_geometry.mCentroid = first_node_location;
+            r_geometry.mCentroid[0] += offset_x;
+            r_geometry.mCentroid[1] += offset_y;
+
+            r_geometry.mCentroid[0] = r_geometry.mCentroid[0] < 0 ? r_geometry.mCentroid[0] + 1.0 : fmod(r_geometry.mCentroid[0], 1.0);
+            r_geometry.mCentroid[1] = r_geometry.mCentroid[1] < 0 ? r_geometry.mCentroid[1] + 1.0 : fmod(r_geometry.mCentroid[1], 1.0);
+
+            // Shift the moments from the first node to the centroid
+            moments[0] = moments[0] / 12.0 - signed_area * offset_y * offset_y;
+            moments[1] = moments[1] / 12.0 - signed_area * offset_x * offset_x;
+            moments[2] = moments[2] / 24.0 - signed_area * offset_x * offset_y;
+
+            // As in CalculateMomentsOfElement(), correct the sign if the nodes are ordered clockwise
+            if (moments[0] < 0.0)
+            {
+                moments = -moments;
+            }
+            r_geometry.mMoments = moments;
+        }
+    }
+
+    mElementGeometriesAreValid = true;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateElementGeometries()
+{
+    mElementGeometriesAreValid = false;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::AreElementGeometriesValid() const
+{
+    return mElementGeometriesAreValid;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const typename ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ElementGeometry& ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::rGetElementGeometry(unsigned index)
+{
+    if (!mElementGeometriesAreValid)
+    {
+#ifdef _OPENMP
+        // Several threads would otherwise rebuild the table at once, while others read it
+        assert(!omp_in_parallel());
+#endif
+        UpdateElementGeometries();
+    }
+
+    assert(index < mElementGeometries.size());
+    return mElementGeometries[index];
+}
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 double ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetElementDivisionSpacing()
 {
@@ -1017,43 +1330,244 @@ c_vector<double, SPACE_DIM> ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetSho
     c_vector<double, 3> moments = CalculateMomentsOfElement(index);
 
     // If the principal moments are equal...
-    double discriminant = (moments(0) - moments(1))*(moments(0) - moments(1)) + 4.0*moments(2)*moments(2);
-    if (fabs(discriminant) < 1e-10) ///\todo remove magic number? (see #1884 and #2401)
+    if (!CalculateShortAxisFromMoments(moments, short_axis))
     {
         // ...then every axis through the centroid is a principal axis, so return a random unit vector
         short_axis(0) = RandomNumberGenerator::Instance()->ranf();
         short_axis(1) = sqrt(1.0 - short_axis(0)*short_axis(0));
     }
+
+    return short_axis;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::CalculateShortAxisFromMoments(const c_vector<double, 3>& rMoments,
+                                                                                 c_vector<double, SPACE_DIM>& rShortAxis)
+{
+    double discriminant = (rMoments(0) - rMoments(1))*(rMoments(0) - rMoments(1)) + 4.0*rMoments(2)*rMoments(2);
+    if (fabs(discriminant) < 1e-10) ///\todo remove magic number? (see #1884 and #2401)
+    {
+        return false;
+    }
+
+    // If the product of inertia is zero, then the coordinate axes are the principal axes
+    if (rMoments(2) == 0.0)
+    {
+        if (rMoments(0) < rMoments(1))
+        {
+            rShortAxis(0) = 0.0;
+            rShortAxis(1) = 1.0;
+        }
+        else
+        {
+            rShortAxis(0) = 1.0;
+            rShortAxis(1) = 0.0;
+        }
+    }
     else
     {
-        // If the product of inertia is zero, then the coordinate axes are the principal axes
-        if (moments(2) == 0.0)
+        // Otherwise we find the eigenvector of the inertia matrix corresponding to the largest eigenvalue
+        double lambda = 0.5*(rMoments(0) + rMoments(1) + sqrt(discriminant));
+
+        rShortAxis(0) = 1.0;
+        rShortAxis(1) = (rMoments(0) - lambda)/rMoments(2);
+
+        double magnitude = norm_2(rShortAxis);
+        rShortAxis = rShortAxis / magnitude;
+    }
+
+    return true;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::CalculateShapeMetrics(ShapeMetrics& rMetrics)
+{
+    assert(ELEMENT_DIM == 2 && SPACE_DIM == 2);
+
+    if (!mElementGeometriesAreValid)
+    {
+        UpdateElementGeometries();
+    }
+
+    int num_elements = mElements.size();
+    rMetrics.mElongationShapeFactors.resize(num_elements);
+    rMetrics.mShortAxesX.resize(num_elements);
+    rMetrics.mShortAxesY.resize(num_elements);
+    rMetrics.mAreaSkewnesses.resize(num_elements);
+
+    /*
+     * The random number generator may not be used from several threads, so the short axis of each element with equal
+     * principal moments is drawn here, in element order, as successive calls to GetShortAxisOfElement() would.  A
+     * negative x component marks the other elements, whose short axes are found in the parallel pass below.
+     */
+    for (int elem_idx = 0; elem_idx < num_elements; elem_idx++)
+    {
+        rMetrics.mShortAxesX[elem_idx] = -1.0;
+
+        c_vector<double, SPACE_DIM> short_axis;
+        if ((unsigned)elem_idx != mMembraneIndex &&
+            !CalculateShortAxisFromMoments(mElementGeometries[elem_idx].mMoments, short_axis))
+        {
+            rMetrics.mShortAxesX[elem_idx] = RandomNumberGenerator::Instance()->ranf();
+            rMetrics.mShortAxesY[elem_idx] = sqrt(1.0 - rMetrics.mShortAxesX[elem_idx]*rMetrics.mShortAxesX[elem_idx]);
+        }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int elem_idx = 0; elem_idx < num_elements; elem_idx++)
+    {
+        if ((unsigned)elem_idx == mMembraneIndex)
+        {
+            rMetrics.mElongationShapeFactors[elem_idx] = 0.0;
+            rMetrics.mShortAxesX[elem_idx] = 0.0;
+            rMetrics.mShortAxesY[elem_idx] = 0.0;
+            rMetrics.mAreaSkewnesses[elem_idx] = 0.0;
+            continue;
+        }
+
+        const ElementGeometry& r_geometry = mElementGeometries[elem_idx];
+
+        rMetrics.mElongationShapeFactors[elem_idx] = CalculateElongationShapeFactorFromMoments(r_geometry.mMoments);
+
+        c_vector<double, SPACE_DIM> short_axis;
+        if (rMetrics.mShortAxesX[elem_idx] < 0.0)
+        {
+            CalculateShortAxisFromMoments(r_geometry.mMoments, short_axis);
+            rMetrics.mShortAxesX[elem_idx] = short_axis(0);
+            rMetrics.mShortAxesY[elem_idx] = short_axis(1);
+        }
+        else
+        {
+            short_axis(0) = rMetrics.mShortAxesX[elem_idx];
+            short_axis(1) = rMetrics.mShortAxesY[elem_idx];
+        }
+
+        /*
+         * As in GetSkewnessOfElementMassDistributionAboutAxis(), the element is translated so that its centroid is at
+         * the origin and rotated so that the axis is vertical.  Rather than integrating a piecewise-linear
+         * approximation to the mass distribution, the moments of the distribution of x over the polygon are found
+         * exactly by Green's theorem, as the integral of x^k dA is that of x^(k+1) dy / (k+1) around the boundary.
+         * Along each edge this is a polynomial in the node coordinates, so the moments are accumulated in one walk
+         * around the element.  The distribution is normalised by the signed area, so the orientation does not matter.
+         */
+        ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[elem_idx];
+        unsigned num_nodes = p_element->GetNumNodes();
+
+        double sin_theta = short_axis(0);
+        double cos_theta = short_axis(1);
+
+        double integrals[4] = {0.0, 0.0, 0.0, 0.0};
+
+        c_vector<double, SPACE_DIM> displacement = this->GetVectorFromAtoB(r_geometry.mCentroid, p_element->GetNodeLocation(0));
+        double x_1 = cos_theta * displacement[0] - sin_theta * displacement[1];
+        double y_1 = sin_theta * displacement[0] + cos_theta * displacement[1];
+
+        for (unsigned local_index = 0; local_index < num_nodes; local_index++)
+        {
+            displacement = this->GetVectorFromAtoB(r_geometry.mCentroid, p_element->GetNodeLocation((local_index + 1) % num_nodes));
+            double x_2 = cos_theta * displacement[0] - sin_theta * displacement[1];
+            double y_2 = sin_theta * displacement[0] + cos_theta * displacement[1];
+
+            double dy = y_2 - y_1;
+            double x_1_sq = x_1 * x_1;
+            double x_2_sq = x_2 * x_2;
+
+            integrals[0] += dy * (x_1 + x_2) / 2.0;
+            integrals[1] += dy * (x_1_sq + x_1 * x_2 + x_2_sq) / 6.0;
+            integrals[2] += dy * (x_1 + x_2) * (x_1_sq + x_2_sq) / 12.0;
+            integrals[3] += dy * (x_1_sq * x_1_sq + x_1_sq * x_1 * x_2 + x_1_sq * x_2_sq + x_1 * x_2 * x_2_sq + x_2_sq * x_2_sq) / 20.0;
+
+            x_1 = x_2;
+            y_1 = y_2;
+        }
+
+        double e_x1 = integrals[1] / integrals[0];
+        double e_x2 = integrals[2] / integrals[0];
+        double e_x3 = integrals[3] / integrals[0];
+
+        // Calculate the standard deviation, and the skewness
+        double sd = sqrt(e_x2 - e_x1 * e_x1);
+        rMetrics.mAreaSkewnesses[elem_idx] = (e_x3 - 3.0 * e_x1 * sd * sd - e_x1 * e_x1 * e_x1) / (sd * sd * sd);
+    }
+
+    // The tortuosity is found from the centroids, through the non-membrane elements in order, as in GetTortuosityOfMesh()
+    rMetrics.mTortuosity = 0.0;
+
+    unsigned first_elem_idx = UINT_MAX;
+    unsigned last_elem_idx = UINT_MAX;
+    double total_length = 0.0;
+    for (unsigned elem_idx = 0; elem_idx < (unsigned)num_elements; elem_idx++)
+    {
+        if (elem_idx != mMembraneIndex)
         {
-            if (moments(0) < moments(1))
+            if (first_elem_idx == UINT_MAX)
             {
-                short_axis(0) = 0.0;
-                short_axis(1) = 1.0;
+                first_elem_idx = elem_idx;
             }
             else
             {
-                short_axis(0) = 1.0;
-                short_axis(1) = 0.0;
+                total_length += norm_2(this->GetVectorFromAtoB(mElementGeometries[last_elem_idx].mCentroid,
+                                                               mElementGeometries[elem_idx].mCentroid));
             }
+            last_elem_idx = elem_idx;
         }
-        else
-        {
-            // Otherwise we find the eigenvector of the inertia matrix corresponding to the largest eigenvalue
-            double lambda = 0.5*(moments(0) + moments(1) + sqrt(discriminant));
+    }
 
-            short_axis(0) = 1.0;
-            short_axis(1) = (moments(0) - lambda)/moments(2);
+    if (first_elem_idx != UINT_MAX)
+    {
+        double straight_line_length = norm_2(this->GetVectorFromAtoB(mElementGeometries[first_elem_idx].mCentroid,
+                                                                     mElementGeometries[last_elem_idx].mCentroid));
+        straight_line_length = std::max(straight_line_length, 1.0-straight_line_length);
 
-            double magnitude = norm_2(short_axis);
-            short_axis = short_axis / magnitude;
-        }
+        rMetrics.mTortuosity = total_length / straight_line_length;
     }
+}
 
-    return short_axis;
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::WriteShapeMetrics(ShapeMetrics& rMetrics,
+                                                                    std::string outputDirectory,
+                                                                    std::string fileName)
+{
+    CalculateShapeMetrics(rMetrics);
+
+    unsigned num_elements = mElements.size();
+    std::vector<unsigned> element_indices(num_elements);
+    std::vector<double> areas(num_elements);
+    std::vector<double> centroids_x(num_elements);
+    std::vector<double> centroids_y(num_elements);
+    for (unsigned elem_idx = 0; elem_idx < num_elements; elem_idx++)
+    {
+        element_indices[elem_idx] = elem_idx;
+        areas[elem_idx] = mElementGeometries[elem_idx].mArea;
+        centroids_x[elem_idx] = mElementGeometries[elem_idx].mCentroid[0];
+        centroids_y[elem_idx] = mElementGeometries[elem_idx].mCentroid[1];
+    }
+
+    std::vector<std::string> headers;
+    headers.push_back("element");
+    headers.push_back("area");
+    headers.push_back("centroid_x");
+    headers.push_back("centroid_y");
+    headers.push_back("elongation_shape_factor");
+    headers.push_back("short_axis_x");
+    headers.push_back("short_axis_y");
+    headers.push_back("area_skewness");
+
+    CsvWriter writer;
+    writer.SetDirectoryName(outputDirectory);
+    writer.SetFileName(fileName);
+    writer.AddHeaders(headers);
+    writer.AddData(element_indices);
+    writer.AddData(areas);
+    writer.AddData(centroids_x);
+    writer.AddData(centroids_y);
+    writer.AddData(rMetrics.mElongationShapeFactors);
+    writer.AddData(rMetrics.mShortAxesX);
+    writer.AddData(rMetrics.mShortAxesY);
+    writer.AddData(rMetrics.mAreaSkewnesses);
+    writer.WriteDataToFile();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -1067,10 +1581,35 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElementAlongGivenAx
     // Get the centroid of the element
     c_vector<double, SPACE_DIM> centroid = this->GetCentroidOfElement(pElement->GetIndex());
 
+    // If the axis of division does not cross two edges then we cannot proceed
+    unsigned node_a_index;
+    unsigned node_b_index;
+    if (!FindDivisionNodes(pElement, centroid, axisOfDivision, node_a_index, node_b_index))
+    {
+        EXCEPTION("Cannot proceed with element division: the given axis of division does not cross two edges of the element");
+    }
+
+    // Now call DivideElement() to divide the element using the nodes found above
+    unsigned new_element_index = DivideElement(pElement,
+                                               node_a_index,
+                                               node_b_index,
+                                               centroid,
+                                               axisOfDivision);
+
+    return new_element_index;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::FindDivisionNodes(ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>* pElement,
+                                                                     const c_vector<double, SPACE_DIM>& rCentroid,
+                                                                     const c_vector<double, SPACE_DIM>& rAxisOfDivision,
+                                                                     unsigned& rNodeAIndex,
+                                                                     unsigned& rNodeBIndex)
+{
     // Create a vector perpendicular to the axis of division
     c_vector<double, SPACE_DIM> perp_axis;
-    perp_axis(0) = -axisOfDivision(1);
-    perp_axis(1) = axisOfDivision(0);
+    perp_axis(0) = -rAxisOfDivision(1);
+    perp_axis(1) = rAxisOfDivision(0);
 
     /*
      * Find which edges the axis of division crosses by finding any node
@@ -1079,10 +1618,10 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElementAlongGivenAx
      */
     unsigned num_nodes = pElement->GetNumNodes();
     std::vector<unsigned> intersecting_nodes;
-    bool is_current_node_on_left = (inner_prod(this->GetVectorFromAtoB(pElement->GetNodeLocation(0), centroid), perp_axis) >= 0);
+    bool is_current_node_on_left = (inner_prod(this->GetVectorFromAtoB(pElement->GetNodeLocation(0), rCentroid), perp_axis) >= 0);
     for (unsigned i=0; i<num_nodes; i++)
     {
-        bool is_next_node_on_left = (inner_prod(this->GetVectorFromAtoB(pElement->GetNodeLocation((i+1)%num_nodes), centroid), perp_axis) >= 0);
+        bool is_next_node_on_left = (inner_prod(this->GetVectorFromAtoB(pElement->GetNodeLocation((i+1)%num_nodes), rCentroid), perp_axis) >= 0);
         if (is_current_node_on_left != is_next_node_on_left)
         {
             intersecting_nodes.push_back(i);
@@ -1090,20 +1629,14 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElementAlongGivenAx
         is_current_node_on_left = is_next_node_on_left;
     }
 
-    // If the axis of division does not cross two edges then we cannot proceed
     if (intersecting_nodes.size() != 2)
     {
-        EXCEPTION("Cannot proceed with element division: the given axis of division does not cross two edges of the element");
+        return false;
     }
 
-    // Now call DivideElement() to divide the element using the nodes found above
-    unsigned new_element_index = DivideElement(pElement,
-                                               pElement->GetNodeLocalIndex(intersecting_nodes[0]),
-                                               pElement->GetNodeLocalIndex(intersecting_nodes[1]),
-                                               centroid,
-                                               axisOfDivision);
-
-    return new_element_index;
+    rNodeAIndex = intersecting_nodes[0];
+    rNodeBIndex = intersecting_nodes[1];
+    return true;
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -1120,23 +1653,176 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElementAlongShortAx
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>* pElement,
-                                                                     unsigned nodeAIndex,
-                                                                     unsigned nodeBIndex,
-                                                                     c_vector<double, SPACE_DIM> centroid,
-                                                                     c_vector<double, SPACE_DIM> axisOfDivision)
+std::vector<unsigned> ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElementsAlongGivenAxes(const std::vector<unsigned>& rElementIndices,
+                                                                                                const std::vector<c_vector<double, SPACE_DIM> >& rAxesOfDivision)
 {
     assert(SPACE_DIM == 2);
     assert(ELEMENT_DIM == SPACE_DIM);
 
+    if (rAxesOfDivision.size() != rElementIndices.size())
+    {
+        EXCEPTION("There must be one axis of division for each element to divide.");
+    }
     if (mElementDivisionSpacing == DOUBLE_UNSET)
     {
         EXCEPTION("The value of mElementDivisionSpacing has not been set.");
     }
 
-    /*
-     * Method outline:
-     *
+    int num_divisions = rElementIndices.size();
+
+    std::vector<bool> is_element_dividing(mElements.size(), false);
+    for (int division = 0; division < num_divisions; division++)
+    {
+        unsigned elem_idx = rElementIndices[division];
+        assert(elem_idx < mElements.size());
+
+        if (is_element_dividing[elem_idx])
+        {
+            EXCEPTION("Element " << elem_idx << " cannot be divided more than once at a time.");
+        }
+        is_element_dividing[elem_idx] = true;
+    }
+
+    /*
+     * First, in parallel, find the locations of the nodes of both daughters of each dividing element.  This does not
+     * modify the mesh, so if any division fails then the mesh is left as it was.  The failure for each division is
+     * recorded as 0 (none), 1 (the axis does not cross two edges) or 2 (the daughters cannot be spaced apart).
+     */
+    std::vector<std::vector<c_vector<double, SPACE_DIM> > > daughter_a_locations(num_divisions);
+    std::vector<std::vector<c_vector<double, SPACE_DIM> > > daughter_b_locations(num_divisions);
+    std::vector<unsigned> failures(num_divisions, 0u);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int division = 0; division < num_divisions; division++)
+    {
+        ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[rElementIndices[division]];
+        c_vector<double, SPACE_DIM> centroid = this->GetCentroidOfElement(rElementIndices[division]);
+
+        unsigned node_a_index;
+        unsigned node_b_index;
+        if (!FindDivisionNodes(p_element, centroid, rAxesOfDivision[division], node_a_index, node_b_index))
+        {
+            failures[division] = 1u;
+        }
+        else if (!CalculateDaughterLocations(p_element, node_a_index, node_b_index, centroid, rAxesOfDivision[division],
+                                             daughter_a_locations[division], daughter_b_locations[division]))
+        {
+            failures[division] = 2u;
+        }
+    }
+
+    for (int division = 0; division < num_divisions; division++)
+    {
+        if (failures[division] == 1u)
+        {
+            EXCEPTION("Cannot proceed with element division: the given axis of division does not cross two edges of the element");
+        }
+        if (failures[division] == 2u)
+        {
+            EXCEPTION("Could not space elements far enough apart during cell division.  Cannot currently handle this case");
+        }
+    }
+
+    /*
+     * Then, in serial, create the new nodes, elements and fluid sources, in the same order as dividing the elements
+     * one at a time.  Storage for all of them is reserved up front, so each container grows at most once.
+     */
+    unsigned num_new_nodes = 0;
+    for (int division = 0; division < num_divisions; division++)
+    {
+        num_new_nodes += mElements[rElementIndices[division]]->GetNumNodes();
+    }
+
+    this->mNodes.reserve(this->mNodes.size() + num_new_nodes);
+    mNodeElementIndices.reserve(this->mNodes.size() + num_new_nodes);
+    for (unsigned species = 0; species < mNodeProteinLevels.size(); species++)
+    {
+        mNodeProteinLevels[species].reserve(this->mNodes.size() + num_new_nodes);
+    }
+    mElements.reserve(mElements.size() + num_divisions);
+    mElementFluidSources.reserve(mElementFluidSources.size() + num_divisions);
+
+    mNodePool.Reserve(num_new_nodes);
+    mElementPool.Reserve(num_divisions);
+    mFluidSourcePool.Reserve(num_divisions);
+
+    std::vector<unsigned> new_element_indices(num_divisions);
+    for (int division = 0; division < num_divisions; division++)
+    {
+        new_element_indices[division] = AddDaughterElement(mElements[rElementIndices[division]],
+                                                           daughter_a_locations[division],
+                                                           daughter_b_locations[division]);
+    }
+
+    // The geometry table is out of date, and lists of node pairs do not yet include the new nodes
+    InvalidateElementGeometries();
+    mNumNodeRenumberings++;
+
+    // Finally, in parallel, move the fluid sources of both daughters of each division to their centroids
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int division = 0; division < num_divisions; division++)
+    {
+        unsigned elem_idx = rElementIndices[division];
+        unsigned new_elem_idx = new_element_indices[division];
+
+        mElements[elem_idx]->GetFluidSource()->rGetModifiableLocation() = this->GetCentroidOfElement(elem_idx);
+        mElements[new_elem_idx]->GetFluidSource()->rGetModifiableLocation() = this->GetCentroidOfElement(new_elem_idx);
+    }
+
+    return new_element_indices;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>* pElement,
+                                                                     unsigned nodeAIndex,
+                                                                     unsigned nodeBIndex,
+                                                                     c_vector<double, SPACE_DIM> centroid,
+                                                                     c_vector<double, SPACE_DIM> axisOfDivision)
+{
+    assert(SPACE_DIM == 2);
+    assert(ELEMENT_DIM == SPACE_DIM);
+
+    if (mElementDivisionSpacing == DOUBLE_UNSET)
+    {
+        EXCEPTION("The value of mElementDivisionSpacing has not been set.");
+    }
+
+    std::vector<c_vector<double, SPACE_DIM> > daughter_a_locations;
+    std::vector<c_vector<double, SPACE_DIM> > daughter_b_locations;
+    if (!CalculateDaughterLocations(pElement, nodeAIndex, nodeBIndex, centroid, axisOfDivision,
+                                    daughter_a_locations, daughter_b_locations))
+    {
+        EXCEPTION("Could not space elements far enough apart during cell division.  Cannot currently handle this case");
+    }
+
+    unsigned new_elem_idx = AddDaughterElement(pElement, daughter_a_locations, daughter_b_locations);
+
+    // Nodes have been moved and created, so the element geometry table is out of date
+    InvalidateElementGeometries();
+
+    // Update fluid source locations for both daughter elements
+    pElement->GetFluidSource()->rGetModifiableLocation() = this->GetCentroidOfElement(pElement->GetIndex());
+    mElements[new_elem_idx]->GetFluidSource()->rGetModifiableLocation() = this->GetCentroidOfElement(new_elem_idx);
+
+    return new_elem_idx;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::CalculateDaughterLocations(ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>* pElement,
+                                                                              unsigned nodeAIndex,
+                                                                              unsigned nodeBIndex,
+                                                                              const c_vector<double, SPACE_DIM>& rCentroid,
+                                                                              const c_vector<double, SPACE_DIM>& rAxisOfDivision,
+                                                                              std::vector<c_vector<double, SPACE_DIM> >& rDaughterALocations,
+                                                                              std::vector<c_vector<double, SPACE_DIM> >& rDaughterBLocations)
+{
+    /*
+     * Method outline:
+     *
      *   Each element needs to end up with the same number of nodes as the original element, and those nodes will be
      *   equally spaced around the outline of each of the two daughter elements.
      *
@@ -1145,18 +1831,28 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
      *
      *   To achieve this, we find four 'corner' locations, each of which has a perpendicular distance from the axis of
      *   half the required spacing, and are found by using the locations from the existing element as a stencil.
+     *
+     *   The mesh is not modified here, so that the work for several divisions can be done at once: the corner
+     *   locations are adjusted in a copy of the node locations.
      */
 
     double half_spacing = 0.5 * mElementDivisionSpacing;
 
     // Get unit vectors in the direction of the division axis, and the perpendicular
-    c_vector<double, SPACE_DIM> unit_axis = axisOfDivision / norm_2(axisOfDivision);
+    c_vector<double, SPACE_DIM> unit_axis = rAxisOfDivision / norm_2(rAxisOfDivision);
     c_vector<double, SPACE_DIM> unit_perp;
     unit_perp[0] = -unit_axis[1];
     unit_perp[1] = unit_axis[0];
 
     unsigned num_nodes = pElement->GetNumNodes();
 
+    std::vector<c_vector<double, SPACE_DIM> > locations;
+    locations.reserve(num_nodes);
+    for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
+    {
+        locations.push_back(pElement->GetNode(node_idx)->rGetLocation());
+    }
+
     /*
      * We first identify the start and end indices of the nodes which will form the location stencil for each daughter
      * cell.  Our starting point is the node indices already identified.
@@ -1165,7 +1861,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
      * necessary until the perpendicular distance between the centroid and the node is at least half the required
      * spacing.
      *
-     * Finally, we move the relevant node to be exactly half the required spacing.
+     * Finally, we move the relevant location to be exactly half the required spacing.
      */
     unsigned start_a = (nodeAIndex + 1) % num_nodes;
     unsigned end_a = nodeBIndex;
@@ -1177,7 +1873,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
     bool no_node_satisfied_condition_1 = true;
     for (unsigned i = start_a ; i != end_a ;)
     {
-        c_vector<double, SPACE_DIM> centroid_to_i = this->GetVectorFromAtoB(centroid, pElement->GetNode(i)->rGetLocation());
+        c_vector<double, SPACE_DIM> centroid_to_i = this->GetVectorFromAtoB(rCentroid, locations[i]);
         double perpendicular_dist = inner_prod(centroid_to_i, unit_perp);
 
         if (fabs(perpendicular_dist) >= half_spacing)
@@ -1186,10 +1882,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
             start_a = i;
 
             // Calculate position so it's exactly 0.5 * elem_spacing perpendicular distance from the centroid
-            c_vector<double, SPACE_DIM> new_location = pElement->GetNode(i)->rGetLocation();
-            new_location -= unit_perp * copysign(fabs(perpendicular_dist) - half_spacing, perpendicular_dist);
-
-            pElement->GetNode(i)->SetPoint(ChastePoint<SPACE_DIM>(new_location));
+            locations[i] -= unit_perp * copysign(fabs(perpendicular_dist) - half_spacing, perpendicular_dist);
             break;
         }
 
@@ -1201,7 +1894,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
     bool no_node_satisfied_condition_2 = true;
     for (unsigned i = end_a ; i != start_a ;)
     {
-        c_vector<double, SPACE_DIM> centroid_to_i = this->GetVectorFromAtoB(centroid, pElement->GetNode(i)->rGetLocation());
+        c_vector<double, SPACE_DIM> centroid_to_i = this->GetVectorFromAtoB(rCentroid, locations[i]);
         double perpendicular_dist = inner_prod(centroid_to_i, unit_perp);
 
         if (fabs(perpendicular_dist) >= half_spacing)
@@ -1210,10 +1903,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
             end_a = i;
 
             // Calculate position so it's exactly 0.5 * elem_spacing perpendicular distance from the centroid
-            c_vector<double, SPACE_DIM> new_location = pElement->GetNode(i)->rGetLocation();
-            new_location -= unit_perp * copysign(fabs(perpendicular_dist) - half_spacing, perpendicular_dist);
-
-            pElement->GetNode(i)->SetPoint(ChastePoint<SPACE_DIM>(new_location));
+            locations[i] -= unit_perp * copysign(fabs(perpendicular_dist) - half_spacing, perpendicular_dist);
             break;
         }
 
@@ -1225,7 +1915,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
     bool no_node_satisfied_condition_3 = true;
     for (unsigned i = start_b ; i != end_b ;)
     {
-        c_vector<double, SPACE_DIM> centroid_to_i = this->GetVectorFromAtoB(centroid, pElement->GetNode(i)->rGetLocation());
+        c_vector<double, SPACE_DIM> centroid_to_i = this->GetVectorFromAtoB(rCentroid, locations[i]);
         double perpendicular_dist = inner_prod(centroid_to_i, unit_perp);
 
         if (fabs(perpendicular_dist) >= half_spacing)
@@ -1234,10 +1924,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
             start_b = i;
 
             // Calculate position so it's exactly 0.5 * elem_spacing perpendicular distance from the centroid
-            c_vector<double, SPACE_DIM> new_location = pElement->GetNode(i)->rGetLocation();
-            new_location -= unit_perp * copysign(fabs(perpendicular_dist) - half_spacing, perpendicular_dist);
-
-            pElement->GetNode(i)->SetPoint(ChastePoint<SPACE_DIM>(new_location));
+            locations[i] -= unit_perp * copysign(fabs(perpendicular_dist) - half_spacing, perpendicular_dist);
             break;
         }
 
@@ -1249,7 +1936,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
     bool no_node_satisfied_condition_4 = true;
     for (unsigned i = end_b ; i != start_b ;)
     {
-        c_vector<double, SPACE_DIM> centroid_to_i = this->GetVectorFromAtoB(centroid, pElement->GetNode(i)->rGetLocation());
+        c_vector<double, SPACE_DIM> centroid_to_i = this->GetVectorFromAtoB(rCentroid, locations[i]);
         double perpendicular_dist = inner_prod(centroid_to_i, unit_perp);
 
         if (fabs(perpendicular_dist) >= half_spacing)
@@ -1258,10 +1945,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
             end_b = i;
 
             // Calculate position so it's exactly 0.5 * elem_spacing perpendicular distance from the centroid
-            c_vector<double, SPACE_DIM> new_location = pElement->GetNode(i)->rGetLocation();
-            new_location -= unit_perp * copysign(fabs(perpendicular_dist) - half_spacing, perpendicular_dist);
-
-            pElement->GetNode(i)->SetPoint(ChastePoint<SPACE_DIM>(new_location));
+            locations[i] -= unit_perp * copysign(fabs(perpendicular_dist) - half_spacing, perpendicular_dist);
             break;
         }
 
@@ -1271,7 +1955,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
 
     if (no_node_satisfied_condition_1 || no_node_satisfied_condition_2 || no_node_satisfied_condition_3 || no_node_satisfied_condition_4)
     {
-        EXCEPTION("Could not space elements far enough apart during cell division.  Cannot currently handle this case");
+        return false;
     }
 
     /*
@@ -1280,7 +1964,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
     std::vector<c_vector<double, SPACE_DIM> > daughter_a_location_stencil;
     for (unsigned node_idx = start_a; node_idx != (end_a + 1) % num_nodes; )
     {
-        daughter_a_location_stencil.push_back(c_vector<double, SPACE_DIM>(pElement->GetNode(node_idx)->rGetLocation()));
+        daughter_a_location_stencil.push_back(locations[node_idx]);
 
         // Go to next node
         node_idx = (node_idx + 1) % num_nodes;
@@ -1289,7 +1973,7 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
     std::vector<c_vector<double, SPACE_DIM> > daughter_b_location_stencil;
     for (unsigned node_idx = start_b; node_idx != (end_b + 1) % num_nodes; )
     {
-        daughter_b_location_stencil.push_back(c_vector<double, SPACE_DIM>(pElement->GetNode(node_idx)->rGetLocation()));
+        daughter_b_location_stencil.push_back(locations[node_idx]);
 
         // Go to next node
         node_idx = (node_idx + 1) % num_nodes;
@@ -1298,76 +1982,35 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
     assert(daughter_a_location_stencil.size() > 1);
     assert(daughter_b_location_stencil.size() > 1);
 
-    // To help calculating cumulative distances, add the first location on to the end
-    daughter_a_location_stencil.push_back(daughter_a_location_stencil[0]);
-    daughter_b_location_stencil.push_back(daughter_b_location_stencil[0]);
+    // Find locations equally spaced by arc length around each stencil, one for each node of the original element
+    ResampleLocationsByArcLength(daughter_a_location_stencil, num_nodes, rDaughterALocations);
+    ResampleLocationsByArcLength(daughter_b_location_stencil, num_nodes, rDaughterBLocations);
 
-    // Calculate the cumulative distances around the stencils
-    std::vector<double> cumulative_distances_a;
-    std::vector<double> cumulative_distances_b;
-    cumulative_distances_a.push_back(0.0);
-    cumulative_distances_b.push_back(0.0);
-    for (unsigned loc_idx = 1; loc_idx < daughter_a_location_stencil.size(); loc_idx++)
-    {
-        cumulative_distances_a.push_back(cumulative_distances_a.back() +
-                                         norm_2(this->GetVectorFromAtoB(daughter_a_location_stencil[loc_idx - 1], daughter_a_location_stencil[loc_idx])));
-    }
-    for (unsigned loc_idx = 1; loc_idx < daughter_b_location_stencil.size(); loc_idx++)
-    {
-        cumulative_distances_b.push_back(cumulative_distances_b.back() +
-                                         norm_2(this->GetVectorFromAtoB(daughter_b_location_stencil[loc_idx - 1], daughter_b_location_stencil[loc_idx])));
-    }
+    return true;
+}
 
-    // Find the target node spacing for each of the daughter elements
-    double target_spacing_a = cumulative_distances_a.back() / (double)num_nodes;
-    double target_spacing_b = cumulative_distances_b.back() / (double)num_nodes;
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::AddDaughterElement(ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>* pElement,
+                                                                          const std::vector<c_vector<double, SPACE_DIM> >& rDaughterALocations,
+                                                                          const std::vector<c_vector<double, SPACE_DIM> >& rDaughterBLocations)
+{
+    unsigned num_nodes = pElement->GetNumNodes();
+    assert(rDaughterALocations.size() == num_nodes);
+    assert(rDaughterBLocations.size() == num_nodes);
 
     // Move the existing nodes into position to become daughter-A nodes
-    unsigned last_idx_used = 0;
     for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
     {
-        double location_along_arc = (double)node_idx * target_spacing_a;
-
-        while (location_along_arc > cumulative_distances_a[last_idx_used + 1])
-        {
-            last_idx_used++;
-        }
-
-        // Interpolant is the extra distance past the last index used divided by the length of the next line segment
-        double interpolant = (location_along_arc - cumulative_distances_a[last_idx_used]) /
-                             (cumulative_distances_a[last_idx_used + 1] - cumulative_distances_a[last_idx_used]);
-
-        c_vector<double, SPACE_DIM> this_to_next = this->GetVectorFromAtoB(daughter_a_location_stencil[last_idx_used],
-                                                                           daughter_a_location_stencil[last_idx_used + 1]);
-
-        c_vector<double, SPACE_DIM> new_location_a = daughter_a_location_stencil[last_idx_used] + interpolant * this_to_next;
-
-        pElement->GetNode(node_idx)->SetPoint(ChastePoint<SPACE_DIM>(new_location_a));
+        pElement->GetNode(node_idx)->SetPoint(ChastePoint<SPACE_DIM>(rDaughterALocations[node_idx]));
     }
 
-    // Create new nodes at positions around the daughter-B stencil
-    last_idx_used = 0;
+    // Create new nodes at positions around the daughter-B stencil, contiguous in the node pool
     std::vector<Node<SPACE_DIM>*> new_nodes_vec;
+    mNodePool.Reserve(num_nodes);
     for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
     {
-        double location_along_arc = (double)node_idx * target_spacing_b;
-
-        while (location_along_arc > cumulative_distances_b[last_idx_used + 1])
-        {
-            last_idx_used++;
-        }
-
-        // Interpolant is the extra distance past the last index used divided by the length of the next line segment
-        double interpolant = (location_along_arc - cumulative_distances_b[last_idx_used]) /
-                             (cumulative_distances_b[last_idx_used + 1] - cumulative_distances_b[last_idx_used]);
-
-        c_vector<double, SPACE_DIM> this_to_next = this->GetVectorFromAtoB(daughter_b_location_stencil[last_idx_used],
-                                                                           daughter_b_location_stencil[last_idx_used + 1]);
-
-        c_vector<double, SPACE_DIM> new_location_b = daughter_b_location_stencil[last_idx_used] + interpolant * this_to_next;
-
         unsigned new_node_idx = this->mNodes.size();
-        this->mNodes.push_back(new Node<SPACE_DIM>(new_node_idx, new_location_b, true));
+        this->mNodes.push_back(new (mNodePool.Allocate()) Node<SPACE_DIM>(new_node_idx, rDaughterBLocations[node_idx], true));
         new_nodes_vec.push_back(this->mNodes.back());
     }
 
@@ -1382,11 +2025,26 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
         }
     }
 
+    // Copy protein levels; the new nodes were appended to mNodes, so their levels are appended in the same order
+    for (unsigned species = 0; species < mNodeProteinLevels.size(); species++)
+    {
+        std::vector<double>& r_levels = mNodeProteinLevels[species];
+        r_levels.reserve(this->mNodes.size());
+
+        for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
+        {
+            r_levels.push_back(r_levels[pElement->GetNodeGlobalIndex(node_idx)]);
+        }
+    }
+
     // Create the new element
     unsigned new_elem_idx = this->mElements.size();
-    this->mElements.push_back(new ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>(new_elem_idx, new_nodes_vec));
+    this->mElements.push_back(new (mElementPool.Allocate()) ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>(new_elem_idx, new_nodes_vec));
     this->mElements.back()->RegisterWithNodes();
 
+    // The new nodes were appended to mNodes, so their element indices are appended in the same order
+    mNodeElementIndices.resize(this->mNodes.size(), new_elem_idx);
+
     // Copy any element attributes
     for (unsigned elem_attribute = 0; elem_attribute < pElement->GetNumElementAttributes(); elem_attribute++)
     {
@@ -1399,12 +2057,8 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
         this->mElements.back()->rGetCornerNodes().push_back(pElement->rGetCornerNodes()[corner]);
     }
 
-    // Update fluid source location for the existing element
-    pElement->GetFluidSource()->rGetModifiableLocation() = this->GetCentroidOfElement(pElement->GetIndex());
-
-    // Add a fluid source for the new element
-    c_vector<double, SPACE_DIM> new_centroid = this->GetCentroidOfElement(new_elem_idx);
-    mElementFluidSources.push_back(new FluidSource<SPACE_DIM>(new_elem_idx, new_centroid));
+    // Add a fluid source for the new element; the caller moves it to the centroid once all nodes are in place
+    mElementFluidSources.push_back(new (mFluidSourcePool.Allocate()) FluidSource<SPACE_DIM>(new_elem_idx));
 
     // Set source parameters
     mElementFluidSources.back()->SetAssociatedElementIndex(new_elem_idx);
@@ -1416,6 +2070,674 @@ unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(ImmersedBou
     return new_elem_idx;
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ResampleLocationsByArcLength(const std::vector<c_vector<double, SPACE_DIM> >& rStencil,
+                                                                               unsigned numLocations,
+                                                                               std::vector<c_vector<double, SPACE_DIM> >& rLocations)
+{
+    assert(rStencil.size() > 1);
+
+    // To help calculating cumulative distances, add the first location on to the end
+    std::vector<c_vector<double, SPACE_DIM> > closed_stencil(rStencil);
+    closed_stencil.push_back(rStencil[0]);
+
+    // Calculate the cumulative distances around the stencil
+    std::vector<double> cumulative_distances;
+    cumulative_distances.reserve(closed_stencil.size());
+    cumulative_distances.push_back(0.0);
+    for (unsigned loc_idx = 1; loc_idx < closed_stencil.size(); loc_idx++)
+    {
+        cumulative_distances.push_back(cumulative_distances.back() +
+                                       norm_2(this->GetVectorFromAtoB(closed_stencil[loc_idx - 1], closed_stencil[loc_idx])));
+    }
+
+    // Find the target spacing between locations
+    double target_spacing = cumulative_distances.back() / (double)numLocations;
+
+    rLocations.resize(numLocations);
+
+    unsigned last_idx_used = 0;
+    for (unsigned loc_idx = 0; loc_idx < numLocations; loc_idx++)
+    {
+        double location_along_arc = (double)loc_idx * target_spacing;
+
+        while (location_along_arc > cumulative_distances[last_idx_used + 1])
+        {
+            last_idx_used++;
+        }
+
+        // Interpolant is the extra distance past the last index used divided by the length of the next line segment
+        double interpolant = (location_along_arc - cumulative_distances[last_idx_used]) /
+                             (cumulative_distances[last_idx_used + 1] - cumulative_distances[last_idx_used]);
+
+        c_vector<double, SPACE_DIM> this_to_next = this->GetVectorFromAtoB(closed_stencil[last_idx_used],
+                                                                           closed_stencil[last_idx_used + 1]);
+
+        rLocations[loc_idx] = closed_stencil[last_idx_used] + interpolant * this_to_next;
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetNodeSpacingNonUniformityOfElement(unsigned index)
+{
+    ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = GetElement(index);
+    unsigned num_nodes = p_element->GetNumNodes();
+
+    double min_spacing = DBL_MAX;
+    double max_spacing = 0.0;
+    for (unsigned local_index = 0; local_index < num_nodes; local_index++)
+    {
+        double spacing = norm_2(this->GetVectorFromAtoB(p_element->GetNodeLocation(local_index),
+                                                        p_element->GetNodeLocation((local_index + 1) % num_nodes)));
+
+        min_spacing = std::min(min_spacing, spacing);
+        max_spacing = std::max(max_spacing, spacing);
+    }
+
+    // Coincident nodes are as non-uniform as possible
+    return min_spacing > 0.0 ? max_spacing / min_spacing : DBL_MAX;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::RemeshElements(double nonUniformityThreshold)
+{
+    assert(SPACE_DIM == 2);
+
+    if (nonUniformityThreshold < 1.0)
+    {
+        EXCEPTION("The node spacing non-uniformity threshold must be at least 1.");
+    }
+
+    int num_elements = mElements.size();
+    int num_remeshed = 0;
+
+    // Each element moves only its own nodes, so the elements can be remeshed independently
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:num_remeshed)
+#endif
+    for (int elem_idx = 0; elem_idx < num_elements; elem_idx++)
+    {
+        // The basement membrane is not closed, so is left alone
+        if ((unsigned)elem_idx == mMembraneIndex)
+        {
+            continue;
+        }
+
+        if (GetNodeSpacingNonUniformityOfElement(elem_idx) > nonUniformityThreshold)
+        {
+            RedistributeNodesOfElement(elem_idx);
+            num_remeshed++;
+        }
+    }
+
+    if (num_remeshed > 0)
+    {
+        InvalidateElementGeometries();
+    }
+
+    return num_remeshed;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::RedistributeNodesOfElement(unsigned index)
+{
+    ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = GetElement(index);
+    unsigned num_nodes = p_element->GetNumNodes();
+
+    // The current node locations form the stencil, so the first node stays where it is
+    std::vector<c_vector<double, SPACE_DIM> > stencil(num_nodes);
+    for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
+    {
+        stencil[node_idx] = p_element->GetNodeLocation(node_idx);
+    }
+
+    std::vector<c_vector<double, SPACE_DIM> > new_locations;
+    ResampleLocationsByArcLength(stencil, num_nodes, new_locations);
+
+    /*
+     * Each node keeps its identity, and so its attributes, region and protein levels, and moves along the boundary to
+     * its new location.  As in UpdateNodeLocations(), locations are wrapped to account for the periodic boundary.
+     */
+    for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
+    {
+        c_vector<double, SPACE_DIM> new_location = new_locations[node_idx];
+        for (unsigned dim = 0; dim < SPACE_DIM; dim++)
+        {
+            new_location[dim] = fmod(new_location[dim] + 1.0, 1.0);
+        }
+        p_element->GetNode(node_idx)->SetPoint(ChastePoint<SPACE_DIM>(new_location));
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::AdaptNodeCounts(double targetSpacing, double tolerance, unsigned minNumNodes)
+{
+    assert(SPACE_DIM == 2);
+
+    if (targetSpacing <= 0.0)
+    {
+        EXCEPTION("The target node spacing must be positive.");
+    }
+    if (tolerance < 0.0)
+    {
+        EXCEPTION("The node spacing tolerance must be non-negative.");
+    }
+    if (minNumNodes < 3)
+    {
+        EXCEPTION("Each element must keep at least 3 nodes.");
+    }
+
+    /*
+     * First, in parallel, decide the new number of nodes for each element and find their locations, equally spaced by
+     * arc length around the current boundary.  An element keeps its nodes if its average spacing is within the
+     * tolerance of the target, which stops elements near the threshold from changing resolution every time.
+     */
+    int num_elements = mElements.size();
+    std::vector<std::vector<c_vector<double, SPACE_DIM> > > new_locations(num_elements);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int elem_idx = 0; elem_idx < num_elements; elem_idx++)
+    {
+        if ((unsigned)elem_idx == mMembraneIndex)
+        {
+            continue;
+        }
+
+        ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[elem_idx];
+        unsigned num_nodes = p_element->GetNumNodes();
+
+        std::vector<c_vector<double, SPACE_DIM> > stencil(num_nodes);
+        double perimeter = 0.0;
+        for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
+        {
+            stencil[node_idx] = p_element->GetNodeLocation(node_idx);
+            perimeter += norm_2(this->GetVectorFromAtoB(p_element->GetNodeLocation(node_idx),
+                                                        p_element->GetNodeLocation((node_idx + 1) % num_nodes)));
+        }
+
+        if (fabs(perimeter / (num_nodes * targetSpacing) - 1.0) <= tolerance)
+        {
+            continue;
+        }
+
+        unsigned new_num_nodes = std::max(minNumNodes, unsigned(floor(perimeter / targetSpacing + 0.5)));
+        if (new_num_nodes != num_nodes)
+        {
+            ResampleLocationsByArcLength(stencil, new_num_nodes, new_locations[elem_idx]);
+        }
+    }
+
+    /*
+     * Then, serially, resize each changed element.  Its first nodes are reused and any others are created or deleted.
+     * Each node in the new element takes its attributes, region and protein levels from the old node at the
+     * corresponding position along the boundary.
+     */
+    std::vector<Node<SPACE_DIM>*> old_nodes(this->mNodes);
+    std::vector<unsigned> new_to_old_node_indices;
+    std::vector<Node<SPACE_DIM>*> new_nodes;
+    new_nodes.reserve(old_nodes.size());
+    new_to_old_node_indices.reserve(old_nodes.size());
+
+    std::vector<bool> is_node_placed(old_nodes.size(), false);
+    std::vector<Node<SPACE_DIM>*> nodes_to_delete;
+
+    unsigned num_adapted = 0;
+    for (int elem_idx = 0; elem_idx < num_elements; elem_idx++)
+    {
+        ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[elem_idx];
+        unsigned num_nodes = p_element->GetNumNodes();
+
+        if (new_locations[elem_idx].empty())
+        {
+            // This element is unchanged, but its nodes are renumbered along with all the others
+            for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
+            {
+                unsigned old_idx = p_element->GetNodeGlobalIndex(node_idx);
+                new_to_old_node_indices.push_back(old_idx);
+                new_nodes.push_back(old_nodes[old_idx]);
+                is_node_placed[old_idx] = true;
+            }
+            continue;
+        }
+
+        num_adapted++;
+        unsigned new_num_nodes = new_locations[elem_idx].size();
+
+        // Record the old nodes of this element, and the region and attributes of each, before any are changed
+        std::vector<Node<SPACE_DIM>*> elem_old_nodes(num_nodes);
+        std::vector<unsigned> elem_old_indices(num_nodes);
+        std::vector<unsigned> elem_old_regions(num_nodes);
+        std::vector<std::vector<double> > elem_old_attributes(num_nodes);
+        for (unsigned node_idx = 0; node_idx < num_nodes; node_idx++)
+        {
+            Node<SPACE_DIM>* p_node = p_element->GetNode(node_idx);
+            elem_old_nodes[node_idx] = p_node;
+            elem_old_indices[node_idx] = p_node->GetIndex();
+            elem_old_regions[node_idx] = p_node->GetRegion();
+            if (p_node->GetNumNodeAttributes() > 0)
+            {
+                elem_old_attributes[node_idx] = p_node->rGetNodeAttributes();
+            }
+            is_node_placed[p_node->GetIndex()] = true;
+        }
+
+        // Delete surplus nodes from the end of the element, or add new ones
+        while (p_element->GetNumNodes() > new_num_nodes)
+        {
+            nodes_to_delete.push_back(p_element->GetNode(p_element->GetNumNodes() - 1));
+            p_element->DeleteNode(p_element->GetNumNodes() - 1);
+        }
+        while (p_element->GetNumNodes() < new_num_nodes)
+        {
+            p_element->AddNode(new (mNodePool.Allocate()) Node<SPACE_DIM>(UINT_MAX, new_locations[elem_idx][p_element->GetNumNodes()], true),
+                               p_element->GetNumNodes() - 1);
+        }
+
+        for (unsigned node_idx = 0; node_idx < new_num_nodes; node_idx++)
+        {
+            // The old node at the corresponding position along the boundary
+            unsigned source_idx = (node_idx * num_nodes) / new_num_nodes;
+
+            c_vector<double, SPACE_DIM> new_location = new_locations[elem_idx][node_idx];
+            for (unsigned dim = 0; dim < SPACE_DIM; dim++)
+            {
+                new_location[dim] = fmod(new_location[dim] + 1.0, 1.0);
+            }
+
+            Node<SPACE_DIM>* p_node = p_element->GetNode(node_idx);
+            p_node->SetPoint(ChastePoint<SPACE_DIM>(new_location));
+            p_node->SetRegion(elem_old_regions[source_idx]);
+
+            const std::vector<double>& r_source_attributes = elem_old_attributes[source_idx];
+            for (unsigned attribute = 0; attribute < r_source_attributes.size(); attribute++)
+            {
+                if (attribute < p_node->GetNumNodeAttributes())
+                {
+                    p_node->rGetNodeAttributes()[attribute] = r_source_attributes[attribute];
+                }
+                else
+                {
+                    p_node->AddNodeAttribute(r_source_attributes[attribute]);
+                }
+            }
+
+            new_to_old_node_indices.push_back(elem_old_indices[source_idx]);
+            new_nodes.push_back(p_node);
+        }
+
+        // Corner nodes move to the node at the corresponding position along the new boundary
+        std::vector<Node<SPACE_DIM>*>& r_corner_nodes = p_element->rGetCornerNodes();
+        for (unsigned corner = 0; corner < r_corner_nodes.size(); corner++)
+        {
+            unsigned old_local_idx = std::find(elem_old_nodes.begin(), elem_old_nodes.end(), r_corner_nodes[corner]) - elem_old_nodes.begin();
+            if (old_local_idx < num_nodes)
+            {
+                unsigned new_local_idx = std::min(new_num_nodes - 1, unsigned(floor((double)(old_local_idx * new_num_nodes) / num_nodes + 0.5)));
+                r_corner_nodes[corner] = p_element->GetNode(new_local_idx);
+            }
+        }
+
+        // Keep the reference spacing used by the membrane forces consistent with the new resolution
+        if (p_element->GetAverageNodeSpacing() != DOUBLE_UNSET)
+        {
+            p_element->SetAverageNodeSpacing(p_element->GetAverageNodeSpacing() * num_nodes / new_num_nodes);
+        }
+    }
+
+    if (num_adapted == 0)
+    {
+        return 0;
+    }
+
+    // Any nodes not in an element keep their relative order, after all the others
+    for (unsigned old_idx = 0; old_idx < old_nodes.size(); old_idx++)
+    {
+        if (!is_node_placed[old_idx])
+        {
+            new_to_old_node_indices.push_back(old_idx);
+            new_nodes.push_back(old_nodes[old_idx]);
+        }
+    }
+
+    // Renumber the nodes densely, so that the nodes of each element are contiguous
+    this->mNodes.swap(new_nodes);
+    for (unsigned node_idx = 0; node_idx < this->mNodes.size(); node_idx++)
+    {
+        this->mNodes[node_idx]->SetIndex(node_idx);
+    }
+
+    for (unsigned node_idx = 0; node_idx < nodes_to_delete.size(); node_idx++)
+    {
+        mNodePool.Free(nodes_to_delete[node_idx]);
+    }
+
+    // Permute the protein levels to match
+    for (unsigned species = 0; species < mNodeProteinLevels.size(); species++)
+    {
+        const std::vector<double>& r_old_levels = mNodeProteinLevels[species];
+        std::vector<double> new_levels(new_to_old_node_indices.size());
+        for (unsigned node_idx = 0; node_idx < new_levels.size(); node_idx++)
+        {
+            new_levels[node_idx] = r_old_levels[new_to_old_node_indices[node_idx]];
+        }
+        mNodeProteinLevels[species].swap(new_levels);
+    }
+
+    UpdateNodeElementIndices();
+    InvalidateElementGeometries();
+    ClearNeighbourLists();
+    mNumNodeRenumberings++;
+
+    // Finally, in parallel, move the fluid source of each adapted element to its new centroid
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int elem_idx = 0; elem_idx < num_elements; elem_idx++)
+    {
+        if (!new_locations[elem_idx].empty() && mElements[elem_idx]->GetFluidSource() != NULL)
+        {
+            mElements[elem_idx]->GetFluidSource()->rGetModifiableLocation() = this->GetCentroidOfElement(elem_idx);
+        }
+    }
+
+    return num_adapted;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::AddNode(Node<SPACE_DIM>* pNewNode)
+{
+    // Nodes are always appended, so that node indices stay dense; deleted indices are reclaimed by ReMesh()
+    unsigned new_node_idx = this->mNodes.size();
+    pNewNode->SetIndex(new_node_idx);
+    this->mNodes.push_back(pNewNode);
+
+    mNodeElementIndices.push_back(UINT_MAX);
+    for (unsigned species = 0; species < mNodeProteinLevels.size(); species++)
+    {
+        mNodeProteinLevels[species].push_back(0.0);
+    }
+
+    return new_node_idx;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DeleteElementPriorToReMesh(unsigned index)
+{
+    assert(index < mElements.size());
+
+    if (index == mMembraneIndex)
+    {
+        EXCEPTION("The membrane element cannot be deleted.");
+    }
+
+    ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[index];
+    assert(!p_element->IsDeleted());
+
+    // Mark the nodes of the element as deleted; each node is contained in only this element
+    for (unsigned node_idx = 0; node_idx < p_element->GetNumNodes(); node_idx++)
+    {
+        p_element->GetNode(node_idx)->MarkAsDeleted();
+        mDeletedNodeIndices.push_back(p_element->GetNodeGlobalIndex(node_idx));
+    }
+
+    // The fluid source of the element should have no effect before it is removed
+    if (p_element->GetFluidSource() != NULL)
+    {
+        p_element->GetFluidSource()->SetStrength(0.0);
+    }
+
+    p_element->MarkAsDeleted();
+    mDeletedElementIndices.push_back(index);
+
+    InvalidateElementGeometries();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::DeleteNodePriorToReMesh(unsigned index)
+{
+    assert(index < this->mNodes.size());
+
+    Node<SPACE_DIM>* p_node = this->mNodes[index];
+    assert(!p_node->IsDeleted());
+
+    // Remove the node from its element, which must remain a polygon
+    unsigned elem_idx = mNodeElementIndices[index];
+    if (elem_idx != UINT_MAX)
+    {
+        ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[elem_idx];
+
+        if (p_element->GetNumNodes() <= 3)
+        {
+            EXCEPTION("Each element must keep at least 3 nodes.");
+        }
+
+        const std::vector<Node<SPACE_DIM>*>& r_corner_nodes = p_element->rGetCornerNodes();
+        if (std::find(r_corner_nodes.begin(), r_corner_nodes.end(), p_node) != r_corner_nodes.end())
+        {
+            EXCEPTION("Node " << index << " is a corner node of element " << elem_idx << " and cannot be deleted.");
+        }
+
+        p_element->DeleteNode(p_element->GetNodeLocalIndex(index));
+        mNodeElementIndices[index] = UINT_MAX;
+    }
+
+    p_node->MarkAsDeleted();
+    mDeletedNodeIndices.push_back(index);
+
+    InvalidateElementGeometries();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::HasDeletedNodesOrElements() const
+{
+    return !(mDeletedNodeIndices.empty() && mDeletedElementIndices.empty());
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh(VertexElementMap& rElementMap)
+{
+    rElementMap.Resize(mElements.size());
+    rElementMap.ResetToIdentity();
+
+    if (!HasDeletedNodesOrElements())
+    {
+        return;
+    }
+
+    /*
+     * Remove the deleted elements, with their fluid sources, and renumber the remaining elements densely in their
+     * existing order.  The element fluid sources are rebuilt in the same order, which is the order in which they are
+     * created.
+     */
+    std::vector<ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>*> live_elements;
+    live_elements.reserve(mElements.size() - mDeletedElementIndices.size());
+
+    std::vector<FluidSource<SPACE_DIM>*> live_sources;
+    live_sources.reserve(mElementFluidSources.size());
+
+    for (unsigned old_elem_idx = 0; old_elem_idx < mElements.size(); old_elem_idx++)
+    {
+        ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[old_elem_idx];
+
+        if (p_element->IsDeleted())
+        {
+            rElementMap.SetDeleted(old_elem_idx);
+            mFluidSourcePool.Free(p_element->GetFluidSource());
+            mElementPool.Free(p_element);
+        }
+        else
+        {
+            unsigned new_elem_idx = live_elements.size();
+            rElementMap.SetNewIndex(old_elem_idx, new_elem_idx);
+
+            if (new_elem_idx != old_elem_idx)
+            {
+                p_element->ResetIndex(new_elem_idx);
+            }
+            if (old_elem_idx == mMembraneIndex)
+            {
+                mMembraneIndex = new_elem_idx;
+            }
+
+            FluidSource<SPACE_DIM>* p_source = p_element->GetFluidSource();
+            if (p_source != NULL)
+            {
+                p_source->SetIndex(live_sources.size());
+                p_source->SetAssociatedElementIndex(new_elem_idx);
+                live_sources.push_back(p_source);
+            }
+
+            live_elements.push_back(p_element);
+        }
+    }
+
+    mElements.swap(live_elements);
+    mElementFluidSources.swap(live_sources);
+
+    // Remove the deleted nodes, and renumber the remaining nodes densely in their existing order
+    std::vector<Node<SPACE_DIM>*> live_nodes;
+    live_nodes.reserve(this->mNodes.size() - mDeletedNodeIndices.size());
+
+    std::vector<unsigned> new_to_old_node_indices;
+    new_to_old_node_indices.reserve(live_nodes.capacity());
+
+    for (unsigned old_node_idx = 0; old_node_idx < this->mNodes.size(); old_node_idx++)
+    {
+        Node<SPACE_DIM>* p_node = this->mNodes[old_node_idx];
+
+        if (p_node->IsDeleted())
+        {
+            mNodePool.Free(p_node);
+        }
+        else
+        {
+            p_node->SetIndex(live_nodes.size());
+            live_nodes.push_back(p_node);
+            new_to_old_node_indices.push_back(old_node_idx);
+        }
+    }
+
+    this->mNodes.swap(live_nodes);
+
+    // Compact the protein levels to match
+    for (unsigned species = 0; species < mNodeProteinLevels.size(); species++)
+    {
+        const std::vector<double>& r_old_levels = mNodeProteinLevels[species];
+        std::vector<double> new_levels(new_to_old_node_indices.size());
+        for (unsigned node_idx = 0; node_idx < new_levels.size(); node_idx++)
+        {
+            new_levels[node_idx] = r_old_levels[new_to_old_node_indices[node_idx]];
+        }
+        mNodeProteinLevels[species].swap(new_levels);
+    }
+
+    mDeletedNodeIndices.clear();
+    mDeletedElementIndices.clear();
+
+    UpdateNodeElementIndices();
+    InvalidateElementGeometries();
+    ClearNeighbourLists();
+    mNumNodeRenumberings++;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetNumNodeRenumberings() const
+{
+    return mNumNodeRenumberings;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::BuildNeighbourList(unsigned numRows,
+                                                                     std::vector<std::pair<unsigned, unsigned> >& rEdges,
+                                                                     std::vector<unsigned>& rOffsets,
+                                                                     std::vector<unsigned>& rIndices)
+{
+    // Sorting the edges groups them by row, with the columns of each row in increasing order
+    std::sort(rEdges.begin(), rEdges.end());
+    rEdges.erase(std::unique(rEdges.begin(), rEdges.end()), rEdges.end());
+
+    rOffsets.assign(numRows + 1, 0u);
+    rIndices.resize(rEdges.size());
+    for (unsigned edge_idx = 0; edge_idx < rEdges.size(); edge_idx++)
+    {
+        rOffsets[rEdges[edge_idx].first + 1]++;
+        rIndices[edge_idx] = rEdges[edge_idx].second;
+    }
+    for (unsigned row = 0; row < numRows; row++)
+    {
+        rOffsets[row + 1] += rOffsets[row];
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::ClearNeighbourLists()
+{
+    mElementNeighbourOffsets.clear();
+    mElementNeighbourIndices.clear();
+    mNodeNeighbourOffsets.clear();
+    mNodeNeighbourIndices.clear();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::UpdateNeighbourLists(const std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> >& rNodePairs)
+{
+    std::vector<std::pair<unsigned, unsigned> > node_edges;
+    node_edges.reserve(2 * rNodePairs.size());
+
+    std::vector<std::pair<unsigned, unsigned> > element_edges;
+
+    for (unsigned pair_idx = 0; pair_idx < rNodePairs.size(); pair_idx++)
+    {
+        unsigned node_a_idx = rNodePairs[pair_idx].first->GetIndex();
+        unsigned node_b_idx = rNodePairs[pair_idx].second->GetIndex();
+
+        node_edges.push_back(std::make_pair(node_a_idx, node_b_idx));
+        node_edges.push_back(std::make_pair(node_b_idx, node_a_idx));
+
+        // Pairs of nodes in the same element, or not in any element, do not make elements neighbours
+        unsigned elem_a_idx = mNodeElementIndices[node_a_idx];
+        unsigned elem_b_idx = mNodeElementIndices[node_b_idx];
+        if (elem_a_idx != elem_b_idx && elem_a_idx != UINT_MAX && elem_b_idx != UINT_MAX)
+        {
+            element_edges.push_back(std::make_pair(elem_a_idx, elem_b_idx));
+            element_edges.push_back(std::make_pair(elem_b_idx, elem_a_idx));
+        }
+    }
+
+    BuildNeighbourList(this->mNodes.size(), node_edges, mNodeNeighbourOffsets, mNodeNeighbourIndices);
+    BuildNeighbourList(mElements.size(), element_edges, mElementNeighbourOffsets, mElementNeighbourIndices);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::set<unsigned> ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetNeighbouringElementIndices(unsigned index) const
+{
+    std::set<unsigned> neighbour_indices;
+
+    if (index + 1 < mElementNeighbourOffsets.size())
+    {
+        neighbour_indices.insert(mElementNeighbourIndices.begin() + mElementNeighbourOffsets[index],
+                                 mElementNeighbourIndices.begin() + mElementNeighbourOffsets[index + 1]);
+    }
+
+    return neighbour_indices;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::set<unsigned> ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>::GetNeighbouringNodeIndices(unsigned index) const
+{
+    std::set<unsigned> neighbour_indices;
+
+    if (index + 1 < mNodeNeighbourOffsets.size())
+    {
+        neighbour_indices.insert(mNodeNeighbourIndices.begin() + mNodeNeighbourOffsets[index],
+                                 mNodeNeighbourIndices.begin() + mNodeNeighbourOffsets[index + 1]);
+    }
+
+    return neighbour_indices;
+}
+
 // Explicit instantiation
 template class ImmersedBoundaryMesh<1,1>;
 template class ImmersedBoundaryMesh<1,2>;
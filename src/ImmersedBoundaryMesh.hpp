@@ -42,6 +42,7 @@ class ImmersedBoundaryMeshWriter;
 
 #include <iostream>
 #include <map>
+#include <set>
 #include <algorithm>
 
 #include "ChasteSerialization.hpp"
@@ -56,6 +57,8 @@ class ImmersedBoundaryMeshWriter;
 #include "ImmersedBoundaryElement.hpp"
 #include "ImmersedBoundaryArray.hpp"
 #include "FluidSource.hpp"
+#include "VertexElementMap.hpp"
+#include "ImmersedBoundaryObjectPool.hpp"
 
 /**
  * An immersed boundary mesh class, in which elements may contain different numbers of nodes.
@@ -68,6 +71,66 @@ class ImmersedBoundaryMesh : public AbstractMesh<ELEMENT_DIM, SPACE_DIM>
 {
     friend class TestImmersedBoundaryMesh;
 
+public:
+
+    /**
+     * The geometry of an element, as stored in the element geometry table.  Each quantity takes the value returned
+     * by the corresponding direct method: GetVolumeOfElement(), GetSurfaceAreaOfElement(), GetCentroidOfElement(),
+     * CalculateMomentsOfElement() and CalculateBoundingBoxOfElement().  As in the latter, the bounding box is found
+     * relative to the first node of the element, so its corners may lie outside the unit square.
+     */
+    struct ElementGeometry
+    {
+        /** The (unsigned) area of the element. */
+        double mArea;
+
+        /** The perimeter of the element. */
+        double mPerimeter;
+
+        /** The current average distance between neighbouring nodes, i.e. the perimeter over the number of nodes. */
+        double mAverageNodeSpacing;
+
+        /** The centroid of the element, which is the zero vector for the membrane element. */
+        c_vector<double, SPACE_DIM> mCentroid;
+
+        /** The moments (I_xx, I_yy, I_xy) of the element about its centroid, which are zero for the membrane element. */
+        c_vector<double, 3> mMoments;
+
+        /** The 'bottom left' corner of the bounding box of the element. */
+        c_vector<double, SPACE_DIM> mBoundingBoxMin;
+
+        /** The 'top right' corner of the bounding box of the element. */
+        c_vector<double, SPACE_DIM> mBoundingBoxMax;
+    };
+
+    /**
+     * The shape metrics of every element, as computed by CalculateShapeMetrics().  Each metric is stored as a column
+     * indexed by element index, so that the storage can be reused from one sample to the next.  All metrics are zero
+     * for the membrane element.
+     */
+    struct ShapeMetrics
+    {
+        /** The elongation shape factor of each element, as given by GetElongationShapeFactorOfElement(). */
+        std::vector<double> mElongationShapeFactors;
+
+        /** The x component of the short axis of each element, as given by GetShortAxisOfElement(). */
+        std::vector<double> mShortAxesX;
+
+        /** The y component of the short axis of each element. */
+        std::vector<double> mShortAxesY;
+
+        /**
+         * The skewness of the distribution of the area of each element perpendicular to its short axis.  This is exact
+         * for any polygon.  GetSkewnessOfElementMassDistributionAboutAxis() instead takes the mass at each node to be
+         * the span between the outermost crossings of the polygon, and interpolates linearly between nodes, so the two
+         * agree for convex elements but differ for concave ones, where that span includes gaps outside the element.
+         */
+        std::vector<double> mAreaSkewnesses;
+
+        /** The tortuosity of the mesh, as given by GetTortuosityOfMesh(). */
+        double mTortuosity;
+    };
+
 protected:
 
     /** Number of grid points in x direction */
@@ -109,6 +172,105 @@ protected:
     /** Vector of fluid sources used to balance those of the elements. */
     std::vector<FluidSource<SPACE_DIM>*> mBalancingFluidSources;
 
+    /**
+     * Storage for the nodes created by the mesh itself, when reading a mesh, dividing elements or adapting node counts.
+     * Nodes passed to the constructor are either created elsewhere with new, or created by a mesh generator in a pool
+     * handed over with AdoptObjectPools(), and Clear() deletes each node accordingly.
+     */
+    ImmersedBoundaryObjectPool<Node<SPACE_DIM> > mNodePool;
+
+    /** Storage for the elements created by the mesh itself, as for #mNodePool. */
+    ImmersedBoundaryObjectPool<ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM> > mElementPool;
+
+    /** Storage for the fluid sources, all of which are created and owned by the mesh. */
+    ImmersedBoundaryObjectPool<FluidSource<SPACE_DIM> > mFluidSourcePool;
+
+    /**
+     * The index of the element containing each node, indexed by node index.  Each node in an immersed boundary mesh
+     * is contained in exactly one element, so this gives a contiguous alternative to querying the containing element
+     * set of each node.  Nodes not yet associated with any element have the value UINT_MAX.
+     */
+    std::vector<unsigned> mNodeElementIndices;
+
+    /**
+     * Recalculate #mNodeElementIndices from scratch, using the current nodes of each element.
+     */
+    void UpdateNodeElementIndices();
+
+    /**
+     * The level of each protein species at each node.  mNodeProteinLevels[s][i] is the level of species s at node i,
+     * so the levels of each species are stored contiguously.  The mesh keeps each column the same length as mNodes.
+     */
+    std::vector<std::vector<double> > mNodeProteinLevels;
+
+    /**
+     * The geometry of each element, indexed by element index.  The table is filled by a single pass over the elements
+     * in UpdateElementGeometries(), and is only read while #mElementGeometriesAreValid is true.
+     */
+    std::vector<ElementGeometry> mElementGeometries;
+
+    /** Whether #mElementGeometries describes the current node locations and topology of the mesh. */
+    bool mElementGeometriesAreValid;
+
+    /**
+     * The number of times the nodes have been renumbered, for example by AdaptNodeCounts() or ReMesh(), or added in
+     * bulk by DivideElementsAlongGivenAxes().  Anything which stores node indices or pointers, such as a list of node
+     * pairs, must be rebuilt when this changes.
+     */
+    unsigned mNumNodeRenumberings;
+
+    /**
+     * The neighbours of each element in compressed sparse row form: the neighbours of element i are the entries of
+     * #mElementNeighbourIndices from mElementNeighbourOffsets[i] up to mElementNeighbourOffsets[i+1], in increasing
+     * order.  Filled by UpdateNeighbourLists(), and emptied whenever the elements are renumbered.
+     */
+    std::vector<unsigned> mElementNeighbourOffsets;
+
+    /** The neighbouring element indices of all elements, indexed by #mElementNeighbourOffsets. */
+    std::vector<unsigned> mElementNeighbourIndices;
+
+    /** The offsets of the neighbours of each node in #mNodeNeighbourIndices, as for #mElementNeighbourOffsets. */
+    std::vector<unsigned> mNodeNeighbourOffsets;
+
+    /** The neighbouring node indices of all nodes, indexed by #mNodeNeighbourOffsets. */
+    std::vector<unsigned> mNodeNeighbourIndices;
+
+    /**
+     * Fill a compressed sparse row adjacency from a list of directed edges, discarding repeated edges.
+     *
+     * @param numRows the number of rows
+     * @param rEdges the edges, each a pair of row indices less than numRows, which are sorted in place
+     * @param rOffsets filled with the numRows + 1 offsets of the rows in rIndices
+     * @param rIndices filled with the column indices of each row, in increasing order
+     */
+    void BuildNeighbourList(unsigned numRows,
+                            std::vector<std::pair<unsigned, unsigned> >& rEdges,
+                            std::vector<unsigned>& rOffsets,
+                            std::vector<unsigned>& rIndices);
+
+    /**
+     * Empty the neighbour lists, which must be done whenever nodes or elements are renumbered.
+     */
+    void ClearNeighbourLists();
+
+    /**
+     * Helper method for GetElongationShapeFactorOfElement() and CalculateShapeMetrics().
+     *
+     * @param rMoments the moments (I_xx, I_yy, I_xy) of an element about its centroid
+     * @return the square root of the ratio of the principal moments
+     */
+    static double CalculateElongationShapeFactorFromMoments(const c_vector<double, 3>& rMoments);
+
+    /**
+     * Helper method for GetShortAxisOfElement() and CalculateShapeMetrics(), which finds the short axis of an element
+     * from its moments.
+     *
+     * @param rMoments the moments (I_xx, I_yy, I_xy) of the element about its centroid
+     * @param rShortAxis filled with the unit short axis, unless the principal moments are equal
+     * @return false if the principal moments are equal, so that every axis is a principal axis
+     */
+    static bool CalculateShortAxisFromMoments(const c_vector<double, 3>& rMoments, c_vector<double, SPACE_DIM>& rShortAxis);
+
     /**
      * Solve node mapping method. This overridden method is required
      * as it is pure virtual in the base class.
@@ -155,12 +317,86 @@ protected:
                            c_vector<double, SPACE_DIM> centroid,
                            c_vector<double, SPACE_DIM> axisOfDivision);
 
+    /**
+     * Find the nodes at which an axis of division through the centroid of an element crosses its boundary.
+     *
+     * @param pElement the element to divide
+     * @param rCentroid the centroid of the element
+     * @param rAxisOfDivision the axis of division
+     * @param rNodeAIndex set to the local index of the node before the first crossing
+     * @param rNodeBIndex set to the local index of the node before the second crossing
+     * @return whether the axis crosses exactly two edges of the element
+     */
+    bool FindDivisionNodes(ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>* pElement,
+                           const c_vector<double, SPACE_DIM>& rCentroid,
+                           const c_vector<double, SPACE_DIM>& rAxisOfDivision,
+                           unsigned& rNodeAIndex,
+                           unsigned& rNodeBIndex);
+
+    /**
+     * Find the node locations of the two daughters of an element, as described in DivideElement().  The mesh is not
+     * modified, so this may be called for several elements at once.
+     *
+     * @param pElement the element to divide
+     * @param nodeAIndex the local index of one node within this element
+     * @param nodeBIndex the local index of another node within this element
+     * @param rCentroid the centroid of the element being divided
+     * @param rAxisOfDivision the specified division axis
+     * @param rDaughterALocations filled with the new locations of the nodes of the element
+     * @param rDaughterBLocations filled with the locations of the nodes of the new element
+     * @return whether the daughters could be spaced far enough apart
+     */
+    bool CalculateDaughterLocations(ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>* pElement,
+                                    unsigned nodeAIndex,
+                                    unsigned nodeBIndex,
+                                    const c_vector<double, SPACE_DIM>& rCentroid,
+                                    const c_vector<double, SPACE_DIM>& rAxisOfDivision,
+                                    std::vector<c_vector<double, SPACE_DIM> >& rDaughterALocations,
+                                    std::vector<c_vector<double, SPACE_DIM> >& rDaughterBLocations);
+
+    /**
+     * Complete the division of an element: move its nodes to the daughter-A locations, and append a new element with
+     * new nodes at the daughter-B locations, copying node and element data across.  The new element is given a fluid
+     * source, but the caller must move both daughters' sources to their centroids and invalidate the element geometry
+     * table.
+     *
+     * @param pElement the element to divide
+     * @param rDaughterALocations the new locations of the nodes of the element
+     * @param rDaughterBLocations the locations of the nodes of the new element
+     * @return the index of the new element
+     */
+    unsigned AddDaughterElement(ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>* pElement,
+                                const std::vector<c_vector<double, SPACE_DIM> >& rDaughterALocations,
+                                const std::vector<c_vector<double, SPACE_DIM> >& rDaughterBLocations);
+
+    /**
+     * Find locations equally spaced by arc length around a closed polygon, the first of which is the first vertex of
+     * the polygon.  Distances are measured using GetVectorFromAtoB(), to allow for periodicity.  This is used to place
+     * the nodes of daughter elements in DivideElement(), and to redistribute nodes in RemeshElements().
+     *
+     * @param rStencil the vertices of the polygon, in order, without the first vertex repeated at the end
+     * @param numLocations the number of locations to find
+     * @param rLocations filled with the locations, which are not mapped back into the unit square
+     */
+    void ResampleLocationsByArcLength(const std::vector<c_vector<double, SPACE_DIM> >& rStencil,
+                                      unsigned numLocations,
+                                      std::vector<c_vector<double, SPACE_DIM> >& rLocations);
+
+    /**
+     * Move the nodes of an element to be equally spaced by arc length around its current boundary.  This does not
+     * invalidate the element geometry table, so that it may be called for different elements in parallel.
+     *
+     * @param index  the global index of a specified immersed boundary element
+     */
+    void RedistributeNodesOfElement(unsigned index);
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
 
     /**
      * Archive the ImmersedBoundaryMesh and its member variables. Note that this will
      * write out an ImmersedBoundaryMeshWriter file to wherever ArchiveLocationInfo has specified.
+     * The protein levels of the nodes are written to the archive itself.
      *
      * @param archive the archive
      * @param version the current version of this class
@@ -175,10 +411,25 @@ protected:
                                                              ArchiveLocationInfo::GetMeshFilename(),
                                                              false);
         mesh_writer.WriteFilesUsingMesh(*(const_cast<ImmersedBoundaryMesh<ELEMENT_DIM, SPACE_DIM>*>(this)));
+
+        // The protein levels are not in the mesh files, so are archived here for the nodes written, in the same order
+        std::vector<std::vector<double> > node_protein_levels(mNodeProteinLevels.size());
+        for (unsigned species = 0; species < mNodeProteinLevels.size(); species++)
+        {
+            for (unsigned node_idx = 0; node_idx < this->mNodes.size(); node_idx++)
+            {
+                if (!this->mNodes[node_idx]->IsDeleted())
+                {
+                    node_protein_levels[species].push_back(mNodeProteinLevels[species][node_idx]);
+                }
+            }
+        }
+        archive & node_protein_levels;
     }
 
     /**
-     * Load a mesh by using ImmersedBoundaryMeshReader and the location in ArchiveLocationInfo.
+     * Load a mesh by using ImmersedBoundaryMeshReader and the location in ArchiveLocationInfo, and then the protein
+     * levels of its nodes from the archive.
      *
      * @param archive the archive
      * @param version the current version of this class
@@ -190,6 +441,12 @@ protected:
 
         ImmersedBoundaryMeshReader<ELEMENT_DIM,SPACE_DIM> mesh_reader(ArchiveLocationInfo::GetArchiveDirectory() + ArchiveLocationInfo::GetMeshFilename());
         this->ConstructFromMeshReader(mesh_reader);
+
+        archive & mNodeProteinLevels;
+        for (unsigned species = 0; species < mNodeProteinLevels.size(); species++)
+        {
+            assert(mNodeProteinLevels[species].size() == this->mNodes.size());
+        }
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
@@ -236,12 +493,23 @@ public:
     virtual ~ImmersedBoundaryMesh();
 
     /**
-     * @return the number of Nodes in the mesh.
+     * Take over the storage of pools in which the nodes and elements passed to the constructor were created, so that
+     * mesh generators can allocate from pools rather than with new.  The mesh's own node and element pools must not
+     * yet hold any objects; on return the given pools are empty.
+     *
+     * @param rNodePool the pool holding the nodes of the mesh
+     * @param rElementPool the pool holding the elements of the mesh
+     */
+    void AdoptObjectPools(ImmersedBoundaryObjectPool<Node<SPACE_DIM> >& rNodePool,
+                          ImmersedBoundaryObjectPool<ImmersedBoundaryElement<ELEMENT_DIM, SPACE_DIM> >& rElementPool);
+
+    /**
+     * @return the number of Nodes in the mesh, excluding those marked as deleted.
      */
     virtual unsigned GetNumNodes() const;
 
     /**
-     * @return the number of ImmersedBoundaryElements in the mesh.
+     * @return the number of ImmersedBoundaryElements in the mesh, excluding those marked as deleted.
      */
     virtual unsigned GetNumElements() const;
 
@@ -315,6 +583,53 @@ public:
      */
     std::vector<Node<SPACE_DIM>*>& rGetNodes();
 
+    /**
+     * @return reference to the vector storing, for each node index, the index of the element containing that node
+     */
+    const std::vector<unsigned>& rGetNodeElementIndices() const;
+
+    /**
+     * @param nodeIndex the global index of a node
+     * @return the index of the element containing the node (UINT_MAX if the node is not in any element)
+     */
+    unsigned GetElementIndexOfNode(unsigned nodeIndex) const;
+
+    /**
+     * Add a protein species, whose level is stored at every node.  The levels at new nodes created by the mesh (for
+     * instance by element division) are copied from the corresponding node of the parent element.
+     *
+     * @param initialLevel the level of the species at every existing node (defaults to 0.0)
+     * @return the index of the new species
+     */
+    unsigned AddProteinSpecies(double initialLevel=0.0);
+
+    /**
+     * @return the number of protein species stored at each node
+     */
+    unsigned GetNumProteinSpecies() const;
+
+    /**
+     * @param speciesIndex the index of a protein species
+     * @return reference to non-modifiable vector of the level of this species at each node, indexed by node index
+     */
+    const std::vector<double>& rGetProteinLevels(unsigned speciesIndex) const;
+
+    /**
+     * @param speciesIndex the index of a protein species
+     * @return reference to modifiable vector of the level of this species at each node, indexed by node index
+     */
+    std::vector<double>& rGetModifiableProteinLevels(unsigned speciesIndex);
+
+    /**
+     * Estimate the memory used by the mesh, in bytes, for each of its main components: the fluid velocity grids, the
+     * nodes, the elements, the fluid sources, the per-node element indices and protein levels, the element
+     * geometry table and the neighbour lists.  Container sizes are counted at their capacity; the bookkeeping overhead
+     * of std::set nodes is estimated.
+     *
+     * @return the number of bytes used by each component, indexed by component name
+     */
+    std::map<std::string, std::size_t> GetMemoryUsage() const;
+
     /**
      * @param the new number of fluid mesh points in the x direction.
      */
@@ -392,7 +707,7 @@ public:
     void ConstructFromMeshReader(AbstractMeshReader<ELEMENT_DIM,SPACE_DIM>& rMeshReader);
 
     /**
-     * Delete mNodes, mFaces and mElements.
+     * Delete mNodes, mElements and the fluid sources, and release the storage in the object pools.
      */
     virtual void Clear();
 
@@ -421,12 +736,45 @@ public:
     /**
      * Compute the average node spacing of an element.
      *
+     * The value is stored on the element, and if recalculate is false the stored value is returned.  It is therefore
+     * the spacing when first requested, which the membrane forces use as a reference length; the current spacing is
+     * available from rGetElementGeometry().
+     *
      * @param index  the global index of a specified immersed boundary element
      * @param recalculate whether or not to recalculate the value
-     * @return the surface area of the element
+     * @return the average node spacing of the element
      */
     double GetAverageNodeSpacingOfElement(unsigned index, bool recalculate=true);
 
+    /**
+     * Recalculate the geometry of every element in a single pass, parallelised over elements, in which the node
+     * ring of each element is walked once.
+     */
+    void UpdateElementGeometries();
+
+    /**
+     * Mark the element geometry table as out of date.  This is done automatically when nodes are moved by SetNode()
+     * and when elements divide, but must be called by any code which moves nodes directly.
+     */
+    void InvalidateElementGeometries();
+
+    /**
+     * @return whether the element geometry table describes the current state of the mesh
+     */
+    bool AreElementGeometriesValid() const;
+
+    /**
+     * Get the geometry of an element from the element geometry table, first recalculating the table for all elements
+     * if it is out of date.  As the table may be recalculated, this must not be called from within a parallel region
+     * unless the table is known to be up to date, which is asserted when OpenMP is enabled.  A force which reads the
+     * table from a parallel sweep should therefore call UpdateElementGeometries() in its serial setup, such as
+     * SetupForcePipelineStep().
+     *
+     * @param index  the global index of a specified immersed boundary element
+     * @return the geometry of the element
+     */
+    const ElementGeometry& rGetElementGeometry(unsigned index);
+
     /**
      * Compute the second moments and product moment of area for a given 2D element
      * about its centroid. These are:
@@ -522,6 +870,34 @@ public:
      */
     c_vector<double, SPACE_DIM> GetShortAxisOfElement(unsigned index);
 
+    /**
+     * Calculate the shape metrics of every element in a single pass, parallelised over elements.  The area, centroid
+     * and moments of each element are taken from the element geometry table, which is first recalculated if it is out
+     * of date, and are shared between the metrics.  The skewness of each element is found about its short axis from
+     * the exact moments of its area distribution, without sorting or allocating memory; see
+     * ShapeMetrics::mAreaSkewnesses for how this differs from GetSkewnessOfElementMassDistributionAboutAxis() for
+     * concave elements.
+     *
+     * As in GetShortAxisOfElement(), an element whose principal moments are equal is given a random short axis.  These
+     * are drawn in element order before the parallel pass, so that the results do not depend on the number of threads.
+     *
+     * This method is only implemented in 2D at present.
+     *
+     * @param rMetrics filled with the shape metrics, with each column resized to the number of elements
+     */
+    void CalculateShapeMetrics(ShapeMetrics& rMetrics);
+
+    /**
+     * Calculate the shape metrics of every element using CalculateShapeMetrics(), and write them to a CSV file with a
+     * header row and one row per element.  The columns are the element index, area, centroid, elongation shape factor,
+     * short axis and area skewness.
+     *
+     * @param rMetrics the storage for the shape metrics, which is filled as in CalculateShapeMetrics()
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     * @param fileName the file name
+     */
+    void WriteShapeMetrics(ShapeMetrics& rMetrics, std::string outputDirectory, std::string fileName);
+
     /**
      * Divide an element along a specified axis.
      *
@@ -550,6 +926,138 @@ public:
     unsigned DivideElementAlongShortAxis(ImmersedBoundaryElement<ELEMENT_DIM,SPACE_DIM>* pElement,
                                          bool placeOriginalElementBelow=false);
 
+    /**
+     * Divide several elements at once, each along a specified axis.  The result is the same as calling
+     * DivideElementAlongGivenAxis() for each element in turn, but the geometric work for all the divisions is done in
+     * parallel, storage for the new nodes, elements and fluid sources is reserved once, and the element geometry table
+     * is invalidated once.  #mNumNodeRenumberings is incremented, so that lists of node pairs are rebuilt to include
+     * the new nodes.
+     *
+     * If any division fails then an exception is thrown before the mesh is modified.
+     *
+     * @param rElementIndices the global indices of the elements to divide, each of which may appear only once
+     * @param rAxesOfDivision the axis along which to divide each element
+     *
+     * @return the indices of the new elements, in the same order as the elements divided
+     */
+    std::vector<unsigned> DivideElementsAlongGivenAxes(const std::vector<unsigned>& rElementIndices,
+                                                       const std::vector<c_vector<double, SPACE_DIM> >& rAxesOfDivision);
+
+    /**
+     * Add a node to the mesh.  The node is not contained in any element, and is given the next free index, so that
+     * node indices remain dense; its protein levels are zero.
+     *
+     * @param pNewNode pointer to the new node, which the mesh takes ownership of
+     * @return the global index of the new node
+     */
+    unsigned AddNode(Node<SPACE_DIM>* pNewNode);
+
+    /**
+     * Mark an element as deleted, along with all of its nodes, and set the strength of its fluid source to zero.  The
+     * element, its nodes and its fluid source are removed by the next call to ReMesh(), which must be made before the
+     * mesh is used in a time step: until then the node and element vectors contain deleted entries.
+     *
+     * @param index  the global index of the element to delete, which may not be the membrane element
+     */
+    void DeleteElementPriorToReMesh(unsigned index);
+
+    /**
+     * Remove a node from the element containing it, if any, and mark it as deleted.  As for
+     * DeleteElementPriorToReMesh(), the node is removed by the next call to ReMesh().
+     *
+     * @param index  the global index of the node to delete, which may not be a corner node or one of only three
+     *     nodes in its element
+     */
+    void DeleteNodePriorToReMesh(unsigned index);
+
+    /**
+     * @return whether any nodes or elements are marked as deleted and awaiting ReMesh()
+     */
+    bool HasDeletedNodesOrElements() const;
+
+    /**
+     * Remove all nodes and elements marked as deleted, with the fluid sources of deleted elements, and renumber the
+     * remaining nodes and elements densely, keeping their order.  Protein levels, the node-to-element indices and
+     * the membrane index are updated to match, and the element fluid sources are renumbered in element order.  If
+     * anything is removed, the element geometry table is invalidated and #mNumNodeRenumberings is incremented.
+     *
+     * @param rElementMap filled with the new index of each old element, or marked deleted for removed elements
+     */
+    void ReMesh(VertexElementMap& rElementMap);
+
+    /**
+     * Measure how unevenly the nodes of an element are spaced around its boundary.
+     *
+     * @param index  the global index of a specified immersed boundary element
+     * @return the ratio of the largest to the smallest distance between neighbouring nodes, which is 1 for uniformly
+     *     spaced nodes, or DBL_MAX if two neighbouring nodes coincide
+     */
+    double GetNodeSpacingNonUniformityOfElement(unsigned index);
+
+    /**
+     * Redistribute the nodes of each element whose node spacing non-uniformity exceeds a threshold, so that they are
+     * equally spaced by arc length around the current boundary of the element.  The first node of each element stays
+     * in place, and each node keeps its attributes, region and protein levels.  The membrane element is not remeshed.
+     *
+     * Elements are remeshed in parallel.
+     *
+     * @param nonUniformityThreshold the threshold, at least 1, above which GetNodeSpacingNonUniformityOfElement()
+     *     triggers remeshing
+     * @return the number of elements remeshed
+     */
+    unsigned RemeshElements(double nonUniformityThreshold);
+
+    /**
+     * Add or remove nodes from each element whose average node spacing differs from a target by more than a given
+     * relative tolerance, so that its spacing is as close as possible to the target.  The nodes of each such element
+     * are placed equally spaced by arc length around its current boundary, and each takes its attributes, region and
+     * protein levels from the old node at the corresponding position.  Corner nodes and the reference node spacing of
+     * the element are updated to match, and its fluid source is moved to its new centroid.  The membrane element is not
+     * changed.
+     *
+     * If any element changes, all nodes are renumbered so that the indices are dense and the nodes of each element are
+     * contiguous, and #mNumNodeRenumberings is incremented.
+     *
+     * @param targetSpacing the target distance between neighbouring nodes
+     * @param tolerance the relative difference between the average and target spacings which is tolerated (defaults
+     *     to 0.25)
+     * @param minNumNodes the fewest nodes an element may have (defaults to 8)
+     * @return the number of elements whose number of nodes changed
+     */
+    unsigned AdaptNodeCounts(double targetSpacing, double tolerance=0.25, unsigned minNumNodes=8);
+
+    /**
+     * @return #mNumNodeRenumberings
+     */
+    unsigned GetNumNodeRenumberings() const;
+
+    /**
+     * Rebuild the neighbour lists of the nodes and elements from a list of node pairs, such as the one found by the
+     * box collection in ImmersedBoundarySimulationModifier.  Two nodes are neighbours if they form a pair, and two
+     * elements are neighbours if any pair has a node in each.  This should be called whenever the pairs change.
+     *
+     * @param rNodePairs the node pairs, each listed once
+     */
+    void UpdateNeighbourLists(const std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> >& rNodePairs);
+
+    /**
+     * Get the neighbours of an element from the lists built by UpdateNeighbourLists().  An element created since
+     * the lists were last built has no neighbours.
+     *
+     * @param index the global index of the element
+     * @return the indices of the neighbouring elements
+     */
+    std::set<unsigned> GetNeighbouringElementIndices(unsigned index) const;
+
+    /**
+     * Get the neighbours of a node from the lists built by UpdateNeighbourLists().  A node created since the lists
+     * were last built has no neighbours.
+     *
+     * @param index the global index of the node
+     * @return the indices of the neighbouring nodes
+     */
+    std::set<unsigned> GetNeighbouringNodeIndices(unsigned index) const;
+
 
     /**
      * @return mElementDivisionSpacing
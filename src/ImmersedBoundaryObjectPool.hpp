@@ -0,0 +1,299 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYOBJECTPOOL_HPP_
+#define IMMERSEDBOUNDARYOBJECTPOOL_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <vector>
+
+/**
+ * A pool of storage for objects of a single type, used by ImmersedBoundaryMesh for the nodes, elements and fluid
+ * sources it creates itself.
+ *
+ * Storage is allocated in blocks, each twice the size of the last, so objects created together are contiguous in
+ * memory and a pool holding n objects has O(log n) blocks.  Objects are constructed in the pool with placement new,
+ *
+ *     Node<2>* p_node = new (pool.Allocate()) Node<2>(index, location, true);
+ *
+ * and destroyed with Free(), which returns their storage to the pool for reuse.  All the storage is released in one
+ * go by Release() or by the destructor, at which point every object in the pool must already have been destroyed.
+ *
+ * Free() also accepts objects which were not allocated from the pool, deleting them with delete, so that a container
+ * may hold a mixture of objects from the pool and objects created elsewhere with new.
+ */
+template<class T>
+class ImmersedBoundaryObjectPool
+{
+private:
+
+    /** The blocks of storage, each able to hold the corresponding entry of #mBlockSizes objects. */
+    std::vector<T*> mBlocks;
+
+    /** The number of objects each block can hold. */
+    std::vector<std::size_t> mBlockSizes;
+
+    /** The number of slots in the last block which have been handed out. */
+    std::size_t mNumSlotsUsedInLastBlock;
+
+    /** The size of the first block to be allocated. */
+    std::size_t mInitialBlockSize;
+
+    /** Slots which held objects that have since been destroyed, and which are reused first. */
+    std::vector<T*> mFreeSlots;
+
+    /** The number of objects currently in the pool. */
+    std::size_t mNumObjects;
+
+    /**
+     * Copying a pool is not allowed, as the objects in it cannot be copied.
+     *
+     * @param rOther the pool to copy
+     */
+    ImmersedBoundaryObjectPool(const ImmersedBoundaryObjectPool<T>& rOther);
+
+    /**
+     * Assigning a pool is not allowed, as the objects in it cannot be copied.
+     *
+     * @param rOther the pool to assign
+     * @return this pool
+     */
+    ImmersedBoundaryObjectPool<T>& operator=(const ImmersedBoundaryObjectPool<T>& rOther);
+
+    /**
+     * Allocate a new block of storage.
+     *
+     * @param blockSize the number of objects the block can hold
+     */
+    void AllocateBlock(std::size_t blockSize)
+    {
+        mBlocks.push_back(static_cast<T*>(::operator new(blockSize * sizeof(T))));
+        mBlockSizes.push_back(blockSize);
+        mNumSlotsUsedInLastBlock = 0;
+    }
+
+public:
+
+    /**
+     * Constructor.  No storage is allocated until it is needed.
+     *
+     * @param initialBlockSize the number of objects the first block of storage can hold (defaults to 256)
+     */
+    ImmersedBoundaryObjectPool(std::size_t initialBlockSize=256)
+        : mNumSlotsUsedInLastBlock(0),
+          mInitialBlockSize(initialBlockSize > 0 ? initialBlockSize : 1),
+          mNumObjects(0)
+    {
+    }
+
+    /**
+     * Destructor.  Releases all the storage in the pool.
+     */
+    ~ImmersedBoundaryObjectPool()
+    {
+        Release();
+    }
+
+    /**
+     * Ensure that at least a given number of further objects can be allocated without allocating more than one new
+     * block, so that, unless storage freed earlier is reused, they will be contiguous in memory.  If a new block is
+     * needed, any unused slots in the current last block are added to the free slots, so they are reused first rather
+     * than abandoned.
+     *
+     * @param numObjects the number of further objects
+     */
+    void Reserve(std::size_t numObjects)
+    {
+        std::size_t num_available = mFreeSlots.size();
+        if (!mBlocks.empty())
+        {
+            num_available += mBlockSizes.back() - mNumSlotsUsedInLastBlock;
+        }
+
+        if (num_available < numObjects)
+        {
+            if (!mBlocks.empty())
+            {
+                // Push the unused slots in reverse, so that Allocate() hands them out in order of address
+                for (std::size_t slot = mBlockSizes.back(); slot > mNumSlotsUsedInLastBlock; slot--)
+                {
+                    mFreeSlots.push_back(mBlocks.back() + slot - 1);
+                }
+            }
+
+            std::size_t block_size = mBlocks.empty() ? mInitialBlockSize : 2 * mBlockSizes.back();
+            AllocateBlock(block_size > numObjects ? block_size : numObjects);
+        }
+    }
+
+    /**
+     * @return uninitialised storage for one object, in which the caller must construct the object with placement new
+     */
+    void* Allocate()
+    {
+        T* p_slot;
+        if (!mFreeSlots.empty())
+        {
+            p_slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+        else
+        {
+            if (mBlocks.empty() || mNumSlotsUsedInLastBlock == mBlockSizes.back())
+            {
+                AllocateBlock(mBlocks.empty() ? mInitialBlockSize : 2 * mBlockSizes.back());
+            }
+            p_slot = mBlocks.back() + mNumSlotsUsedInLastBlock;
+            mNumSlotsUsedInLastBlock++;
+        }
+
+        mNumObjects++;
+        return p_slot;
+    }
+
+    /**
+     * @param pObject pointer to an object
+     * @return whether the object lies in storage belonging to this pool
+     */
+    bool Owns(const T* pObject) const
+    {
+        std::less<const T*> less;
+        for (unsigned block = 0; block < mBlocks.size(); block++)
+        {
+            if (!less(pObject, mBlocks[block]) && less(pObject, mBlocks[block] + mBlockSizes[block]))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Destroy an object.  If it lies in storage belonging to this pool, its destructor is called and the storage is
+     * returned to the pool; otherwise it is assumed to have been created with new, and is deleted.
+     *
+     * @param pObject pointer to the object, which may be NULL
+     */
+    void Free(T* pObject)
+    {
+        if (pObject == NULL)
+        {
+            return;
+        }
+
+        if (Owns(pObject))
+        {
+            pObject->~T();
+            mFreeSlots.push_back(pObject);
+
+            assert(mNumObjects > 0);
+            mNumObjects--;
+        }
+        else
+        {
+            delete pObject;
+        }
+    }
+
+    /**
+     * Release all the storage in the pool.  Every object constructed in the pool must already have been destroyed by
+     * Free(), as their destructors are not called here.
+     */
+    void Release()
+    {
+        assert(mNumObjects == 0);
+
+        for (unsigned block = 0; block < mBlocks.size(); block++)
+        {
+            ::operator delete(mBlocks[block]);
+        }
+        mBlocks.clear();
+        mBlockSizes.clear();
+        mFreeSlots.clear();
+        mNumSlotsUsedInLastBlock = 0;
+        mNumObjects = 0;
+    }
+
+    /**
+     * Exchange the storage, and so the objects, of this pool with those of another.  This allows objects to be
+     * constructed in a pool before the container which is to own them exists, and then handed over to it.
+     *
+     * @param rOther the other pool
+     */
+    void Swap(ImmersedBoundaryObjectPool<T>& rOther)
+    {
+        mBlocks.swap(rOther.mBlocks);
+        mBlockSizes.swap(rOther.mBlockSizes);
+        mFreeSlots.swap(rOther.mFreeSlots);
+        std::swap(mNumSlotsUsedInLastBlock, rOther.mNumSlotsUsedInLastBlock);
+        std::swap(mInitialBlockSize, rOther.mInitialBlockSize);
+        std::swap(mNumObjects, rOther.mNumObjects);
+    }
+
+    /**
+     * @return the number of objects currently in the pool
+     */
+    std::size_t GetNumObjects() const
+    {
+        return mNumObjects;
+    }
+
+    /**
+     * @return the number of blocks of storage allocated
+     */
+    std::size_t GetNumBlocks() const
+    {
+        return mBlocks.size();
+    }
+
+    /**
+     * @return the number of objects the allocated storage can hold
+     */
+    std::size_t GetCapacity() const
+    {
+        std::size_t capacity = 0;
+        for (unsigned block = 0; block < mBlockSizes.size(); block++)
+        {
+            capacity += mBlockSizes[block];
+        }
+        return capacity;
+    }
+};
+
+#endif /*IMMERSEDBOUNDARYOBJECTPOOL_HPP_*/
@@ -0,0 +1,352 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYPAIRPOTENTIALS_HPP_
+#define IMMERSEDBOUNDARYPAIRPOTENTIALS_HPP_
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+/**
+ * The pair laws available for cell-cell adhesion.
+ */
+typedef enum PairLawType_
+{
+    LINEAR_SPRING_LAW,
+    MORSE_POTENTIAL,
+    LENNARD_JONES_POTENTIAL,
+    PIECEWISE_LINEAR_LAW
+} PairLawType;
+
+/*
+ * This file provides a small library of pair laws for use in forces between pairs of nodes.  Each law is a lightweight
+ * class, used as a compile-time policy, whose Evaluate() method returns a dimensional force magnitude g(d) for a pair
+ * of nodes a distance d apart.  A positive magnitude is attractive.  The force on each node is then the product of g(d)
+ * with a spring constant and a unit vector between the nodes.
+ *
+ * Each law vanishes at the rest length.  The linear, Lennard-Jones and piecewise-linear laws are scaled to have unit
+ * slope there, so that a given spring constant means the same stiffness near equilibrium; the Morse law keeps the
+ * scaling historically used by ImmersedBoundaryCellCellInteractionForce, whose slope at the rest length is 2.
+ *
+ * Any law may be converted to a TabulatedPairLaw, which replaces evaluation by linear interpolation in a lookup table
+ * over [0, cutoff].
+ */
+
+/**
+ * Base class for the pair laws, providing batched evaluation over a block of distances.
+ *
+ * The curiously recurring template pattern is used so that the call to Evaluate() in the batch loop is resolved, and
+ * may be inlined, at compile time.
+ */
+template<class LAW>
+class AbstractPairLaw
+{
+public:
+
+    /**
+     * Evaluate the law at each of a block of distances.
+     *
+     * @param pDistances pointer to the first of numDistances distances
+     * @param pMagnitudes pointer to the first of numDistances locations in which to store the results
+     * @param numDistances the number of distances in the block
+     */
+    inline void EvaluateBatch(const double* pDistances, double* pMagnitudes, unsigned numDistances) const
+    {
+        const LAW& r_law = static_cast<const LAW&>(*this);
+
+        for (unsigned i = 0; i < numDistances; i++)
+        {
+            pMagnitudes[i] = r_law.Evaluate(pDistances[i]);
+        }
+    }
+};
+
+/**
+ * A linear spring: g(d) = d - restLength.
+ */
+class LinearSpringPairLaw : public AbstractPairLaw<LinearSpringPairLaw>
+{
+private:
+
+    /** The rest length of the spring. */
+    double mRestLength;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param restLength the rest length of the spring
+     */
+    LinearSpringPairLaw(double restLength)
+        : mRestLength(restLength)
+    {
+    }
+
+    /**
+     * @param distance the distance between the nodes
+     * @return the force magnitude
+     */
+    inline double Evaluate(double distance) const
+    {
+        return distance - mRestLength;
+    }
+};
+
+/**
+ * The force derived from a Morse potential: g(d) = 2 w e (1 - e), where e = exp((restLength - d) / w) and w is the
+ * well width.
+ */
+class MorsePairLaw : public AbstractPairLaw<MorsePairLaw>
+{
+private:
+
+    /** The rest length, at which the potential is minimised. */
+    double mRestLength;
+
+    /** The width of the potential well. */
+    double mWellWidth;
+
+    /** The reciprocal of #mWellWidth. */
+    double mInverseWellWidth;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param restLength the rest length
+     * @param wellWidth the width of the potential well
+     */
+    MorsePairLaw(double restLength, double wellWidth)
+        : mRestLength(restLength),
+          mWellWidth(wellWidth),
+          mInverseWellWidth(1.0 / wellWidth)
+    {
+    }
+
+    /**
+     * @param distance the distance between the nodes
+     * @return the force magnitude
+     */
+    inline double Evaluate(double distance) const
+    {
+        double morse_exp = exp((mRestLength - distance) * mInverseWellWidth);
+        return 2.0 * mWellWidth * morse_exp * (1.0 - morse_exp);
+    }
+};
+
+/**
+ * The force derived from a 12-6 Lennard-Jones potential whose minimum lies at the rest length, scaled to unit
+ * stiffness at the minimum:
+ *
+ *   g(d) = (restLength^2 / 3d) ((s/d)^6 - 2 (s/d)^12),  where s = restLength / 2^(1/6).
+ *
+ * To avoid the singularity as d tends to zero, the magnitude is held constant below a core distance of half the rest
+ * length.
+ */
+class LennardJonesPairLaw : public AbstractPairLaw<LennardJonesPairLaw>
+{
+private:
+
+    /** The characteristic length s of the potential. */
+    double mSigma;
+
+    /** The prefactor restLength^2 / 3. */
+    double mPrefactor;
+
+    /** The distance below which the magnitude is held constant. */
+    double mCoreDistance;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param restLength the rest length, at which the potential is minimised
+     */
+    LennardJonesPairLaw(double restLength)
+        : mSigma(restLength * pow(2.0, -1.0 / 6.0)),
+          mPrefactor(restLength * restLength / 3.0),
+          mCoreDistance(0.5 * restLength)
+    {
+    }
+
+    /**
+     * @param distance the distance between the nodes
+     * @return the force magnitude
+     */
+    inline double Evaluate(double distance) const
+    {
+        double dist = std::max(distance, mCoreDistance);
+        double ratio = mSigma / dist;
+        double ratio_6 = ratio * ratio * ratio;
+        ratio_6 *= ratio_6;
+
+        return mPrefactor * ratio_6 * (1.0 - 2.0 * ratio_6) / dist;
+    }
+};
+
+/**
+ * A piecewise-linear law: linear with unit slope up to the midpoint between the rest length and the cutoff, then
+ * decreasing linearly to zero at the cutoff, so that the force is continuous as pairs leave the interaction distance.
+ */
+class PiecewiseLinearPairLaw : public AbstractPairLaw<PiecewiseLinearPairLaw>
+{
+private:
+
+    /** The rest length. */
+    double mRestLength;
+
+    /** The distance at which the attractive force peaks. */
+    double mPeakDistance;
+
+    /** The distance beyond which the force is zero. */
+    double mCutoff;
+
+    /** The gradient of the decreasing part of the law. */
+    double mDecaySlope;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param restLength the rest length
+     * @param cutoff the distance beyond which the force is zero; must exceed restLength
+     */
+    PiecewiseLinearPairLaw(double restLength, double cutoff)
+        : mRestLength(restLength),
+          mPeakDistance(0.5 * (restLength + cutoff)),
+          mCutoff(cutoff)
+    {
+        assert(cutoff > restLength);
+        mDecaySlope = (mPeakDistance - mRestLength) / (mCutoff - mPeakDistance);
+    }
+
+    /**
+     * @param distance the distance between the nodes
+     * @return the force magnitude
+     */
+    inline double Evaluate(double distance) const
+    {
+        if (distance < mPeakDistance)
+        {
+            return distance - mRestLength;
+        }
+        return std::max(0.0, mDecaySlope * (mCutoff - distance));
+    }
+};
+
+/**
+ * A pair law evaluated by linear interpolation in a lookup table of another law, sampled at equally spaced distances
+ * over [0, cutoff].  Distances beyond the cutoff take the value at the cutoff.
+ */
+class TabulatedPairLaw : public AbstractPairLaw<TabulatedPairLaw>
+{
+private:
+
+    /** The sampled magnitudes, at distances i * cutoff / num_intervals. */
+    std::vector<double> mTable;
+
+    /** The number of intervals in the table, as a double. */
+    double mMaxIndex;
+
+    /** The reciprocal of the spacing between table entries. */
+    double mInverseSpacing;
+
+public:
+
+    /**
+     * Default constructor, creating an empty table.  Tabulate() must be called before use.
+     */
+    TabulatedPairLaw()
+        : mMaxIndex(0.0),
+          mInverseSpacing(0.0)
+    {
+    }
+
+    /**
+     * Fill the table by sampling a given law.
+     *
+     * @param rLaw the law to tabulate
+     * @param cutoff the largest distance in the table
+     * @param numIntervals the number of intervals into which [0, cutoff] is divided
+     */
+    template<class LAW>
+    void Tabulate(const LAW& rLaw, double cutoff, unsigned numIntervals)
+    {
+        assert(cutoff > 0.0);
+        assert(numIntervals > 0);
+
+        std::vector<double> distances(numIntervals + 1);
+        for (unsigned i = 0; i <= numIntervals; i++)
+        {
+            distances[i] = cutoff * (double)i / (double)numIntervals;
+        }
+
+        mTable.resize(numIntervals + 1);
+        rLaw.EvaluateBatch(&distances[0], &mTable[0], numIntervals + 1);
+
+        mMaxIndex = (double)numIntervals;
+        mInverseSpacing = (double)numIntervals / cutoff;
+    }
+
+    /**
+     * @return whether Tabulate() has been called
+     */
+    bool IsTabulated() const
+    {
+        return !mTable.empty();
+    }
+
+    /**
+     * @param distance the distance between the nodes
+     * @return the linearly interpolated force magnitude
+     */
+    inline double Evaluate(double distance) const
+    {
+        // Clamp to the final interval, so that the interpolation is always between two table entries
+        double position = std::min(distance * mInverseSpacing, mMaxIndex);
+        unsigned lower = std::min((unsigned)position, (unsigned)mMaxIndex - 1);
+        double interpolant = position - (double)lower;
+
+        return mTable[lower] + interpolant * (mTable[lower + 1] - mTable[lower]);
+    }
+};
+
+#endif /*IMMERSEDBOUNDARYPAIRPOTENTIALS_HPP_*/
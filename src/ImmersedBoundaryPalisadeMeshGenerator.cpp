@@ -147,6 +147,10 @@ ImmersedBoundaryPalisadeMeshGenerator::ImmersedBoundaryPalisadeMeshGenerator(uns
     std::vector<ImmersedBoundaryElement<2,2>*> ib_elements;
     std::vector<Node<2>*> nodes;
 
+    // Nodes and elements are created in pools which are handed over to the mesh, so each is contiguous in memory
+    ImmersedBoundaryObjectPool<Node<2> > node_pool;
+    ImmersedBoundaryObjectPool<ImmersedBoundaryElement<2,2> > element_pool;
+
     // Helper c_vector for offsets in x and y
     c_vector<double, 2> x_offset = x_unit * cell_width;
     c_vector<double, 2> y_offset = y_unit * (1.0 - cell_height) / 2.0;
@@ -162,18 +166,19 @@ ImmersedBoundaryPalisadeMeshGenerator::ImmersedBoundaryPalisadeMeshGenerator(uns
 
         std::vector<Node<2>*> nodes_this_elem;
 
+        node_pool.Reserve(num_membrane_nodes);
         for (unsigned mem_node_idx = 0; mem_node_idx < num_membrane_nodes; mem_node_idx++)
         {
             // Calculate location of node
             c_vector<double, 2> location = 0.97 * y_offset + ( 0.5 / num_membrane_nodes + double(mem_node_idx) / num_membrane_nodes ) * x_unit;
 
             // Create the new node
-            nodes.push_back(new Node<2>(mem_node_idx, location, true));
+            nodes.push_back(new (node_pool.Allocate()) Node<2>(mem_node_idx, location, true));
             nodes_this_elem.push_back(nodes.back());
         }
 
         // Create the membrane element
-        ib_elements.push_back(new ImmersedBoundaryElement<2,2>(0, nodes_this_elem));
+        ib_elements.push_back(new (element_pool.Allocate()) ImmersedBoundaryElement<2,2>(0, nodes_this_elem));
 
         // Pass in null corners
         std::vector<Node<2>*>& r_elem_corners = ib_elements.back()->rGetCornerNodes();
@@ -185,6 +190,9 @@ ImmersedBoundaryPalisadeMeshGenerator::ImmersedBoundaryPalisadeMeshGenerator(uns
 
     RandomNumberGenerator* p_rand_gen = RandomNumberGenerator::Instance();
 
+    node_pool.Reserve(mNumCellsWide * locations.size());
+    element_pool.Reserve(mNumCellsWide);
+
     for (unsigned cell_idx = 0; cell_idx < mNumCellsWide; cell_idx++)
     {
         std::vector<Node<2>*> nodes_this_elem;
@@ -199,11 +207,11 @@ ImmersedBoundaryPalisadeMeshGenerator::ImmersedBoundaryPalisadeMeshGenerator(uns
             scaled_location[1] *= (1.0 + temp_rand * mRandomYMult);
             scaled_location[1] += y_offset[1];
 
-            nodes.push_back(new Node<2>(node_index, scaled_location, true));
+            nodes.push_back(new (node_pool.Allocate()) Node<2>(node_index, scaled_location, true));
             nodes_this_elem.push_back(nodes.back());
         }
 
-        ib_elements.push_back(new ImmersedBoundaryElement<2,2>(ib_elements.size(), nodes_this_elem));
+        ib_elements.push_back(new (element_pool.Allocate()) ImmersedBoundaryElement<2,2>(ib_elements.size(), nodes_this_elem));
 
         // Pass in the correct corners
         std::vector<Node<2>*>& r_elem_corners = ib_elements.back()->rGetCornerNodes();
@@ -222,6 +230,7 @@ ImmersedBoundaryPalisadeMeshGenerator::ImmersedBoundaryPalisadeMeshGenerator(uns
     {
         mpMesh = new ImmersedBoundaryMesh<2,2>(nodes, ib_elements, 256, 256);
     }
+    mpMesh->AdoptObjectPools(node_pool, element_pool);
 }
 
 ImmersedBoundaryPalisadeMeshGenerator::~ImmersedBoundaryPalisadeMeshGenerator()
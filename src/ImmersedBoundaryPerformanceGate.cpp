@@ -0,0 +1,341 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ImmersedBoundaryPerformanceGate.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <boost/property_tree/json_parser.hpp>
+
+/** The factor relating the MAD to the standard deviation of normally distributed data. */
+static const double MAD_TO_STANDARD_DEVIATION = 1.4826;
+
+ImmersedBoundaryPerformanceGate::ImmersedBoundaryPerformanceGate()
+    : mRelativeThreshold(0.2),
+      mNumMads(3.0)
+{
+}
+
+double ImmersedBoundaryPerformanceGate::CalculateMedian(std::vector<double> values)
+{
+    if (values.empty())
+    {
+        EXCEPTION("Cannot calculate the median of no values.");
+    }
+
+    unsigned mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double median = values[mid];
+
+    // For an even number of values, average the two middle values
+    if (values.size() % 2 == 0)
+    {
+        median = 0.5 * (median + *std::max_element(values.begin(), values.begin() + mid));
+    }
+    return median;
+}
+
+double ImmersedBoundaryPerformanceGate::CalculateMedianAbsoluteDeviation(const std::vector<double>& rValues)
+{
+    double median = CalculateMedian(rValues);
+
+    std::vector<double> deviations(rValues.size());
+    for (unsigned i = 0; i < rValues.size(); i++)
+    {
+        deviations[i] = fabs(rValues[i] - median);
+    }
+    return CalculateMedian(deviations);
+}
+
+void ImmersedBoundaryPerformanceGate::SetRelativeThreshold(double relativeThreshold)
+{
+    if (relativeThreshold < 0.0)
+    {
+        EXCEPTION("The relative threshold must be non-negative.");
+    }
+    mRelativeThreshold = relativeThreshold;
+}
+
+double ImmersedBoundaryPerformanceGate::GetRelativeThreshold() const
+{
+    return mRelativeThreshold;
+}
+
+void ImmersedBoundaryPerformanceGate::SetNumMads(double numMads)
+{
+    if (numMads < 0.0)
+    {
+        EXCEPTION("The number of MADs must be non-negative.");
+    }
+    mNumMads = numMads;
+}
+
+double ImmersedBoundaryPerformanceGate::GetNumMads() const
+{
+    return mNumMads;
+}
+
+void ImmersedBoundaryPerformanceGate::AddSample(const std::string& rSetup, const std::string& rPhase, double time)
+{
+    mSamples[rSetup][rPhase].push_back(time);
+}
+
+void ImmersedBoundaryPerformanceGate::AddBaseline(const std::string& rSetup, const std::string& rPhase, double median, double mad)
+{
+    mBaseline[rSetup][rPhase] = std::make_pair(median, mad);
+}
+
+void ImmersedBoundaryPerformanceGate::LoadBaseline(const std::string& rFileName)
+{
+    boost::property_tree::ptree root;
+    try
+    {
+        boost::property_tree::read_json(rFileName, root);
+    }
+    catch (boost::property_tree::json_parser_error& e)
+    {
+        EXCEPTION("Could not read the performance baseline " << rFileName << ": " << e.what());
+    }
+
+    boost::property_tree::ptree empty_tree;
+    const boost::property_tree::ptree& r_setups = root.get_child("Setups", empty_tree);
+
+    for (boost::property_tree::ptree::const_iterator setup_iter = r_setups.begin();
+         setup_iter != r_setups.end();
+         ++setup_iter)
+    {
+        for (boost::property_tree::ptree::const_iterator phase_iter = setup_iter->second.begin();
+             phase_iter != setup_iter->second.end();
+             ++phase_iter)
+        {
+            AddBaseline(setup_iter->first,
+                        phase_iter->first,
+                        phase_iter->second.get<double>("Median"),
+                        phase_iter->second.get<double>("Mad", 0.0));
+        }
+    }
+}
+
+std::vector<ImmersedBoundaryPerformanceGate::PhaseComparison> ImmersedBoundaryPerformanceGate::Compare() const
+{
+    std::vector<PhaseComparison> comparisons;
+
+    for (std::map<std::string, std::map<std::string, std::vector<double> > >::const_iterator setup_iter = mSamples.begin();
+         setup_iter != mSamples.end();
+         ++setup_iter)
+    {
+        for (std::map<std::string, std::vector<double> >::const_iterator phase_iter = setup_iter->second.begin();
+             phase_iter != setup_iter->second.end();
+             ++phase_iter)
+        {
+            PhaseComparison comparison;
+            comparison.mSetup = setup_iter->first;
+            comparison.mPhase = phase_iter->first;
+            comparison.mBaselineMedian = -1.0;
+            comparison.mCurrentMedian = CalculateMedian(phase_iter->second);
+            comparison.mNoise = MAD_TO_STANDARD_DEVIATION * mNumMads * CalculateMedianAbsoluteDeviation(phase_iter->second);
+            comparison.mRegressed = false;
+
+            std::map<std::string, std::map<std::string, std::pair<double, double> > >::const_iterator baseline_setup_iter = mBaseline.find(setup_iter->first);
+            if (baseline_setup_iter != mBaseline.end())
+            {
+                std::map<std::string, std::pair<double, double> >::const_iterator baseline_iter = baseline_setup_iter->second.find(phase_iter->first);
+                if (baseline_iter != baseline_setup_iter->second.end())
+                {
+                    comparison.mBaselineMedian = baseline_iter->second.first;
+                    comparison.mNoise = std::max(comparison.mNoise, MAD_TO_STANDARD_DEVIATION * mNumMads * baseline_iter->second.second);
+
+                    // A regression must be both relatively large and larger than the noise
+                    double increase = comparison.mCurrentMedian - comparison.mBaselineMedian;
+                    comparison.mRegressed = increase > mRelativeThreshold * comparison.mBaselineMedian &&
+                                            increase > comparison.mNoise;
+                }
+            }
+
+            comparisons.push_back(comparison);
+        }
+    }
+
+    return comparisons;
+}
+
+unsigned ImmersedBoundaryPerformanceGate::GetNumRegressions() const
+{
+    std::vector<PhaseComparison> comparisons = Compare();
+
+    unsigned num_regressions = 0;
+    for (unsigned i = 0; i < comparisons.size(); i++)
+    {
+        if (comparisons[i].mRegressed)
+        {
+            num_regressions++;
+        }
+    }
+    return num_regressions;
+}
+
+unsigned ImmersedBoundaryPerformanceGate::GetNumPhasesMissingFromBaseline() const
+{
+    std::vector<PhaseComparison> comparisons = Compare();
+
+    unsigned num_missing = 0;
+    for (unsigned i = 0; i < comparisons.size(); i++)
+    {
+        if (comparisons[i].mBaselineMedian < 0.0)
+        {
+            num_missing++;
+        }
+    }
+    return num_missing;
+}
+
+std::vector<std::string> ImmersedBoundaryPerformanceGate::GetUnmeasuredBaselinePhases() const
+{
+    std::vector<std::string> unmeasured_phases;
+
+    for (std::map<std::string, std::map<std::string, std::pair<double, double> > >::const_iterator setup_iter = mBaseline.begin();
+         setup_iter != mBaseline.end();
+         ++setup_iter)
+    {
+        std::map<std::string, std::map<std::string, std::vector<double> > >::const_iterator samples_setup_iter = mSamples.find(setup_iter->first);
+
+        for (std::map<std::string, std::pair<double, double> >::const_iterator phase_iter = setup_iter->second.begin();
+             phase_iter != setup_iter->second.end();
+             ++phase_iter)
+        {
+            if (samples_setup_iter == mSamples.end() ||
+                samples_setup_iter->second.find(phase_iter->first) == samples_setup_iter->second.end())
+            {
+                unmeasured_phases.push_back(setup_iter->first + "/" + phase_iter->first);
+            }
+        }
+    }
+
+    return unmeasured_phases;
+}
+
+void ImmersedBoundaryPerformanceGate::WriteResults(const std::string& rFileName) const
+{
+    boost::property_tree::ptree setups;
+
+    for (std::map<std::string, std::map<std::string, std::vector<double> > >::const_iterator setup_iter = mSamples.begin();
+         setup_iter != mSamples.end();
+         ++setup_iter)
+    {
+        boost::property_tree::ptree phases;
+        for (std::map<std::string, std::vector<double> >::const_iterator phase_iter = setup_iter->second.begin();
+             phase_iter != setup_iter->second.end();
+             ++phase_iter)
+        {
+            boost::property_tree::ptree phase;
+            phase.put("Median", CalculateMedian(phase_iter->second));
+            phase.put("Mad", CalculateMedianAbsoluteDeviation(phase_iter->second));
+            phase.put("NumSamples", phase_iter->second.size());
+            phases.add_child(boost::property_tree::ptree::path_type(phase_iter->first, '/'), phase);
+        }
+        setups.add_child(boost::property_tree::ptree::path_type(setup_iter->first, '/'), phases);
+    }
+
+    boost::property_tree::ptree root;
+    root.add_child("Setups", setups);
+    boost::property_tree::write_json(rFileName, root);
+}
+
+void ImmersedBoundaryPerformanceGate::WriteReport(const std::string& rFileName) const
+{
+    std::vector<PhaseComparison> comparisons = Compare();
+
+    std::ofstream report(rFileName.c_str());
+    if (!report.is_open())
+    {
+        EXCEPTION("Could not open the performance report " << rFileName << " for writing.");
+    }
+
+    report << "Performance comparison with baseline: a phase regresses if its median grows by more than "
+           << 100.0 * mRelativeThreshold << "% and by more than " << mNumMads << " scaled MADs\n\n";
+
+    report << std::left << std::setw(32) << "Setup" << std::setw(32) << "Phase"
+           << std::right << std::setw(14) << "Baseline (s)" << std::setw(14) << "Current (s)" << std::setw(10) << "Change"
+           << "  Status\n";
+
+    std::string previous_setup;
+    for (unsigned i = 0; i < comparisons.size(); i++)
+    {
+        const PhaseComparison& r_comparison = comparisons[i];
+
+        // Only name each setup on its first line, so the report reads as one block per setup
+        report << std::left << std::setw(32) << (r_comparison.mSetup == previous_setup ? "" : r_comparison.mSetup)
+               << std::setw(32) << r_comparison.mPhase << std::right << std::scientific << std::setprecision(3);
+        previous_setup = r_comparison.mSetup;
+
+        if (r_comparison.mBaselineMedian < 0.0)
+        {
+            report << std::setw(14) << "-" << std::setw(14) << r_comparison.mCurrentMedian << std::setw(10) << "-"
+                   << "  NEW\n";
+            continue;
+        }
+
+        double change = r_comparison.mBaselineMedian > 0.0 ? r_comparison.mCurrentMedian / r_comparison.mBaselineMedian - 1.0 : 0.0;
+        double decrease = r_comparison.mBaselineMedian - r_comparison.mCurrentMedian;
+
+        std::string status = "ok";
+        if (r_comparison.mRegressed)
+        {
+            status = "REGRESSED";
+        }
+        else if (decrease > mRelativeThreshold * r_comparison.mBaselineMedian && decrease > r_comparison.mNoise)
+        {
+            status = "improved";
+        }
+
+        report << std::setw(14) << r_comparison.mBaselineMedian << std::setw(14) << r_comparison.mCurrentMedian
+               << std::setw(9) << std::fixed << std::setprecision(1) << std::showpos << 100.0 * change << "%"
+               << std::noshowpos << "  " << status << "\n";
+    }
+
+    std::vector<std::string> unmeasured_phases = GetUnmeasuredBaselinePhases();
+    for (unsigned i = 0; i < unmeasured_phases.size(); i++)
+    {
+        report << std::left << std::setw(64) << unmeasured_phases[i] << "  NOT RUN\n";
+    }
+
+    report << "\n" << GetNumRegressions() << " regression(s) found\n";
+    report << GetNumPhasesMissingFromBaseline() << " phase(s) missing from the baseline\n";
+    report << unmeasured_phases.size() << " baseline phase(s) not run\n";
+    report.close();
+}
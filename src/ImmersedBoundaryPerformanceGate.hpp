@@ -0,0 +1,207 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYPERFORMANCEGATE_HPP_
+#define IMMERSEDBOUNDARYPERFORMANCEGATE_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/property_tree/ptree.hpp>
+
+/**
+ * Compares repeated timings of the phases of standard benchmark setups with a stored baseline, to catch performance
+ * regressions.
+ *
+ * Timings are summarised by their median and median absolute deviation (MAD), which are insensitive to the odd slow
+ * run.  A phase is flagged as regressed only if its median has grown by more than a relative threshold over the
+ * baseline median, and the growth is also larger than a multiple of the noise, taken as the larger of the current
+ * and baseline MADs scaled to estimate a standard deviation.
+ *
+ * Baselines are stored as JSON, with a child of "Setups" for each setup name, a child of that for each phase, and
+ * "Median" and "Mad" values for each phase.  WriteResults() writes the current timings in the same format, so a new
+ * baseline can be produced by copying its output.
+ */
+class ImmersedBoundaryPerformanceGate
+{
+public:
+
+    /** The outcome of comparing one phase of one setup with the baseline. */
+    struct PhaseComparison
+    {
+        /** The setup name. */
+        std::string mSetup;
+
+        /** The phase name. */
+        std::string mPhase;
+
+        /** The baseline median, or a negative value if the phase is not in the baseline. */
+        double mBaselineMedian;
+
+        /** The current median. */
+        double mCurrentMedian;
+
+        /** The noise threshold the change in median was compared with. */
+        double mNoise;
+
+        /** Whether the phase has regressed. */
+        bool mRegressed;
+    };
+
+private:
+
+    /** The timing samples of each phase of each setup, indexed by setup name then phase name. */
+    std::map<std::string, std::map<std::string, std::vector<double> > > mSamples;
+
+    /** The baseline median and MAD of each phase of each setup, indexed by setup name then phase name. */
+    std::map<std::string, std::map<std::string, std::pair<double, double> > > mBaseline;
+
+    /** The fractional increase in median over the baseline above which a phase may be flagged.  Defaults to 0.2. */
+    double mRelativeThreshold;
+
+    /** The number of scaled MADs by which the median must increase for a phase to be flagged.  Defaults to 3. */
+    double mNumMads;
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    ImmersedBoundaryPerformanceGate();
+
+    /**
+     * @param values the values, which must not be empty
+     * @return the median of the values
+     */
+    static double CalculateMedian(std::vector<double> values);
+
+    /**
+     * @param rValues the values, which must not be empty
+     * @return the median absolute deviation of the values from their median
+     */
+    static double CalculateMedianAbsoluteDeviation(const std::vector<double>& rValues);
+
+    /**
+     * Set #mRelativeThreshold.
+     *
+     * @param relativeThreshold the fractional increase in median above which a phase may be flagged
+     */
+    void SetRelativeThreshold(double relativeThreshold);
+
+    /**
+     * @return #mRelativeThreshold
+     */
+    double GetRelativeThreshold() const;
+
+    /**
+     * Set #mNumMads.
+     *
+     * @param numMads the number of scaled MADs by which the median must increase for a phase to be flagged
+     */
+    void SetNumMads(double numMads);
+
+    /**
+     * @return #mNumMads
+     */
+    double GetNumMads() const;
+
+    /**
+     * Add a timing sample, usually from one repeat of a benchmark.
+     *
+     * @param rSetup the setup name
+     * @param rPhase the phase name
+     * @param time the wall time
+     */
+    void AddSample(const std::string& rSetup, const std::string& rPhase, double time);
+
+    /**
+     * Add a baseline median and MAD for one phase of one setup, replacing any existing value.
+     *
+     * @param rSetup the setup name
+     * @param rPhase the phase name
+     * @param median the baseline median
+     * @param mad the baseline MAD
+     */
+    void AddBaseline(const std::string& rSetup, const std::string& rPhase, double median, double mad);
+
+    /**
+     * Read baseline medians and MADs from a JSON file, in the format written by WriteResults().
+     *
+     * @param rFileName the absolute path of the file
+     */
+    void LoadBaseline(const std::string& rFileName);
+
+    /**
+     * Compare each phase of each setup with the baseline.
+     *
+     * @return one comparison for each phase with at least one sample, ordered by setup then phase
+     */
+    std::vector<PhaseComparison> Compare() const;
+
+    /**
+     * @return the number of phases flagged as regressed by Compare()
+     */
+    unsigned GetNumRegressions() const;
+
+    /**
+     * @return the number of phases with samples but no baseline, which cannot be checked for regressions
+     */
+    unsigned GetNumPhasesMissingFromBaseline() const;
+
+    /**
+     * @return the names, as "setup/phase", of the phases in the baseline with no samples, for example because a setup
+     *     was not run or a phase was renamed
+     */
+    std::vector<std::string> GetUnmeasuredBaselinePhases() const;
+
+    /**
+     * Write the current medians and MADs as JSON, in the baseline format.
+     *
+     * @param rFileName the absolute path of the file
+     */
+    void WriteResults(const std::string& rFileName) const;
+
+    /**
+     * Write a human-readable report listing, for each phase of each setup, the baseline and current medians, the
+     * relative change and whether the phase is new, within noise, improved or regressed.  Baseline phases with no
+     * samples are listed after these, and the numbers of new and unmeasured phases are given with the number of
+     * regressions.
+     *
+     * @param rFileName the absolute path of the file
+     */
+    void WriteReport(const std::string& rFileName) const;
+};
+
+#endif /*IMMERSEDBOUNDARYPERFORMANCEGATE_HPP_*/
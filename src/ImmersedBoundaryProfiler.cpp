@@ -0,0 +1,479 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ImmersedBoundaryProfiler.hpp"
+#include "CsvWriter.hpp"
+#include "Exception.hpp"
+#include "ImmersedBoundaryTraceRecorder.hpp"
+#include "Timer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+ImmersedBoundaryProfiler* ImmersedBoundaryProfiler::mpInstance = NULL;
+
+const unsigned ImmersedBoundaryProfiler::CACHE_LINE_SIZE;
+
+ImmersedBoundaryProfiler::ImmersedBoundaryProfiler()
+    : mEnabled(false),
+      mNumGridPoints(0),
+      mMaxNumStoredSamples(4096),
+      mReservoirRandomState(0)
+{
+}
+
+ImmersedBoundaryProfiler* ImmersedBoundaryProfiler::Instance()
+{
+    if (mpInstance == NULL)
+    {
+        mpInstance = new ImmersedBoundaryProfiler();
+    }
+    return mpInstance;
+}
+
+void ImmersedBoundaryProfiler::Destroy()
+{
+    if (mpInstance)
+    {
+        delete mpInstance;
+        mpInstance = NULL;
+    }
+}
+
+void ImmersedBoundaryProfiler::Enable()
+{
+    mEnabled = true;
+}
+
+void ImmersedBoundaryProfiler::Disable()
+{
+    mEnabled = false;
+}
+
+bool ImmersedBoundaryProfiler::IsEnabled() const
+{
+    return mEnabled;
+}
+
+void ImmersedBoundaryProfiler::Reset()
+{
+    mPhases.clear();
+    mPhaseNames.clear();
+    mReservoirRandomState = 0;
+}
+
+ImmersedBoundaryProfiler::PhaseData& ImmersedBoundaryProfiler::rGetOrCreatePhaseData(const std::string& rPhase)
+{
+    std::map<std::string, PhaseData>::iterator iter = mPhases.find(rPhase);
+    if (iter == mPhases.end())
+    {
+        PhaseData new_phase;
+        new_phase.mStartTime = -1.0;
+        new_phase.mNumSamples = 0;
+        new_phase.mMean = 0.0;
+        new_phase.mSumSquaredDifferences = 0.0;
+        new_phase.mTotal = 0.0;
+        new_phase.mMin = 0.0;
+        new_phase.mMax = 0.0;
+        new_phase.mNumCounterSamples = 0;
+        new_phase.mCounterTotals.resize(ImmersedBoundaryHardwareCounters::NUM_COUNTERS, 0.0);
+
+        iter = mPhases.insert(std::make_pair(rPhase, new_phase)).first;
+        mPhaseNames.push_back(rPhase);
+    }
+    return iter->second;
+}
+
+void ImmersedBoundaryProfiler::BeginPhase(const char* pPhase)
+{
+    ImmersedBoundaryTraceRecorder::Instance()->BeginEvent(pPhase);
+
+    if (!mEnabled)
+    {
+        return;
+    }
+
+    PhaseData& r_phase = rGetOrCreatePhaseData(pPhase);
+
+    if (!mHardwareCounters.Read(r_phase.mCounterStarts))
+    {
+        r_phase.mCounterStarts.clear();
+    }
+
+    // Take the time last, so that the look-up above is not included in the sample
+    r_phase.mStartTime = Timer::GetWallTime();
+}
+
+void ImmersedBoundaryProfiler::EndPhase(const char* pPhase)
+{
+    if (mEnabled)
+    {
+        // Take the time and counters first, so that the look-up below is not included in the sample
+        double end_time = Timer::GetWallTime();
+        std::vector<double> counter_ends;
+        bool have_counters = mHardwareCounters.Read(counter_ends);
+
+        std::map<std::string, PhaseData>::iterator iter = mPhases.find(pPhase);
+        if (iter != mPhases.end() && iter->second.mStartTime >= 0.0)
+        {
+            PhaseData& r_phase = iter->second;
+            double start_time = r_phase.mStartTime;
+            r_phase.mStartTime = -1.0;
+
+            if (have_counters && r_phase.mCounterStarts.size() == counter_ends.size())
+            {
+                r_phase.mNumCounterSamples++;
+                for (unsigned counter_idx = 0; counter_idx < counter_ends.size(); counter_idx++)
+                {
+                    r_phase.mCounterTotals[counter_idx] += counter_ends[counter_idx] - r_phase.mCounterStarts[counter_idx];
+                }
+            }
+            r_phase.mCounterStarts.clear();
+
+            AddSample(iter->first, end_time - start_time);
+        }
+    }
+
+    ImmersedBoundaryTraceRecorder::Instance()->EndEvent(pPhase);
+}
+
+void ImmersedBoundaryProfiler::AddSample(const std::string& rPhase, double sample)
+{
+    PhaseData& r_phase = rGetOrCreatePhaseData(rPhase);
+
+    // Welford's update of the running mean and sum of squared differences
+    r_phase.mNumSamples++;
+    double delta = sample - r_phase.mMean;
+    r_phase.mMean += delta / double(r_phase.mNumSamples);
+    r_phase.mSumSquaredDifferences += delta * (sample - r_phase.mMean);
+
+    r_phase.mTotal += sample;
+
+    if (r_phase.mNumSamples == 1)
+    {
+        r_phase.mMin = sample;
+        r_phase.mMax = sample;
+    }
+    else
+    {
+        r_phase.mMin = std::min(r_phase.mMin, sample);
+        r_phase.mMax = std::max(r_phase.mMax, sample);
+    }
+
+    // Reservoir sampling: once the store is full, the nth sample replaces a random stored sample with probability m/n
+    if (r_phase.mStoredSamples.size() < mMaxNumStoredSamples)
+    {
+        r_phase.mStoredSamples.push_back(sample);
+    }
+    else
+    {
+        mReservoirRandomState = 1664525u * mReservoirRandomState + 1013904223u;
+        // Scale the state rather than taking a remainder, as the low bits of the generator are the least random
+        unsigned idx = unsigned(double(mReservoirRandomState) / 4294967296.0 * double(r_phase.mNumSamples));
+        if (idx < r_phase.mStoredSamples.size())
+        {
+            r_phase.mStoredSamples[idx] = sample;
+        }
+    }
+}
+
+const ImmersedBoundaryProfiler::PhaseData& ImmersedBoundaryProfiler::rGetPhaseData(const std::string& rPhase) const
+{
+    std::map<std::string, PhaseData>::const_iterator iter = mPhases.find(rPhase);
+    if (iter == mPhases.end() || iter->second.mNumSamples == 0)
+    {
+        EXCEPTION("No samples have been recorded for the phase " << rPhase << ".");
+    }
+    return iter->second;
+}
+
+std::vector<std::string> ImmersedBoundaryProfiler::GetPhaseNames() const
+{
+    std::vector<std::string> phase_names;
+    for (unsigned i = 0; i < mPhaseNames.size(); i++)
+    {
+        if (GetNumSamples(mPhaseNames[i]) > 0)
+        {
+            phase_names.push_back(mPhaseNames[i]);
+        }
+    }
+    return phase_names;
+}
+
+unsigned ImmersedBoundaryProfiler::GetNumSamples(const std::string& rPhase) const
+{
+    std::map<std::string, PhaseData>::const_iterator iter = mPhases.find(rPhase);
+    return iter == mPhases.end() ? 0 : iter->second.mNumSamples;
+}
+
+double ImmersedBoundaryProfiler::GetTotalTime(const std::string& rPhase) const
+{
+    return rGetPhaseData(rPhase).mTotal;
+}
+
+double ImmersedBoundaryProfiler::GetMean(const std::string& rPhase) const
+{
+    return rGetPhaseData(rPhase).mMean;
+}
+
+double ImmersedBoundaryProfiler::GetVariance(const std::string& rPhase) const
+{
+    const PhaseData& r_phase = rGetPhaseData(rPhase);
+    if (r_phase.mNumSamples < 2)
+    {
+        return 0.0;
+    }
+    return r_phase.mSumSquaredDifferences / double(r_phase.mNumSamples - 1);
+}
+
+double ImmersedBoundaryProfiler::GetPercentile(const std::string& rPhase, double percentile) const
+{
+    if (percentile < 0.0 || percentile > 100.0)
+    {
+        EXCEPTION("The percentile must be between 0 and 100.");
+    }
+
+    const PhaseData& r_phase = rGetPhaseData(rPhase);
+
+    std::vector<double> sorted_samples = r_phase.mStoredSamples;
+    std::sort(sorted_samples.begin(), sorted_samples.end());
+    return GetPercentileOfSortedSamples(r_phase, sorted_samples, percentile);
+}
+
+double ImmersedBoundaryProfiler::GetPercentileOfSortedSamples(const PhaseData& rPhase,
+                                                              const std::vector<double>& rSortedSamples,
+                                                              double percentile)
+{
+    // The extremes are tracked exactly, even if they are no longer stored
+    if (percentile == 0.0)
+    {
+        return rPhase.mMin;
+    }
+    if (percentile == 100.0)
+    {
+        return rPhase.mMax;
+    }
+
+    // Nearest rank: the sample at position ceil(p n / 100) in sorted order, counting from one
+    unsigned rank = unsigned(ceil(percentile * double(rSortedSamples.size()) / 100.0));
+    unsigned idx = rank == 0 ? 0 : rank - 1;
+    return rSortedSamples[idx];
+}
+
+void ImmersedBoundaryProfiler::SetMaxNumStoredSamples(unsigned maxNumStoredSamples)
+{
+    if (maxNumStoredSamples == 0)
+    {
+        EXCEPTION("At least one sample must be stored for each phase.");
+    }
+    mMaxNumStoredSamples = maxNumStoredSamples;
+}
+
+unsigned ImmersedBoundaryProfiler::GetMaxNumStoredSamples() const
+{
+    return mMaxNumStoredSamples;
+}
+
+void ImmersedBoundaryProfiler::WriteSummary(std::string outputDirectory, std::string fileName) const
+{
+    std::vector<std::string> phase_names = GetPhaseNames();
+    if (phase_names.empty())
+    {
+        EXCEPTION("No phases have been profiled.");
+    }
+
+    std::vector<unsigned> num_samples;
+    std::vector<double> totals;
+    std::vector<double> means;
+    std::vector<double> std_devs;
+    std::vector<double> minima;
+    std::vector<double> medians;
+    std::vector<double> percentiles_90;
+    std::vector<double> percentiles_99;
+    std::vector<double> maxima;
+
+    // Hardware counter columns are only added if some phase has counts
+    bool have_counters = false;
+    for (unsigned i = 0; i < phase_names.size(); i++)
+    {
+        have_counters = have_counters || (GetNumCounterSamples(phase_names[i]) > 0);
+    }
+    std::vector<std::vector<double> > counter_means(ImmersedBoundaryHardwareCounters::NUM_COUNTERS);
+    std::vector<double> instructions_per_cycle;
+    std::vector<double> bytes_per_grid_point;
+
+    std::vector<double> sorted_samples;
+    for (unsigned i = 0; i < phase_names.size(); i++)
+    {
+        const std::string& r_phase = phase_names[i];
+        num_samples.push_back(GetNumSamples(r_phase));
+        totals.push_back(GetTotalTime(r_phase));
+        means.push_back(GetMean(r_phase));
+        std_devs.push_back(sqrt(GetVariance(r_phase)));
+
+        // Sort the stored samples once for all the percentiles of this phase
+        const PhaseData& r_phase_data = rGetPhaseData(r_phase);
+        sorted_samples.assign(r_phase_data.mStoredSamples.begin(), r_phase_data.mStoredSamples.end());
+        std::sort(sorted_samples.begin(), sorted_samples.end());
+
+        minima.push_back(GetPercentileOfSortedSamples(r_phase_data, sorted_samples, 0.0));
+        medians.push_back(GetPercentileOfSortedSamples(r_phase_data, sorted_samples, 50.0));
+        percentiles_90.push_back(GetPercentileOfSortedSamples(r_phase_data, sorted_samples, 90.0));
+        percentiles_99.push_back(GetPercentileOfSortedSamples(r_phase_data, sorted_samples, 99.0));
+        maxima.push_back(GetPercentileOfSortedSamples(r_phase_data, sorted_samples, 100.0));
+
+        if (have_counters)
+        {
+            bool phase_has_counters = GetNumCounterSamples(r_phase) > 0;
+            for (unsigned counter_idx = 0; counter_idx < ImmersedBoundaryHardwareCounters::NUM_COUNTERS; counter_idx++)
+            {
+                counter_means[counter_idx].push_back(phase_has_counters ? GetMeanCounterValue(r_phase, counter_idx) : 0.0);
+            }
+            instructions_per_cycle.push_back(phase_has_counters ? GetInstructionsPerCycle(r_phase) : 0.0);
+            bytes_per_grid_point.push_back(phase_has_counters && mNumGridPoints > 0 ? GetBytesPerGridPoint(r_phase) : 0.0);
+        }
+    }
+
+    // The writer outputs unsigned data, then doubles, then strings
+    std::vector<std::string> headers;
+    headers.push_back("NumSamples");
+    headers.push_back("TotalTime");
+    headers.push_back("MeanTime");
+    headers.push_back("StdDevTime");
+    headers.push_back("MinTime");
+    headers.push_back("MedianTime");
+    headers.push_back("P90Time");
+    headers.push_back("P99Time");
+    headers.push_back("MaxTime");
+    if (have_counters)
+    {
+        for (unsigned counter_idx = 0; counter_idx < ImmersedBoundaryHardwareCounters::NUM_COUNTERS; counter_idx++)
+        {
+            headers.push_back("Mean" + ImmersedBoundaryHardwareCounters::GetCounterName(counter_idx));
+        }
+        headers.push_back("InstructionsPerCycle");
+        headers.push_back("BytesPerGridPoint");
+    }
+    headers.push_back("Phase");
+
+    CsvWriter writer;
+    writer.SetDirectoryName(outputDirectory);
+    writer.SetFileName(fileName);
+    writer.AddHeaders(headers);
+    writer.AddData(num_samples);
+    writer.AddData(totals);
+    writer.AddData(means);
+    writer.AddData(std_devs);
+    writer.AddData(minima);
+    writer.AddData(medians);
+    writer.AddData(percentiles_90);
+    writer.AddData(percentiles_99);
+    writer.AddData(maxima);
+    if (have_counters)
+    {
+        for (unsigned counter_idx = 0; counter_idx < ImmersedBoundaryHardwareCounters::NUM_COUNTERS; counter_idx++)
+        {
+            writer.AddData(counter_means[counter_idx]);
+        }
+        writer.AddData(instructions_per_cycle);
+        writer.AddData(bytes_per_grid_point);
+    }
+    writer.AddData(phase_names);
+    writer.WriteDataToFile();
+}
+
+bool ImmersedBoundaryProfiler::EnableHardwareCounters()
+{
+    return mHardwareCounters.Open();
+}
+
+void ImmersedBoundaryProfiler::DisableHardwareCounters()
+{
+    mHardwareCounters.Close();
+}
+
+bool ImmersedBoundaryProfiler::AreHardwareCountersEnabled() const
+{
+    return mHardwareCounters.IsOpen();
+}
+
+void ImmersedBoundaryProfiler::SetNumGridPoints(unsigned numGridPoints)
+{
+    mNumGridPoints = numGridPoints;
+}
+
+unsigned ImmersedBoundaryProfiler::GetNumGridPoints() const
+{
+    return mNumGridPoints;
+}
+
+unsigned ImmersedBoundaryProfiler::GetNumCounterSamples(const std::string& rPhase) const
+{
+    std::map<std::string, PhaseData>::const_iterator iter = mPhases.find(rPhase);
+    return iter == mPhases.end() ? 0 : iter->second.mNumCounterSamples;
+}
+
+double ImmersedBoundaryProfiler::GetMeanCounterValue(const std::string& rPhase, unsigned counterIndex) const
+{
+    if (counterIndex >= ImmersedBoundaryHardwareCounters::NUM_COUNTERS)
+    {
+        EXCEPTION("There is no hardware counter with index " << counterIndex << ".");
+    }
+
+    const PhaseData& r_phase = rGetPhaseData(rPhase);
+    if (r_phase.mNumCounterSamples == 0)
+    {
+        EXCEPTION("No hardware counters have been recorded for the phase " << rPhase << ".");
+    }
+    return r_phase.mCounterTotals[counterIndex] / double(r_phase.mNumCounterSamples);
+}
+
+double ImmersedBoundaryProfiler::GetInstructionsPerCycle(const std::string& rPhase) const
+{
+    double cycles = GetMeanCounterValue(rPhase, ImmersedBoundaryHardwareCounters::CYCLES);
+    double instructions = GetMeanCounterValue(rPhase, ImmersedBoundaryHardwareCounters::INSTRUCTIONS);
+    return cycles > 0.0 ? instructions / cycles : 0.0;
+}
+
+double ImmersedBoundaryProfiler::GetBytesPerGridPoint(const std::string& rPhase) const
+{
+    if (mNumGridPoints == 0)
+    {
+        EXCEPTION("The number of grid points has not been set.");
+    }
+
+    double cache_misses = GetMeanCounterValue(rPhase, ImmersedBoundaryHardwareCounters::CACHE_MISSES);
+    return cache_misses * double(CACHE_LINE_SIZE) / double(mNumGridPoints);
+}
@@ -0,0 +1,343 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYPROFILER_HPP_
+#define IMMERSEDBOUNDARYPROFILER_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ImmersedBoundaryHardwareCounters.hpp"
+
+/**
+ * A singleton which records the wall time spent in each phase of an immersed boundary simulation time step, such as
+ * the force evaluation or the forward FFT.  Each call to EndPhase() adds one sample to the phase, and for each phase
+ * the profiler maintains the number, total, minimum and maximum of the samples and a running mean and variance, using
+ * Welford's algorithm.  Percentiles are computed from a uniform random sample of at most #mMaxNumStoredSamples
+ * samples, kept by reservoir sampling, so that memory use does not grow with the length of a simulation.  They are
+ * exact until more samples than this have been added, and estimates afterwards.
+ *
+ * The profiler is disabled by default, in which case BeginPhase() and EndPhase() record nothing.  Phase boundaries
+ * are also passed on to ImmersedBoundaryTraceRecorder, so that they appear in a trace if it is enabled.  Phases must
+ * only be timed from serial code.
+ *
+ * Optionally, hardware performance counters can also be recorded around each phase, using
+ * ImmersedBoundaryHardwareCounters, from which the instructions per cycle and the memory traffic per fluid grid point
+ * are derived.  If the counters are unavailable, only wall times are recorded.
+ */
+class ImmersedBoundaryProfiler
+{
+private:
+
+    /** Timing statistics for a single phase. */
+    struct PhaseData
+    {
+        /** The wall time at which the phase was last begun, or a negative value if the phase is not running. */
+        double mStartTime;
+
+        /** The number of samples. */
+        unsigned mNumSamples;
+
+        /** The running mean of the samples. */
+        double mMean;
+
+        /** The running sum of squared differences from the mean. */
+        double mSumSquaredDifferences;
+
+        /** The sum of the samples. */
+        double mTotal;
+
+        /** The smallest sample. */
+        double mMin;
+
+        /** The largest sample. */
+        double mMax;
+
+        /** A uniform random sample of at most #mMaxNumStoredSamples of the samples, used to find percentiles. */
+        std::vector<double> mStoredSamples;
+
+        /** The hardware counter values at which the phase was last begun, or empty if they were not read. */
+        std::vector<double> mCounterStarts;
+
+        /** The number of samples for which hardware counters were recorded. */
+        unsigned mNumCounterSamples;
+
+        /** The sum over samples of each hardware counter, indexed as in ImmersedBoundaryHardwareCounters. */
+        std::vector<double> mCounterTotals;
+    };
+
+    /** A pointer to the singleton instance of this class. */
+    static ImmersedBoundaryProfiler* mpInstance;
+
+    /** Whether phases are currently being timed. */
+    bool mEnabled;
+
+    /** The timing statistics for each phase, indexed by phase name. */
+    std::map<std::string, PhaseData> mPhases;
+
+    /** The phase names in the order in which they were first begun. */
+    std::vector<std::string> mPhaseNames;
+
+    /** The hardware counters read at the start and end of each phase, if they are enabled. */
+    ImmersedBoundaryHardwareCounters mHardwareCounters;
+
+    /** The number of fluid grid points, used to normalise the memory traffic of each phase. */
+    unsigned mNumGridPoints;
+
+    /** The largest number of samples stored for each phase to compute percentiles.  Defaults to 4096. */
+    unsigned mMaxNumStoredSamples;
+
+    /**
+     * The state of the linear congruential generator used for reservoir sampling.  A generator of the profiler's own
+     * is used so that profiling does not change the random numbers drawn by a simulation.
+     */
+    unsigned mReservoirRandomState;
+
+    /**
+     * Default constructor.  Use Instance() to access the profiler.
+     */
+    ImmersedBoundaryProfiler();
+
+    /**
+     * Helper method to find the data for a phase, throwing if no samples have been recorded for it.
+     *
+     * @param rPhase the phase name
+     * @return the data for the phase
+     */
+    const PhaseData& rGetPhaseData(const std::string& rPhase) const;
+
+    /**
+     * Helper method to find the data for a phase, adding the phase if it has not been seen before.
+     *
+     * @param rPhase the phase name
+     * @return the data for the phase
+     */
+    PhaseData& rGetOrCreatePhaseData(const std::string& rPhase);
+
+    /**
+     * Helper method for GetPercentile() and WriteSummary(), which finds a percentile of a phase from its stored
+     * samples once they have been sorted.
+     *
+     * @param rPhase the data for the phase
+     * @param rSortedSamples the stored samples of the phase, in ascending order
+     * @param percentile the percentile, between 0 and 100
+     * @return the percentile
+     */
+    static double GetPercentileOfSortedSamples(const PhaseData& rPhase,
+                                               const std::vector<double>& rSortedSamples,
+                                               double percentile);
+
+public:
+
+    /**
+     * @return a pointer to the single instance of the profiler, creating it if necessary
+     */
+    static ImmersedBoundaryProfiler* Instance();
+
+    /**
+     * Destroy the single instance of the profiler.
+     */
+    static void Destroy();
+
+    /**
+     * Start timing phases.
+     */
+    void Enable();
+
+    /**
+     * Stop timing phases.  Statistics already recorded are kept.
+     */
+    void Disable();
+
+    /**
+     * @return #mEnabled
+     */
+    bool IsEnabled() const;
+
+    /**
+     * Discard all statistics recorded so far.
+     */
+    void Reset();
+
+    /**
+     * Record the start of a phase.  Does nothing if both the profiler and the trace recorder are disabled.
+     *
+     * @param pPhase the phase name
+     */
+    void BeginPhase(const char* pPhase);
+
+    /**
+     * Record the end of a phase, adding the time since the matching call to BeginPhase() as a new sample.  Does
+     * not add a sample if the profiler is disabled or the phase is not running.
+     *
+     * @param pPhase the phase name
+     */
+    void EndPhase(const char* pPhase);
+
+    /**
+     * Add a sample to a phase directly, for example a duration measured elsewhere.  Unlike EndPhase(), this records
+     * the sample even if the profiler is disabled.
+     *
+     * @param rPhase the phase name
+     * @param sample the wall time of the sample
+     */
+    void AddSample(const std::string& rPhase, double sample);
+
+    /**
+     * @return the names of all phases with at least one sample, in the order in which they were first begun
+     */
+    std::vector<std::string> GetPhaseNames() const;
+
+    /**
+     * @param rPhase the phase name
+     * @return the number of samples recorded for the phase, which is zero for an unknown phase
+     */
+    unsigned GetNumSamples(const std::string& rPhase) const;
+
+    /**
+     * @param rPhase the phase name
+     * @return the total wall time recorded for the phase
+     */
+    double GetTotalTime(const std::string& rPhase) const;
+
+    /**
+     * @param rPhase the phase name
+     * @return the mean wall time of the phase
+     */
+    double GetMean(const std::string& rPhase) const;
+
+    /**
+     * @param rPhase the phase name
+     * @return the sample variance of the wall time of the phase, which is zero if there is only one sample
+     */
+    double GetVariance(const std::string& rPhase) const;
+
+    /**
+     * Get a percentile of the wall time of a phase, using the nearest-rank method on the stored samples.  The 0th and
+     * 100th percentiles are always the exact minimum and maximum.
+     *
+     * @param rPhase the phase name
+     * @param percentile the percentile, between 0 and 100
+     * @return the smallest stored sample such that at least the given percentage of stored samples are no greater
+     *     than it
+     */
+    double GetPercentile(const std::string& rPhase, double percentile) const;
+
+    /**
+     * Set #mMaxNumStoredSamples.  Samples already stored beyond the new limit are kept until the next Reset().
+     *
+     * @param maxNumStoredSamples the largest number of samples stored for each phase, which must be positive
+     */
+    void SetMaxNumStoredSamples(unsigned maxNumStoredSamples);
+
+    /**
+     * @return #mMaxNumStoredSamples
+     */
+    unsigned GetMaxNumStoredSamples() const;
+
+    /**
+     * Write a summary of all phases to a CSV file, with one row per phase giving the number of samples, the total,
+     * mean and standard deviation of the wall time, and its minimum, median, 90th and 99th percentiles and maximum.
+     * If hardware counters were recorded, the mean of each counter, the instructions per cycle and the bytes per grid
+     * point are also given, with zero for phases without counts.
+     *
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     * @param fileName the file name (defaults to profile.csv)
+     */
+    void WriteSummary(std::string outputDirectory, std::string fileName="profile.csv") const;
+
+    /** The assumed size in bytes of the cache line transferred from memory on each last-level cache miss. */
+    static const unsigned CACHE_LINE_SIZE = 64;
+
+    /**
+     * Start recording hardware counters around each phase, if they are available.
+     *
+     * @return whether the hardware counters are available
+     */
+    bool EnableHardwareCounters();
+
+    /**
+     * Stop recording hardware counters.  Counts already recorded are kept.
+     */
+    void DisableHardwareCounters();
+
+    /**
+     * @return whether hardware counters are being recorded
+     */
+    bool AreHardwareCountersEnabled() const;
+
+    /**
+     * Set the number of fluid grid points, used by GetBytesPerGridPoint().
+     *
+     * @param numGridPoints the number of grid points
+     */
+    void SetNumGridPoints(unsigned numGridPoints);
+
+    /**
+     * @return #mNumGridPoints
+     */
+    unsigned GetNumGridPoints() const;
+
+    /**
+     * @param rPhase the phase name
+     * @return the number of samples of the phase for which hardware counters were recorded
+     */
+    unsigned GetNumCounterSamples(const std::string& rPhase) const;
+
+    /**
+     * @param rPhase the phase name
+     * @param counterIndex the index of the counter, as in ImmersedBoundaryHardwareCounters
+     * @return the mean value of the counter over the samples of the phase for which counters were recorded
+     */
+    double GetMeanCounterValue(const std::string& rPhase, unsigned counterIndex) const;
+
+    /**
+     * @param rPhase the phase name
+     * @return the ratio of instructions to CPU cycles in the phase
+     */
+    double GetInstructionsPerCycle(const std::string& rPhase) const;
+
+    /**
+     * Estimate the memory traffic of a phase per fluid grid point, assuming that each last-level cache miss
+     * transfers one cache line of CACHE_LINE_SIZE bytes.  Write-backs and hardware prefetches are not counted.
+     *
+     * @param rPhase the phase name
+     * @return the mean number of bytes read from memory per grid point in each sample of the phase
+     */
+    double GetBytesPerGridPoint(const std::string& rPhase) const;
+};
+
+#endif /*IMMERSEDBOUNDARYPROFILER_HPP_*/
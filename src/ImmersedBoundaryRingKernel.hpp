@@ -0,0 +1,140 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYRINGKERNEL_HPP_
+#define IMMERSEDBOUNDARYRINGKERNEL_HPP_
+
+#include <cmath>
+
+/*
+ * This file provides the inner loop of ImmersedBoundaryMembraneElasticityForce, operating on contiguous arrays of
+ * node coordinates rather than on Node objects.  Coordinates and forces are stored interleaved, so that the location
+ * of point i is (pLocations[DIM*i], ..., pLocations[DIM*i + DIM-1]).
+ *
+ * The domain is assumed, as in ImmersedBoundaryMesh::GetVectorFromAtoB(), to be precisely the periodic unit square.
+ */
+
+/**
+ * Static helper methods for evaluating linear spring forces around a chain of consecutive nodes in a ring.
+ */
+template<unsigned DIM>
+class ImmersedBoundaryRingKernel
+{
+public:
+
+    /**
+     * Map a component of a displacement in the periodic unit domain to its minimum image, in [-0.5, 0.5].
+     *
+     * This agrees with ImmersedBoundaryMesh::GetVectorFromAtoB() but has no data-dependent branch, so may be
+     * vectorised.
+     *
+     * @param displacement the component of the displacement
+     * @return the component of the minimum image displacement
+     */
+    static inline double MinimumImage(double displacement)
+    {
+        return displacement - floor(displacement + 0.5);
+    }
+
+    /**
+     * Calculate the net linear spring force on each node in a chain of consecutive nodes.
+     *
+     * Each node in the chain is joined by springs to its predecessor and its successor, so pLocations must hold the
+     * numChainNodes nodes of the chain together with one halo node either side: numChainNodes + 2 points in all.  A
+     * whole ring of n nodes is the chain with pLocations holding node n-1, nodes 0 to n-1, and node 0, in that order.
+     *
+     * The force exerted by node i on node i+1 is computed once per spring, and the difference of consecutive spring
+     * forces is written directly, so the net force is obtained in a single pass.
+     *
+     * @param pLocations the numChainNodes + 2 interleaved node locations
+     * @param numChainNodes the number of nodes on which to calculate the force
+     * @param springConstant the spring constant
+     * @param restLength the spring rest length
+     * @param pForces on return, the numChainNodes interleaved forces, which are overwritten
+     */
+    static void CalculateChainForces(const double* pLocations,
+                                     unsigned numChainNodes,
+                                     double springConstant,
+                                     double restLength,
+                                     double* pForces)
+    {
+        // The force exerted on the first chain node by the halo node before it
+        double prev_force[DIM];
+        CalculateSpringForce(pLocations, springConstant, restLength, prev_force);
+
+        for (unsigned node_idx = 0; node_idx < numChainNodes; node_idx++)
+        {
+            double next_force[DIM];
+            CalculateSpringForce(pLocations + DIM * (node_idx + 1), springConstant, restLength, next_force);
+
+            for (unsigned dim = 0; dim < DIM; dim++)
+            {
+                pForces[DIM * node_idx + dim] = next_force[dim] - prev_force[dim];
+                prev_force[dim] = next_force[dim];
+            }
+        }
+    }
+
+    /**
+     * Calculate the Hooke's law force exerted by one node on the next.
+     *
+     * @param pLocations pointer to the location of the first node, immediately followed by that of the second
+     * @param springConstant the spring constant
+     * @param restLength the spring rest length
+     * @param pForce on return, the force on the second node
+     */
+    static inline void CalculateSpringForce(const double* pLocations,
+                                            double springConstant,
+                                            double restLength,
+                                            double* pForce)
+    {
+        double normed_dist_squared = 0.0;
+        for (unsigned dim = 0; dim < DIM; dim++)
+        {
+            pForce[dim] = MinimumImage(pLocations[DIM + dim] - pLocations[dim]);
+            normed_dist_squared += pForce[dim] * pForce[dim];
+        }
+
+        double normed_dist = sqrt(normed_dist_squared);
+        double scale = springConstant * (normed_dist - restLength) / normed_dist;
+
+        for (unsigned dim = 0; dim < DIM; dim++)
+        {
+            pForce[dim] *= scale;
+        }
+    }
+};
+
+#endif /*IMMERSEDBOUNDARYRINGKERNEL_HPP_*/
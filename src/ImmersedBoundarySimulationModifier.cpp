@@ -38,11 +38,28 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //#include "Exception.hpp"
 //#include "Warnings.hpp"
 //#include <complex>
-//#include "Timer.hpp"
 //#include "FileFinder.hpp"
 //#include <fftw3.h>
 //#include <boost/thread.hpp>
 #include "FluidSource.hpp"
+#include "CsvWriter.hpp"
+#include "OutputFileHandler.hpp"
+#include "Warnings.hpp"
+#include "Timer.hpp"
+#include "ImmersedBoundaryProfiler.hpp"
+#include "ImmersedBoundaryTraceRecorder.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 
 template<unsigned DIM>
 ImmersedBoundarySimulationModifier<DIM>::ImmersedBoundarySimulationModifier()
@@ -50,6 +67,10 @@ ImmersedBoundarySimulationModifier<DIM>::ImmersedBoundarySimulationModifier()
       mpMesh(NULL),
       mpCellPopulation(NULL),
       mNodeNeighbourUpdateFrequency(1u),
+      mRemeshingFrequency(0u),
+      mRemeshingThreshold(2.0),
+      mTargetNodeSpacingFraction(0.0),
+      mNumNodeRenumberingsAtLastNodePairUpdate(0u),
       mNumGridPtsX(0u),
       mNumGridPtsY(0u),
       mGridSpacingX(0.0),
@@ -58,6 +79,15 @@ ImmersedBoundarySimulationModifier<DIM>::ImmersedBoundarySimulationModifier()
       mpBoxCollection(NULL),
       mReynoldsNumber(1e-4),
       mI(0.0, 1.0),
+      mUseForcePipeline(false),
+      mForceInstrumentationEnabled(false),
+      mOutputDirectory(""),
+      mProfilingEnabled(false),
+      mHardwareCountersEnabled(false),
+      mTracingEnabled(false),
+      mHealthMonitoringEnabled(false),
+      mMemoryReportingEnabled(false),
+      mNumElementsAtLastMemoryReport(0u),
       mpArrays(NULL),
       mpFftInterface(NULL)
 {
@@ -83,47 +113,168 @@ ImmersedBoundarySimulationModifier<DIM>::~ImmersedBoundarySimulationModifier()
 template<unsigned DIM>
 void ImmersedBoundarySimulationModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
-    // We need to update node neighbours occasionally, but not necessarily each timestep
-    if (SimulationTime::Instance()->GetTimeStepsElapsed() % mNodeNeighbourUpdateFrequency == 0)
+    ImmersedBoundaryProfiler::Instance()->BeginPhase("UpdateAtEndOfTimeStep");
+
+    // Nodes bunch up along stretched boundaries, so we occasionally redistribute them before finding neighbours
+    if (mRemeshingFrequency > 0 && SimulationTime::Instance()->GetTimeStepsElapsed() % mRemeshingFrequency == 0)
+    {
+        // Adapt the number of nodes in each element to its perimeter, so the Lagrangian work follows the total perimeter
+        if (mTargetNodeSpacingFraction > 0.0)
+        {
+            ImmersedBoundaryProfiler::Instance()->BeginPhase("AdaptNodeCounts");
+            mpMesh->AdaptNodeCounts(mTargetNodeSpacingFraction * mGridSpacingX);
+            ImmersedBoundaryProfiler::Instance()->EndPhase("AdaptNodeCounts");
+        }
+
+        ImmersedBoundaryProfiler::Instance()->BeginPhase("RemeshElements");
+        mpMesh->RemeshElements(mRemeshingThreshold);
+        ImmersedBoundaryProfiler::Instance()->EndPhase("RemeshElements");
+    }
+
+    /*
+     * We need to update node neighbours occasionally, but not necessarily each timestep.  If the nodes have been
+     * renumbered, however, the node pairs refer to nodes which may no longer exist and must be recalculated now.
+     */
+    if (SimulationTime::Instance()->GetTimeStepsElapsed() % mNodeNeighbourUpdateFrequency == 0 ||
+        mpMesh->GetNumNodeRenumberings() != mNumNodeRenumberingsAtLastNodePairUpdate)
     {
+        ImmersedBoundaryProfiler::Instance()->BeginPhase("CalculateNodePairs");
         mpBoxCollection->CalculateNodePairs(mpMesh->rGetNodes(), mNodePairs);
+        mpMesh->UpdateNeighbourLists(mNodePairs);
+        mNumNodeRenumberingsAtLastNodePairUpdate = mpMesh->GetNumNodeRenumberings();
+        ImmersedBoundaryProfiler::Instance()->EndPhase("CalculateNodePairs");
     }
 
     // This will solve the fluid problem for all timesteps after the first, which is handled in SetupSolve()
     this->UpdateFluidVelocityGrids(rCellPopulation);
+
+    if (mHealthMonitoringEnabled)
+    {
+        this->RecordHealthCounters();
+    }
+
+    // Cell division and removal change the size of the mesh, so report memory usage again, labelled by the net change
+    if (mMemoryReportingEnabled && mpMesh->GetNumElements() != mNumElementsAtLastMemoryReport)
+    {
+        std::string event = mpMesh->GetNumElements() > mNumElementsAtLastMemoryReport ? "Division" : "Removal";
+        this->WriteMemoryReport(mOutputDirectory, event);
+    }
+
+    ImmersedBoundaryProfiler::Instance()->EndPhase("UpdateAtEndOfTimeStep");
 }
 
 template<unsigned DIM>
 void ImmersedBoundarySimulationModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
 {
+    mOutputDirectory = outputDirectory;
+
+    if (mProfilingEnabled)
+    {
+        ImmersedBoundaryProfiler::Instance()->Reset();
+        ImmersedBoundaryProfiler::Instance()->Enable();
+    }
+
+    if (mTracingEnabled)
+    {
+        ImmersedBoundaryTraceRecorder::Instance()->Enable();
+    }
+
+    mHealthRecords.clear();
+
     // We can set up some helper variables here which need only be set up once for the entire simulation
     this->SetupConstantMemberVariables(rCellPopulation);
 
+    if (mProfilingEnabled && mHardwareCountersEnabled)
+    {
+        ImmersedBoundaryProfiler* p_profiler = ImmersedBoundaryProfiler::Instance();
+        p_profiler->SetNumGridPoints(mNumGridPtsX * mNumGridPtsY);
+        if (!p_profiler->EnableHardwareCounters())
+        {
+            WARN_ONCE_ONLY("Hardware performance counters are unavailable, so only wall times will be profiled.");
+        }
+    }
+
     // This will solve the fluid problem based on the initial mesh setup
     this->UpdateFluidVelocityGrids(rCellPopulation);
+
+    if (mMemoryReportingEnabled)
+    {
+        this->WriteMemoryReport(mOutputDirectory, "Setup");
+    }
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    if (mForceInstrumentationEnabled && !mForceCollection.empty())
+    {
+        this->WriteForceInstrumentation(mOutputDirectory);
+    }
+
+    if (mProfilingEnabled)
+    {
+        ImmersedBoundaryProfiler* p_profiler = ImmersedBoundaryProfiler::Instance();
+        if (!p_profiler->GetPhaseNames().empty())
+        {
+            p_profiler->WriteSummary(mOutputDirectory);
+        }
+        p_profiler->Disable();
+        p_profiler->DisableHardwareCounters();
+    }
+
+    if (mTracingEnabled)
+    {
+        ImmersedBoundaryTraceRecorder::Instance()->WriteTrace(mOutputDirectory);
+        ImmersedBoundaryTraceRecorder::Instance()->Disable();
+    }
+
+    if (mHealthMonitoringEnabled && !mHealthRecords.empty())
+    {
+        this->WriteHealthCounters(mOutputDirectory);
+    }
 }
 
 template<unsigned DIM>
 void ImmersedBoundarySimulationModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
 {
-    // No parameters to output, so just call method on direct parent class
+    // Output the parameters, and any instrumentation counters, of each immersed boundary force
+    for (unsigned force_idx = 0; force_idx < mForceCollection.size(); force_idx++)
+    {
+        mForceCollection[force_idx]->OutputImmersedBoundaryForceInfo(rParamsFile);
+    }
+
+    // Next, call method on direct parent class
     AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
 }
 
 template<unsigned DIM>
 void ImmersedBoundarySimulationModifier<DIM>::UpdateFluidVelocityGrids(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
+    ImmersedBoundaryProfiler* p_profiler = ImmersedBoundaryProfiler::Instance();
+
+    p_profiler->BeginPhase("ClearForcesAndSources");
     this->ClearForcesAndSources();
+    p_profiler->EndPhase("ClearForcesAndSources");
+
+    p_profiler->BeginPhase("AddForceContributions");
     this->AddImmersedBoundaryForceContributions();
+    p_profiler->EndPhase("AddForceContributions");
+
+    p_profiler->BeginPhase("PropagateForcesToFluidGrid");
     this->PropagateForcesToFluidGrid();
+    p_profiler->EndPhase("PropagateForcesToFluidGrid");
 
     // If sources are active, we must propagate them from their nodes to the grid
     if (mpCellPopulation->DoesPopulationHaveActiveSources())
     {
+        p_profiler->BeginPhase("PropagateFluidSourcesToGrid");
         this->PropagateFluidSourcesToGrid();
+        p_profiler->EndPhase("PropagateFluidSourcesToGrid");
     }
 
+    p_profiler->BeginPhase("SolveNavierStokesSpectral");
     this->SolveNavierStokesSpectral();
+    p_profiler->EndPhase("SolveNavierStokesSpectral");
 }
 
 template<unsigned DIM>
@@ -154,6 +305,8 @@ void ImmersedBoundarySimulationModifier<DIM>::SetupConstantMemberVariables(Abstr
     mpBoxCollection = new ObsoleteBoxCollection<DIM>(mpCellPopulation->GetInteractionDistance(), domain_size, true, true);
     mpBoxCollection->SetupLocalBoxesHalfOnly();
     mpBoxCollection->CalculateNodePairs(mpMesh->rGetNodes(), mNodePairs);
+    mpMesh->UpdateNeighbourLists(mNodePairs);
+    mNumNodeRenumberingsAtLastNodePairUpdate = mpMesh->GetNumNodeRenumberings();
 
     bool multi_thread_fft = false;
 
@@ -221,12 +374,276 @@ void ImmersedBoundarySimulationModifier<DIM>::ClearForcesAndSources()
 template<unsigned DIM>
 void ImmersedBoundarySimulationModifier<DIM>::AddImmersedBoundaryForceContributions()
 {
+    // The force pipeline can only be used if every force supports it
+    bool use_force_pipeline = mUseForcePipeline;
+    for (unsigned force_idx = 0; force_idx < mForceCollection.size(); force_idx++)
+    {
+        use_force_pipeline = use_force_pipeline && mForceCollection[force_idx]->SupportsForcePipeline();
+    }
+
+    if (use_force_pipeline)
+    {
+        this->EvaluateForcePipeline();
+        return;
+    }
+
     // Add contributions from each immersed boundary force
     for (typename std::vector<boost::shared_ptr<AbstractImmersedBoundaryForce<DIM> > >::iterator iter = mForceCollection.begin();
          iter != mForceCollection.end();
          ++iter)
     {
-        (*iter)->AddImmersedBoundaryForceContribution(mNodePairs, *mpCellPopulation);
+        if ((*iter)->GetInstrumentationEnabled())
+        {
+            double start_time = Timer::GetWallTime();
+            (*iter)->AddImmersedBoundaryForceContribution(mNodePairs, *mpCellPopulation);
+            (*iter)->AddInstrumentedCall(Timer::GetWallTime() - start_time);
+        }
+        else
+        {
+            (*iter)->AddImmersedBoundaryForceContribution(mNodePairs, *mpCellPopulation);
+        }
+    }
+
+    // Gather the applied force on each node into contiguous storage
+    mNodeForces.resize(DIM * mpMesh->GetNumNodes());
+    for (unsigned node_idx = 0; node_idx < mpMesh->GetNumNodes(); node_idx++)
+    {
+        const c_vector<double, DIM>& r_applied_force = mpMesh->GetNode(node_idx)->rGetAppliedForce();
+        for (unsigned dim = 0; dim < DIM; dim++)
+        {
+            mNodeForces[DIM * node_idx + dim] = r_applied_force[dim];
+        }
+    }
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::EvaluateForcePipeline()
+{
+    unsigned num_forces = mForceCollection.size();
+    int num_force_components = DIM * mpMesh->GetNumNodes();
+
+    mNodeForces.assign(num_force_components, 0.0);
+    if (num_force_components == 0)
+    {
+        return;
+    }
+
+    /*
+     * Any work needed by each force before the sweeps is done serially.  For instrumented forces, each evaluation is
+     * recorded here, and the time spent in the kernels below is added to it, summed over threads.
+     */
+    for (unsigned force_idx = 0; force_idx < num_forces; force_idx++)
+    {
+        AbstractImmersedBoundaryForce<DIM>* p_force = mForceCollection[force_idx].get();
+
+        if (p_force->GetInstrumentationEnabled())
+        {
+            double start_time = Timer::GetWallTime();
+            p_force->SetupForcePipelineStep(mNodePairs, *mpCellPopulation);
+            p_force->AddInstrumentedCall(Timer::GetWallTime() - start_time);
+        }
+        else
+        {
+            p_force->SetupForcePipelineStep(mNodePairs, *mpCellPopulation);
+        }
+    }
+
+    /*
+     * Sweep over elements.  Element kernels write only to the nodes they are given, so elements may be processed
+     * concurrently.  Large elements, such as the basement lamina, are split into items of consecutive nodes so that
+     * they are shared between threads rather than left to one.
+     */
+    this->UpdateElementSweepOrder();
+
+    unsigned max_nodes_per_item = UINT_MAX;
+    for (unsigned force_idx = 0; force_idx < num_forces; force_idx++)
+    {
+        max_nodes_per_item = std::min(max_nodes_per_item, mForceCollection[force_idx]->GetMaxNodesPerElementKernelCall());
+    }
+    this->UpdateElementSweepItems(max_nodes_per_item);
+
+    double* p_node_forces = &mNodeForces[0];
+    int num_items = mElementSweepItems.size() / 3;
+
+    // Each thread records its share of each sweep in the trace, if enabled
+    ImmersedBoundaryTraceRecorder* p_trace_recorder = ImmersedBoundaryTraceRecorder::Instance();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        p_trace_recorder->BeginEvent("ElementSweep");
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic) nowait
+#endif
+        for (int item_idx = 0; item_idx < num_items; item_idx++)
+        {
+            unsigned elem_idx = mElementSweepItems[3 * item_idx];
+            unsigned first_node = mElementSweepItems[3 * item_idx + 1];
+            unsigned end_node = mElementSweepItems[3 * item_idx + 2];
+
+            for (unsigned force_idx = 0; force_idx < num_forces; force_idx++)
+            {
+                AbstractImmersedBoundaryForce<DIM>* p_force = mForceCollection[force_idx].get();
+
+                if (p_force->GetInstrumentationEnabled())
+                {
+                    double start_time = Timer::GetWallTime();
+                    p_force->AddElementKernelContributions(elem_idx, first_node, end_node, p_node_forces);
+                    p_force->AddInstrumentedThreadTime(Timer::GetWallTime() - start_time);
+                }
+                else
+                {
+                    p_force->AddElementKernelContributions(elem_idx, first_node, end_node, p_node_forces);
+                }
+            }
+        }
+
+        p_trace_recorder->EndEvent("ElementSweep");
+    }
+
+    /*
+     * Sweep over node pairs.  A pair may involve any two nodes, so each thread accumulates into its own copy of the
+     * node forces over a contiguous range of pairs, and the copies are summed afterwards.
+     */
+    unsigned num_pairs = mNodePairs.size();
+
+#ifdef _OPENMP
+    this->PrepareThreadNodeForces();
+
+#pragma omp parallel
+    {
+        unsigned thread_idx = omp_get_thread_num();
+        unsigned num_threads = omp_get_num_threads();
+
+        unsigned begin = (unsigned)(((unsigned long)num_pairs * thread_idx) / num_threads);
+        unsigned end = (unsigned)(((unsigned long)num_pairs * (thread_idx + 1)) / num_threads);
+
+        p_trace_recorder->BeginEvent("PairSweep");
+
+        for (unsigned force_idx = 0; force_idx < num_forces; force_idx++)
+        {
+            AbstractImmersedBoundaryForce<DIM>* p_force = mForceCollection[force_idx].get();
+
+            if (p_force->GetInstrumentationEnabled())
+            {
+                double start_time = Timer::GetWallTime();
+                p_force->AddPairKernelContributions(mNodePairs, begin, end, &mThreadNodeForces[thread_idx][0]);
+                p_force->AddInstrumentedThreadTime(Timer::GetWallTime() - start_time);
+            }
+            else
+            {
+                p_force->AddPairKernelContributions(mNodePairs, begin, end, &mThreadNodeForces[thread_idx][0]);
+            }
+        }
+
+        p_trace_recorder->EndEvent("PairSweep");
+    }
+
+    this->ReduceThreadNodeForces();
+#else
+    p_trace_recorder->BeginEvent("PairSweep");
+
+    for (unsigned force_idx = 0; force_idx < num_forces; force_idx++)
+    {
+        AbstractImmersedBoundaryForce<DIM>* p_force = mForceCollection[force_idx].get();
+
+        if (p_force->GetInstrumentationEnabled())
+        {
+            double start_time = Timer::GetWallTime();
+            p_force->AddPairKernelContributions(mNodePairs, 0, num_pairs, p_node_forces);
+            p_force->AddInstrumentedThreadTime(Timer::GetWallTime() - start_time);
+        }
+        else
+        {
+            p_force->AddPairKernelContributions(mNodePairs, 0, num_pairs, p_node_forces);
+        }
+    }
+
+    p_trace_recorder->EndEvent("PairSweep");
+#endif
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::UpdateElementSweepOrder()
+{
+    // Visiting the largest elements first stops a large element, such as the basement lamina, from being left until last
+    std::vector<std::pair<unsigned, unsigned> > elements_by_size;
+    for (typename ImmersedBoundaryMesh<DIM, DIM>::ImmersedBoundaryElementIterator elem_iter = mpMesh->GetElementIteratorBegin(false);
+         elem_iter != mpMesh->GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        elements_by_size.push_back(std::make_pair(elem_iter->GetNumNodes(), elem_iter->GetIndex()));
+    }
+    std::sort(elements_by_size.begin(), elements_by_size.end(), std::greater<std::pair<unsigned, unsigned> >());
+
+    mElementSweepOrder.resize(elements_by_size.size());
+    for (unsigned i = 0; i < elements_by_size.size(); i++)
+    {
+        mElementSweepOrder[i] = elements_by_size[i].second;
+    }
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::UpdateElementSweepItems(unsigned maxNodesPerItem)
+{
+    assert(maxNodesPerItem > 0);
+
+    mElementSweepItems.clear();
+
+    for (unsigned i = 0; i < mElementSweepOrder.size(); i++)
+    {
+        unsigned elem_idx = mElementSweepOrder[i];
+        unsigned num_nodes = mpMesh->GetElement(elem_idx)->GetNumNodes();
+
+        if (num_nodes == 0)
+        {
+            continue;
+        }
+
+        // Split large elements into chunks of roughly equal size, keeping the chunks of an element together
+        unsigned num_chunks = 1 + (num_nodes - 1) / maxNodesPerItem;
+
+        for (unsigned chunk_idx = 0; chunk_idx < num_chunks; chunk_idx++)
+        {
+            mElementSweepItems.push_back(elem_idx);
+            mElementSweepItems.push_back((chunk_idx * num_nodes) / num_chunks);
+            mElementSweepItems.push_back(((chunk_idx + 1) * num_nodes) / num_chunks);
+        }
+    }
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::PrepareThreadNodeForces()
+{
+    unsigned num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+
+    mThreadNodeForces.resize(num_threads);
+    for (unsigned thread_idx = 0; thread_idx < num_threads; thread_idx++)
+    {
+        mThreadNodeForces[thread_idx].assign(mNodeForces.size(), 0.0);
+    }
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::ReduceThreadNodeForces()
+{
+    int num_force_components = mNodeForces.size();
+    int num_buffers = mThreadNodeForces.size();
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < num_force_components; i++)
+    {
+        for (int thread_idx = 0; thread_idx < num_buffers; thread_idx++)
+        {
+            mNodeForces[i] += mThreadNodeForces[thread_idx][i];
+        }
     }
 }
 
@@ -265,7 +682,10 @@ void ImmersedBoundarySimulationModifier<DIM>::PropagateForcesToFluidGrid()
 
             // Get location and applied force contribution of current node
             node_location = p_node->rGetLocation();
-            applied_force = p_node->rGetAppliedForce();
+            for (unsigned dim = 0; dim < DIM; dim++)
+            {
+                applied_force[dim] = mNodeForces[DIM * p_node->GetIndex() + dim];
+            }
 
             // Get first grid index in each dimension, taking account of possible wrap-around
             first_idx_x = unsigned(floor(node_location[0] / mGridSpacingX)) + mNumGridPtsX - 1;
@@ -396,7 +816,10 @@ void ImmersedBoundarySimulationModifier<DIM>::SolveNavierStokesSpectral()
     multi_array<std::complex<double>, 3>& fourier_grids = mpArrays->rGetModifiableFourierGrids();
     multi_array<std::complex<double>, 2>& pressure_grid = mpArrays->rGetModifiablePressureGrid();
 
+    ImmersedBoundaryProfiler* p_profiler = ImmersedBoundaryProfiler::Instance();
+
     // Perform upwind differencing and create RHS of linear system
+    p_profiler->BeginPhase("Upwind");
     Upwind2d(vel_grids, rhs_grids);
 
     // If the population has active sources, the Right Hand Side grids are calculated differently.
@@ -431,8 +854,12 @@ void ImmersedBoundarySimulationModifier<DIM>::SolveNavierStokesSpectral()
         }
     }
 
+    p_profiler->EndPhase("Upwind");
+
     // Perform fft on rhs_grids; results go to fourier_grids
+    p_profiler->BeginPhase("ForwardFft");
     mpFftInterface->FftExecuteForward();
+    p_profiler->EndPhase("ForwardFft");
 
     /*
      * The result of a DFT of n real datapoints is n/2 + 1 complex values, due to redundancy: element n-1 is conj(2),
@@ -440,6 +867,8 @@ void ImmersedBoundarySimulationModifier<DIM>::SolveNavierStokesSpectral()
      * redundancy, and so all calculations need only be done on reduced-size arrays, saving memory and computation.
      */
 
+    p_profiler->BeginPhase("SpectralUpdate");
+
     // If the population has active fluid sources, the computation is slightly more complicated
     if (mpCellPopulation->DoesPopulationHaveActiveSources())
     {
@@ -483,8 +912,14 @@ void ImmersedBoundarySimulationModifier<DIM>::SolveNavierStokesSpectral()
         }
     }
 
+    p_profiler->EndPhase("SpectralUpdate");
+
     // Perform inverse fft on fourier_grids; results are in vel_grids.  Then, normalise the DFT.
+    p_profiler->BeginPhase("InverseFft");
     mpFftInterface->FftExecuteInverse();
+    p_profiler->EndPhase("InverseFft");
+
+    p_profiler->BeginPhase("Normalise");
     for (unsigned dim = 0; dim < 2; dim++)
     {
         for (unsigned x = 0; x < mNumGridPtsX; x++)
@@ -495,6 +930,7 @@ void ImmersedBoundarySimulationModifier<DIM>::SolveNavierStokesSpectral()
             }
         }
     }
+    p_profiler->EndPhase("Normalise");
 }
 
 template<unsigned DIM>
@@ -596,12 +1032,429 @@ unsigned ImmersedBoundarySimulationModifier<DIM>::GetNodeNeighbourUpdateFrequenc
     return mNodeNeighbourUpdateFrequency;
 }
 
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetRemeshingFrequency(unsigned remeshingFrequency)
+{
+    mRemeshingFrequency = remeshingFrequency;
+}
+
+template<unsigned DIM>
+unsigned ImmersedBoundarySimulationModifier<DIM>::GetRemeshingFrequency()
+{
+    return mRemeshingFrequency;
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetRemeshingThreshold(double remeshingThreshold)
+{
+    assert(remeshingThreshold >= 1.0);
+    mRemeshingThreshold = remeshingThreshold;
+}
+
+template<unsigned DIM>
+double ImmersedBoundarySimulationModifier<DIM>::GetRemeshingThreshold()
+{
+    return mRemeshingThreshold;
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetTargetNodeSpacingFraction(double targetNodeSpacingFraction)
+{
+    assert(targetNodeSpacingFraction >= 0.0);
+    mTargetNodeSpacingFraction = targetNodeSpacingFraction;
+}
+
+template<unsigned DIM>
+double ImmersedBoundarySimulationModifier<DIM>::GetTargetNodeSpacingFraction()
+{
+    return mTargetNodeSpacingFraction;
+}
+
 template<unsigned DIM>
 void ImmersedBoundarySimulationModifier<DIM>::AddImmersedBoundaryForce(boost::shared_ptr<AbstractImmersedBoundaryForce<DIM> > pForce)
 {
+    if (mForceInstrumentationEnabled)
+    {
+        pForce->SetInstrumentationEnabled(true);
+    }
     mForceCollection.push_back(pForce);
 }
 
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetForceInstrumentationEnabled(bool forceInstrumentationEnabled)
+{
+    mForceInstrumentationEnabled = forceInstrumentationEnabled;
+
+    for (unsigned force_idx = 0; force_idx < mForceCollection.size(); force_idx++)
+    {
+        mForceCollection[force_idx]->SetInstrumentationEnabled(forceInstrumentationEnabled);
+    }
+}
+
+template<unsigned DIM>
+bool ImmersedBoundarySimulationModifier<DIM>::GetForceInstrumentationEnabled()
+{
+    return mForceInstrumentationEnabled;
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::WriteForceInstrumentation(std::string outputDirectory)
+{
+    std::vector<unsigned> num_calls;
+    std::vector<double> thread_times;
+    std::vector<double> mean_thread_times;
+    std::vector<double> mean_elements;
+    std::vector<double> mean_pairs_examined;
+    std::vector<double> mean_pairs_interacting;
+    std::vector<std::string> force_names;
+
+    for (unsigned force_idx = 0; force_idx < mForceCollection.size(); force_idx++)
+    {
+        AbstractImmersedBoundaryForce<DIM>* p_force = mForceCollection[force_idx].get();
+
+        // Avoid dividing by zero for a force that has not yet been evaluated
+        double calls = std::max(1.0, double(p_force->GetNumInstrumentedCalls()));
+
+        num_calls.push_back(p_force->GetNumInstrumentedCalls());
+        thread_times.push_back(p_force->GetCumulativeThreadTime());
+        mean_thread_times.push_back(p_force->GetCumulativeThreadTime() / calls);
+        mean_elements.push_back(double(p_force->GetNumElementsProcessed()) / calls);
+        mean_pairs_examined.push_back(double(p_force->GetNumPairsExamined()) / calls);
+        mean_pairs_interacting.push_back(double(p_force->GetNumPairsInteracting()) / calls);
+        force_names.push_back(p_force->GetIdentifier());
+    }
+
+    // The writer outputs unsigned data, then doubles, then strings
+    std::vector<std::string> headers;
+    headers.push_back("NumCalls");
+    headers.push_back("CumulativeThreadTime");
+    headers.push_back("MeanThreadTimePerCall");
+    headers.push_back("MeanElementsProcessedPerCall");
+    headers.push_back("MeanPairsExaminedPerCall");
+    headers.push_back("MeanPairsInteractingPerCall");
+    headers.push_back("Force");
+
+    CsvWriter writer;
+    writer.SetDirectoryName(outputDirectory);
+    writer.SetFileName("force_instrumentation.csv");
+    writer.AddHeaders(headers);
+    writer.AddData(num_calls);
+    writer.AddData(thread_times);
+    writer.AddData(mean_thread_times);
+    writer.AddData(mean_elements);
+    writer.AddData(mean_pairs_examined);
+    writer.AddData(mean_pairs_interacting);
+    writer.AddData(force_names);
+    writer.WriteDataToFile();
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetUseForcePipeline(bool useForcePipeline)
+{
+    mUseForcePipeline = useForcePipeline;
+}
+
+template<unsigned DIM>
+bool ImmersedBoundarySimulationModifier<DIM>::GetUseForcePipeline()
+{
+    return mUseForcePipeline;
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetProfilingEnabled(bool profilingEnabled)
+{
+    mProfilingEnabled = profilingEnabled;
+}
+
+template<unsigned DIM>
+bool ImmersedBoundarySimulationModifier<DIM>::GetProfilingEnabled()
+{
+    return mProfilingEnabled;
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetHardwareCountersEnabled(bool hardwareCountersEnabled)
+{
+    mHardwareCountersEnabled = hardwareCountersEnabled;
+}
+
+template<unsigned DIM>
+bool ImmersedBoundarySimulationModifier<DIM>::GetHardwareCountersEnabled()
+{
+    return mHardwareCountersEnabled;
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetTracingEnabled(bool tracingEnabled)
+{
+    mTracingEnabled = tracingEnabled;
+}
+
+template<unsigned DIM>
+bool ImmersedBoundarySimulationModifier<DIM>::GetTracingEnabled()
+{
+    return mTracingEnabled;
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetHealthMonitoringEnabled(bool healthMonitoringEnabled)
+{
+    mHealthMonitoringEnabled = healthMonitoringEnabled;
+}
+
+template<unsigned DIM>
+bool ImmersedBoundarySimulationModifier<DIM>::GetHealthMonitoringEnabled()
+{
+    return mHealthMonitoringEnabled;
+}
+
+template<unsigned DIM>
+double ImmersedBoundarySimulationModifier<DIM>::CalculateMaxFluidSpeed()
+{
+    const multi_array<double, 3>& vel_grids = mpMesh->rGet2dVelocityGrids();
+
+    double max_speed_squared = 0.0;
+    for (unsigned x = 0; x < mNumGridPtsX; x++)
+    {
+        for (unsigned y = 0; y < mNumGridPtsY; y++)
+        {
+            double speed_squared = vel_grids[0][x][y] * vel_grids[0][x][y] + vel_grids[1][x][y] * vel_grids[1][x][y];
+            max_speed_squared = std::max(max_speed_squared, speed_squared);
+        }
+    }
+
+    return sqrt(max_speed_squared);
+}
+
+template<unsigned DIM>
+double ImmersedBoundarySimulationModifier<DIM>::CalculateVelocityDivergenceNorm()
+{
+    const multi_array<double, 3>& vel_grids = mpMesh->rGet2dVelocityGrids();
+
+    // Central differences, with the grid periodic in each direction
+    double sum_squared_divergence = 0.0;
+    for (unsigned x = 0; x < mNumGridPtsX; x++)
+    {
+        unsigned x_next = (x + 1) % mNumGridPtsX;
+        unsigned x_prev = (x + mNumGridPtsX - 1) % mNumGridPtsX;
+
+        for (unsigned y = 0; y < mNumGridPtsY; y++)
+        {
+            unsigned y_next = (y + 1) % mNumGridPtsY;
+            unsigned y_prev = (y + mNumGridPtsY - 1) % mNumGridPtsY;
+
+            double divergence = (vel_grids[0][x_next][y] - vel_grids[0][x_prev][y]) / (2.0 * mGridSpacingX) +
+                                (vel_grids[1][x][y_next] - vel_grids[1][x][y_prev]) / (2.0 * mGridSpacingY);
+
+            sum_squared_divergence += divergence * divergence;
+        }
+    }
+
+    // Each grid point represents an area of mGridSpacingX * mGridSpacingY of the unit square
+    return sqrt(sum_squared_divergence * mGridSpacingX * mGridSpacingY);
+}
+
+template<unsigned DIM>
+unsigned ImmersedBoundarySimulationModifier<DIM>::CountNodePairsWithinInteractionDistance()
+{
+    double interaction_distance = mpCellPopulation->GetInteractionDistance();
+
+    unsigned num_pairs = 0;
+    for (unsigned pair_idx = 0; pair_idx < mNodePairs.size(); pair_idx++)
+    {
+        c_vector<double, DIM> vector_between_nodes = mpMesh->GetVectorFromAtoB(mNodePairs[pair_idx].first->rGetLocation(),
+                                                                               mNodePairs[pair_idx].second->rGetLocation());
+        if (norm_2(vector_between_nodes) < interaction_distance)
+        {
+            num_pairs++;
+        }
+    }
+
+    return num_pairs;
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::RecordHealthCounters()
+{
+    HealthRecord record;
+    record.mTimeStep = SimulationTime::Instance()->GetTimeStepsElapsed();
+    record.mTime = SimulationTime::Instance()->GetTime();
+    record.mNumNodesClamped = mpCellPopulation->GetNumNodesClamped();
+    record.mNumSourcesClamped = mpCellPopulation->GetNumSourcesClamped();
+    record.mNumPairsWithinInteractionDistance = this->CountNodePairsWithinInteractionDistance();
+    record.mMaxRelativeDisplacement = mpCellPopulation->GetMaxRelativeDisplacement();
+    record.mMaxFluidSpeed = this->CalculateMaxFluidSpeed();
+    record.mVelocityDivergenceNorm = this->CalculateVelocityDivergenceNorm();
+
+    // If nothing was scaled back, the current time step is as good a suggestion as any
+    record.mSuggestedTimeStep = std::min(mpCellPopulation->GetSuggestedTimeStep(), SimulationTime::Instance()->GetTimeStep());
+
+    mHealthRecords.push_back(record);
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::WriteHealthCounters(std::string outputDirectory)
+{
+    unsigned num_records = mHealthRecords.size();
+
+    std::vector<unsigned> time_steps(num_records);
+    std::vector<unsigned> num_nodes_clamped(num_records);
+    std::vector<unsigned> num_sources_clamped(num_records);
+    std::vector<unsigned> num_pairs(num_records);
+    std::vector<double> times(num_records);
+    std::vector<double> max_relative_displacements(num_records);
+    std::vector<double> suggested_time_steps(num_records);
+    std::vector<double> max_fluid_speeds(num_records);
+    std::vector<double> divergence_norms(num_records);
+
+    for (unsigned record_idx = 0; record_idx < num_records; record_idx++)
+    {
+        const HealthRecord& r_record = mHealthRecords[record_idx];
+        time_steps[record_idx] = r_record.mTimeStep;
+        num_nodes_clamped[record_idx] = r_record.mNumNodesClamped;
+        num_sources_clamped[record_idx] = r_record.mNumSourcesClamped;
+        num_pairs[record_idx] = r_record.mNumPairsWithinInteractionDistance;
+        times[record_idx] = r_record.mTime;
+        max_relative_displacements[record_idx] = r_record.mMaxRelativeDisplacement;
+        suggested_time_steps[record_idx] = r_record.mSuggestedTimeStep;
+        max_fluid_speeds[record_idx] = r_record.mMaxFluidSpeed;
+        divergence_norms[record_idx] = r_record.mVelocityDivergenceNorm;
+    }
+
+    // The writer outputs unsigned data, then doubles
+    std::vector<std::string> headers;
+    headers.push_back("TimeStep");
+    headers.push_back("NumNodesClamped");
+    headers.push_back("NumSourcesClamped");
+    headers.push_back("NumPairsWithinInteractionDistance");
+    headers.push_back("Time");
+    headers.push_back("MaxRelativeDisplacement");
+    headers.push_back("SuggestedTimeStep");
+    headers.push_back("MaxFluidSpeed");
+    headers.push_back("VelocityDivergenceNorm");
+
+    CsvWriter writer;
+    writer.SetDirectoryName(outputDirectory);
+    writer.SetFileName("health.csv");
+    writer.AddHeaders(headers);
+    writer.AddData(time_steps);
+    writer.AddData(num_nodes_clamped);
+    writer.AddData(num_sources_clamped);
+    writer.AddData(num_pairs);
+    writer.AddData(times);
+    writer.AddData(max_relative_displacements);
+    writer.AddData(suggested_time_steps);
+    writer.AddData(max_fluid_speeds);
+    writer.AddData(divergence_norms);
+    writer.WriteDataToFile();
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::SetMemoryReportingEnabled(bool memoryReportingEnabled)
+{
+    mMemoryReportingEnabled = memoryReportingEnabled;
+}
+
+template<unsigned DIM>
+bool ImmersedBoundarySimulationModifier<DIM>::GetMemoryReportingEnabled()
+{
+    return mMemoryReportingEnabled;
+}
+
+template<unsigned DIM>
+std::map<std::string, std::size_t> ImmersedBoundarySimulationModifier<DIM>::GetMemoryUsage()
+{
+    std::map<std::string, std::size_t> memory_usage;
+
+    if (mpMesh)
+    {
+        std::map<std::string, std::size_t> mesh_usage = mpMesh->GetMemoryUsage();
+        for (std::map<std::string, std::size_t>::iterator it = mesh_usage.begin(); it != mesh_usage.end(); ++it)
+        {
+            memory_usage["Mesh/" + it->first] = it->second;
+        }
+    }
+
+    if (mpArrays)
+    {
+        std::map<std::string, std::size_t> arrays_usage = mpArrays->GetMemoryUsage();
+        for (std::map<std::string, std::size_t>::iterator it = arrays_usage.begin(); it != arrays_usage.end(); ++it)
+        {
+            memory_usage["Arrays/" + it->first] = it->second;
+        }
+    }
+
+    memory_usage["NodePairs"] = mNodePairs.capacity() * sizeof(std::pair<Node<DIM>*, Node<DIM>*>);
+    memory_usage["NodeForces"] = mNodeForces.capacity() * sizeof(double);
+
+    std::size_t thread_force_bytes = mThreadNodeForces.capacity() * sizeof(std::vector<double>);
+    for (unsigned thread_idx = 0; thread_idx < mThreadNodeForces.size(); thread_idx++)
+    {
+        thread_force_bytes += mThreadNodeForces[thread_idx].capacity() * sizeof(double);
+    }
+    memory_usage["ThreadNodeForces"] = thread_force_bytes;
+
+    memory_usage["ElementSweepOrder"] = mElementSweepOrder.capacity() * sizeof(unsigned);
+    memory_usage["ElementSweepItems"] = mElementSweepItems.capacity() * sizeof(unsigned);
+
+    return memory_usage;
+}
+
+template<unsigned DIM>
+std::size_t ImmersedBoundarySimulationModifier<DIM>::GetPeakResidentSetSize()
+{
+    std::size_t peak_rss = 0;
+
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        // ru_maxrss is given in bytes on macOS, but in kilobytes elsewhere
+#ifdef __APPLE__
+        peak_rss = static_cast<std::size_t>(usage.ru_maxrss);
+#else
+        peak_rss = 1024 * static_cast<std::size_t>(usage.ru_maxrss);
+#endif
+    }
+#endif
+
+    return peak_rss;
+}
+
+template<unsigned DIM>
+void ImmersedBoundarySimulationModifier<DIM>::WriteMemoryReport(std::string outputDirectory, std::string event)
+{
+    std::map<std::string, std::size_t> memory_usage = this->GetMemoryUsage();
+
+    // Start a new report at setup, and append to it for the rest of the simulation
+    OutputFileHandler output_file_handler(outputDirectory, false);
+    out_stream p_file;
+    if (event == "Setup")
+    {
+        p_file = output_file_handler.OpenOutputFile("memory.csv");
+        *p_file << "Time,Event,NumElements,Component,Bytes\n";
+    }
+    else
+    {
+        p_file = output_file_handler.OpenOutputFile("memory.csv", std::ios::app);
+    }
+
+    double time = SimulationTime::Instance()->GetTime();
+    unsigned num_elements = mpMesh ? mpMesh->GetNumElements() : 0u;
+
+    std::size_t total_bytes = 0;
+    for (std::map<std::string, std::size_t>::iterator it = memory_usage.begin(); it != memory_usage.end(); ++it)
+    {
+        *p_file << time << "," << event << "," << num_elements << "," << it->first << "," << it->second << "\n";
+        total_bytes += it->second;
+    }
+    *p_file << time << "," << event << "," << num_elements << ",Total," << total_bytes << "\n";
+    *p_file << time << "," << event << "," << num_elements << ",PeakResidentSetSize," << GetPeakResidentSetSize() << "\n";
+    p_file->close();
+
+    mNumElementsAtLastMemoryReport = num_elements;
+}
+
 template<unsigned DIM>
 void ImmersedBoundarySimulationModifier<DIM>::SetReynoldsNumber(double reynoldsNumber)
 {
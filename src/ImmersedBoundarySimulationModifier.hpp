@@ -83,6 +83,8 @@ private:
         archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
     }
 
+protected:
+
     /** Pointer to the immersed boundary mesh */
     ImmersedBoundaryMesh<DIM,DIM>* mpMesh;
 
@@ -92,6 +94,25 @@ private:
     /** How often we calculate which cells are neighbours */
     unsigned mNodeNeighbourUpdateFrequency;
 
+    /**
+     * How often, in time steps, the nodes of unevenly resolved elements are redistributed by
+     * ImmersedBoundaryMesh::RemeshElements().  Zero, the default, means never.
+     */
+    unsigned mRemeshingFrequency;
+
+    /** The node spacing non-uniformity above which an element is remeshed.  Initialised to 2 in the constructor. */
+    double mRemeshingThreshold;
+
+    /**
+     * The target node spacing, as a fraction of the fluid grid spacing, to which the number of nodes in each element is
+     * adapted by ImmersedBoundaryMesh::AdaptNodeCounts() whenever elements are remeshed.  Zero, the default, means
+     * the number of nodes in each element is not adapted.
+     */
+    double mTargetNodeSpacingFraction;
+
+    /** The value of ImmersedBoundaryMesh::GetNumNodeRenumberings() when #mNodePairs was last calculated. */
+    unsigned mNumNodeRenumberingsAtLastNodePairUpdate;
+
     /**
      * Number of grid points in the x direction.
      *
@@ -137,6 +158,118 @@ private:
     /** A list of force laws to determine the force applied to each node */
     std::vector<boost::shared_ptr<AbstractImmersedBoundaryForce<DIM> > > mForceCollection;
 
+    /**
+     * Whether to evaluate the forces with the force pipeline, if every force supports it.
+     *
+     * Initialised to false in the constructor.
+     */
+    bool mUseForcePipeline;
+
+    /**
+     * The force on each node, with the DIM components for node i stored from mNodeForces[DIM*i], which is spread to
+     * the fluid grid by PropagateForcesToFluidGrid().
+     */
+    std::vector<double> mNodeForces;
+
+    /** Storage for the node forces accumulated by each thread in the pair sweep of the force pipeline. */
+    std::vector<std::vector<double> > mThreadNodeForces;
+
+    /** The order in which elements are visited in the element sweep of the force pipeline: largest first. */
+    std::vector<unsigned> mElementSweepOrder;
+
+    /**
+     * The work items of the element sweep of the force pipeline, stored as triples of the element index and the
+     * local indices of the first node and one past the last node in the item.
+     */
+    std::vector<unsigned> mElementSweepItems;
+
+    /**
+     * Whether to record thread time and work counters for each force.
+     *
+     * Initialised to false in the constructor.
+     */
+    bool mForceInstrumentationEnabled;
+
+    /** The output directory of the simulation, relative to where Chaste output is stored, set in SetupSolve(). */
+    std::string mOutputDirectory;
+
+    /**
+     * Whether to time each phase of the immersed boundary algorithm with ImmersedBoundaryProfiler, writing a summary
+     * to profile.csv at the end of the simulation.
+     *
+     * Initialised to false in the constructor.
+     */
+    bool mProfilingEnabled;
+
+    /**
+     * Whether to also record hardware performance counters around each phase when profiling, if they are available.
+     *
+     * Initialised to false in the constructor.
+     */
+    bool mHardwareCountersEnabled;
+
+    /**
+     * Whether to record a timeline of the phases of the immersed boundary algorithm with
+     * ImmersedBoundaryTraceRecorder, writing it to trace.json at the end of the simulation.
+     *
+     * Initialised to false in the constructor.
+     */
+    bool mTracingEnabled;
+
+    /** The health counters of the simulation at the end of a single time step. */
+    struct HealthRecord
+    {
+        /** The number of time steps elapsed. */
+        unsigned mTimeStep;
+
+        /** The simulation time. */
+        double mTime;
+
+        /** The number of nodes whose displacement was scaled back. */
+        unsigned mNumNodesClamped;
+
+        /** The number of fluid sources whose displacement was scaled back. */
+        unsigned mNumSourcesClamped;
+
+        /** The number of node pairs closer than the interaction distance. */
+        unsigned mNumPairsWithinInteractionDistance;
+
+        /** The largest displacement of a node or source, relative to the characteristic node spacing. */
+        double mMaxRelativeDisplacement;
+
+        /** The largest time step for which no displacement would have been scaled back. */
+        double mSuggestedTimeStep;
+
+        /** The largest fluid speed on the grid. */
+        double mMaxFluidSpeed;
+
+        /** The discrete L2 norm of the divergence of the fluid velocity. */
+        double mVelocityDivergenceNorm;
+    };
+
+    /**
+     * Whether to record health counters, such as the number of nodes whose displacement was scaled back, at each
+     * time step, writing them to health.csv at the end of the simulation.
+     *
+     * Initialised to false in the constructor.
+     */
+    bool mHealthMonitoringEnabled;
+
+    /** The health counters recorded at each time step since SetupSolve() was called. */
+    std::vector<HealthRecord> mHealthRecords;
+
+    /**
+     * Whether to write the memory used by each component of the simulation to memory.csv in SetupSolve(), and again
+     * after any time step in which the number of elements changed, labelled "Division" if it rose and "Removal" if it
+     * fell.
+     *
+     * Initialised to false in the constructor.
+     */
+    bool mMemoryReportingEnabled;
+
+    /** The number of elements in the mesh when the memory report was last written. */
+    unsigned mNumElementsAtLastMemoryReport;
+
     /** Pointer to structure storing all necessary arrays */
     ImmersedBoundary2dArrays<DIM>* mpArrays;
 
@@ -167,9 +300,42 @@ private:
     void ClearForcesAndSources();
 
     /**
-     * Loops over each immersed boundary force and invokes AddImmersedBoundaryForceContribution()
+     * Loops over each immersed boundary force and invokes AddImmersedBoundaryForceContribution(), or evaluates all
+     * forces together with EvaluateForcePipeline(), and stores the resulting force on each node in mNodeForces
+     */
+    virtual void AddImmersedBoundaryForceContributions();
+
+    /**
+     * Helper method for AddImmersedBoundaryForceContributions()
+     * Evaluates all forces with one sweep over elements, then one sweep over node pairs, accumulating into mNodeForces
+     */
+    void EvaluateForcePipeline();
+
+    /**
+     * Helper method for EvaluateForcePipeline()
+     * Fills mElementSweepOrder with the indices of the elements in decreasing order of their number of nodes
+     */
+    void UpdateElementSweepOrder();
+
+    /**
+     * Helper method for EvaluateForcePipeline()
+     * Fills mElementSweepItems by splitting the elements of mElementSweepOrder, in that order, into items of consecutive nodes
+     *
+     * @param maxNodesPerItem the largest number of nodes in an item
+     */
+    void UpdateElementSweepItems(unsigned maxNodesPerItem);
+
+    /**
+     * Helper method for EvaluateForcePipeline()
+     * Resizes mThreadNodeForces to hold one zeroed copy of mNodeForces for each available thread
+     */
+    void PrepareThreadNodeForces();
+
+    /**
+     * Helper method for EvaluateForcePipeline()
+     * Adds the node forces accumulated by each thread in mThreadNodeForces to mNodeForces
      */
-    void AddImmersedBoundaryForceContributions();
+    void ReduceThreadNodeForces();
 
     /**
      * Helper method for UpdateFluidVelocityGrids()
@@ -253,9 +419,21 @@ public:
      */
     virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
 
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Writes the force instrumentation counters to file, if force instrumentation is enabled, the phase timings, if
+     * profiling is enabled, the timeline, if tracing is enabled, and the health counters, if health monitoring is
+     * enabled.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
     /**
      * Overridden OutputSimulationModifierParameters() method.
-     * Output any simulation modifier parameters to file.
+     * Output any simulation modifier parameters to file, including the parameters and instrumentation counters of each
+     * immersed boundary force, as given by OutputImmersedBoundaryForceInfo().
      *
      * @param rParamsFile the file stream to which the parameters are output
      */
@@ -271,6 +449,41 @@ public:
      */
     unsigned GetNodeNeighbourUpdateFrequency();
 
+    /**
+     * @param remeshingFrequency the new number of time steps after which elements are remeshed, or zero to disable
+     *     remeshing
+     */
+    void SetRemeshingFrequency(unsigned remeshingFrequency);
+
+    /**
+     * @return #mRemeshingFrequency
+     */
+    unsigned GetRemeshingFrequency();
+
+    /**
+     * @param remeshingThreshold the new node spacing non-uniformity, at least 1, above which an element is remeshed
+     */
+    void SetRemeshingThreshold(double remeshingThreshold);
+
+    /**
+     * @return #mRemeshingThreshold
+     */
+    double GetRemeshingThreshold();
+
+    /**
+     * Set the target node spacing, as a fraction of the fluid grid spacing, for adaptive resolution.  If positive, the
+     * number of nodes in each element is adapted to this spacing every #mRemeshingFrequency time steps, just before
+     * the elements are remeshed, so remeshing must also be enabled.
+     *
+     * @param targetNodeSpacingFraction the new target node spacing fraction, or zero to disable adaptive resolution
+     */
+    void SetTargetNodeSpacingFraction(double targetNodeSpacingFraction);
+
+    /**
+     * @return #mTargetNodeSpacingFraction
+     */
+    double GetTargetNodeSpacingFraction();
+
     /**
      * Add an immersed boundary force to be used in this modifier.
      *
@@ -278,6 +491,167 @@ public:
      */
     void AddImmersedBoundaryForce(boost::shared_ptr<AbstractImmersedBoundaryForce<DIM> > pForce);
 
+    /**
+     * Set whether to evaluate the forces with the force pipeline.  This has an effect only if every force supports
+     * it; see AbstractImmersedBoundaryForce::SupportsForcePipeline().
+     *
+     * Note that with the force pipeline, the forces are spread to the fluid grid without being stored on the nodes.
+     *
+     * @param useForcePipeline whether to use the force pipeline
+     */
+    void SetUseForcePipeline(bool useForcePipeline);
+
+    /**
+     * @return #mUseForcePipeline
+     */
+    bool GetUseForcePipeline();
+
+    /**
+     * Set whether to record thread time and work counters for each force.  This applies to all forces already added, and
+     * to any forces added later.
+     *
+     * @param forceInstrumentationEnabled whether to instrument the forces
+     */
+    void SetForceInstrumentationEnabled(bool forceInstrumentationEnabled);
+
+    /**
+     * @return #mForceInstrumentationEnabled
+     */
+    bool GetForceInstrumentationEnabled();
+
+    /**
+     * Write the thread time and work counters of each force to the file force_instrumentation.csv, with one row per
+     * force.  Counters are given as means per evaluation of the force.  The thread time is summed over the threads
+     * that evaluated the force, as described in AbstractImmersedBoundaryForce.
+     *
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    void WriteForceInstrumentation(std::string outputDirectory);
+
+    /**
+     * Set whether to time each phase of the immersed boundary algorithm.  If so, the profiler is reset and enabled in
+     * SetupSolve(), and a summary of the phase timings is written to profile.csv in UpdateAtEndOfSolve().
+     *
+     * @param profilingEnabled whether to profile the simulation
+     */
+    void SetProfilingEnabled(bool profilingEnabled);
+
+    /**
+     * @return #mProfilingEnabled
+     */
+    bool GetProfilingEnabled();
+
+    /**
+     * Set whether to record hardware performance counters, such as instructions and cache misses, around each phase
+     * when profiling.  If the counters are unavailable, for example in a container, a warning is given and only wall
+     * times are profiled.  This has no effect unless profiling is enabled.
+     *
+     * @param hardwareCountersEnabled whether to record hardware counters
+     */
+    void SetHardwareCountersEnabled(bool hardwareCountersEnabled);
+
+    /**
+     * @return #mHardwareCountersEnabled
+     */
+    bool GetHardwareCountersEnabled();
+
+    /**
+     * Set whether to record a timeline of the phases of the immersed boundary algorithm.  If so, the trace recorder is
+     * enabled in SetupSolve(), and the timeline is written to trace.json, in the Chrome Trace Event format, in
+     * UpdateAtEndOfSolve().
+     *
+     * @param tracingEnabled whether to trace the simulation
+     */
+    void SetTracingEnabled(bool tracingEnabled);
+
+    /**
+     * @return #mTracingEnabled
+     */
+    bool GetTracingEnabled();
+
+    /**
+     * Set whether to record health counters at each time step: the number of nodes and sources whose displacement was
+     * scaled back, the largest relative displacement and the time step that would have avoided scaling back, the
+     * largest fluid speed, the divergence norm of the fluid velocity and the number of node pairs closer than the
+     * interaction distance.  If so, the counters are written to health.csv in UpdateAtEndOfSolve().
+     *
+     * @param healthMonitoringEnabled whether to record health counters
+     */
+    void SetHealthMonitoringEnabled(bool healthMonitoringEnabled);
+
+    /**
+     * @return #mHealthMonitoringEnabled
+     */
+    bool GetHealthMonitoringEnabled();
+
+    /**
+     * @return the largest fluid speed on the grid
+     */
+    double CalculateMaxFluidSpeed();
+
+    /**
+     * Calculate the discrete L2 norm of the divergence of the fluid velocity over the unit square, using central
+     * differences on the periodic grid.  In the absence of fluid sources this should be close to zero.
+     *
+     * @return the divergence norm
+     */
+    double CalculateVelocityDivergenceNorm();
+
+    /**
+     * @return the number of node pairs closer than the interaction distance of the cell population
+     */
+    unsigned CountNodePairsWithinInteractionDistance();
+
+    /**
+     * Record the health counters for the current time step.  Called from UpdateAtEndOfTimeStep() if health
+     * monitoring is enabled.
+     */
+    void RecordHealthCounters();
+
+    /**
+     * Write the health counters recorded so far to the file health.csv, with one row per time step.
+     *
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    void WriteHealthCounters(std::string outputDirectory);
+
+    /**
+     * Set whether to report the memory used by each component of the simulation.  If so, a report is written to
+     * memory.csv in SetupSolve(), and again after any time step in which cells divided or were removed.
+     *
+     * @param memoryReportingEnabled whether to report memory usage
+     */
+    void SetMemoryReportingEnabled(bool memoryReportingEnabled);
+
+    /**
+     * @return #mMemoryReportingEnabled
+     */
+    bool GetMemoryReportingEnabled();
+
+    /**
+     * Get the number of bytes used by each component of the simulation, indexed by name.  This comprises the entries
+     * of ImmersedBoundaryMesh::GetMemoryUsage(), prefixed by "Mesh/", those of ImmersedBoundary2dArrays::GetMemoryUsage(),
+     * prefixed by "Arrays/", and the node pairs and node force buffers held by this modifier.
+     *
+     * @return the memory usage of each component
+     */
+    std::map<std::string, std::size_t> GetMemoryUsage();
+
+    /**
+     * @return the peak resident set size of this process in bytes, or zero if this is not available on the platform
+     */
+    static std::size_t GetPeakResidentSetSize();
+
+    /**
+     * Write the current memory usage of each component, their total and the peak resident set size to the file
+     * memory.csv, with one row per component.  The file is created, with a header, when the event is "Setup", and is
+     * appended to otherwise.
+     *
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     * @param event a label for the point in the simulation at which the report is written
+     */
+    void WriteMemoryReport(std::string outputDirectory, std::string event);
+
     /**
      * Set #mReynoldsNumber.
      *
@@ -0,0 +1,224 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYSTATICFORCESIMULATIONMODIFIER_HPP_
+#define IMMERSEDBOUNDARYSTATICFORCESIMULATIONMODIFIER_HPP_
+
+#include "ImmersedBoundarySimulationModifier.hpp"
+#include "ImmersedBoundaryForcePolicies.hpp"
+#include "ImmersedBoundaryRingKernel.hpp"
+
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * An immersed boundary simulation modifier whose forces are fixed at compile time.
+ *
+ * Rather than a collection of AbstractImmersedBoundaryForce objects called through virtual methods, the forces are
+ * given as up to three force policy template parameters; see ImmersedBoundaryForcePolicies.hpp.  Each time step the
+ * modifier makes one sweep over elements and one sweep over node pairs, and in each the methods of every policy are
+ * inlined into a single loop body.  For example,
+ *
+ *     ImmersedBoundaryStaticForceSimulationModifier<2,
+ *                                                   MembraneElasticityForcePolicy<2>,
+ *                                                   CellCellInteractionForcePolicy<2, MorsePairLaw> >
+ *
+ * Forces added with AddImmersedBoundaryForce() are ignored by this class.
+ */
+template<unsigned DIM, class POLICY_1, class POLICY_2=NullForcePolicy<DIM>, class POLICY_3=NullForcePolicy<DIM> >
+class ImmersedBoundaryStaticForceSimulationModifier : public ImmersedBoundarySimulationModifier<DIM>
+{
+private:
+
+    /** To allow tests to directly access solver methods */
+    friend class TestImmersedBoundarySimulationModifier;
+
+    /** The first force policy. */
+    POLICY_1 mPolicy1;
+
+    /** The second force policy. */
+    POLICY_2 mPolicy2;
+
+    /** The third force policy. */
+    POLICY_3 mPolicy3;
+
+    /**
+     * Add the force between each pair of nodes in a range that are closer than the interaction distance.
+     *
+     * @param begin the index of the first pair in the range
+     * @param end one past the index of the last pair in the range
+     * @param interactionDistance the interaction distance
+     * @param pForces the node forces, stored with the DIM components for node i at pForces[DIM*i]
+     */
+    void AddPairContributions(unsigned begin, unsigned end, double interactionDistance, double* pForces)
+    {
+        for (unsigned pair = begin; pair < end; pair++)
+        {
+            unsigned node_a_idx = this->mNodePairs[pair].first->GetIndex();
+            unsigned node_b_idx = this->mNodePairs[pair].second->GetIndex();
+
+            const c_vector<double, DIM>& r_location_a = this->mNodePairs[pair].first->rGetLocation();
+            const c_vector<double, DIM>& r_location_b = this->mNodePairs[pair].second->rGetLocation();
+
+            double vector_between_nodes[DIM];
+            double normed_dist_squared = 0.0;
+            for (unsigned dim = 0; dim < DIM; dim++)
+            {
+                vector_between_nodes[dim] = ImmersedBoundaryRingKernel<DIM>::MinimumImage(r_location_b[dim] - r_location_a[dim]);
+                normed_dist_squared += vector_between_nodes[dim] * vector_between_nodes[dim];
+            }
+
+            double normed_dist = sqrt(normed_dist_squared);
+
+            if (normed_dist < interactionDistance)
+            {
+                mPolicy1.AddPairContribution(node_a_idx, node_b_idx, vector_between_nodes, normed_dist, pForces);
+                mPolicy2.AddPairContribution(node_a_idx, node_b_idx, vector_between_nodes, normed_dist, pForces);
+                mPolicy3.AddPairContribution(node_a_idx, node_b_idx, vector_between_nodes, normed_dist, pForces);
+            }
+        }
+    }
+
+protected:
+
+    /**
+     * Overridden AddImmersedBoundaryForceContributions() method.
+     *
+     * Evaluates the forces given by the policies, storing the resulting force on each node in mNodeForces.
+     */
+    void AddImmersedBoundaryForceContributions()
+    {
+        int num_force_components = DIM * this->mpMesh->GetNumNodes();
+
+        this->mNodeForces.assign(num_force_components, 0.0);
+        if (num_force_components == 0)
+        {
+            return;
+        }
+
+        mPolicy1.SetupStep(this->mNodePairs, *(this->mpCellPopulation));
+        mPolicy2.SetupStep(this->mNodePairs, *(this->mpCellPopulation));
+        mPolicy3.SetupStep(this->mNodePairs, *(this->mpCellPopulation));
+
+        // Sweep over elements, which write only to their own nodes
+        this->UpdateElementSweepOrder();
+
+        double* p_node_forces = &(this->mNodeForces[0]);
+        int num_elements = this->mElementSweepOrder.size();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < num_elements; i++)
+        {
+            unsigned elem_idx = this->mElementSweepOrder[i];
+
+            mPolicy1.AddElementContributions(elem_idx, p_node_forces);
+            mPolicy2.AddElementContributions(elem_idx, p_node_forces);
+            mPolicy3.AddElementContributions(elem_idx, p_node_forces);
+        }
+
+        // Sweep over node pairs, with each thread accumulating into its own copy of the node forces
+        unsigned num_pairs = this->mNodePairs.size();
+        double interaction_distance = this->mpCellPopulation->GetInteractionDistance();
+
+#ifdef _OPENMP
+        this->PrepareThreadNodeForces();
+
+#pragma omp parallel
+        {
+            unsigned thread_idx = omp_get_thread_num();
+            unsigned num_threads = omp_get_num_threads();
+
+            unsigned begin = (unsigned)(((unsigned long)num_pairs * thread_idx) / num_threads);
+            unsigned end = (unsigned)(((unsigned long)num_pairs * (thread_idx + 1)) / num_threads);
+
+            AddPairContributions(begin, end, interaction_distance, &(this->mThreadNodeForces[thread_idx][0]));
+        }
+
+        this->ReduceThreadNodeForces();
+#else
+        AddPairContributions(0, num_pairs, interaction_distance, p_node_forces);
+#endif
+    }
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rPolicy1 the first force policy
+     * @param rPolicy2 the second force policy (defaults to no force)
+     * @param rPolicy3 the third force policy (defaults to no force)
+     */
+    ImmersedBoundaryStaticForceSimulationModifier(const POLICY_1& rPolicy1=POLICY_1(),
+                                                  const POLICY_2& rPolicy2=POLICY_2(),
+                                                  const POLICY_3& rPolicy3=POLICY_3())
+        : ImmersedBoundarySimulationModifier<DIM>(),
+          mPolicy1(rPolicy1),
+          mPolicy2(rPolicy2),
+          mPolicy3(rPolicy3)
+    {
+    }
+
+    /**
+     * @return reference to the first force policy
+     */
+    POLICY_1& rGetPolicy1()
+    {
+        return mPolicy1;
+    }
+
+    /**
+     * @return reference to the second force policy
+     */
+    POLICY_2& rGetPolicy2()
+    {
+        return mPolicy2;
+    }
+
+    /**
+     * @return reference to the third force policy
+     */
+    POLICY_3& rGetPolicy3()
+    {
+        return mPolicy3;
+    }
+};
+
+#endif /*IMMERSEDBOUNDARYSTATICFORCESIMULATIONMODIFIER_HPP_*/
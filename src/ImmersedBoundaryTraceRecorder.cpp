@@ -0,0 +1,212 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ImmersedBoundaryTraceRecorder.hpp"
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+#include "Timer.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+ImmersedBoundaryTraceRecorder* ImmersedBoundaryTraceRecorder::mpInstance = NULL;
+
+ImmersedBoundaryTraceRecorder::ImmersedBoundaryTraceRecorder()
+    : mEnabled(false),
+      mBufferCapacity(1u << 16),
+      mStartTime(0.0)
+{
+}
+
+ImmersedBoundaryTraceRecorder* ImmersedBoundaryTraceRecorder::Instance()
+{
+    if (mpInstance == NULL)
+    {
+        mpInstance = new ImmersedBoundaryTraceRecorder();
+    }
+    return mpInstance;
+}
+
+void ImmersedBoundaryTraceRecorder::Destroy()
+{
+    if (mpInstance)
+    {
+        delete mpInstance;
+        mpInstance = NULL;
+    }
+}
+
+void ImmersedBoundaryTraceRecorder::Enable()
+{
+    unsigned num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+
+    mThreadBuffers.resize(num_threads);
+    for (unsigned thread_idx = 0; thread_idx < num_threads; thread_idx++)
+    {
+        mThreadBuffers[thread_idx].mEvents.resize(mBufferCapacity);
+        mThreadBuffers[thread_idx].mNumRecorded = 0;
+    }
+
+    mStartTime = Timer::GetWallTime();
+    mEnabled = true;
+}
+
+void ImmersedBoundaryTraceRecorder::Disable()
+{
+    mEnabled = false;
+}
+
+bool ImmersedBoundaryTraceRecorder::IsEnabled() const
+{
+    return mEnabled;
+}
+
+void ImmersedBoundaryTraceRecorder::SetBufferCapacity(unsigned bufferCapacity)
+{
+    if (bufferCapacity == 0)
+    {
+        EXCEPTION("The trace buffer capacity must be positive.");
+    }
+    mBufferCapacity = bufferCapacity;
+}
+
+unsigned ImmersedBoundaryTraceRecorder::GetBufferCapacity() const
+{
+    return mBufferCapacity;
+}
+
+void ImmersedBoundaryTraceRecorder::RecordEvent(const char* pName, char type)
+{
+    double time = Timer::GetWallTime() - mStartTime;
+
+    unsigned thread_idx = 0;
+#ifdef _OPENMP
+    thread_idx = omp_get_thread_num();
+#endif
+
+    // Threads beyond those present when the recorder was enabled are not recorded
+    if (thread_idx >= mThreadBuffers.size())
+    {
+        return;
+    }
+
+    // Only this thread writes to its buffer, so no synchronisation is needed
+    ThreadBuffer& r_buffer = mThreadBuffers[thread_idx];
+    TraceEvent& r_event = r_buffer.mEvents[r_buffer.mNumRecorded % r_buffer.mEvents.size()];
+    r_event.mpName = pName;
+    r_event.mTime = time;
+    r_event.mType = type;
+    r_buffer.mNumRecorded++;
+}
+
+void ImmersedBoundaryTraceRecorder::BeginEvent(const char* pName)
+{
+    if (mEnabled)
+    {
+        RecordEvent(pName, 'B');
+    }
+}
+
+void ImmersedBoundaryTraceRecorder::EndEvent(const char* pName)
+{
+    if (mEnabled)
+    {
+        RecordEvent(pName, 'E');
+    }
+}
+
+unsigned long ImmersedBoundaryTraceRecorder::GetNumEvents() const
+{
+    unsigned long num_events = 0;
+    for (unsigned thread_idx = 0; thread_idx < mThreadBuffers.size(); thread_idx++)
+    {
+        const ThreadBuffer& r_buffer = mThreadBuffers[thread_idx];
+        num_events += std::min<unsigned long>(r_buffer.mNumRecorded, r_buffer.mEvents.size());
+    }
+    return num_events;
+}
+
+unsigned long ImmersedBoundaryTraceRecorder::GetNumOverwrittenEvents() const
+{
+    unsigned long num_overwritten = 0;
+    for (unsigned thread_idx = 0; thread_idx < mThreadBuffers.size(); thread_idx++)
+    {
+        const ThreadBuffer& r_buffer = mThreadBuffers[thread_idx];
+        if (r_buffer.mNumRecorded > r_buffer.mEvents.size())
+        {
+            num_overwritten += r_buffer.mNumRecorded - r_buffer.mEvents.size();
+        }
+    }
+    return num_overwritten;
+}
+
+void ImmersedBoundaryTraceRecorder::WriteTrace(std::string outputDirectory, std::string fileName) const
+{
+    OutputFileHandler output_file_handler(outputDirectory, false);
+    out_stream p_file = output_file_handler.OpenOutputFile(fileName);
+
+    *p_file << "{\"traceEvents\":[";
+
+    bool first_event = true;
+    for (unsigned thread_idx = 0; thread_idx < mThreadBuffers.size(); thread_idx++)
+    {
+        const ThreadBuffer& r_buffer = mThreadBuffers[thread_idx];
+        unsigned long capacity = r_buffer.mEvents.size();
+
+        // If the buffer has wrapped around, the oldest event held is the one after the most recent
+        unsigned long first = r_buffer.mNumRecorded > capacity ? r_buffer.mNumRecorded - capacity : 0;
+
+        for (unsigned long event_idx = first; event_idx < r_buffer.mNumRecorded; event_idx++)
+        {
+            const TraceEvent& r_event = r_buffer.mEvents[event_idx % capacity];
+
+            *p_file << (first_event ? "\n" : ",\n");
+            *p_file << "{\"name\":\"" << r_event.mpName << "\",\"ph\":\"" << r_event.mType << "\","
+                    << "\"ts\":" << std::fixed << std::setprecision(3) << 1e6 * r_event.mTime << ","
+                    << "\"pid\":0,\"tid\":" << thread_idx << "}";
+            first_event = false;
+        }
+    }
+
+    *p_file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    p_file->close();
+}
@@ -0,0 +1,183 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYTRACERECORDER_HPP_
+#define IMMERSEDBOUNDARYTRACERECORDER_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * A singleton which records the beginning and end of each phase of an immersed boundary simulation as a timeline,
+ * which can be written in the Chrome Trace Event JSON format and viewed with chrome://tracing or Perfetto.
+ *
+ * Each OpenMP thread writes to its own fixed-size ring buffer, so recording an event takes no lock and allocates no
+ * memory.  If a buffer fills, the oldest events of that thread are overwritten.  The buffers are allocated by
+ * Enable(), which must be called from serial code, as must WriteTrace().
+ *
+ * Event names are stored as pointers, so must be string literals or otherwise outlive the recorder.
+ */
+class ImmersedBoundaryTraceRecorder
+{
+private:
+
+    /** A single begin or end event. */
+    struct TraceEvent
+    {
+        /** The event name. */
+        const char* mpName;
+
+        /** The wall time of the event, relative to when the recorder was enabled. */
+        double mTime;
+
+        /** The Chrome trace event type: 'B' for begin or 'E' for end. */
+        char mType;
+    };
+
+    /** The ring buffer of events for one thread. */
+    struct ThreadBuffer
+    {
+        /** Storage for the events, of size #mBufferCapacity. */
+        std::vector<TraceEvent> mEvents;
+
+        /** The number of events recorded by the thread, including any since overwritten. */
+        unsigned long mNumRecorded;
+
+        /** Padding so that the counters of different threads do not share a cache line. */
+        char mPadding[64];
+    };
+
+    /** A pointer to the singleton instance of this class. */
+    static ImmersedBoundaryTraceRecorder* mpInstance;
+
+    /** Whether events are currently being recorded. */
+    bool mEnabled;
+
+    /** The number of events each thread can hold before the oldest are overwritten. */
+    unsigned mBufferCapacity;
+
+    /** The wall time at which the recorder was last enabled. */
+    double mStartTime;
+
+    /** One ring buffer per thread, indexed by OpenMP thread number. */
+    std::vector<ThreadBuffer> mThreadBuffers;
+
+    /**
+     * Default constructor.  Use Instance() to access the recorder.
+     */
+    ImmersedBoundaryTraceRecorder();
+
+    /**
+     * Helper method to record an event in the buffer of the calling thread.
+     *
+     * @param pName the event name
+     * @param type the event type
+     */
+    void RecordEvent(const char* pName, char type);
+
+public:
+
+    /**
+     * @return a pointer to the single instance of the recorder, creating it if necessary
+     */
+    static ImmersedBoundaryTraceRecorder* Instance();
+
+    /**
+     * Destroy the single instance of the recorder.
+     */
+    static void Destroy();
+
+    /**
+     * Discard any recorded events, allocate one buffer for each OpenMP thread, and start recording.
+     */
+    void Enable();
+
+    /**
+     * Stop recording.  Events already recorded are kept.
+     */
+    void Disable();
+
+    /**
+     * @return #mEnabled
+     */
+    bool IsEnabled() const;
+
+    /**
+     * Set #mBufferCapacity, which takes effect the next time the recorder is enabled.
+     *
+     * @param bufferCapacity the number of events each thread can hold
+     */
+    void SetBufferCapacity(unsigned bufferCapacity);
+
+    /**
+     * @return #mBufferCapacity
+     */
+    unsigned GetBufferCapacity() const;
+
+    /**
+     * Record the beginning of an event on the calling thread.  Does nothing if the recorder is disabled.
+     *
+     * @param pName the event name
+     */
+    void BeginEvent(const char* pName);
+
+    /**
+     * Record the end of an event on the calling thread.  Does nothing if the recorder is disabled.
+     *
+     * @param pName the event name
+     */
+    void EndEvent(const char* pName);
+
+    /**
+     * @return the number of events held in all buffers
+     */
+    unsigned long GetNumEvents() const;
+
+    /**
+     * @return the number of events that have been overwritten because a buffer was full
+     */
+    unsigned long GetNumOverwrittenEvents() const;
+
+    /**
+     * Write all events held in the buffers to file in the Chrome Trace Event JSON format, with times in microseconds
+     * and one track per thread.
+     *
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     * @param fileName the file name (defaults to trace.json)
+     */
+    void WriteTrace(std::string outputDirectory, std::string fileName="trace.json") const;
+};
+
+#endif /*IMMERSEDBOUNDARYTRACERECORDER_HPP_*/
@@ -0,0 +1,326 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ImmersedBoundaryTrajectory.hpp"
+#include "CsvWriter.hpp"
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+
+void ImmersedBoundaryTrajectory::AddFrame(unsigned timeStep,
+                                          const std::vector<double>& rNodeLocations,
+                                          const std::vector<double>& rVelocityGrids)
+{
+    if (!mFrames.empty() && timeStep <= mFrames.back().mTimeStep)
+    {
+        EXCEPTION("Frames must be added in increasing order of time step.");
+    }
+
+    Frame frame;
+    frame.mTimeStep = timeStep;
+    mFrames.push_back(frame);
+    mFrames.back().mNodeLocations = rNodeLocations;
+    mFrames.back().mVelocityGrids = rVelocityGrids;
+}
+
+void ImmersedBoundaryTrajectory::Clear()
+{
+    mFrames.clear();
+}
+
+unsigned ImmersedBoundaryTrajectory::GetNumFrames() const
+{
+    return mFrames.size();
+}
+
+unsigned ImmersedBoundaryTrajectory::GetTimeStep(unsigned frameIndex) const
+{
+    assert(frameIndex < mFrames.size());
+    return mFrames[frameIndex].mTimeStep;
+}
+
+const std::vector<double>& ImmersedBoundaryTrajectory::rGetNodeLocations(unsigned frameIndex) const
+{
+    assert(frameIndex < mFrames.size());
+    return mFrames[frameIndex].mNodeLocations;
+}
+
+const std::vector<double>& ImmersedBoundaryTrajectory::rGetVelocityGrids(unsigned frameIndex) const
+{
+    assert(frameIndex < mFrames.size());
+    return mFrames[frameIndex].mVelocityGrids;
+}
+
+void ImmersedBoundaryTrajectory::Write(std::string outputDirectory, std::string fileName) const
+{
+    OutputFileHandler output_file_handler(outputDirectory, false);
+    out_stream p_file = output_file_handler.OpenOutputFile(fileName, std::ios::out | std::ios::trunc | std::ios::binary);
+
+    // Each frame is stored as its time step, then the size and values of each field
+    unsigned num_frames = mFrames.size();
+    p_file->write(reinterpret_cast<const char*>(&num_frames), sizeof(unsigned));
+    for (unsigned frame_idx = 0; frame_idx < num_frames; frame_idx++)
+    {
+        const Frame& r_frame = mFrames[frame_idx];
+        unsigned num_locations = r_frame.mNodeLocations.size();
+        unsigned num_velocities = r_frame.mVelocityGrids.size();
+
+        p_file->write(reinterpret_cast<const char*>(&r_frame.mTimeStep), sizeof(unsigned));
+        p_file->write(reinterpret_cast<const char*>(&num_locations), sizeof(unsigned));
+        if (num_locations > 0)
+        {
+            p_file->write(reinterpret_cast<const char*>(&r_frame.mNodeLocations[0]), num_locations * sizeof(double));
+        }
+        p_file->write(reinterpret_cast<const char*>(&num_velocities), sizeof(unsigned));
+        if (num_velocities > 0)
+        {
+            p_file->write(reinterpret_cast<const char*>(&r_frame.mVelocityGrids[0]), num_velocities * sizeof(double));
+        }
+    }
+    p_file->close();
+}
+
+void ImmersedBoundaryTrajectory::Load(const FileFinder& rFile)
+{
+    std::ifstream file(rFile.GetAbsolutePath().c_str(), std::ios::binary);
+    if (!file.is_open())
+    {
+        EXCEPTION("Unable to open trajectory file " << rFile.GetAbsolutePath() << ".");
+    }
+
+    mFrames.clear();
+
+    unsigned num_frames = 0;
+    file.read(reinterpret_cast<char*>(&num_frames), sizeof(unsigned));
+    for (unsigned frame_idx = 0; file.good() && frame_idx < num_frames; frame_idx++)
+    {
+        Frame frame;
+        unsigned num_locations = 0;
+        unsigned num_velocities = 0;
+
+        file.read(reinterpret_cast<char*>(&frame.mTimeStep), sizeof(unsigned));
+        file.read(reinterpret_cast<char*>(&num_locations), sizeof(unsigned));
+        frame.mNodeLocations.resize(num_locations);
+        if (file.good() && num_locations > 0)
+        {
+            file.read(reinterpret_cast<char*>(&frame.mNodeLocations[0]), num_locations * sizeof(double));
+        }
+        file.read(reinterpret_cast<char*>(&num_velocities), sizeof(unsigned));
+        frame.mVelocityGrids.resize(num_velocities);
+        if (file.good() && num_velocities > 0)
+        {
+            file.read(reinterpret_cast<char*>(&frame.mVelocityGrids[0]), num_velocities * sizeof(double));
+        }
+
+        mFrames.push_back(frame);
+    }
+
+    if (!file.good())
+    {
+        mFrames.clear();
+        EXCEPTION("Unable to read trajectory file " << rFile.GetAbsolutePath() << ".");
+    }
+}
+
+double ImmersedBoundaryTrajectory::GetUlp(double reference)
+{
+    if (reference == 0.0)
+    {
+        // The smallest subnormal double
+        return ldexp(1.0, -1074);
+    }
+
+    // For |reference| = m 2^e with 0.5 <= m < 1, doubles are spaced 2^(e-53) apart, down to the subnormal range
+    int exponent;
+    frexp(reference, &exponent);
+    return ldexp(1.0, std::max(exponent - 53, -1074));
+}
+
+ImmersedBoundaryTrajectory::FieldComparison ImmersedBoundaryTrajectory::CompareField(const std::string& rField,
+                                                                                     const std::vector<const std::vector<double>*>& rReference,
+                                                                                     const std::vector<const std::vector<double>*>& rOther)
+{
+    FieldComparison comparison;
+    comparison.mField = rField;
+    comparison.mNumValues = 0;
+    comparison.mNumDifferences = 0;
+
+    std::vector<double> ulps;
+    double max_abs_difference = 0.0;
+    double max_abs_reference = 0.0;
+    double sum_squared_differences = 0.0;
+    double sum_squared_reference = 0.0;
+
+    for (unsigned frame_idx = 0; frame_idx < rReference.size(); frame_idx++)
+    {
+        const std::vector<double>& r_reference = *(rReference[frame_idx]);
+        const std::vector<double>& r_other = *(rOther[frame_idx]);
+
+        if (r_reference.size() != r_other.size())
+        {
+            EXCEPTION("The field " << rField << " has a different size in frame " << frame_idx << ".");
+        }
+
+        for (unsigned i = 0; i < r_reference.size(); i++)
+        {
+            double difference = fabs(r_other[i] - r_reference[i]);
+
+            // Differences from a reference of zero may overflow
+            ulps.push_back(std::min(difference / GetUlp(r_reference[i]), DBL_MAX));
+            comparison.mNumDifferences += (difference > 0.0) ? 1 : 0;
+
+            max_abs_difference = std::max(max_abs_difference, difference);
+            max_abs_reference = std::max(max_abs_reference, fabs(r_reference[i]));
+            sum_squared_differences += difference * difference;
+            sum_squared_reference += r_reference[i] * r_reference[i];
+        }
+    }
+
+    comparison.mNumValues = ulps.size();
+    comparison.mMaxUlps = 0.0;
+    comparison.mMedianUlps = 0.0;
+    if (!ulps.empty())
+    {
+        comparison.mMaxUlps = *std::max_element(ulps.begin(), ulps.end());
+
+        std::vector<double>::iterator median = ulps.begin() + ulps.size() / 2;
+        std::nth_element(ulps.begin(), median, ulps.end());
+        comparison.mMedianUlps = *median;
+    }
+
+    // If the reference is identically zero, report the differences unscaled
+    comparison.mMaxRelativeError = max_abs_reference > 0.0 ? max_abs_difference / max_abs_reference : max_abs_difference;
+    comparison.mRelativeL2Error = sum_squared_reference > 0.0 ? sqrt(sum_squared_differences / sum_squared_reference) : sqrt(sum_squared_differences);
+
+    return comparison;
+}
+
+std::vector<ImmersedBoundaryTrajectory::FieldComparison> ImmersedBoundaryTrajectory::Compare(const ImmersedBoundaryTrajectory& rOther) const
+{
+    if (mFrames.size() != rOther.mFrames.size())
+    {
+        EXCEPTION("The trajectories have different numbers of frames.");
+    }
+
+    std::vector<const std::vector<double>*> reference_locations;
+    std::vector<const std::vector<double>*> other_locations;
+    std::vector<const std::vector<double>*> reference_velocities;
+    std::vector<const std::vector<double>*> other_velocities;
+
+    for (unsigned frame_idx = 0; frame_idx < mFrames.size(); frame_idx++)
+    {
+        if (mFrames[frame_idx].mTimeStep != rOther.mFrames[frame_idx].mTimeStep)
+        {
+            EXCEPTION("The trajectories were sampled at different time steps.");
+        }
+
+        reference_locations.push_back(&(mFrames[frame_idx].mNodeLocations));
+        other_locations.push_back(&(rOther.mFrames[frame_idx].mNodeLocations));
+        reference_velocities.push_back(&(mFrames[frame_idx].mVelocityGrids));
+        other_velocities.push_back(&(rOther.mFrames[frame_idx].mVelocityGrids));
+    }
+
+    std::vector<FieldComparison> comparisons;
+    comparisons.push_back(CompareField("NodeLocations", reference_locations, other_locations));
+    comparisons.push_back(CompareField("VelocityGrids", reference_velocities, other_velocities));
+    return comparisons;
+}
+
+void ImmersedBoundaryTrajectory::WriteComparisons(const std::map<std::string, std::vector<FieldComparison> >& rComparisons,
+                                                  std::string outputDirectory,
+                                                  std::string fileName)
+{
+    std::vector<unsigned> num_values;
+    std::vector<unsigned> num_differences;
+    std::vector<double> max_ulps;
+    std::vector<double> median_ulps;
+    std::vector<double> max_relative_errors;
+    std::vector<double> relative_l2_errors;
+    std::vector<std::string> names;
+    std::vector<std::string> fields;
+
+    for (std::map<std::string, std::vector<FieldComparison> >::const_iterator iter = rComparisons.begin();
+         iter != rComparisons.end();
+         ++iter)
+    {
+        for (unsigned field_idx = 0; field_idx < iter->second.size(); field_idx++)
+        {
+            const FieldComparison& r_comparison = iter->second[field_idx];
+            num_values.push_back(r_comparison.mNumValues);
+            num_differences.push_back(r_comparison.mNumDifferences);
+            max_ulps.push_back(r_comparison.mMaxUlps);
+            median_ulps.push_back(r_comparison.mMedianUlps);
+            max_relative_errors.push_back(r_comparison.mMaxRelativeError);
+            relative_l2_errors.push_back(r_comparison.mRelativeL2Error);
+            names.push_back(iter->first);
+            fields.push_back(r_comparison.mField);
+        }
+    }
+
+    if (names.empty())
+    {
+        EXCEPTION("There are no comparisons to write.");
+    }
+
+    // The writer outputs unsigned data, then doubles, then strings
+    std::vector<std::string> headers;
+    headers.push_back("NumValues");
+    headers.push_back("NumDifferences");
+    headers.push_back("MaxUlps");
+    headers.push_back("MedianUlps");
+    headers.push_back("MaxRelativeError");
+    headers.push_back("RelativeL2Error");
+    headers.push_back("Variant");
+    headers.push_back("Field");
+
+    CsvWriter writer;
+    writer.SetDirectoryName(outputDirectory);
+    writer.SetFileName(fileName);
+    writer.AddHeaders(headers);
+    writer.AddData(num_values);
+    writer.AddData(num_differences);
+    writer.AddData(max_ulps);
+    writer.AddData(median_ulps);
+    writer.AddData(max_relative_errors);
+    writer.AddData(relative_l2_errors);
+    writer.AddData(names);
+    writer.AddData(fields);
+    writer.WriteDataToFile();
+}
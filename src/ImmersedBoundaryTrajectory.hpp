@@ -0,0 +1,196 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYTRAJECTORY_HPP_
+#define IMMERSEDBOUNDARYTRAJECTORY_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "FileFinder.hpp"
+
+/**
+ * The trajectory of an immersed boundary simulation, sampled at chosen time steps: the node locations and the fluid
+ * velocity grids at each sample, stored to full precision.  A trajectory recorded from the reference implementation
+ * can be written to file and compared with one recorded from an optimised kernel, or with a different number of
+ * threads, using Compare().  Trajectories are normally recorded with ImmersedBoundaryTrajectoryModifier.
+ */
+class ImmersedBoundaryTrajectory
+{
+public:
+
+    /** The differences between one field of two trajectories, over all frames. */
+    struct FieldComparison
+    {
+        /** The field name: "NodeLocations" or "VelocityGrids". */
+        std::string mField;
+
+        /** The number of values compared. */
+        unsigned mNumValues;
+
+        /** The number of values which differ. */
+        unsigned mNumDifferences;
+
+        /** The largest difference in units in the last place of the reference value. */
+        double mMaxUlps;
+
+        /** The median difference in units in the last place of the reference value. */
+        double mMedianUlps;
+
+        /** The largest absolute difference, relative to the largest absolute reference value. */
+        double mMaxRelativeError;
+
+        /** The L2 norm of the differences, relative to the L2 norm of the reference values. */
+        double mRelativeL2Error;
+    };
+
+private:
+
+    /** The data recorded at a single time step. */
+    struct Frame
+    {
+        /** The number of time steps elapsed. */
+        unsigned mTimeStep;
+
+        /** The node locations, with the components for node i stored from DIM*i. */
+        std::vector<double> mNodeLocations;
+
+        /** The fluid velocity grids, flattened in storage order. */
+        std::vector<double> mVelocityGrids;
+    };
+
+    /** The frames, in the order they were recorded. */
+    std::vector<Frame> mFrames;
+
+    /**
+     * Helper method for Compare(), which compares one field of all frames.
+     *
+     * @param rField the field name
+     * @param rReference the values of the field in each frame of the reference trajectory
+     * @param rOther the values of the field in each frame of the other trajectory
+     * @return the comparison
+     */
+    static FieldComparison CompareField(const std::string& rField,
+                                        const std::vector<const std::vector<double>*>& rReference,
+                                        const std::vector<const std::vector<double>*>& rOther);
+
+public:
+
+    /**
+     * Add a frame to the trajectory.
+     *
+     * @param timeStep the number of time steps elapsed, which must be greater than that of the previous frame
+     * @param rNodeLocations the node locations
+     * @param rVelocityGrids the fluid velocity grids, flattened
+     */
+    void AddFrame(unsigned timeStep, const std::vector<double>& rNodeLocations, const std::vector<double>& rVelocityGrids);
+
+    /**
+     * Remove all frames.
+     */
+    void Clear();
+
+    /**
+     * @return the number of frames
+     */
+    unsigned GetNumFrames() const;
+
+    /**
+     * @param frameIndex the index of a frame
+     * @return the number of time steps elapsed at the frame
+     */
+    unsigned GetTimeStep(unsigned frameIndex) const;
+
+    /**
+     * @param frameIndex the index of a frame
+     * @return the node locations at the frame
+     */
+    const std::vector<double>& rGetNodeLocations(unsigned frameIndex) const;
+
+    /**
+     * @param frameIndex the index of a frame
+     * @return the fluid velocity grids at the frame
+     */
+    const std::vector<double>& rGetVelocityGrids(unsigned frameIndex) const;
+
+    /**
+     * Write the trajectory to a binary file, which can be read back exactly with Load() on the same platform.
+     *
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     * @param fileName the file name
+     */
+    void Write(std::string outputDirectory, std::string fileName) const;
+
+    /**
+     * Replace this trajectory with one read from a file written by Write().
+     *
+     * @param rFile the file
+     */
+    void Load(const FileFinder& rFile);
+
+    /**
+     * Compare another trajectory with this one, taking this one as the reference.  The trajectories must have frames
+     * at the same time steps, with fields of the same sizes.
+     *
+     * The number of units in the last place (ULPs) by which a value differs is the absolute difference divided by the
+     * spacing of doubles at the reference value.  Near zero this spacing is very small, so the median is usually more
+     * informative than the maximum.
+     *
+     * @param rOther the trajectory to compare
+     * @return the comparison of each field
+     */
+    std::vector<FieldComparison> Compare(const ImmersedBoundaryTrajectory& rOther) const;
+
+    /**
+     * @param reference the reference value
+     * @return the spacing of doubles at the reference value
+     */
+    static double GetUlp(double reference);
+
+    /**
+     * Write the comparisons of several trajectories with a reference to a CSV file, with one row per trajectory and
+     * field.
+     *
+     * @param rComparisons the comparisons, indexed by a name for each trajectory
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     * @param fileName the file name (defaults to trajectory_comparison.csv)
+     */
+    static void WriteComparisons(const std::map<std::string, std::vector<FieldComparison> >& rComparisons,
+                                 std::string outputDirectory,
+                                 std::string fileName="trajectory_comparison.csv");
+};
+
+#endif /*IMMERSEDBOUNDARYTRAJECTORY_HPP_*/
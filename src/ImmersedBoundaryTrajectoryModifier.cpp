@@ -0,0 +1,127 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ImmersedBoundaryTrajectoryModifier.hpp"
+#include "ImmersedBoundaryCellPopulation.hpp"
+#include "Exception.hpp"
+
+template<unsigned DIM>
+ImmersedBoundaryTrajectoryModifier<DIM>::ImmersedBoundaryTrajectoryModifier(unsigned samplingInterval)
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mSamplingInterval(samplingInterval)
+{
+    if (mSamplingInterval == 0)
+    {
+        EXCEPTION("The sampling interval must be positive.");
+    }
+}
+
+template<unsigned DIM>
+ImmersedBoundaryTrajectoryModifier<DIM>::~ImmersedBoundaryTrajectoryModifier()
+{
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryTrajectoryModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    if (SimulationTime::Instance()->GetTimeStepsElapsed() % mSamplingInterval == 0)
+    {
+        this->RecordFrame(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryTrajectoryModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    mTrajectory.Clear();
+    this->RecordFrame(rCellPopulation);
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryTrajectoryModifier<DIM>::RecordFrame(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    if (dynamic_cast<ImmersedBoundaryCellPopulation<DIM> *>(&rCellPopulation) == NULL)
+    {
+        EXCEPTION("Cell population must be immersed boundary");
+    }
+
+    ImmersedBoundaryMesh<DIM,DIM>& r_mesh = static_cast<ImmersedBoundaryCellPopulation<DIM> *>(&rCellPopulation)->rGetMesh();
+
+    std::vector<double> node_locations(DIM * r_mesh.GetNumNodes());
+    for (unsigned node_idx = 0; node_idx < r_mesh.GetNumNodes(); node_idx++)
+    {
+        const c_vector<double, DIM>& r_location = r_mesh.GetNode(node_idx)->rGetLocation();
+        for (unsigned dim = 0; dim < DIM; dim++)
+        {
+            node_locations[DIM * node_idx + dim] = r_location[dim];
+        }
+    }
+
+    // Only the two-dimensional velocity grids are used by the fluid solver
+    const multi_array<double, 3>& r_grids = r_mesh.rGet2dVelocityGrids();
+    std::vector<double> velocity_grids(r_grids.data(), r_grids.data() + r_grids.num_elements());
+
+    mTrajectory.AddFrame(SimulationTime::Instance()->GetTimeStepsElapsed(), node_locations, velocity_grids);
+}
+
+template<unsigned DIM>
+void ImmersedBoundaryTrajectoryModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<SamplingInterval>" << mSamplingInterval << "</SamplingInterval>\n";
+
+    // Next, call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+template<unsigned DIM>
+unsigned ImmersedBoundaryTrajectoryModifier<DIM>::GetSamplingInterval()
+{
+    return mSamplingInterval;
+}
+
+template<unsigned DIM>
+const ImmersedBoundaryTrajectory& ImmersedBoundaryTrajectoryModifier<DIM>::rGetTrajectory() const
+{
+    return mTrajectory;
+}
+
+// Explicit instantiation
+template class ImmersedBoundaryTrajectoryModifier<1>;
+template class ImmersedBoundaryTrajectoryModifier<2>;
+template class ImmersedBoundaryTrajectoryModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ImmersedBoundaryTrajectoryModifier)
@@ -0,0 +1,141 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef IMMERSEDBOUNDARYTRAJECTORYMODIFIER_HPP_
+#define IMMERSEDBOUNDARYTRAJECTORYMODIFIER_HPP_
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "ChasteSerialization.hpp"
+#include "ImmersedBoundaryTrajectory.hpp"
+
+#include <boost/serialization/base_object.hpp>
+
+/**
+ * A modifier which records the trajectory of an immersed boundary simulation, sampling the node locations and fluid
+ * velocity grids at the start of the simulation and then every mSamplingInterval time steps.
+ *
+ * Since the fluid is solved by ImmersedBoundarySimulationModifier, this modifier must be added to the simulation
+ * after it, so that each sample sees the velocity grids for the current time step.
+ */
+template<unsigned DIM>
+class ImmersedBoundaryTrajectoryModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mSamplingInterval;
+    }
+
+    /** The number of time steps between samples. */
+    unsigned mSamplingInterval;
+
+    /** The recorded trajectory. */
+    ImmersedBoundaryTrajectory mTrajectory;
+
+    /**
+     * Add a frame with the current node locations and velocity grids to the trajectory.
+     *
+     * @param rCellPopulation reference to the cell population, which must be an immersed boundary cell population
+     */
+    void RecordFrame(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param samplingInterval the number of time steps between samples (defaults to 1)
+     */
+    ImmersedBoundaryTrajectoryModifier(unsigned samplingInterval=1);
+
+    /**
+     * Destructor.
+     */
+    virtual ~ImmersedBoundaryTrajectoryModifier();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Records a frame if the number of time steps elapsed is a multiple of the sampling interval.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Discards any previous trajectory and records the first frame.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+
+    /**
+     * @return #mSamplingInterval
+     */
+    unsigned GetSamplingInterval();
+
+    /**
+     * @return the recorded trajectory
+     */
+    const ImmersedBoundaryTrajectory& rGetTrajectory() const;
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ImmersedBoundaryTrajectoryModifier)
+
+#endif /*IMMERSEDBOUNDARYTRAJECTORYMODIFIER_HPP_*/
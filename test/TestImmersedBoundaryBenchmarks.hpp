@@ -0,0 +1,164 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for the test environment
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+// Includes from trunk
+#include "OutputFileHandler.hpp"
+
+// Includes from Immersed Boundary
+#include "ImmersedBoundaryBenchmark.hpp"
+#include "ImmersedBoundaryProfiler.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+/**
+ * Scaling benchmarks for the immersed boundary pipeline.  Starting from a base case, the grid size, number of nodes
+ * per cell, number of cells and number of threads are each varied in turn, for both palisade and honeycomb meshes.
+ * The median time of each phase of the time step and the mean time of a full step are written to
+ * benchmark_results.json.
+ *
+ * The largest grids need several gigabytes of memory, so this test is only in the profile test pack.
+ */
+class TestImmersedBoundaryBenchmarks : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestScalingSweep() throw(Exception)
+    {
+        std::string output_directory = "TestImmersedBoundaryBenchmarks";
+
+        const unsigned base_num_cells = 8;
+        const unsigned base_num_nodes_per_cell = 128;
+        const unsigned base_num_grid_pts = 256;
+
+        unsigned max_num_threads = 1;
+#ifdef _OPENMP
+        max_num_threads = omp_get_max_threads();
+#endif
+
+        std::vector<unsigned> grid_sizes;
+        for (unsigned num_grid_pts = 64; num_grid_pts <= 4096; num_grid_pts *= 4)
+        {
+            grid_sizes.push_back(num_grid_pts);
+        }
+
+        std::vector<unsigned> nodes_per_cell;
+        for (unsigned num_nodes = 32; num_nodes <= 512; num_nodes *= 2)
+        {
+            nodes_per_cell.push_back(num_nodes);
+        }
+
+        std::vector<unsigned> cell_counts;
+        for (unsigned num_cells = 2; num_cells <= 32; num_cells *= 2)
+        {
+            cell_counts.push_back(num_cells);
+        }
+
+        std::vector<unsigned> thread_counts;
+        for (unsigned num_threads = 1; num_threads <= max_num_threads; num_threads *= 2)
+        {
+            thread_counts.push_back(num_threads);
+        }
+
+        // Vary one parameter at a time from the base case, without repeating the base case itself
+        std::vector<ImmersedBoundaryBenchmark> benchmarks;
+        std::vector<std::string> mesh_types;
+        mesh_types.push_back("palisade");
+        mesh_types.push_back("honeycomb");
+
+        for (unsigned type_idx = 0; type_idx < mesh_types.size(); type_idx++)
+        {
+            const std::string& r_type = mesh_types[type_idx];
+
+            for (unsigned i = 0; i < grid_sizes.size(); i++)
+            {
+                benchmarks.push_back(ImmersedBoundaryBenchmark(r_type, base_num_cells, base_num_nodes_per_cell, grid_sizes[i]));
+            }
+            for (unsigned i = 0; i < nodes_per_cell.size(); i++)
+            {
+                if (nodes_per_cell[i] != base_num_nodes_per_cell)
+                {
+                    benchmarks.push_back(ImmersedBoundaryBenchmark(r_type, base_num_cells, nodes_per_cell[i], base_num_grid_pts));
+                }
+            }
+            for (unsigned i = 0; i < cell_counts.size(); i++)
+            {
+                if (cell_counts[i] != base_num_cells)
+                {
+                    benchmarks.push_back(ImmersedBoundaryBenchmark(r_type, cell_counts[i], base_num_nodes_per_cell, base_num_grid_pts));
+                }
+            }
+            for (unsigned i = 0; i < thread_counts.size(); i++)
+            {
+                if (thread_counts[i] != 1)
+                {
+                    benchmarks.push_back(ImmersedBoundaryBenchmark(r_type, base_num_cells, base_num_nodes_per_cell, base_num_grid_pts, thread_counts[i]));
+                }
+            }
+        }
+
+        boost::property_tree::ptree results;
+        for (unsigned i = 0; i < benchmarks.size(); i++)
+        {
+            benchmarks[i].Run(output_directory);
+
+            TS_ASSERT(benchmarks[i].GetMeanStepTime() > 0.0);
+            TS_ASSERT(benchmarks[i].rGetMedianPhaseTimes().count("SolveNavierStokesSpectral") > 0);
+
+            benchmarks[i].AddResultsToPropertyTree(results);
+        }
+
+        boost::property_tree::ptree root;
+        root.put("MaxNumThreads", max_num_threads);
+        root.add_child("Benchmarks", results);
+
+        OutputFileHandler output_file_handler(output_directory, false);
+        std::string json_file = output_file_handler.GetOutputDirectoryFullPath() + "benchmark_results.json";
+        boost::property_tree::write_json(json_file, root);
+
+        ImmersedBoundaryProfiler::Destroy();
+    }
+};
@@ -187,7 +187,62 @@ public:
         TS_ASSERT_DELTA(cell_population.GetNode(0)->rGetLocation()[1], new_location[1], 1e-12);
     }
 
-    ///\todo Test AddNode(), UpdateNodeLocations(), AddCell(), RemoveDeadCells(), IsCellAssociatedWithADeletedLocation() and Update()
+    ///\todo Test UpdateNodeLocations() and AddCell()
+
+    void TestRemoveDeadCellsAndUpdate() throw(Exception)
+    {
+        // Create an immersed boundary cell population object, whose membrane is element 0
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+
+        TS_ASSERT_EQUALS(cell_population.RemoveDeadCells(), 0u);
+
+        CellPtr p_membrane_cell = cell_population.GetCellUsingLocationIndex(0);
+        CellPtr p_dead_cell = cell_population.GetCellUsingLocationIndex(2);
+        CellPtr p_last_cell = cell_population.GetCellUsingLocationIndex(5);
+
+        // Removing a dead cell marks its element and nodes as deleted
+        p_dead_cell->Kill();
+        TS_ASSERT_EQUALS(cell_population.RemoveDeadCells(), 1u);
+        TS_ASSERT_EQUALS(cell_population.GetNumRealCells(), 5u);
+        TS_ASSERT(p_mesh->GetElement(2)->IsDeleted());
+        TS_ASSERT_EQUALS(p_mesh->GetNumElements(), 5u);
+        TS_ASSERT_EQUALS(p_mesh->GetNumNodes(), 483u);
+
+        // Update() compacts the mesh and the correspondence between cells and elements
+        cell_population.Update();
+        TS_ASSERT_EQUALS(p_mesh->GetNumAllElements(), 5u);
+        TS_ASSERT_EQUALS(p_mesh->GetNumAllNodes(), 483u);
+        TS_ASSERT_EQUALS(p_mesh->GetMembraneIndex(), 0u);
+        TS_ASSERT_EQUALS(p_mesh->rGetElementFluidSources().size(), 4u);
+
+        TS_ASSERT_EQUALS(cell_population.GetLocationIndexUsingCell(p_membrane_cell), 0u);
+        TS_ASSERT_EQUALS(cell_population.GetLocationIndexUsingCell(p_last_cell), 4u);
+        TS_ASSERT_EQUALS(cell_population.GetCellUsingLocationIndex(4), p_last_cell);
+
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            TS_ASSERT_EQUALS(cell_population.IsCellAssociatedWithADeletedLocation(*cell_iter), false);
+            TS_ASSERT_LESS_THAN(cell_population.GetLocationIndexUsingCell(*cell_iter), 5u);
+        }
+
+        // The membrane element cannot be removed
+        p_membrane_cell->Kill();
+        TS_ASSERT_THROWS_THIS(cell_population.RemoveDeadCells(), "The membrane element cannot be deleted.");
+
+        // New nodes are appended to the mesh
+        TS_ASSERT_EQUALS(cell_population.AddNode(new Node<2>(0, false, 0.5, 0.5)), 483u);
+        TS_ASSERT_EQUALS(cell_population.GetNumNodes(), 484u);
+    }
 
     void TestVertexBasedDivisionRuleMethods() throw (Exception)
     {
@@ -35,27 +35,228 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // Needed for test framework
 #include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include <cfloat>
+#include <climits>
 
 #include "CheckpointArchiveTypes.hpp"
 #include "FileComparison.hpp"
 #include "CellsGenerator.hpp"
 #include "UniformlyDistributedCellCycleModel.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "SmartPointers.hpp"
 
 // Includes from projects/ImmersedBoundary
 #include "ImmersedBoundaryCellCellInteractionForce.hpp"
 #include "ImmersedBoundaryMembraneElasticityForce.hpp"
 #include "ImmersedBoundaryPalisadeMeshGenerator.hpp"
+#include "ImmersedBoundaryPairPotentials.hpp"
+#include "ImmersedBoundaryRingKernel.hpp"
 
 // This test is never run in parallel
 #include "FakePetscSetup.hpp"
 
-class TestImmersedBoundaryForces : public CxxTest::TestSuite
+class TestImmersedBoundaryForces : public AbstractCellBasedTestSuite
 {
 public:
 
     void TestImmersedBoundaryCellCellInteractionForceMethods() throw (Exception)
     {
-        ///\todo Test this class
+        ImmersedBoundaryCellCellInteractionForce<2> force;
+
+        // Test default pair law and lookup table settings
+        TS_ASSERT(force.IsLinearSpringLaw());
+        TS_ASSERT_EQUALS(force.GetPairLaw(), LINEAR_SPRING_LAW);
+        TS_ASSERT_EQUALS(force.GetUseLookupTable(), false);
+        TS_ASSERT_EQUALS(force.GetNumLookupTableIntervals(), 1000u);
+
+        force.UseLennardJonesPotential();
+        TS_ASSERT(force.IsLennardJonesPotential());
+        TS_ASSERT(!force.IsLinearSpringLaw());
+
+        force.UsePiecewiseLinearLaw();
+        TS_ASSERT(force.IsPiecewiseLinearLaw());
+        TS_ASSERT(!force.IsLennardJonesPotential());
+
+        force.SetUseLookupTable(true);
+        force.SetNumLookupTableIntervals(500);
+        TS_ASSERT_EQUALS(force.GetUseLookupTable(), true);
+        TS_ASSERT_EQUALS(force.GetNumLookupTableIntervals(), 500u);
+    }
+
+    void TestCellCellInteractionForceProteinLevels() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(0.01, 10);
+
+        // Create an immersed boundary cell population
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+
+        ImmersedBoundaryCellCellInteractionForce<2> force;
+        std::vector<std::pair<Node<2>*, Node<2>*> > node_pairs;
+
+        // The first call stores the protein levels in the mesh and initialises them
+        force.AddImmersedBoundaryForceContribution(node_pairs, cell_population);
+        TS_ASSERT_EQUALS(p_mesh->GetNumProteinSpecies(), 3u);
+        TS_ASSERT_EQUALS(force.rGetProteinSpeciesIndices().size(), 3u);
+
+        std::vector<double>& r_e_cad = p_mesh->rGetModifiableProteinLevels(force.rGetProteinSpeciesIndices()[0]);
+        TS_ASSERT_EQUALS(r_e_cad.size(), p_mesh->GetNumNodes());
+        TS_ASSERT_DELTA(r_e_cad[0], 1.0, 1e-12);
+        TS_ASSERT_DELTA(p_mesh->rGetProteinLevels(force.rGetProteinSpeciesIndices()[2])[0], 0.0, 1e-12);
+
+        // With no rates set, the levels do not change
+        r_e_cad[p_mesh->GetElement(1)->GetNodeGlobalIndex(0)] = 2.0;
+        force.AddImmersedBoundaryForceContribution(node_pairs, cell_population);
+        TS_ASSERT_DELTA(r_e_cad[p_mesh->GetElement(1)->GetNodeGlobalIndex(0)], 2.0, 1e-12);
+
+        // Diffusion spreads the excess to neighbouring nodes, conserving the total in the element
+        double min_spacing = DBL_MAX;
+        for (unsigned elem_idx = 0; elem_idx < p_mesh->GetNumElements(); elem_idx++)
+        {
+            min_spacing = std::min(min_spacing, p_mesh->GetAverageNodeSpacingOfElement(elem_idx, false));
+        }
+        double dt = SimulationTime::Instance()->GetTimeStep();
+        double diffusion_coefficient = 0.1 * min_spacing * min_spacing / dt;
+
+        force.SetProteinDiffusionCoefficient(diffusion_coefficient);
+        TS_ASSERT_DELTA(force.GetProteinDiffusionCoefficient(), diffusion_coefficient, 1e-12);
+
+        force.AddImmersedBoundaryForceContribution(node_pairs, cell_population);
+
+        ImmersedBoundaryElement<2,2>* p_elem = p_mesh->GetElement(1);
+        unsigned num_elem_nodes = p_elem->GetNumNodes();
+        double spacing = p_mesh->GetAverageNodeSpacingOfElement(1, false);
+        double diffusion_number = diffusion_coefficient * dt / (spacing * spacing);
+
+        TS_ASSERT_DELTA(r_e_cad[p_elem->GetNodeGlobalIndex(0)], 2.0 - 2.0 * diffusion_number, 1e-9);
+        TS_ASSERT_DELTA(r_e_cad[p_elem->GetNodeGlobalIndex(1)], 1.0 + diffusion_number, 1e-9);
+        TS_ASSERT_DELTA(r_e_cad[p_elem->GetNodeGlobalIndex(num_elem_nodes - 1)], 1.0 + diffusion_number, 1e-9);
+
+        double total = 0.0;
+        for (unsigned i = 0; i < num_elem_nodes; i++)
+        {
+            total += r_e_cad[p_elem->GetNodeGlobalIndex(i)];
+        }
+        TS_ASSERT_DELTA(total, (double)num_elem_nodes + 1.0, 1e-9);
+
+        // A node which is not in any element keeps its level
+        unsigned free_node_idx = p_mesh->AddNode(new Node<2>(0, false, 0.5, 0.5));
+        r_e_cad[free_node_idx] = 3.0;
+        force.AddImmersedBoundaryForceContribution(node_pairs, cell_population);
+        TS_ASSERT_DELTA(r_e_cad[free_node_idx], 3.0, 1e-12);
+
+        // A diffusion coefficient that is too large for the timestep throws
+        force.SetProteinDiffusionCoefficient(min_spacing * min_spacing / dt);
+        TS_ASSERT_THROWS_THIS(force.AddImmersedBoundaryForceContribution(node_pairs, cell_population),
+                              "Protein diffusion is unstable: reduce the timestep or the protein diffusion coefficient.");
+        force.SetProteinDiffusionCoefficient(0.0);
+
+        // Binding recruits E-cadherin to the closest pair of nodes in two neighbouring cells
+        Node<2>* p_node_a = NULL;
+        Node<2>* p_node_b = NULL;
+        double min_dist = DBL_MAX;
+        for (unsigned i = 0; i < p_mesh->GetElement(1)->GetNumNodes(); i++)
+        {
+            for (unsigned j = 0; j < p_mesh->GetElement(2)->GetNumNodes(); j++)
+            {
+                double dist = norm_2(p_mesh->GetVectorFromAtoB(p_mesh->GetElement(1)->GetNode(i)->rGetLocation(),
+                                                               p_mesh->GetElement(2)->GetNode(j)->rGetLocation()));
+                if (dist < min_dist)
+                {
+                    min_dist = dist;
+                    p_node_a = p_mesh->GetElement(1)->GetNode(i);
+                    p_node_b = p_mesh->GetElement(2)->GetNode(j);
+                }
+            }
+        }
+        TS_ASSERT_LESS_THAN(min_dist, cell_population.GetInteractionDistance());
+        node_pairs.push_back(std::pair<Node<2>*, Node<2>*>(p_node_a, p_node_b));
+
+        double level_a = r_e_cad[p_node_a->GetIndex()];
+        double level_b = r_e_cad[p_node_b->GetIndex()];
+
+        force.SetProteinBindingRate(10.0);
+        force.SetProteinUnbindingRate(1.0);
+        TS_ASSERT_DELTA(force.GetProteinBindingRate(), 10.0, 1e-12);
+        TS_ASSERT_DELTA(force.GetProteinUnbindingRate(), 1.0, 1e-12);
+        TS_ASSERT_DELTA(force.GetMaxProteinLevel(), 2.0, 1e-12);
+
+        force.AddImmersedBoundaryForceContribution(node_pairs, cell_population);
+
+        TS_ASSERT_DELTA(r_e_cad[p_node_a->GetIndex()],
+                        level_a + dt * (10.0 * level_b * (2.0 - level_a) - (level_a - 1.0)), 1e-12);
+        TS_ASSERT_DELTA(r_e_cad[p_node_b->GetIndex()],
+                        level_b + dt * (10.0 * level_a * (2.0 - level_b) - (level_b - 1.0)), 1e-12);
+    }
+
+    void TestPairPotentials() throw (Exception)
+    {
+        double rest_length = 0.25;
+        double cutoff = 1.0;
+
+        LinearSpringPairLaw linear(rest_length);
+        MorsePairLaw morse(rest_length, 0.25 * cutoff);
+        LennardJonesPairLaw lennard_jones(rest_length);
+        PiecewiseLinearPairLaw piecewise(rest_length, cutoff);
+
+        // Each law vanishes at the rest length
+        TS_ASSERT_DELTA(linear.Evaluate(rest_length), 0.0, 1e-12);
+        TS_ASSERT_DELTA(morse.Evaluate(rest_length), 0.0, 1e-12);
+        TS_ASSERT_DELTA(lennard_jones.Evaluate(rest_length), 0.0, 1e-12);
+        TS_ASSERT_DELTA(piecewise.Evaluate(rest_length), 0.0, 1e-12);
+
+        // Each law is repulsive below the rest length and attractive above it
+        TS_ASSERT_LESS_THAN(morse.Evaluate(0.2), 0.0);
+        TS_ASSERT_LESS_THAN(0.0, morse.Evaluate(0.3));
+        TS_ASSERT_LESS_THAN(lennard_jones.Evaluate(0.2), 0.0);
+        TS_ASSERT_LESS_THAN(0.0, lennard_jones.Evaluate(0.3));
+
+        // Test slopes at the rest length by central differences
+        double h = 1e-6;
+        TS_ASSERT_DELTA((lennard_jones.Evaluate(rest_length + h) - lennard_jones.Evaluate(rest_length - h)) / (2.0 * h), 1.0, 1e-5);
+        TS_ASSERT_DELTA((morse.Evaluate(rest_length + h) - morse.Evaluate(rest_length - h)) / (2.0 * h), 2.0, 1e-5);
+
+        // The Lennard-Jones law is held constant within its core, and the piecewise law vanishes at the cutoff
+        TS_ASSERT_DELTA(lennard_jones.Evaluate(0.0), lennard_jones.Evaluate(0.5 * rest_length), 1e-12);
+        TS_ASSERT_DELTA(piecewise.Evaluate(0.625), 0.375, 1e-12);
+        TS_ASSERT_DELTA(piecewise.Evaluate(cutoff), 0.0, 1e-12);
+        TS_ASSERT_DELTA(piecewise.Evaluate(0.8125), 0.1875, 1e-12);
+
+        // Batched evaluation should agree exactly with evaluation one distance at a time
+        std::vector<double> distances;
+        for (unsigned i = 0; i < 37; i++)
+        {
+            distances.push_back(0.01 + 0.025 * (double)i);
+        }
+        std::vector<double> magnitudes(distances.size());
+        morse.EvaluateBatch(&distances[0], &magnitudes[0], distances.size());
+        for (unsigned i = 0; i < distances.size(); i++)
+        {
+            TS_ASSERT_DELTA(magnitudes[i], morse.Evaluate(distances[i]), 1e-15);
+        }
+
+        // A lookup table should reproduce table entries exactly, and interpolate accurately between them
+        TabulatedPairLaw table;
+        TS_ASSERT_EQUALS(table.IsTabulated(), false);
+        table.Tabulate(morse, cutoff, 1000);
+        TS_ASSERT_EQUALS(table.IsTabulated(), true);
+
+        TS_ASSERT_DELTA(table.Evaluate(0.5), morse.Evaluate(0.5), 1e-12);
+        TS_ASSERT_DELTA(table.Evaluate(cutoff), morse.Evaluate(cutoff), 1e-12);
+        for (unsigned i = 0; i < distances.size(); i++)
+        {
+            TS_ASSERT_DELTA(table.Evaluate(distances[i] + 3e-4), morse.Evaluate(distances[i] + 3e-4), 1e-4);
+        }
+
+        // Distances beyond the cutoff take the value at the cutoff
+        TS_ASSERT_DELTA(table.Evaluate(2.0 * cutoff), morse.Evaluate(cutoff), 1e-12);
     }
 
     void TestArchivingOfImmersedBoundaryCellCellInteractionForce() throw (Exception)
@@ -75,6 +276,18 @@ public:
             force.SetRestLength(3.4);
             force.UseMorsePotential();
 
+            // Evaluating the force once adds its protein species to the mesh, which are archived by the mesh
+            ImmersedBoundaryPalisadeMeshGenerator gen(3, 50, 0.2, 2.0, 0.0, false);
+            std::vector<CellPtr> cells;
+            MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+            CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+            cells_generator.GenerateBasicRandom(cells, gen.GetMesh()->GetNumElements(), p_diff_type);
+            ImmersedBoundaryCellPopulation<2> cell_population(*(gen.GetMesh()), cells);
+
+            std::vector<std::pair<Node<2>*, Node<2>*> > node_pairs;
+            force.AddImmersedBoundaryForceContribution(node_pairs, cell_population);
+            force.SetRestLength(3.4);
+
             // Serialize via pointer to most abstract class possible
             AbstractImmersedBoundaryForce<2>* const p_force = &force;
             output_arch << p_force;
@@ -96,6 +309,11 @@ public:
             TS_ASSERT_EQUALS(static_cast<ImmersedBoundaryCellCellInteractionForce<2>*>(p_force)->IsLinearSpringLaw(), false);
             TS_ASSERT_EQUALS(static_cast<ImmersedBoundaryCellCellInteractionForce<2>*>(p_force)->IsMorsePotential(), true);
 
+            // The protein species are not added to the mesh again after a restart
+            const std::vector<unsigned>& r_species = static_cast<ImmersedBoundaryCellCellInteractionForce<2>*>(p_force)->rGetProteinSpeciesIndices();
+            TS_ASSERT_EQUALS(r_species.size(), 3u);
+            TS_ASSERT_EQUALS(r_species[2], 2u);
+
             // Tidy up
             delete p_force;
         }
@@ -103,7 +321,98 @@ public:
 
     void TestImmersedBoundaryMembraneElasticityForce() throw (Exception)
     {
-        ///\todo Test this class
+        // Create an immersed boundary cell population, with a basement lamina
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+
+        ImmersedBoundaryMembraneElasticityForce<2> force;
+        std::vector<std::pair<Node<2>*, Node<2>*> > node_pairs;
+
+        TS_ASSERT_EQUALS(force.GetMaxNodesPerWorkItem(), 256u);
+        TS_ASSERT_THROWS_THIS(force.SetMaxNodesPerWorkItem(0), "The maximum number of nodes per work item must be positive.");
+
+        // Calculate the forces with each element in a single work item
+        force.SetMaxNodesPerWorkItem(UINT_MAX);
+        force.AddImmersedBoundaryForceContribution(node_pairs, cell_population);
+
+        std::vector<c_vector<double, 2> > unsplit_forces;
+        for (unsigned node_idx = 0; node_idx < p_mesh->GetNumNodes(); node_idx++)
+        {
+            unsplit_forces.push_back(p_mesh->GetNode(node_idx)->rGetAppliedForce());
+            p_mesh->GetNode(node_idx)->ClearAppliedForce();
+        }
+
+        // The forces on each element sum to zero, and the membrane element is not at rest
+        for (unsigned elem_idx = 0; elem_idx < p_mesh->GetNumElements(); elem_idx++)
+        {
+            ImmersedBoundaryElement<2,2>* p_elem = p_mesh->GetElement(elem_idx);
+
+            c_vector<double, 2> total_force = zero_vector<double>(2);
+            double max_force = 0.0;
+            for (unsigned local_idx = 0; local_idx < p_elem->GetNumNodes(); local_idx++)
+            {
+                total_force += unsplit_forces[p_elem->GetNodeGlobalIndex(local_idx)];
+                max_force = std::max(max_force, norm_2(unsplit_forces[p_elem->GetNodeGlobalIndex(local_idx)]));
+            }
+            TS_ASSERT_DELTA(norm_2(total_force), 0.0, 1e-9 * max_force);
+        }
+
+        // Splitting the elements into many small work items gives the same forces
+        force.SetMaxNodesPerWorkItem(7);
+        force.AddImmersedBoundaryForceContribution(node_pairs, cell_population);
+
+        for (unsigned node_idx = 0; node_idx < p_mesh->GetNumNodes(); node_idx++)
+        {
+            TS_ASSERT_DELTA(p_mesh->GetNode(node_idx)->rGetAppliedForce()[0], unsplit_forces[node_idx][0], 1e-12);
+            TS_ASSERT_DELTA(p_mesh->GetNode(node_idx)->rGetAppliedForce()[1], unsplit_forces[node_idx][1], 1e-12);
+        }
+    }
+
+    void TestImmersedBoundaryRingKernel() throw (Exception)
+    {
+        // The minimum image agrees with the mesh
+        TS_ASSERT_DELTA(ImmersedBoundaryRingKernel<2>::MinimumImage(0.3), 0.3, 1e-15);
+        TS_ASSERT_DELTA(ImmersedBoundaryRingKernel<2>::MinimumImage(-0.3), -0.3, 1e-15);
+        TS_ASSERT_DELTA(ImmersedBoundaryRingKernel<2>::MinimumImage(0.9), -0.1, 1e-15);
+        TS_ASSERT_DELTA(ImmersedBoundaryRingKernel<2>::MinimumImage(-0.8), 0.2, 1e-15);
+
+        // A square ring of side 0.2 straddling the periodic boundary, with unit spring constant and rest length 0.1
+        double ring[8] = {0.9, 0.9, 0.1, 0.9, 0.1, 0.1, 0.9, 0.1};
+
+        // Gather the whole ring, with halo nodes, and calculate the forces
+        double locations[12];
+        for (unsigned i = 0; i < 6; i++)
+        {
+            unsigned local_idx = (i + 3) % 4;
+            locations[2 * i] = ring[2 * local_idx];
+            locations[2 * i + 1] = ring[2 * local_idx + 1];
+        }
+
+        double forces[8];
+        ImmersedBoundaryRingKernel<2>::CalculateChainForces(locations, 4, 1.0, 0.1, forces);
+
+        // Each node is pulled towards the centre of the square by two springs with tension 0.1
+        TS_ASSERT_DELTA(forces[0], 0.1, 1e-12);
+        TS_ASSERT_DELTA(forces[1], 0.1, 1e-12);
+        TS_ASSERT_DELTA(forces[2], -0.1, 1e-12);
+        TS_ASSERT_DELTA(forces[3], 0.1, 1e-12);
+        TS_ASSERT_DELTA(forces[4], -0.1, 1e-12);
+        TS_ASSERT_DELTA(forces[5], -0.1, 1e-12);
+        TS_ASSERT_DELTA(forces[6], 0.1, 1e-12);
+        TS_ASSERT_DELTA(forces[7], -0.1, 1e-12);
+
+        // A chain of two nodes taken from the middle of the ring gives the same forces on those nodes
+        double chain_forces[4];
+        ImmersedBoundaryRingKernel<2>::CalculateChainForces(locations + 2, 2, 1.0, 0.1, chain_forces);
+        for (unsigned i = 0; i < 4; i++)
+        {
+            TS_ASSERT_DELTA(chain_forces[i], forces[2 + i], 1e-12);
+        }
     }
 
     void TestArchivingOfImmersedBoundaryMembraneElasticityForce() throw (Exception)
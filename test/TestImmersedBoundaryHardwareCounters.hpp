@@ -0,0 +1,100 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for test framework
+#include <cxxtest/TestSuite.h>
+
+// Includes from projects/ImmersedBoundary
+#include "ImmersedBoundaryHardwareCounters.hpp"
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+class TestImmersedBoundaryHardwareCounters : public CxxTest::TestSuite
+{
+public:
+
+    void TestCounterNames() throw(Exception)
+    {
+        TS_ASSERT_EQUALS(ImmersedBoundaryHardwareCounters::GetCounterName(ImmersedBoundaryHardwareCounters::CYCLES), "Cycles");
+        TS_ASSERT_EQUALS(ImmersedBoundaryHardwareCounters::GetCounterName(ImmersedBoundaryHardwareCounters::INSTRUCTIONS), "Instructions");
+        TS_ASSERT_EQUALS(ImmersedBoundaryHardwareCounters::GetCounterName(ImmersedBoundaryHardwareCounters::CACHE_MISSES), "CacheMisses");
+        TS_ASSERT_EQUALS(ImmersedBoundaryHardwareCounters::GetCounterName(ImmersedBoundaryHardwareCounters::BRANCH_MISSES), "BranchMisses");
+        TS_ASSERT_THROWS_THIS(ImmersedBoundaryHardwareCounters::GetCounterName(ImmersedBoundaryHardwareCounters::NUM_COUNTERS),
+                              "There is no hardware counter with index 4.");
+    }
+
+    void TestOpenAndRead() throw(Exception)
+    {
+        ImmersedBoundaryHardwareCounters counters;
+        TS_ASSERT_EQUALS(counters.IsOpen(), false);
+        TS_ASSERT_EQUALS(counters.WasMultiplexed(), false);
+
+        // Nothing can be read before the counters are opened
+        std::vector<double> start_values;
+        TS_ASSERT_EQUALS(counters.Read(start_values), false);
+
+        // Counters are often unavailable, for example in containers, in which case they stay closed
+        bool is_available = counters.Open();
+        TS_ASSERT_EQUALS(counters.IsOpen(), is_available);
+
+        if (is_available)
+        {
+            TS_ASSERT(counters.Read(start_values));
+            TS_ASSERT_EQUALS(start_values.size(), ImmersedBoundaryHardwareCounters::NUM_COUNTERS);
+
+            // Do some work that the compiler cannot optimise away
+            volatile double sum = 0.0;
+            for (unsigned i = 0; i < 100000; i++)
+            {
+                sum += 0.5 * i;
+            }
+
+            std::vector<double> end_values;
+            TS_ASSERT(counters.Read(end_values));
+
+            // At least one instruction per loop iteration must have been counted
+            TS_ASSERT(end_values[ImmersedBoundaryHardwareCounters::INSTRUCTIONS] - start_values[ImmersedBoundaryHardwareCounters::INSTRUCTIONS] > 1e5);
+            TS_ASSERT(end_values[ImmersedBoundaryHardwareCounters::CYCLES] > start_values[ImmersedBoundaryHardwareCounters::CYCLES]);
+
+            // Opening again has no effect
+            TS_ASSERT(counters.Open());
+        }
+
+        counters.Close();
+        TS_ASSERT_EQUALS(counters.IsOpen(), false);
+        TS_ASSERT_EQUALS(counters.Read(start_values), false);
+    }
+};
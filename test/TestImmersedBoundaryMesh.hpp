@@ -36,7 +36,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Needed for test framework
 #include <cxxtest/cxxtest/TestSuite.h>
 
+#include <fstream>
+
 #include "ImmersedBoundaryMesh.hpp"
+#include "OutputFileHandler.hpp"
+#include "RandomNumberGenerator.hpp"
 
 // This test is never run in parallel
 #include "FakePetscSetup.hpp"
@@ -136,4 +140,683 @@ public:
                             0.0, 1e-9);
         }
     }
+
+    void TestNodeElementIndices() throw(Exception)
+    {
+        // Two regular 20-gons, with nodes ordered anticlockwise
+        std::vector<Node<2>*> nodes;
+        std::vector<ImmersedBoundaryElement<2, 2>*> elems;
+
+        for (unsigned elem_idx = 0; elem_idx < 2; elem_idx++)
+        {
+            std::vector<Node<2>*> elem_nodes;
+            for (unsigned i = 0; i < 20; i++)
+            {
+                double theta = 2.0 * M_PI * (double)i / 20.0;
+                double x = 0.3 + 0.4 * (double)elem_idx + 0.1 * cos(theta);
+                double y = 0.3 + 0.1 * sin(theta);
+
+                nodes.push_back(new Node<2>(nodes.size(), true, x, y));
+                elem_nodes.push_back(nodes.back());
+            }
+            elems.push_back(new ImmersedBoundaryElement<2, 2>(elem_idx, elem_nodes));
+        }
+
+        ImmersedBoundaryMesh<2, 2> mesh(nodes, elems);
+
+        // Each node should know the single element containing it
+        TS_ASSERT_EQUALS(mesh.rGetNodeElementIndices().size(), 40u);
+        for (unsigned node_idx = 0; node_idx < mesh.GetNumNodes(); node_idx++)
+        {
+            unsigned expected_elem_idx = node_idx < 20 ? 0 : 1;
+            TS_ASSERT_EQUALS(mesh.GetElementIndexOfNode(node_idx), expected_elem_idx);
+            TS_ASSERT_EQUALS(*(mesh.GetNode(node_idx)->ContainingElementsBegin()), expected_elem_idx);
+        }
+
+        // Divide the second element: the new nodes should be recorded against the new element
+        mesh.SetElementDivisionSpacing(0.01);
+
+        c_vector<double, 2> axis;
+        axis[0] = 0.0;
+        axis[1] = 1.0;
+
+        unsigned new_elem_idx = mesh.DivideElementAlongGivenAxis(mesh.GetElement(1), axis);
+        TS_ASSERT_EQUALS(new_elem_idx, 2u);
+
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 60u);
+        TS_ASSERT_EQUALS(mesh.rGetNodeElementIndices().size(), 60u);
+        for (unsigned node_idx = 0; node_idx < mesh.GetNumNodes(); node_idx++)
+        {
+            TS_ASSERT_EQUALS(mesh.GetElementIndexOfNode(node_idx), *(mesh.GetNode(node_idx)->ContainingElementsBegin()));
+        }
+        TS_ASSERT_EQUALS(mesh.GetElementIndexOfNode(59), 2u);
+    }
+
+    void TestElementGeometries() throw(Exception)
+    {
+        /*
+         * Three regular 20-gons: the first ordered anticlockwise, the second ordered clockwise, and the third
+         * straddling the periodic boundary at x = 1.
+         */
+        std::vector<Node<2>*> nodes;
+        std::vector<ImmersedBoundaryElement<2, 2>*> elems;
+
+        for (unsigned elem_idx = 0; elem_idx < 3; elem_idx++)
+        {
+            std::vector<Node<2>*> elem_nodes;
+            for (unsigned i = 0; i < 20; i++)
+            {
+                double theta = 2.0 * M_PI * (double)i / 20.0;
+                if (elem_idx == 1)
+                {
+                    theta = -theta;
+                }
+                double x = fmod(0.2 + 0.35 * (double)elem_idx + 0.15 * cos(theta), 1.0);
+                double y = 0.3 + 0.05 * sin(theta);
+
+                nodes.push_back(new Node<2>(nodes.size(), true, x, y));
+                elem_nodes.push_back(nodes.back());
+            }
+            elems.push_back(new ImmersedBoundaryElement<2, 2>(elem_idx, elem_nodes));
+        }
+
+        ImmersedBoundaryMesh<2, 2> mesh(nodes, elems);
+
+        // The table is filled on first use
+        TS_ASSERT(!mesh.AreElementGeometriesValid());
+        mesh.rGetElementGeometry(0);
+        TS_ASSERT(mesh.AreElementGeometriesValid());
+
+        for (unsigned elem_idx = 0; elem_idx < mesh.GetNumElements(); elem_idx++)
+        {
+            const ImmersedBoundaryMesh<2, 2>::ElementGeometry& r_geometry = mesh.rGetElementGeometry(elem_idx);
+
+            TS_ASSERT_DELTA(r_geometry.mArea, mesh.GetVolumeOfElement(elem_idx), 1e-15);
+            TS_ASSERT_DELTA(r_geometry.mPerimeter, mesh.GetSurfaceAreaOfElement(elem_idx), 1e-15);
+            TS_ASSERT_DELTA(r_geometry.mAverageNodeSpacing, mesh.GetAverageNodeSpacingOfElement(elem_idx), 1e-15);
+
+            c_vector<double, 2> centroid = mesh.GetCentroidOfElement(elem_idx);
+            c_vector<double, 3> moments = mesh.CalculateMomentsOfElement(elem_idx);
+            ChasteCuboid<2> bounding_box = mesh.CalculateBoundingBoxOfElement(elem_idx);
+
+            for (unsigned dim = 0; dim < 2; dim++)
+            {
+                TS_ASSERT_DELTA(r_geometry.mCentroid[dim], centroid[dim], 1e-15);
+                TS_ASSERT_DELTA(r_geometry.mBoundingBoxMin[dim], bounding_box.rGetLowerCorner()[dim], 1e-15);
+                TS_ASSERT_DELTA(r_geometry.mBoundingBoxMax[dim], bounding_box.rGetUpperCorner()[dim], 1e-15);
+            }
+            for (unsigned i = 0; i < 3; i++)
+            {
+                TS_ASSERT_DELTA(r_geometry.mMoments[i], moments[i], 1e-14);
+            }
+            TS_ASSERT(r_geometry.mMoments[0] > 0.0);
+        }
+
+        // The third element straddles the boundary, so its centroid should still be at x = 0.9
+        TS_ASSERT_DELTA(mesh.rGetElementGeometry(2).mCentroid[0], 0.9, 1e-12);
+
+        // Moving a node through the mesh should invalidate the table, which is then recalculated on request
+        double old_area = mesh.rGetElementGeometry(0).mArea;
+
+        ChastePoint<2> new_location(0.38, 0.3);
+        mesh.SetNode(0, new_location);
+        TS_ASSERT(!mesh.AreElementGeometriesValid());
+
+        TS_ASSERT(mesh.rGetElementGeometry(0).mArea > old_area);
+        TS_ASSERT_DELTA(mesh.rGetElementGeometry(0).mArea, mesh.GetVolumeOfElement(0), 1e-15);
+
+        // Dividing an element should also invalidate the table, which then includes the new element
+        mesh.SetElementDivisionSpacing(0.01);
+
+        c_vector<double, 2> axis;
+        axis[0] = 0.0;
+        axis[1] = 1.0;
+
+        unsigned new_elem_idx = mesh.DivideElementAlongGivenAxis(mesh.GetElement(0), axis);
+        TS_ASSERT(!mesh.AreElementGeometriesValid());
+
+        TS_ASSERT_DELTA(mesh.rGetElementGeometry(new_elem_idx).mArea, mesh.GetVolumeOfElement(new_elem_idx), 1e-15);
+        TS_ASSERT_DELTA(mesh.rGetElementGeometry(0).mArea, mesh.GetVolumeOfElement(0), 1e-15);
+    }
+
+    void TestRemeshElements() throw(Exception)
+    {
+        /*
+         * Two circles of 20 nodes: the nodes of the first are bunched up towards its first node, and it straddles the
+         * periodic boundary at x = 1, while the nodes of the second are equally spaced.
+         */
+        std::vector<Node<2>*> nodes;
+        std::vector<ImmersedBoundaryElement<2, 2>*> elems;
+
+        for (unsigned elem_idx = 0; elem_idx < 2; elem_idx++)
+        {
+            std::vector<Node<2>*> elem_nodes;
+            for (unsigned i = 0; i < 20; i++)
+            {
+                double fraction = (double)i / 20.0;
+                double theta = elem_idx == 0 ? 2.0 * M_PI * fraction * fraction : 2.0 * M_PI * fraction;
+                double x = fmod(0.95 - 0.5 * (double)elem_idx + 0.1 * cos(theta), 1.0);
+                double y = 0.5 + 0.1 * sin(theta);
+
+                nodes.push_back(new Node<2>(nodes.size(), true, x, y));
+                nodes.back()->SetRegion(i);
+                elem_nodes.push_back(nodes.back());
+            }
+            elems.push_back(new ImmersedBoundaryElement<2, 2>(elem_idx, elem_nodes));
+        }
+
+        ImmersedBoundaryMesh<2, 2> mesh(nodes, elems);
+
+        TS_ASSERT(mesh.GetNodeSpacingNonUniformityOfElement(0) > 10.0);
+        TS_ASSERT_DELTA(mesh.GetNodeSpacingNonUniformityOfElement(1), 1.0, 1e-10);
+
+        TS_ASSERT_THROWS_THIS(mesh.RemeshElements(0.5), "The node spacing non-uniformity threshold must be at least 1.");
+
+        c_vector<double, 2> first_location = mesh.GetNode(0)->rGetLocation();
+        c_vector<double, 2> uniform_location = mesh.GetNode(25)->rGetLocation();
+        double old_area = mesh.rGetElementGeometry(0).mArea;
+        double old_perimeter = mesh.rGetElementGeometry(0).mPerimeter;
+
+        // Only the bunched up element should be remeshed
+        TS_ASSERT_EQUALS(mesh.RemeshElements(1.5), 1u);
+        TS_ASSERT(!mesh.AreElementGeometriesValid());
+
+        TS_ASSERT(mesh.GetNodeSpacingNonUniformityOfElement(0) < 1.2);
+        TS_ASSERT_DELTA(mesh.GetNode(25)->rGetLocation()[0], uniform_location[0], 1e-15);
+        TS_ASSERT_DELTA(mesh.GetNode(25)->rGetLocation()[1], uniform_location[1], 1e-15);
+
+        // The first node stays put, and each node keeps its region and stays within the domain
+        TS_ASSERT_DELTA(mesh.GetNode(0)->rGetLocation()[0], first_location[0], 1e-15);
+        TS_ASSERT_DELTA(mesh.GetNode(0)->rGetLocation()[1], first_location[1], 1e-15);
+        for (unsigned node_idx = 0; node_idx < 20; node_idx++)
+        {
+            TS_ASSERT_EQUALS(mesh.GetNode(node_idx)->GetRegion(), node_idx);
+            TS_ASSERT(mesh.GetNode(node_idx)->rGetLocation()[0] >= 0.0);
+            TS_ASSERT(mesh.GetNode(node_idx)->rGetLocation()[0] < 1.0);
+        }
+
+        // The new nodes lie on the old boundary, so the perimeter cannot grow and the area changes little
+        TS_ASSERT(mesh.rGetElementGeometry(0).mPerimeter <= old_perimeter + 1e-12);
+        TS_ASSERT_DELTA(mesh.rGetElementGeometry(0).mArea / old_area, 1.0, 0.05);
+
+        // A second pass finds nothing to do
+        TS_ASSERT_EQUALS(mesh.RemeshElements(1.5), 0u);
+    }
+
+    void TestAdaptNodeCounts() throw(Exception)
+    {
+        // Two circles of the same size, the first with 40 nodes and the second with 20
+        std::vector<Node<2>*> nodes;
+        std::vector<ImmersedBoundaryElement<2, 2>*> elems;
+
+        for (unsigned elem_idx = 0; elem_idx < 2; elem_idx++)
+        {
+            unsigned num_nodes = elem_idx == 0 ? 40 : 20;
+
+            std::vector<Node<2>*> elem_nodes;
+            for (unsigned i = 0; i < num_nodes; i++)
+            {
+                double theta = 2.0 * M_PI * (double)i / (double)num_nodes;
+                double x = 0.25 + 0.5 * (double)elem_idx + 0.1 * cos(theta);
+                double y = 0.5 + 0.1 * sin(theta);
+
+                nodes.push_back(new Node<2>(nodes.size(), true, x, y));
+                nodes.back()->SetRegion(i);
+                elem_nodes.push_back(nodes.back());
+            }
+            elems.push_back(new ImmersedBoundaryElement<2, 2>(elem_idx, elem_nodes));
+        }
+
+        ImmersedBoundaryMesh<2, 2> mesh(nodes, elems);
+
+        // Label each node with its original index through a protein species
+        unsigned species = mesh.AddProteinSpecies(0.0);
+        for (unsigned node_idx = 0; node_idx < mesh.GetNumNodes(); node_idx++)
+        {
+            mesh.rGetModifiableProteinLevels(species)[node_idx] = (double)node_idx;
+        }
+
+        mesh.GetElement(0)->rGetCornerNodes().push_back(mesh.GetNode(10));
+        double old_reference_spacing = mesh.GetAverageNodeSpacingOfElement(0, false);
+        c_vector<double, 2> first_location = mesh.GetNode(0)->rGetLocation();
+
+        // Move the fluid source of the first element away from its centroid
+        mesh.GetElement(0)->GetFluidSource()->rGetModifiableLocation() = zero_vector<double>(2);
+
+        TS_ASSERT_THROWS_THIS(mesh.AdaptNodeCounts(0.0), "The target node spacing must be positive.");
+        TS_ASSERT_THROWS_THIS(mesh.AdaptNodeCounts(0.01, -1.0), "The node spacing tolerance must be non-negative.");
+        TS_ASSERT_THROWS_THIS(mesh.AdaptNodeCounts(0.01, 0.25, 2), "Each element must keep at least 3 nodes.");
+        TS_ASSERT_EQUALS(mesh.GetNumNodeRenumberings(), 0u);
+
+        // With the spacing of the second element as the target, only the first element should lose nodes
+        double target_spacing = mesh.GetSurfaceAreaOfElement(1) / 20.0;
+        TS_ASSERT_EQUALS(mesh.AdaptNodeCounts(target_spacing), 1u);
+        TS_ASSERT_EQUALS(mesh.GetNumNodeRenumberings(), 1u);
+
+        TS_ASSERT_EQUALS(mesh.GetElement(0)->GetNumNodes(), 20u);
+        TS_ASSERT_EQUALS(mesh.GetElement(1)->GetNumNodes(), 20u);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 40u);
+
+        // The fluid source of the adapted element is moved to its new centroid
+        c_vector<double, 2> centroid = mesh.GetCentroidOfElement(0);
+        TS_ASSERT_DELTA(mesh.GetElement(0)->GetFluidSource()->rGetLocation()[0], centroid[0], 1e-12);
+        TS_ASSERT_DELTA(mesh.GetElement(0)->GetFluidSource()->rGetLocation()[1], centroid[1], 1e-12);
+
+        // The nodes should be densely renumbered, with those of each element contiguous
+        TS_ASSERT_EQUALS(mesh.rGetNodeElementIndices().size(), 40u);
+        TS_ASSERT_EQUALS(mesh.rGetProteinLevels(species).size(), 40u);
+        for (unsigned node_idx = 0; node_idx < mesh.GetNumNodes(); node_idx++)
+        {
+            TS_ASSERT_EQUALS(mesh.GetNode(node_idx)->GetIndex(), node_idx);
+            TS_ASSERT_EQUALS(mesh.GetElementIndexOfNode(node_idx), node_idx < 20 ? 0u : 1u);
+            TS_ASSERT_EQUALS(*(mesh.GetNode(node_idx)->ContainingElementsBegin()), node_idx < 20 ? 0u : 1u);
+        }
+
+        // Each node takes its region and protein levels from the old node at the same position along the boundary
+        for (unsigned node_idx = 0; node_idx < 20; node_idx++)
+        {
+            TS_ASSERT_EQUALS(mesh.GetNode(node_idx)->GetRegion(), 2 * node_idx);
+            TS_ASSERT_DELTA(mesh.rGetProteinLevels(species)[node_idx], 2.0 * node_idx, 1e-12);
+
+            TS_ASSERT_EQUALS(mesh.GetNode(20 + node_idx)->GetRegion(), node_idx);
+            TS_ASSERT_DELTA(mesh.rGetProteinLevels(species)[20 + node_idx], 40.0 + node_idx, 1e-12);
+        }
+
+        // The first node stays put, and the corner node and reference spacing follow the new resolution
+        TS_ASSERT_DELTA(mesh.GetNode(0)->rGetLocation()[0], first_location[0], 1e-15);
+        TS_ASSERT_DELTA(mesh.GetNode(0)->rGetLocation()[1], first_location[1], 1e-15);
+        TS_ASSERT_EQUALS(mesh.GetElement(0)->rGetCornerNodes()[0], mesh.GetNode(5));
+        TS_ASSERT_DELTA(mesh.GetAverageNodeSpacingOfElement(0, false), 2.0 * old_reference_spacing, 1e-12);
+        TS_ASSERT_DELTA(mesh.GetNodeSpacingNonUniformityOfElement(0), 1.0, 1e-6);
+
+        // A second pass should find nothing to do
+        TS_ASSERT_EQUALS(mesh.AdaptNodeCounts(target_spacing), 0u);
+        TS_ASSERT_EQUALS(mesh.GetNumNodeRenumberings(), 1u);
+
+        // Very coarse targets are limited by the minimum number of nodes
+        TS_ASSERT_EQUALS(mesh.AdaptNodeCounts(1.0), 2u);
+        TS_ASSERT_EQUALS(mesh.GetElement(0)->GetNumNodes(), 8u);
+        TS_ASSERT_EQUALS(mesh.GetElement(1)->GetNumNodes(), 8u);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 16u);
+    }
+
+    void TestDivideElementsAlongGivenAxes() throw(Exception)
+    {
+        // Two identical meshes, each of three ellipses, so that dividing in a batch can be compared with one at a time
+        std::vector<Node<2>*> nodes[2];
+        std::vector<ImmersedBoundaryElement<2, 2>*> elems[2];
+
+        for (unsigned mesh_idx = 0; mesh_idx < 2; mesh_idx++)
+        {
+            for (unsigned elem_idx = 0; elem_idx < 3; elem_idx++)
+            {
+                std::vector<Node<2>*> elem_nodes;
+                for (unsigned i = 0; i < 20; i++)
+                {
+                    double theta = 2.0 * M_PI * (double)i / 20.0;
+                    double x = 0.2 + 0.3 * (double)elem_idx + 0.1 * cos(theta);
+                    double y = 0.5 + 0.08 * sin(theta);
+
+                    nodes[mesh_idx].push_back(new Node<2>(nodes[mesh_idx].size(), true, x, y));
+                    elem_nodes.push_back(nodes[mesh_idx].back());
+                }
+                elems[mesh_idx].push_back(new ImmersedBoundaryElement<2, 2>(elem_idx, elem_nodes));
+            }
+        }
+
+        ImmersedBoundaryMesh<2, 2> serial_mesh(nodes[0], elems[0]);
+        ImmersedBoundaryMesh<2, 2> batch_mesh(nodes[1], elems[1]);
+
+        std::vector<unsigned> elem_indices;
+        elem_indices.push_back(2);
+        elem_indices.push_back(0);
+
+        std::vector<c_vector<double, 2> > axes(2);
+        axes[0][0] = 0.0;
+        axes[0][1] = 1.0;
+        axes[1][0] = 1.0;
+        axes[1][1] = 2.0;
+
+        TS_ASSERT_THROWS_THIS(batch_mesh.DivideElementsAlongGivenAxes(elem_indices, std::vector<c_vector<double, 2> >(1)),
+                              "There must be one axis of division for each element to divide.");
+        TS_ASSERT_THROWS_THIS(batch_mesh.DivideElementsAlongGivenAxes(elem_indices, axes),
+                              "The value of mElementDivisionSpacing has not been set.");
+
+        std::vector<unsigned> repeated_indices(2, 1u);
+        batch_mesh.SetElementDivisionSpacing(0.01);
+        TS_ASSERT_THROWS_THIS(batch_mesh.DivideElementsAlongGivenAxes(repeated_indices, axes),
+                              "Element 1 cannot be divided more than once at a time.");
+
+        // If any division fails, the mesh is left unchanged
+        batch_mesh.SetElementDivisionSpacing(0.5);
+        c_vector<double, 2> first_location = batch_mesh.GetNode(0)->rGetLocation();
+        TS_ASSERT_THROWS_THIS(batch_mesh.DivideElementsAlongGivenAxes(elem_indices, axes),
+                              "Could not space elements far enough apart during cell division.  Cannot currently handle this case");
+        TS_ASSERT_EQUALS(batch_mesh.GetNumNodes(), 60u);
+        TS_ASSERT_EQUALS(batch_mesh.GetNumElements(), 3u);
+        TS_ASSERT_DELTA(batch_mesh.GetNode(0)->rGetLocation()[0], first_location[0], 1e-15);
+        TS_ASSERT_DELTA(batch_mesh.GetNode(0)->rGetLocation()[1], first_location[1], 1e-15);
+
+        // Divide in a batch, and one at a time in the same order
+        serial_mesh.SetElementDivisionSpacing(0.01);
+        batch_mesh.SetElementDivisionSpacing(0.01);
+
+        std::vector<unsigned> new_elem_indices = batch_mesh.DivideElementsAlongGivenAxes(elem_indices, axes);
+        TS_ASSERT_EQUALS(new_elem_indices.size(), 2u);
+        TS_ASSERT_EQUALS(new_elem_indices[0], 3u);
+        TS_ASSERT_EQUALS(new_elem_indices[1], 4u);
+        TS_ASSERT_EQUALS(batch_mesh.GetNumNodeRenumberings(), 1u);
+
+        TS_ASSERT_EQUALS(serial_mesh.DivideElementAlongGivenAxis(serial_mesh.GetElement(2), axes[0]), 3u);
+        TS_ASSERT_EQUALS(serial_mesh.DivideElementAlongGivenAxis(serial_mesh.GetElement(0), axes[1]), 4u);
+        TS_ASSERT_EQUALS(serial_mesh.GetNumNodeRenumberings(), 0u);
+
+        // The two meshes should be identical
+        TS_ASSERT_EQUALS(batch_mesh.GetNumNodes(), 100u);
+        TS_ASSERT_EQUALS(serial_mesh.GetNumNodes(), 100u);
+        TS_ASSERT_EQUALS(batch_mesh.GetNumElements(), 5u);
+        TS_ASSERT_EQUALS(batch_mesh.rGetNodeElementIndices().size(), 100u);
+
+        for (unsigned node_idx = 0; node_idx < batch_mesh.GetNumNodes(); node_idx++)
+        {
+            TS_ASSERT_DELTA(batch_mesh.GetNode(node_idx)->rGetLocation()[0], serial_mesh.GetNode(node_idx)->rGetLocation()[0], 1e-15);
+            TS_ASSERT_DELTA(batch_mesh.GetNode(node_idx)->rGetLocation()[1], serial_mesh.GetNode(node_idx)->rGetLocation()[1], 1e-15);
+            TS_ASSERT_EQUALS(batch_mesh.GetElementIndexOfNode(node_idx), serial_mesh.GetElementIndexOfNode(node_idx));
+        }
+
+        for (unsigned elem_idx = 0; elem_idx < batch_mesh.GetNumElements(); elem_idx++)
+        {
+            TS_ASSERT_EQUALS(batch_mesh.GetElement(elem_idx)->GetNumNodes(), 20u);
+
+            c_vector<double, 2> source_location = batch_mesh.GetElement(elem_idx)->GetFluidSource()->rGetLocation();
+            c_vector<double, 2> serial_source_location = serial_mesh.GetElement(elem_idx)->GetFluidSource()->rGetLocation();
+            TS_ASSERT_DELTA(source_location[0], serial_source_location[0], 1e-15);
+            TS_ASSERT_DELTA(source_location[1], serial_source_location[1], 1e-15);
+            TS_ASSERT_DELTA(source_location[0], batch_mesh.GetCentroidOfElement(elem_idx)[0], 1e-15);
+            TS_ASSERT_DELTA(source_location[1], batch_mesh.GetCentroidOfElement(elem_idx)[1], 1e-15);
+        }
+
+        // The element which was not divided is unchanged
+        TS_ASSERT_DELTA(batch_mesh.GetVolumeOfElement(1), serial_mesh.GetVolumeOfElement(1), 1e-15);
+        TS_ASSERT_EQUALS(batch_mesh.GetNumElements(), serial_mesh.GetNumElements());
+    }
+
+    void TestDeleteAndReMesh() throw(Exception)
+    {
+        // Three regular 20-gons
+        std::vector<Node<2>*> nodes;
+        std::vector<ImmersedBoundaryElement<2, 2>*> elems;
+
+        for (unsigned elem_idx = 0; elem_idx < 3; elem_idx++)
+        {
+            std::vector<Node<2>*> elem_nodes;
+            for (unsigned i = 0; i < 20; i++)
+            {
+                double theta = 2.0 * M_PI * (double)i / 20.0;
+                double x = 0.2 + 0.3 * (double)elem_idx + 0.1 * cos(theta);
+                double y = 0.5 + 0.1 * sin(theta);
+
+                nodes.push_back(new Node<2>(nodes.size(), true, x, y));
+                elem_nodes.push_back(nodes.back());
+            }
+            elems.push_back(new ImmersedBoundaryElement<2, 2>(elem_idx, elem_nodes));
+        }
+
+        ImmersedBoundaryMesh<2, 2> mesh(nodes, elems);
+
+        // Label each node with its original index through a protein species
+        unsigned species = mesh.AddProteinSpecies(0.0);
+        for (unsigned node_idx = 0; node_idx < mesh.GetNumNodes(); node_idx++)
+        {
+            mesh.rGetModifiableProteinLevels(species)[node_idx] = (double)node_idx;
+        }
+
+        // Nothing to do if nothing has been deleted
+        VertexElementMap element_map(mesh.GetNumAllElements());
+        TS_ASSERT_EQUALS(mesh.HasDeletedNodesOrElements(), false);
+        mesh.ReMesh(element_map);
+        TS_ASSERT(element_map.IsIdentityMap());
+        TS_ASSERT_EQUALS(mesh.GetNumNodeRenumberings(), 0u);
+
+        // Corner nodes may not be deleted
+        mesh.GetElement(0)->rGetCornerNodes().push_back(mesh.GetNode(10));
+        TS_ASSERT_THROWS_THIS(mesh.DeleteNodePriorToReMesh(10), "Node 10 is a corner node of element 0 and cannot be deleted.");
+
+        // Delete a node from the first element, and the whole of the second element
+        mesh.DeleteNodePriorToReMesh(5);
+        mesh.DeleteElementPriorToReMesh(1);
+
+        TS_ASSERT_EQUALS(mesh.HasDeletedNodesOrElements(), true);
+        TS_ASSERT_EQUALS(mesh.GetElement(0)->GetNumNodes(), 19u);
+        TS_ASSERT(mesh.GetNode(5)->IsDeleted());
+        TS_ASSERT(mesh.GetElement(1)->IsDeleted());
+        TS_ASSERT_DELTA(mesh.GetElement(1)->GetFluidSource()->GetStrength(), 0.0, 1e-15);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 39u);
+        TS_ASSERT_EQUALS(mesh.GetNumAllNodes(), 60u);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 2u);
+        TS_ASSERT_EQUALS(mesh.GetNumAllElements(), 3u);
+
+        c_vector<double, 2> third_elem_centroid = mesh.GetCentroidOfElement(2);
+
+        mesh.ReMesh(element_map);
+
+        // The remaining elements keep their order
+        TS_ASSERT_EQUALS(element_map.IsIdentityMap(), false);
+        TS_ASSERT_EQUALS(element_map.GetNewIndex(0), 0u);
+        TS_ASSERT(element_map.IsDeleted(1));
+        TS_ASSERT_EQUALS(element_map.GetNewIndex(2), 1u);
+        TS_ASSERT_EQUALS(mesh.HasDeletedNodesOrElements(), false);
+        TS_ASSERT_EQUALS(mesh.GetNumNodeRenumberings(), 1u);
+
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 2u);
+        TS_ASSERT_EQUALS(mesh.GetNumAllElements(), 2u);
+        TS_ASSERT_EQUALS(mesh.GetElement(1)->GetIndex(), 1u);
+        TS_ASSERT_DELTA(mesh.GetCentroidOfElement(1)[0], third_elem_centroid[0], 1e-15);
+        TS_ASSERT_DELTA(mesh.GetCentroidOfElement(1)[1], third_elem_centroid[1], 1e-15);
+
+        // The fluid sources are renumbered to match
+        TS_ASSERT_EQUALS(mesh.rGetElementFluidSources().size(), 2u);
+        for (unsigned elem_idx = 0; elem_idx < 2; elem_idx++)
+        {
+            FluidSource<2>* p_source = mesh.GetElement(elem_idx)->GetFluidSource();
+            TS_ASSERT_EQUALS(p_source, mesh.rGetElementFluidSources()[elem_idx]);
+            TS_ASSERT_EQUALS(p_source->GetIndex(), elem_idx);
+            TS_ASSERT_EQUALS(p_source->GetAssociatedElementIndex(), elem_idx);
+        }
+
+        // The nodes are densely renumbered in their existing order, and their protein levels follow them
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 39u);
+        TS_ASSERT_EQUALS(mesh.GetNumAllNodes(), 39u);
+        TS_ASSERT_EQUALS(mesh.rGetNodeElementIndices().size(), 39u);
+        TS_ASSERT_EQUALS(mesh.rGetProteinLevels(species).size(), 39u);
+        for (unsigned node_idx = 0; node_idx < mesh.GetNumNodes(); node_idx++)
+        {
+            unsigned old_node_idx = node_idx < 5 ? node_idx : (node_idx < 19 ? node_idx + 1 : node_idx + 21);
+
+            TS_ASSERT_EQUALS(mesh.GetNode(node_idx)->GetIndex(), node_idx);
+            TS_ASSERT_DELTA(mesh.rGetProteinLevels(species)[node_idx], (double)old_node_idx, 1e-15);
+            TS_ASSERT_EQUALS(mesh.GetElementIndexOfNode(node_idx), node_idx < 19 ? 0u : 1u);
+            TS_ASSERT_EQUALS(*(mesh.GetNode(node_idx)->ContainingElementsBegin()), node_idx < 19 ? 0u : 1u);
+        }
+
+        // A node added to the mesh is appended
+        TS_ASSERT_EQUALS(mesh.AddNode(new Node<2>(0, false, 0.5, 0.9)), 39u);
+        TS_ASSERT_EQUALS(mesh.GetNode(39)->GetIndex(), 39u);
+        TS_ASSERT_EQUALS(mesh.GetElementIndexOfNode(39), UINT_MAX);
+        TS_ASSERT_DELTA(mesh.rGetProteinLevels(species)[39], 0.0, 1e-15);
+    }
+    void TestNeighbourLists() throw(Exception)
+    {
+        // Three regular 20-gons in a row
+        std::vector<Node<2>*> nodes;
+        std::vector<ImmersedBoundaryElement<2, 2>*> elems;
+
+        for (unsigned elem_idx = 0; elem_idx < 3; elem_idx++)
+        {
+            std::vector<Node<2>*> elem_nodes;
+            for (unsigned i = 0; i < 20; i++)
+            {
+                double theta = 2.0 * M_PI * (double)i / 20.0;
+                double x = 0.2 + 0.3 * (double)elem_idx + 0.1 * cos(theta);
+                double y = 0.5 + 0.1 * sin(theta);
+
+                nodes.push_back(new Node<2>(nodes.size(), true, x, y));
+                elem_nodes.push_back(nodes.back());
+            }
+            elems.push_back(new ImmersedBoundaryElement<2, 2>(elem_idx, elem_nodes));
+        }
+
+        ImmersedBoundaryMesh<2, 2> mesh(nodes, elems);
+
+        // Before any lists are built, nothing has neighbours
+        TS_ASSERT(mesh.GetNeighbouringElementIndices(0).empty());
+        TS_ASSERT(mesh.GetNeighbouringNodeIndices(0).empty());
+
+        // A node outside any element
+        mesh.AddNode(new Node<2>(0, false, 0.9, 0.9));
+
+        // Two pairs between elements 0 and 1, one between elements 1 and 2, one within element 0, and one with the lone node
+        std::vector<std::pair<Node<2>*, Node<2>*> > node_pairs;
+        node_pairs.push_back(std::make_pair(mesh.GetNode(0), mesh.GetNode(30)));
+        node_pairs.push_back(std::make_pair(mesh.GetNode(29), mesh.GetNode(1)));
+        node_pairs.push_back(std::make_pair(mesh.GetNode(20), mesh.GetNode(50)));
+        node_pairs.push_back(std::make_pair(mesh.GetNode(0), mesh.GetNode(1)));
+        node_pairs.push_back(std::make_pair(mesh.GetNode(60), mesh.GetNode(45)));
+
+        mesh.UpdateNeighbourLists(node_pairs);
+
+        std::set<unsigned> expected_elements_0;
+        expected_elements_0.insert(1);
+        TS_ASSERT(mesh.GetNeighbouringElementIndices(0) == expected_elements_0);
+
+        std::set<unsigned> expected_elements_1;
+        expected_elements_1.insert(0);
+        expected_elements_1.insert(2);
+        TS_ASSERT(mesh.GetNeighbouringElementIndices(1) == expected_elements_1);
+
+        std::set<unsigned> expected_elements_2;
+        expected_elements_2.insert(1);
+        TS_ASSERT(mesh.GetNeighbouringElementIndices(2) == expected_elements_2);
+
+        // Repeated pairs between two elements give a single neighbour in each direction
+        TS_ASSERT_EQUALS(mesh.mElementNeighbourOffsets.size(), 4u);
+        TS_ASSERT_EQUALS(mesh.mElementNeighbourIndices.size(), 4u);
+
+        std::set<unsigned> expected_nodes_0;
+        expected_nodes_0.insert(1);
+        expected_nodes_0.insert(30);
+        TS_ASSERT(mesh.GetNeighbouringNodeIndices(0) == expected_nodes_0);
+
+        std::set<unsigned> expected_nodes_60;
+        expected_nodes_60.insert(45);
+        TS_ASSERT(mesh.GetNeighbouringNodeIndices(60) == expected_nodes_60);
+        TS_ASSERT(mesh.GetNeighbouringNodeIndices(2).empty());
+
+        // Nodes and elements beyond the lists have no neighbours
+        TS_ASSERT(mesh.GetNeighbouringNodeIndices(61).empty());
+        TS_ASSERT(mesh.GetNeighbouringElementIndices(3).empty());
+
+        TS_ASSERT_EQUALS(mesh.GetMemoryUsage()["NeighbourLists"],
+                         (mesh.mElementNeighbourOffsets.capacity() + mesh.mElementNeighbourIndices.capacity() +
+                          mesh.mNodeNeighbourOffsets.capacity() + mesh.mNodeNeighbourIndices.capacity()) * sizeof(unsigned));
+
+        // Renumbering empties the lists, which must then be rebuilt from new pairs
+        mesh.DeleteElementPriorToReMesh(2);
+        VertexElementMap element_map(mesh.GetNumAllElements());
+        mesh.ReMesh(element_map);
+        TS_ASSERT(mesh.GetNeighbouringElementIndices(0).empty());
+        TS_ASSERT(mesh.GetNeighbouringNodeIndices(0).empty());
+    }
+    void TestCalculateShapeMetrics() throw(Exception)
+    {
+        // A rotated ellipse, a rotated egg shape and a regular 20-gon, all convex and with nodes ordered anticlockwise
+        std::vector<Node<2>*> nodes;
+        std::vector<ImmersedBoundaryElement<2, 2>*> elems;
+
+        for (unsigned elem_idx = 0; elem_idx < 3; elem_idx++)
+        {
+            std::vector<Node<2>*> elem_nodes;
+            unsigned num_nodes = elem_idx == 2 ? 20 : 40;
+            for (unsigned i = 0; i < num_nodes; i++)
+            {
+                double theta = 2.0 * M_PI * (double)i / (double)num_nodes;
+                double x;
+                double y;
+
+                if (elem_idx == 0)
+                {
+                    double ellipse_x = 0.2 * cos(theta);
+                    double ellipse_y = 0.1 * sin(theta);
+                    x = 0.25 + cos(0.3) * ellipse_x - sin(0.3) * ellipse_y;
+                    y = 0.3 + sin(0.3) * ellipse_x + cos(0.3) * ellipse_y;
+                }
+                else if (elem_idx == 1)
+                {
+                    double egg_x = 0.15 * cos(theta);
+                    double egg_y = 0.08 * sin(theta) * (1.0 + 0.2 * cos(theta));
+                    x = 0.7 + cos(0.5) * egg_x + sin(0.5) * egg_y;
+                    y = 0.3 - sin(0.5) * egg_x + cos(0.5) * egg_y;
+                }
+                else
+                {
+                    x = 0.5 + 0.1 * cos(theta);
+                    y = 0.75 + 0.1 * sin(theta);
+                }
+
+                nodes.push_back(new Node<2>(nodes.size(), true, x, y));
+                elem_nodes.push_back(nodes.back());
+            }
+            elems.push_back(new ImmersedBoundaryElement<2, 2>(elem_idx, elem_nodes));
+        }
+
+        ImmersedBoundaryMesh<2, 2> mesh(nodes, elems);
+
+        ImmersedBoundaryMesh<2, 2>::ShapeMetrics metrics;
+        RandomNumberGenerator::Instance()->Reseed(0);
+        mesh.CalculateShapeMetrics(metrics);
+
+        TS_ASSERT_EQUALS(metrics.mElongationShapeFactors.size(), 3u);
+        TS_ASSERT_EQUALS(metrics.mShortAxesX.size(), 3u);
+        TS_ASSERT_EQUALS(metrics.mShortAxesY.size(), 3u);
+        TS_ASSERT_EQUALS(metrics.mAreaSkewnesses.size(), 3u);
+
+        // The metrics agree with those of the direct methods, as the elements are convex, and the same random short
+        // axis is drawn for the 20-gon
+        RandomNumberGenerator::Instance()->Reseed(0);
+        for (unsigned elem_idx = 0; elem_idx < 3; elem_idx++)
+        {
+            c_vector<double, 2> short_axis = mesh.GetShortAxisOfElement(elem_idx);
+            TS_ASSERT_DELTA(metrics.mShortAxesX[elem_idx], short_axis[0], 1e-10);
+            TS_ASSERT_DELTA(metrics.mShortAxesY[elem_idx], short_axis[1], 1e-10);
+
+            TS_ASSERT_DELTA(metrics.mElongationShapeFactors[elem_idx], mesh.GetElongationShapeFactorOfElement(elem_idx), 1e-10);
+            TS_ASSERT_DELTA(metrics.mAreaSkewnesses[elem_idx],
+                            mesh.GetSkewnessOfElementMassDistributionAboutAxis(elem_idx, short_axis), 1e-9);
+        }
+        TS_ASSERT_DELTA(metrics.mTortuosity, mesh.GetTortuosityOfMesh(), 1e-12);
+
+        // The ellipse is symmetric, but the egg is not
+        TS_ASSERT_DELTA(metrics.mAreaSkewnesses[0], 0.0, 1e-9);
+        TS_ASSERT(fabs(metrics.mAreaSkewnesses[1]) > 1e-3);
+        TS_ASSERT_DELTA(metrics.mElongationShapeFactors[2], 1.0, 1e-6);
+
+        // Writing the metrics gives a header row and one row per element
+        mesh.WriteShapeMetrics(metrics, "TestCalculateShapeMetrics", "shape_metrics.csv");
+
+        OutputFileHandler output_file_handler("TestCalculateShapeMetrics", false);
+        std::ifstream csv_file(output_file_handler.FindFile("shape_metrics.csv").GetAbsolutePath().c_str());
+        TS_ASSERT(csv_file.is_open());
+
+        std::string header;
+        std::getline(csv_file, header);
+        TS_ASSERT_EQUALS(header, "element,area,centroid_x,centroid_y,elongation_shape_factor,short_axis_x,short_axis_y,area_skewness");
+
+        unsigned num_rows = 0;
+        std::string row;
+        while (std::getline(csv_file, row))
+        {
+            num_rows++;
+        }
+        TS_ASSERT_EQUALS(num_rows, 3u);
+    }
 };
@@ -0,0 +1,176 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for test framework
+#include <cxxtest/TestSuite.h>
+
+// Includes from trunk
+#include "Node.hpp"
+
+// Includes from projects/ImmersedBoundary
+#include "ImmersedBoundaryObjectPool.hpp"
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+class TestImmersedBoundaryObjectPool : public CxxTest::TestSuite
+{
+public:
+
+    void TestAllocateAndFree() throw(Exception)
+    {
+        ImmersedBoundaryObjectPool<Node<2> > pool(2);
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 0u);
+        TS_ASSERT_EQUALS(pool.GetNumBlocks(), 0u);
+        TS_ASSERT_EQUALS(pool.GetCapacity(), 0u);
+
+        // Blocks double in size as the pool fills up: 2 + 4 + 8
+        std::vector<Node<2>*> nodes;
+        for (unsigned i = 0; i < 7; i++)
+        {
+            nodes.push_back(new (pool.Allocate()) Node<2>(i, false, 0.1 * i, 0.2));
+        }
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 7u);
+        TS_ASSERT_EQUALS(pool.GetNumBlocks(), 3u);
+        TS_ASSERT_EQUALS(pool.GetCapacity(), 14u);
+
+        for (unsigned i = 0; i < 7; i++)
+        {
+            TS_ASSERT(pool.Owns(nodes[i]));
+            TS_ASSERT_EQUALS(nodes[i]->GetIndex(), i);
+            TS_ASSERT_DELTA(nodes[i]->rGetLocation()[0], 0.1 * i, 1e-12);
+        }
+
+        // Objects from the same block are contiguous
+        TS_ASSERT_EQUALS(nodes[3] - nodes[2], 1);
+
+        // A freed slot is reused by the next allocation
+        Node<2>* p_freed = nodes[4];
+        pool.Free(nodes[4]);
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 6u);
+        nodes[4] = new (pool.Allocate()) Node<2>(4, false, 0.5, 0.5);
+        TS_ASSERT_EQUALS(nodes[4], p_freed);
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 7u);
+        TS_ASSERT_EQUALS(pool.GetCapacity(), 14u);
+
+        // Objects created with new are not owned by the pool, but may still be freed through it
+        Node<2>* p_heap_node = new Node<2>(7, false, 0.0, 0.0);
+        TS_ASSERT(!pool.Owns(p_heap_node));
+        pool.Free(p_heap_node);
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 7u);
+
+        // Freeing NULL does nothing
+        pool.Free(NULL);
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 7u);
+
+        for (unsigned i = 0; i < 7; i++)
+        {
+            pool.Free(nodes[i]);
+        }
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 0u);
+
+        pool.Release();
+        TS_ASSERT_EQUALS(pool.GetNumBlocks(), 0u);
+        TS_ASSERT_EQUALS(pool.GetCapacity(), 0u);
+    }
+
+    void TestReserve() throw(Exception)
+    {
+        ImmersedBoundaryObjectPool<Node<2> > pool(4);
+
+        // Reserving within the free capacity allocates nothing more
+        pool.Reserve(3);
+        TS_ASSERT_EQUALS(pool.GetNumBlocks(), 1u);
+        TS_ASSERT_EQUALS(pool.GetCapacity(), 4u);
+        pool.Reserve(4);
+        TS_ASSERT_EQUALS(pool.GetNumBlocks(), 1u);
+
+        Node<2>* p_first = new (pool.Allocate()) Node<2>(0, false, 0.0, 0.0);
+
+        // Reserving more than remains allocates a single block large enough for all the further objects
+        pool.Reserve(100);
+        TS_ASSERT_EQUALS(pool.GetNumBlocks(), 2u);
+        TS_ASSERT_EQUALS(pool.GetCapacity(), 104u);
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i = 0; i < 100; i++)
+        {
+            nodes.push_back(new (pool.Allocate()) Node<2>(i + 1, false, 0.0, 0.0));
+        }
+        TS_ASSERT_EQUALS(pool.GetNumBlocks(), 2u);
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 101u);
+
+        // The three slots left over in the first block are used first, in order, and the rest are contiguous
+        TS_ASSERT_EQUALS(nodes[0] - p_first, 1);
+        TS_ASSERT_EQUALS(nodes[2] - p_first, 3);
+        TS_ASSERT_EQUALS(nodes[99] - nodes[3], 96);
+        TS_ASSERT_EQUALS(pool.GetCapacity(), 104u);
+
+        pool.Free(p_first);
+        for (unsigned i = 0; i < nodes.size(); i++)
+        {
+            pool.Free(nodes[i]);
+        }
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 0u);
+
+        // The destructor releases the storage
+    }
+
+    void TestSwap() throw(Exception)
+    {
+        ImmersedBoundaryObjectPool<Node<2> > pool(4);
+        std::vector<Node<2>*> nodes;
+        for (unsigned i = 0; i < 3; i++)
+        {
+            nodes.push_back(new (pool.Allocate()) Node<2>(i, false, 0.0, 0.0));
+        }
+
+        // Objects constructed in one pool can be handed over to another
+        ImmersedBoundaryObjectPool<Node<2> > other_pool;
+        other_pool.Swap(pool);
+        TS_ASSERT_EQUALS(pool.GetNumObjects(), 0u);
+        TS_ASSERT_EQUALS(pool.GetNumBlocks(), 0u);
+        TS_ASSERT_EQUALS(other_pool.GetNumObjects(), 3u);
+        TS_ASSERT_EQUALS(other_pool.GetCapacity(), 4u);
+
+        for (unsigned i = 0; i < nodes.size(); i++)
+        {
+            TS_ASSERT(!pool.Owns(nodes[i]));
+            TS_ASSERT(other_pool.Owns(nodes[i]));
+            other_pool.Free(nodes[i]);
+        }
+        TS_ASSERT_EQUALS(other_pool.GetNumObjects(), 0u);
+    }
+};
@@ -0,0 +1,161 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for test framework
+#include <cxxtest/TestSuite.h>
+#include "OutputFileHandler.hpp"
+#include "FileFinder.hpp"
+
+#include <fstream>
+#include <iterator>
+
+// Includes from projects/ImmersedBoundary
+#include "ImmersedBoundaryPerformanceGate.hpp"
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+class TestImmersedBoundaryPerformanceGate : public CxxTest::TestSuite
+{
+public:
+
+    void TestMedianAndMad() throw(Exception)
+    {
+        std::vector<double> values;
+        TS_ASSERT_THROWS_THIS(ImmersedBoundaryPerformanceGate::CalculateMedian(values), "Cannot calculate the median of no values.");
+
+        values.push_back(1.0);
+        values.push_back(1.1);
+        values.push_back(0.9);
+        values.push_back(1.05);
+        values.push_back(0.95);
+        TS_ASSERT_DELTA(ImmersedBoundaryPerformanceGate::CalculateMedian(values), 1.0, 1e-12);
+        TS_ASSERT_DELTA(ImmersedBoundaryPerformanceGate::CalculateMedianAbsoluteDeviation(values), 0.05, 1e-12);
+
+        // A single outlier does not move the median or MAD far
+        values.push_back(100.0);
+        TS_ASSERT_DELTA(ImmersedBoundaryPerformanceGate::CalculateMedian(values), 1.025, 1e-12);
+        TS_ASSERT_DELTA(ImmersedBoundaryPerformanceGate::CalculateMedianAbsoluteDeviation(values), 0.075, 1e-12);
+    }
+
+    void TestCompareWithBaseline() throw(Exception)
+    {
+        ImmersedBoundaryPerformanceGate gate;
+        TS_ASSERT_DELTA(gate.GetRelativeThreshold(), 0.2, 1e-12);
+        TS_ASSERT_DELTA(gate.GetNumMads(), 3.0, 1e-12);
+
+        TS_ASSERT_THROWS_THIS(gate.SetRelativeThreshold(-1.0), "The relative threshold must be non-negative.");
+        TS_ASSERT_THROWS_THIS(gate.SetNumMads(-1.0), "The number of MADs must be non-negative.");
+
+        double noise[5] = {0.0, 0.1, -0.1, 0.05, -0.05};
+        for (unsigned i = 0; i < 5; i++)
+        {
+            gate.AddSample("Setup", "Unchanged", 1.0 + noise[i]);
+            gate.AddSample("Setup", "Slower", 2.0 + noise[i]);
+            gate.AddSample("Setup", "Faster", 1.0 + noise[i]);
+            gate.AddSample("Setup", "Noisy", 1.3 + 4.0 * noise[i]);
+            gate.AddSample("Setup", "New", 1.0 + noise[i]);
+        }
+
+        gate.AddBaseline("Setup", "Unchanged", 1.0, 0.05);
+        gate.AddBaseline("Setup", "Slower", 1.0, 0.05);
+        gate.AddBaseline("Setup", "Faster", 2.0, 0.05);
+        gate.AddBaseline("Setup", "Noisy", 1.0, 0.05);
+
+        // Comparisons are ordered by setup, then phase
+        std::vector<ImmersedBoundaryPerformanceGate::PhaseComparison> comparisons = gate.Compare();
+        TS_ASSERT_EQUALS(comparisons.size(), 5u);
+        TS_ASSERT_EQUALS(comparisons[0].mPhase, "Faster");
+        TS_ASSERT_EQUALS(comparisons[0].mRegressed, false);
+        TS_ASSERT_EQUALS(comparisons[1].mPhase, "New");
+        TS_ASSERT_DELTA(comparisons[1].mBaselineMedian, -1.0, 1e-12);
+        TS_ASSERT_EQUALS(comparisons[1].mRegressed, false);
+        TS_ASSERT_EQUALS(comparisons[2].mPhase, "Noisy");
+        TS_ASSERT_EQUALS(comparisons[2].mRegressed, false);
+        TS_ASSERT_EQUALS(comparisons[3].mPhase, "Slower");
+        TS_ASSERT_EQUALS(comparisons[3].mRegressed, true);
+        TS_ASSERT_DELTA(comparisons[3].mCurrentMedian, 2.0, 1e-12);
+        TS_ASSERT_EQUALS(comparisons[4].mPhase, "Unchanged");
+        TS_ASSERT_EQUALS(comparisons[4].mRegressed, false);
+
+        TS_ASSERT_EQUALS(gate.GetNumRegressions(), 1u);
+        TS_ASSERT_EQUALS(gate.GetNumPhasesMissingFromBaseline(), 1u);
+        TS_ASSERT(gate.GetUnmeasuredBaselinePhases().empty());
+
+        // With no noise allowance the noisy phase is flagged too
+        gate.SetNumMads(0.0);
+        TS_ASSERT_EQUALS(gate.GetNumRegressions(), 2u);
+        gate.SetNumMads(3.0);
+
+        // The current results can be read back as a baseline, against which nothing has regressed
+        OutputFileHandler output_file_handler("TestImmersedBoundaryPerformanceGate", false);
+        std::string results_dir = output_file_handler.GetOutputDirectoryFullPath();
+        gate.WriteResults(results_dir + "results.json");
+
+        ImmersedBoundaryPerformanceGate new_gate;
+        new_gate.LoadBaseline(results_dir + "results.json");
+        for (unsigned i = 0; i < 5; i++)
+        {
+            new_gate.AddSample("Setup", "Slower", 2.0 + noise[i]);
+        }
+        TS_ASSERT_EQUALS(new_gate.GetNumRegressions(), 0u);
+
+        TS_ASSERT_THROWS_CONTAINS(new_gate.LoadBaseline(results_dir + "missing.json"), "Could not read the performance baseline");
+
+        // The report lists each phase with its status
+        gate.WriteReport(results_dir + "report.txt");
+        std::ifstream report_file((results_dir + "report.txt").c_str());
+        std::string report((std::istreambuf_iterator<char>(report_file)), std::istreambuf_iterator<char>());
+        TS_ASSERT(report.find("REGRESSED") != std::string::npos);
+        TS_ASSERT(report.find("improved") != std::string::npos);
+        TS_ASSERT(report.find("NEW") != std::string::npos);
+        TS_ASSERT(report.find("1 regression(s) found") != std::string::npos);
+        TS_ASSERT(report.find("1 phase(s) missing from the baseline") != std::string::npos);
+
+        // Baseline phases which are not run are listed
+        gate.AddBaseline("Setup", "Removed", 1.0, 0.05);
+        gate.AddBaseline("OtherSetup", "Phase", 1.0, 0.05);
+        std::vector<std::string> unmeasured_phases = gate.GetUnmeasuredBaselinePhases();
+        TS_ASSERT_EQUALS(unmeasured_phases.size(), 2u);
+        TS_ASSERT_EQUALS(unmeasured_phases[0], "OtherSetup/Phase");
+        TS_ASSERT_EQUALS(unmeasured_phases[1], "Setup/Removed");
+
+        gate.WriteReport(results_dir + "report_unmeasured.txt");
+        std::ifstream unmeasured_report_file((results_dir + "report_unmeasured.txt").c_str());
+        std::string unmeasured_report((std::istreambuf_iterator<char>(unmeasured_report_file)), std::istreambuf_iterator<char>());
+        TS_ASSERT(unmeasured_report.find("NOT RUN") != std::string::npos);
+        TS_ASSERT(unmeasured_report.find("2 baseline phase(s) not run") != std::string::npos);
+    }
+};
@@ -0,0 +1,123 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for the test environment
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+// Includes from trunk
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+
+// Includes from Immersed Boundary
+#include "ImmersedBoundaryBenchmark.hpp"
+#include "ImmersedBoundaryPerformanceGate.hpp"
+#include "ImmersedBoundaryProfiler.hpp"
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+/**
+ * Times each phase of a reduced set of standard setups several times, and compares the medians with the baseline in
+ * test/data/TestImmersedBoundaryPerformanceRegression/baseline.json.  The comparison is written to
+ * performance_report.txt, and the current timings to current_results.json in the same format as the baseline.
+ *
+ * Timings depend on the machine, so the baseline should be regenerated by copying current_results.json from the
+ * machine that runs this test whenever that machine changes, or a setup or phase is added, removed or renamed.  A
+ * phase missing from the baseline, or a baseline phase which is not run, fails the test, as it cannot be checked.
+ *
+ * No baseline has yet been recorded on the reference machine, so this test is in the profile test pack rather than the
+ * nightly one.  It should be moved to the nightly pack when current_results.json from that machine is checked in.
+ */
+class TestImmersedBoundaryPerformanceRegression : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestPhaseTimingsAgainstBaseline() throw(Exception)
+    {
+        std::string output_directory = "TestImmersedBoundaryPerformanceRegression";
+
+        // The relative threshold and noise multiplier for flagging a regression
+        const double relative_threshold = 0.2;
+        const double num_mads = 3.0;
+        const unsigned num_repeats = 5;
+
+        std::vector<ImmersedBoundaryBenchmark> benchmarks;
+        benchmarks.push_back(ImmersedBoundaryBenchmark("palisade", 8, 128, 128, 1, 10));
+        benchmarks.push_back(ImmersedBoundaryBenchmark("palisade", 8, 128, 256, 1, 10));
+        benchmarks.push_back(ImmersedBoundaryBenchmark("honeycomb", 9, 128, 128, 1, 10));
+        benchmarks.push_back(ImmersedBoundaryBenchmark("honeycomb", 9, 128, 256, 1, 10));
+
+        ImmersedBoundaryPerformanceGate gate;
+        gate.SetRelativeThreshold(relative_threshold);
+        gate.SetNumMads(num_mads);
+
+        for (unsigned i = 0; i < benchmarks.size(); i++)
+        {
+            for (unsigned repeat = 0; repeat < num_repeats; repeat++)
+            {
+                benchmarks[i].Run(output_directory);
+
+                const std::map<std::string, double>& r_times = benchmarks[i].rGetMedianPhaseTimes();
+                for (std::map<std::string, double>::const_iterator iter = r_times.begin(); iter != r_times.end(); ++iter)
+                {
+                    gate.AddSample(benchmarks[i].GetName(), iter->first, iter->second);
+                }
+                gate.AddSample(benchmarks[i].GetName(), "Step", benchmarks[i].GetMeanStepTime());
+            }
+        }
+
+        FileFinder baseline_file("projects/ImmersedBoundary/test/data/TestImmersedBoundaryPerformanceRegression/baseline.json",
+                                 RelativeTo::ChasteSourceRoot);
+        gate.LoadBaseline(baseline_file.GetAbsolutePath());
+
+        OutputFileHandler output_file_handler(output_directory, false);
+        std::string results_dir = output_file_handler.GetOutputDirectoryFullPath();
+        gate.WriteResults(results_dir + "current_results.json");
+        gate.WriteReport(results_dir + "performance_report.txt");
+
+        TS_ASSERT_EQUALS(gate.GetNumRegressions(), 0u);
+
+        // Every phase must be checked against the baseline, and every baseline phase must still be measured
+        TS_ASSERT_EQUALS(gate.GetNumPhasesMissingFromBaseline(), 0u);
+        std::vector<std::string> unmeasured_phases = gate.GetUnmeasuredBaselinePhases();
+        for (unsigned i = 0; i < unmeasured_phases.size(); i++)
+        {
+            TS_FAIL("Baseline phase " + unmeasured_phases[i] + " was not run");
+        }
+
+        ImmersedBoundaryProfiler::Destroy();
+    }
+};
@@ -0,0 +1,214 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for test framework
+#include <cxxtest/TestSuite.h>
+#include "OutputFileHandler.hpp"
+#include "FileFinder.hpp"
+
+// Includes from projects/ImmersedBoundary
+#include "ImmersedBoundaryProfiler.hpp"
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+class TestImmersedBoundaryProfiler : public CxxTest::TestSuite
+{
+public:
+
+    void TestEnableAndDisable() throw(Exception)
+    {
+        ImmersedBoundaryProfiler* p_profiler = ImmersedBoundaryProfiler::Instance();
+        TS_ASSERT_EQUALS(p_profiler, ImmersedBoundaryProfiler::Instance());
+        TS_ASSERT_EQUALS(p_profiler->IsEnabled(), false);
+
+        // Nothing is recorded while the profiler is disabled
+        p_profiler->BeginPhase("Phase");
+        p_profiler->EndPhase("Phase");
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("Phase"), 0u);
+        TS_ASSERT(p_profiler->GetPhaseNames().empty());
+
+        p_profiler->Enable();
+        TS_ASSERT_EQUALS(p_profiler->IsEnabled(), true);
+
+        p_profiler->BeginPhase("Phase");
+        p_profiler->EndPhase("Phase");
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("Phase"), 1u);
+        TS_ASSERT(p_profiler->GetTotalTime("Phase") >= 0.0);
+
+        // Ending a phase that is not running has no effect
+        p_profiler->EndPhase("Phase");
+        p_profiler->EndPhase("OtherPhase");
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("Phase"), 1u);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("OtherPhase"), 0u);
+
+        // Phases may be nested, and are listed in the order they were first begun
+        p_profiler->BeginPhase("Outer");
+        p_profiler->BeginPhase("Inner");
+        p_profiler->EndPhase("Inner");
+        p_profiler->EndPhase("Outer");
+        TS_ASSERT(p_profiler->GetTotalTime("Inner") <= p_profiler->GetTotalTime("Outer"));
+
+        std::vector<std::string> phase_names = p_profiler->GetPhaseNames();
+        TS_ASSERT_EQUALS(phase_names.size(), 3u);
+        TS_ASSERT_EQUALS(phase_names[0], "Phase");
+        TS_ASSERT_EQUALS(phase_names[1], "Outer");
+        TS_ASSERT_EQUALS(phase_names[2], "Inner");
+
+        p_profiler->Disable();
+        TS_ASSERT_EQUALS(p_profiler->IsEnabled(), false);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("Phase"), 1u);
+
+        p_profiler->Reset();
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("Phase"), 0u);
+        TS_ASSERT(p_profiler->GetPhaseNames().empty());
+
+        ImmersedBoundaryProfiler::Destroy();
+    }
+
+    void TestStatistics() throw(Exception)
+    {
+        ImmersedBoundaryProfiler* p_profiler = ImmersedBoundaryProfiler::Instance();
+
+        TS_ASSERT_THROWS_THIS(p_profiler->GetMean("Phase"), "No samples have been recorded for the phase Phase.");
+        TS_ASSERT_THROWS_THIS(p_profiler->WriteSummary("TestImmersedBoundaryProfiler"), "No phases have been profiled.");
+
+        // Add the samples 10, 1, 9, 2, ..., 6, 5
+        for (unsigned i = 0; i < 5; i++)
+        {
+            p_profiler->AddSample("Phase", 10.0 - i);
+            p_profiler->AddSample("Phase", 1.0 + i);
+        }
+
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("Phase"), 10u);
+        TS_ASSERT_DELTA(p_profiler->GetTotalTime("Phase"), 55.0, 1e-12);
+        TS_ASSERT_DELTA(p_profiler->GetMean("Phase"), 5.5, 1e-12);
+        TS_ASSERT_DELTA(p_profiler->GetVariance("Phase"), 55.0 / 6.0, 1e-12);
+
+        TS_ASSERT_DELTA(p_profiler->GetPercentile("Phase", 0.0), 1.0, 1e-12);
+        TS_ASSERT_DELTA(p_profiler->GetPercentile("Phase", 50.0), 5.0, 1e-12);
+        TS_ASSERT_DELTA(p_profiler->GetPercentile("Phase", 90.0), 9.0, 1e-12);
+        TS_ASSERT_DELTA(p_profiler->GetPercentile("Phase", 99.0), 10.0, 1e-12);
+        TS_ASSERT_DELTA(p_profiler->GetPercentile("Phase", 100.0), 10.0, 1e-12);
+        TS_ASSERT_THROWS_THIS(p_profiler->GetPercentile("Phase", 101.0), "The percentile must be between 0 and 100.");
+
+        // A single sample has zero variance
+        p_profiler->AddSample("SinglePhase", 3.0);
+        TS_ASSERT_DELTA(p_profiler->GetVariance("SinglePhase"), 0.0, 1e-12);
+        TS_ASSERT_DELTA(p_profiler->GetPercentile("SinglePhase", 50.0), 3.0, 1e-12);
+
+        // Once the store is full, the extremes stay exact and the percentiles are estimated from a bounded sample
+        TS_ASSERT_EQUALS(p_profiler->GetMaxNumStoredSamples(), 4096u);
+        TS_ASSERT_THROWS_THIS(p_profiler->SetMaxNumStoredSamples(0), "At least one sample must be stored for each phase.");
+        p_profiler->SetMaxNumStoredSamples(100);
+        for (unsigned i = 0; i < 10000; i++)
+        {
+            p_profiler->AddSample("LongPhase", double((37 * i) % 10000));
+        }
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("LongPhase"), 10000u);
+        TS_ASSERT_DELTA(p_profiler->GetMean("LongPhase"), 4999.5, 1e-9);
+        TS_ASSERT_DELTA(p_profiler->GetPercentile("LongPhase", 0.0), 0.0, 1e-12);
+        TS_ASSERT_DELTA(p_profiler->GetPercentile("LongPhase", 100.0), 9999.0, 1e-12);
+        TS_ASSERT_DELTA(p_profiler->GetPercentile("LongPhase", 50.0), 5000.0, 1500.0);
+
+        p_profiler->WriteSummary("TestImmersedBoundaryProfiler");
+
+        OutputFileHandler output_file_handler("TestImmersedBoundaryProfiler", false);
+        FileFinder csv_file = output_file_handler.FindFile("profile.csv");
+        TS_ASSERT(csv_file.Exists());
+
+        ImmersedBoundaryProfiler::Destroy();
+    }
+
+    void TestHardwareCounters() throw(Exception)
+    {
+        ImmersedBoundaryProfiler* p_profiler = ImmersedBoundaryProfiler::Instance();
+        TS_ASSERT_EQUALS(p_profiler->AreHardwareCountersEnabled(), false);
+        TS_ASSERT_EQUALS(p_profiler->GetNumGridPoints(), 0u);
+
+        p_profiler->Enable();
+        p_profiler->AddSample("Phase", 1.0);
+        TS_ASSERT_THROWS_THIS(p_profiler->GetBytesPerGridPoint("Phase"), "The number of grid points has not been set.");
+
+        p_profiler->SetNumGridPoints(256);
+        TS_ASSERT_EQUALS(p_profiler->GetNumGridPoints(), 256u);
+
+        // Samples added directly have no counts
+        TS_ASSERT_EQUALS(p_profiler->GetNumCounterSamples("Phase"), 0u);
+        TS_ASSERT_THROWS_THIS(p_profiler->GetMeanCounterValue("Phase", ImmersedBoundaryHardwareCounters::CYCLES),
+                              "No hardware counters have been recorded for the phase Phase.");
+        TS_ASSERT_THROWS_THIS(p_profiler->GetMeanCounterValue("Phase", ImmersedBoundaryHardwareCounters::NUM_COUNTERS),
+                              "There is no hardware counter with index 4.");
+
+        // The counters may be unavailable, in which case only wall times are recorded
+        bool is_available = p_profiler->EnableHardwareCounters();
+        TS_ASSERT_EQUALS(p_profiler->AreHardwareCountersEnabled(), is_available);
+
+        p_profiler->BeginPhase("Kernel");
+        volatile double sum = 0.0;
+        for (unsigned i = 0; i < 100000; i++)
+        {
+            sum += 0.5 * i;
+        }
+        p_profiler->EndPhase("Kernel");
+
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("Kernel"), 1u);
+        if (is_available)
+        {
+            TS_ASSERT_EQUALS(p_profiler->GetNumCounterSamples("Kernel"), 1u);
+            TS_ASSERT(p_profiler->GetMeanCounterValue("Kernel", ImmersedBoundaryHardwareCounters::INSTRUCTIONS) > 1e5);
+            TS_ASSERT(p_profiler->GetInstructionsPerCycle("Kernel") > 0.0);
+
+            double cache_misses = p_profiler->GetMeanCounterValue("Kernel", ImmersedBoundaryHardwareCounters::CACHE_MISSES);
+            TS_ASSERT_DELTA(p_profiler->GetBytesPerGridPoint("Kernel"), cache_misses * 64.0 / 256.0, 1e-9);
+        }
+        else
+        {
+            TS_ASSERT_EQUALS(p_profiler->GetNumCounterSamples("Kernel"), 0u);
+        }
+
+        // The summary includes counter columns only if counts were recorded
+        p_profiler->WriteSummary("TestImmersedBoundaryProfiler", "profile_with_counters.csv");
+
+        OutputFileHandler output_file_handler("TestImmersedBoundaryProfiler", false);
+        FileFinder csv_file = output_file_handler.FindFile("profile_with_counters.csv");
+        TS_ASSERT(csv_file.Exists());
+
+        p_profiler->DisableHardwareCounters();
+        TS_ASSERT_EQUALS(p_profiler->AreHardwareCountersEnabled(), false);
+
+        ImmersedBoundaryProfiler::Destroy();
+    }
+};
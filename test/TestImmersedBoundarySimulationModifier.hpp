@@ -37,6 +37,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cxxtest/TestSuite.h>
 #include "AbstractCellBasedTestSuite.hpp"
 
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iterator>
+
 // Includes from trunk
 #include "CellsGenerator.hpp"
 #include "CheckpointArchiveTypes.hpp"
@@ -51,9 +56,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ImmersedBoundaryMesh.hpp"
 #include "ImmersedBoundaryCellPopulation.hpp"
 #include "ImmersedBoundarySimulationModifier.hpp"
+#include "ImmersedBoundaryStaticForceSimulationModifier.hpp"
 #include "ImmersedBoundaryPalisadeMeshGenerator.hpp"
 #include "ImmersedBoundaryMembraneElasticityForce.hpp"
 #include "ImmersedBoundaryCellCellInteractionForce.hpp"
+#include "ImmersedBoundaryProfiler.hpp"
+#include "ImmersedBoundaryTraceRecorder.hpp"
 
 // This test is never run in parallel
 #include "FakePetscSetup.hpp"
@@ -72,6 +80,20 @@ public:
         modifier.SetNodeNeighbourUpdateFrequency(2);
         TS_ASSERT_EQUALS(modifier.GetNodeNeighbourUpdateFrequency(), 2u);
 
+        // Test GetRemeshingFrequency(), SetRemeshingFrequency(), GetRemeshingThreshold() and SetRemeshingThreshold()
+        TS_ASSERT_EQUALS(modifier.GetRemeshingFrequency(), 0u);
+        modifier.SetRemeshingFrequency(10);
+        TS_ASSERT_EQUALS(modifier.GetRemeshingFrequency(), 10u);
+
+        TS_ASSERT_DELTA(modifier.GetRemeshingThreshold(), 2.0, 1e-12);
+        modifier.SetRemeshingThreshold(1.5);
+        TS_ASSERT_DELTA(modifier.GetRemeshingThreshold(), 1.5, 1e-12);
+
+        // Test GetTargetNodeSpacingFraction() and SetTargetNodeSpacingFraction()
+        TS_ASSERT_DELTA(modifier.GetTargetNodeSpacingFraction(), 0.0, 1e-12);
+        modifier.SetTargetNodeSpacingFraction(0.5);
+        TS_ASSERT_DELTA(modifier.GetTargetNodeSpacingFraction(), 0.5, 1e-12);
+
         // Test GetReynoldsNumber() and SetReynoldsNumber()
         TS_ASSERT_DELTA(modifier.GetReynoldsNumber(), 1e-4, 1e-6);
         modifier.SetReynoldsNumber(1e-5);
@@ -200,6 +222,124 @@ public:
         }
     }
 
+    void TestForceInstrumentation() throw(Exception)
+    {
+        // Set up SimulationTime - needed by SetupConstantMemberVariables()
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(2.0, 2);
+
+        // Create an immersed boundary cell population
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+
+        ImmersedBoundarySimulationModifier<2> modifier;
+        modifier.SetupConstantMemberVariables(cell_population);
+
+        MAKE_PTR(ImmersedBoundaryMembraneElasticityForce<2>, p_boundary_force);
+        modifier.AddImmersedBoundaryForce(p_boundary_force);
+
+        // Instrumentation is disabled by default, and applies to forces added before and after it is enabled
+        TS_ASSERT_EQUALS(modifier.GetForceInstrumentationEnabled(), false);
+        TS_ASSERT_EQUALS(p_boundary_force->GetInstrumentationEnabled(), false);
+        modifier.SetForceInstrumentationEnabled(true);
+        TS_ASSERT_EQUALS(modifier.GetForceInstrumentationEnabled(), true);
+        TS_ASSERT_EQUALS(p_boundary_force->GetInstrumentationEnabled(), true);
+
+        MAKE_PTR(ImmersedBoundaryCellCellInteractionForce<2>, p_cell_cell_force);
+        modifier.AddImmersedBoundaryForce(p_cell_cell_force);
+        TS_ASSERT_EQUALS(p_cell_cell_force->GetInstrumentationEnabled(), true);
+
+        // Evaluate the forces twice, once through each path
+        modifier.AddImmersedBoundaryForceContributions();
+        modifier.SetUseForcePipeline(true);
+        modifier.AddImmersedBoundaryForceContributions();
+
+        TS_ASSERT_EQUALS(p_boundary_force->GetNumInstrumentedCalls(), 2u);
+        TS_ASSERT_EQUALS(p_boundary_force->GetNumElementsProcessed(), 2ul * p_mesh->GetNumElements());
+        TS_ASSERT_EQUALS(p_boundary_force->GetNumPairsExamined(), 0ul);
+        TS_ASSERT(p_boundary_force->GetCumulativeThreadTime() >= 0.0);
+
+        TS_ASSERT_EQUALS(p_cell_cell_force->GetNumInstrumentedCalls(), 2u);
+        TS_ASSERT_EQUALS(p_cell_cell_force->GetNumElementsProcessed(), 0ul);
+        TS_ASSERT_EQUALS(p_cell_cell_force->GetNumPairsExamined(), 2ul * modifier.mNodePairs.size());
+        TS_ASSERT(p_cell_cell_force->GetNumPairsInteracting() > 0ul);
+        TS_ASSERT(p_cell_cell_force->GetNumPairsInteracting() <= p_cell_cell_force->GetNumPairsExamined());
+
+        // The counters are written alongside the force parameters in the modifier parameters, and to a CSV file
+        OutputFileHandler output_file_handler("TestForceInstrumentation", false);
+        out_stream modifier_parameter_file = output_file_handler.OpenOutputFile("modifier.parameters");
+        modifier.OutputSimulationModifierParameters(modifier_parameter_file);
+        modifier_parameter_file->close();
+
+        std::ifstream params_file((output_file_handler.GetOutputDirectoryFullPath() + "modifier.parameters").c_str());
+        std::string params((std::istreambuf_iterator<char>(params_file)), std::istreambuf_iterator<char>());
+        TS_ASSERT(params.find("<" + p_boundary_force->GetIdentifier() + ">") != std::string::npos);
+        TS_ASSERT(params.find("<" + p_cell_cell_force->GetIdentifier() + ">") != std::string::npos);
+        TS_ASSERT(params.find("<NumPairsExamined>") != std::string::npos);
+
+        modifier.WriteForceInstrumentation("TestForceInstrumentation");
+        FileFinder csv_file = output_file_handler.FindFile("force_instrumentation.csv");
+        TS_ASSERT(csv_file.Exists());
+
+        // Counters may be reset
+        p_cell_cell_force->ResetInstrumentation();
+        TS_ASSERT_EQUALS(p_cell_cell_force->GetNumInstrumentedCalls(), 0u);
+        TS_ASSERT_EQUALS(p_cell_cell_force->GetNumPairsExamined(), 0ul);
+        TS_ASSERT_DELTA(p_cell_cell_force->GetCumulativeThreadTime(), 0.0, 1e-12);
+    }
+
+    void TestStaticForceSimulationModifier() throw(Exception)
+    {
+        // Set up SimulationTime - needed by SetupConstantMemberVariables()
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(2.0, 2);
+
+        // Create an immersed boundary cell population
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+
+        // Compose the same forces as in TestAddImmersedBoundaryForce() at compile time
+        typedef MembraneElasticityForcePolicy<2> MembranePolicy;
+        typedef CellCellInteractionForcePolicy<2, LinearSpringPairLaw> CellCellPolicy;
+
+        LinearSpringPairLaw law(0.25 * cell_population.GetInteractionDistance());
+        ImmersedBoundaryStaticForceSimulationModifier<2, MembranePolicy, CellCellPolicy> modifier(MembranePolicy(1.0 * 1e7),
+                                                                                                CellCellPolicy(law, 1.0 * 1e6));
+        modifier.SetupConstantMemberVariables(cell_population);
+
+        modifier.ClearForcesAndSources();
+        modifier.AddImmersedBoundaryForceContributions();
+
+        TS_ASSERT_EQUALS(modifier.mNodeForces.size(), 2 * p_mesh->GetNumNodes());
+        TS_ASSERT_DELTA(modifier.mNodeForces[0], -125.2290, 1e-3);
+        TS_ASSERT_DELTA(modifier.mNodeForces[1], 6352.7140, 1e-3);
+        TS_ASSERT_DELTA(modifier.mNodeForces[10], -1235.1356, 1e-3);
+        TS_ASSERT_DELTA(modifier.mNodeForces[11], 16800.5590, 1e-3);
+
+        // A single policy may be used alone, with the remaining slots defaulting to no force
+        ImmersedBoundaryStaticForceSimulationModifier<2, CellCellPolicy> cell_cell_modifier(CellCellPolicy(law, 1.0 * 1e6));
+        cell_cell_modifier.SetupConstantMemberVariables(cell_population);
+        cell_cell_modifier.AddImmersedBoundaryForceContributions();
+
+        ImmersedBoundaryStaticForceSimulationModifier<2, MembranePolicy> membrane_modifier(MembranePolicy(1.0 * 1e7));
+        membrane_modifier.SetupConstantMemberVariables(cell_population);
+        membrane_modifier.AddImmersedBoundaryForceContributions();
+
+        for (unsigned i = 0; i < modifier.mNodeForces.size(); i++)
+        {
+            double sum = cell_cell_modifier.mNodeForces[i] + membrane_modifier.mNodeForces[i];
+            TS_ASSERT_DELTA(modifier.mNodeForces[i], sum, 1e-9 * (1.0 + fabs(sum)));
+        }
+    }
+
     void TestPropagateForcesToFluidGrid() throw(Exception)
     {
         ///\todo Test this method
@@ -289,5 +429,305 @@ public:
 
         TS_ASSERT_DELTA(p_mesh->GetNode(5)->rGetAppliedForce()[0], -1235.1356, 1e-3);
         TS_ASSERT_DELTA(p_mesh->GetNode(5)->rGetAppliedForce()[1], 16800.5590, 1e-3);
+
+        // The applied forces are also gathered into contiguous storage, ready to be spread to the fluid grid
+        TS_ASSERT_EQUALS(modifier.mNodeForces.size(), 2 * p_mesh->GetNumNodes());
+        TS_ASSERT_DELTA(modifier.mNodeForces[0], -125.2290, 1e-3);
+        TS_ASSERT_DELTA(modifier.mNodeForces[11], 16800.5590, 1e-3);
+    }
+
+    void TestForcePipeline() throw(Exception)
+    {
+        // Set up SimulationTime - needed by SetupConstantMemberVariables()
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(2.0, 2);
+
+        // Create an immersed boundary cell population
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+
+        ImmersedBoundarySimulationModifier<2> modifier;
+        TS_ASSERT_EQUALS(modifier.GetUseForcePipeline(), false);
+        modifier.SetUseForcePipeline(true);
+        TS_ASSERT_EQUALS(modifier.GetUseForcePipeline(), true);
+        modifier.SetupConstantMemberVariables(cell_population);
+
+        // Add the same forces as in TestAddImmersedBoundaryForce(), both of which support the force pipeline
+        MAKE_PTR(ImmersedBoundaryMembraneElasticityForce<2>, p_boundary_force);
+        modifier.AddImmersedBoundaryForce(p_boundary_force);
+        p_boundary_force->SetSpringConstant(1.0 * 1e7);
+        TS_ASSERT_EQUALS(p_boundary_force->SupportsForcePipeline(), true);
+
+        MAKE_PTR(ImmersedBoundaryCellCellInteractionForce<2>, p_cell_cell_force);
+        modifier.AddImmersedBoundaryForce(p_cell_cell_force);
+        p_cell_cell_force->SetSpringConstant(1.0 * 1e6);
+        TS_ASSERT_EQUALS(p_cell_cell_force->SupportsForcePipeline(), true);
+
+        // The forces are accumulated directly into contiguous storage, and not stored on the nodes
+        modifier.ClearForcesAndSources();
+        modifier.AddImmersedBoundaryForceContributions();
+
+        TS_ASSERT_EQUALS(modifier.mNodeForces.size(), 2 * p_mesh->GetNumNodes());
+        TS_ASSERT_DELTA(modifier.mNodeForces[0], -125.2290, 1e-3);
+        TS_ASSERT_DELTA(modifier.mNodeForces[1], 6352.7140, 1e-3);
+        TS_ASSERT_DELTA(modifier.mNodeForces[10], -1235.1356, 1e-3);
+        TS_ASSERT_DELTA(modifier.mNodeForces[11], 16800.5590, 1e-3);
+
+        TS_ASSERT_DELTA(p_mesh->GetNode(0)->rGetAppliedForce()[0], 0.0, 1e-12);
+
+        // Without the force pipeline, the same forces are calculated through the nodes
+        std::vector<double> pipeline_forces = modifier.mNodeForces;
+
+        modifier.SetUseForcePipeline(false);
+        modifier.ClearForcesAndSources();
+        modifier.AddImmersedBoundaryForceContributions();
+
+        for (unsigned i = 0; i < pipeline_forces.size(); i++)
+        {
+            TS_ASSERT_DELTA(modifier.mNodeForces[i], pipeline_forces[i], 1e-9 * (1.0 + fabs(pipeline_forces[i])));
+        }
+
+        // Splitting elements into small work items in the element sweep gives the same forces
+        p_boundary_force->SetMaxNodesPerWorkItem(7);
+        TS_ASSERT_EQUALS(p_boundary_force->GetMaxNodesPerElementKernelCall(), 7u);
+        TS_ASSERT_EQUALS(p_cell_cell_force->GetMaxNodesPerElementKernelCall(), UINT_MAX);
+
+        modifier.SetUseForcePipeline(true);
+        modifier.ClearForcesAndSources();
+        modifier.AddImmersedBoundaryForceContributions();
+
+        TS_ASSERT_EQUALS(modifier.mElementSweepItems.size() % 3, 0u);
+        TS_ASSERT_LESS_THAN(3 * p_mesh->GetNumElements(), modifier.mElementSweepItems.size());
+        for (unsigned item_idx = 0; item_idx < modifier.mElementSweepItems.size() / 3; item_idx++)
+        {
+            TS_ASSERT_LESS_THAN_EQUALS(modifier.mElementSweepItems[3 * item_idx + 2] - modifier.mElementSweepItems[3 * item_idx + 1], 7u);
+        }
+
+        for (unsigned i = 0; i < pipeline_forces.size(); i++)
+        {
+            TS_ASSERT_DELTA(modifier.mNodeForces[i], pipeline_forces[i], 1e-9 * (1.0 + fabs(pipeline_forces[i])));
+        }
+    }
+
+    void TestProfilingAndTracing() throw(Exception)
+    {
+        // Set up SimulationTime - needed by SetupConstantMemberVariables()
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(2.0, 2);
+
+        // Create an immersed boundary cell population
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+
+        ImmersedBoundarySimulationModifier<2> modifier;
+        MAKE_PTR(ImmersedBoundaryMembraneElasticityForce<2>, p_boundary_force);
+        modifier.AddImmersedBoundaryForce(p_boundary_force);
+
+        TS_ASSERT_EQUALS(modifier.GetProfilingEnabled(), false);
+        modifier.SetProfilingEnabled(true);
+        TS_ASSERT_EQUALS(modifier.GetProfilingEnabled(), true);
+
+        TS_ASSERT_EQUALS(modifier.GetTracingEnabled(), false);
+        modifier.SetTracingEnabled(true);
+        TS_ASSERT_EQUALS(modifier.GetTracingEnabled(), true);
+
+        TS_ASSERT_EQUALS(modifier.GetHardwareCountersEnabled(), false);
+        modifier.SetHardwareCountersEnabled(true);
+        TS_ASSERT_EQUALS(modifier.GetHardwareCountersEnabled(), true);
+
+        // The fluid problem is solved once in SetupSolve() and once in UpdateAtEndOfTimeStep()
+        modifier.SetupSolve(cell_population, "TestModifierProfiling");
+        TS_ASSERT_EQUALS(ImmersedBoundaryProfiler::Instance()->IsEnabled(), true);
+        TS_ASSERT_EQUALS(ImmersedBoundaryProfiler::Instance()->GetNumGridPoints(), p_mesh->GetNumGridPtsX() * p_mesh->GetNumGridPtsY());
+
+        cell_population.UpdateNodeLocations(SimulationTime::Instance()->GetTimeStep());
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+
+        ImmersedBoundaryProfiler* p_profiler = ImmersedBoundaryProfiler::Instance();
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("UpdateAtEndOfTimeStep"), 1u);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("CalculateNodePairs"), 1u);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("UpdateNodeLocations"), 1u);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("ClearForcesAndSources"), 2u);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("AddForceContributions"), 2u);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("PropagateForcesToFluidGrid"), 2u);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("PropagateFluidSourcesToGrid"), 0u);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("ForwardFft"), 2u);
+        TS_ASSERT_EQUALS(p_profiler->GetNumSamples("InverseFft"), 2u);
+
+        // The sub-phases of the fluid solve take no longer than the solve itself
+        double sub_phase_time = 0.0;
+        sub_phase_time += p_profiler->GetTotalTime("Upwind");
+        sub_phase_time += p_profiler->GetTotalTime("ForwardFft");
+        sub_phase_time += p_profiler->GetTotalTime("SpectralUpdate");
+        sub_phase_time += p_profiler->GetTotalTime("InverseFft");
+        sub_phase_time += p_profiler->GetTotalTime("Normalise");
+        TS_ASSERT(sub_phase_time <= p_profiler->GetTotalTime("SolveNavierStokesSpectral"));
+
+        // The summary is written at the end of the solve, after which the profiler is disabled
+        modifier.UpdateAtEndOfSolve(cell_population);
+        TS_ASSERT_EQUALS(p_profiler->IsEnabled(), false);
+        TS_ASSERT_EQUALS(p_profiler->AreHardwareCountersEnabled(), false);
+
+        OutputFileHandler output_file_handler("TestModifierProfiling", false);
+        FileFinder csv_file = output_file_handler.FindFile("profile.csv");
+        TS_ASSERT(csv_file.Exists());
+
+        // Each phase begun and ended above appears twice in the timeline
+        TS_ASSERT_EQUALS(ImmersedBoundaryTraceRecorder::Instance()->IsEnabled(), false);
+        TS_ASSERT(ImmersedBoundaryTraceRecorder::Instance()->GetNumEvents() >= 2ul * 20);
+        FileFinder trace_file = output_file_handler.FindFile("trace.json");
+        TS_ASSERT(trace_file.Exists());
+
+        ImmersedBoundaryProfiler::Destroy();
+        ImmersedBoundaryTraceRecorder::Destroy();
+    }
+
+    void TestHealthCounters() throw(Exception)
+    {
+        // Set up SimulationTime - needed by SetupConstantMemberVariables()
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(2.0, 2);
+
+        // Create an immersed boundary cell population
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+
+        ImmersedBoundarySimulationModifier<2> modifier;
+        MAKE_PTR(ImmersedBoundaryMembraneElasticityForce<2>, p_boundary_force);
+        modifier.AddImmersedBoundaryForce(p_boundary_force);
+
+        TS_ASSERT_EQUALS(modifier.GetHealthMonitoringEnabled(), false);
+        modifier.SetHealthMonitoringEnabled(true);
+        TS_ASSERT_EQUALS(modifier.GetHealthMonitoringEnabled(), true);
+
+        modifier.SetupSolve(cell_population, "TestHealthCounters");
+
+        // A uniform fluid velocity far too large for the time step moves every node by more than the spacing
+        multi_array<double, 3>& vel_grids = p_mesh->rGetModifiable2dVelocityGrids();
+        unsigned num_grid_pts_x = p_mesh->GetNumGridPtsX();
+        unsigned num_grid_pts_y = p_mesh->GetNumGridPtsY();
+        for (unsigned x = 0; x < num_grid_pts_x; x++)
+        {
+            for (unsigned y = 0; y < num_grid_pts_y; y++)
+            {
+                vel_grids[0][x][y] = 1e3;
+                vel_grids[1][x][y] = 0.0;
+            }
+        }
+
+        double dt = SimulationTime::Instance()->GetTimeStep();
+        cell_population.UpdateNodeLocations(dt);
+
+        TS_ASSERT_EQUALS(cell_population.GetNumNodesClamped(), p_mesh->GetNumNodes());
+        TS_ASSERT_EQUALS(cell_population.GetNumSourcesClamped(), 0u);
+        TS_ASSERT(cell_population.GetMaxRelativeDisplacement() > 1.0);
+        TS_ASSERT(cell_population.GetSuggestedTimeStep() < dt);
+
+        // For u = sin(2 pi x), v = 0, the discrete divergence is cos(2 pi x) sin(2 pi h) / h, with norm sin(2 pi h) / (h sqrt(2))
+        for (unsigned x = 0; x < num_grid_pts_x; x++)
+        {
+            for (unsigned y = 0; y < num_grid_pts_y; y++)
+            {
+                vel_grids[0][x][y] = sin(2.0 * M_PI * x / num_grid_pts_x);
+                vel_grids[1][x][y] = 0.0;
+            }
+        }
+
+        double h = 1.0 / num_grid_pts_x;
+        TS_ASSERT_DELTA(modifier.CalculateMaxFluidSpeed(), 1.0, 1e-6);
+        TS_ASSERT_DELTA(modifier.CalculateVelocityDivergenceNorm(), sin(2.0 * M_PI * h) / (h * sqrt(2.0)), 1e-9);
+
+        // Only some of the node pairs from the box collection lie within the interaction distance
+        unsigned num_pairs = modifier.CountNodePairsWithinInteractionDistance();
+        TS_ASSERT(num_pairs > 0u);
+        TS_ASSERT(num_pairs <= modifier.mNodePairs.size());
+
+        modifier.RecordHealthCounters();
+        TS_ASSERT_EQUALS(modifier.mHealthRecords.size(), 1u);
+        TS_ASSERT_EQUALS(modifier.mHealthRecords[0].mNumNodesClamped, p_mesh->GetNumNodes());
+        TS_ASSERT_EQUALS(modifier.mHealthRecords[0].mNumPairsWithinInteractionDistance, num_pairs);
+        TS_ASSERT_DELTA(modifier.mHealthRecords[0].mSuggestedTimeStep, cell_population.GetSuggestedTimeStep(), 1e-12);
+
+        // The counters are written at the end of the solve
+        modifier.UpdateAtEndOfSolve(cell_population);
+
+        OutputFileHandler output_file_handler("TestHealthCounters", false);
+        FileFinder csv_file = output_file_handler.FindFile("health.csv");
+        TS_ASSERT(csv_file.Exists());
+    }
+
+    void TestMemoryReport() throw(Exception)
+    {
+        // Set up SimulationTime - needed by SetupConstantMemberVariables()
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        // Create an immersed boundary cell population
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+
+        ImmersedBoundarySimulationModifier<2> modifier;
+        MAKE_PTR(ImmersedBoundaryMembraneElasticityForce<2>, p_boundary_force);
+        modifier.AddImmersedBoundaryForce(p_boundary_force);
+
+        TS_ASSERT_EQUALS(modifier.GetMemoryReportingEnabled(), false);
+        modifier.SetMemoryReportingEnabled(true);
+        TS_ASSERT_EQUALS(modifier.GetMemoryReportingEnabled(), true);
+
+        // Before setup, only the buffers held by the modifier itself are reported, and these are empty
+        std::map<std::string, std::size_t> memory_usage = modifier.GetMemoryUsage();
+        TS_ASSERT_EQUALS(memory_usage.count("Arrays/ForceGrids"), 0u);
+        TS_ASSERT_EQUALS(memory_usage["NodePairs"], 0u);
+
+        modifier.SetupSolve(cell_population, "TestMemoryReport");
+        TS_ASSERT_EQUALS(modifier.mNumElementsAtLastMemoryReport, p_mesh->GetNumElements());
+
+        // The velocity and force grids each hold two doubles per grid point
+        std::size_t grid_bytes = 2 * p_mesh->GetNumGridPtsX() * p_mesh->GetNumGridPtsY() * sizeof(double);
+        memory_usage = modifier.GetMemoryUsage();
+        TS_ASSERT_EQUALS(memory_usage["Mesh/VelocityGrids"], grid_bytes);
+        TS_ASSERT_EQUALS(memory_usage["Arrays/ForceGrids"], grid_bytes);
+        TS_ASSERT(memory_usage["Mesh/Nodes"] > p_mesh->GetNumNodes() * sizeof(Node<2>));
+        TS_ASSERT(memory_usage["Mesh/Elements"] > 0u);
+        TS_ASSERT(memory_usage["NodePairs"] >= modifier.mNodePairs.size() * sizeof(std::pair<Node<2>*, Node<2>*>));
+        TS_ASSERT_EQUALS(memory_usage["NodeForces"], modifier.mNodeForces.capacity() * sizeof(double));
+
+        // The peak resident set size must at least cover the grids
+        TS_ASSERT(ImmersedBoundarySimulationModifier<2>::GetPeakResidentSetSize() > grid_bytes);
+
+        // Further reports are appended to the one written at setup
+        OutputFileHandler output_file_handler("TestMemoryReport", false);
+        FileFinder csv_file = output_file_handler.FindFile("memory.csv");
+        TS_ASSERT(csv_file.Exists());
+
+        std::ifstream setup_file(csv_file.GetAbsolutePath().c_str());
+        unsigned num_setup_lines = std::count(std::istreambuf_iterator<char>(setup_file), std::istreambuf_iterator<char>(), '\n');
+        setup_file.close();
+
+        // One line per component, plus the header and the total and peak rows
+        TS_ASSERT_EQUALS(num_setup_lines, memory_usage.size() + 3);
+
+        modifier.WriteMemoryReport("TestMemoryReport", "Division");
+
+        std::ifstream division_file(csv_file.GetAbsolutePath().c_str());
+        unsigned num_lines = std::count(std::istreambuf_iterator<char>(division_file), std::istreambuf_iterator<char>(), '\n');
+        division_file.close();
+        TS_ASSERT_EQUALS(num_lines, 2 * num_setup_lines - 1);
     }
 };
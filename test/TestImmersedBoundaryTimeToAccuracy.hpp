@@ -0,0 +1,138 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for the test environment
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+// Includes from trunk
+#include "OutputFileHandler.hpp"
+#include "FileFinder.hpp"
+
+// Includes from Immersed Boundary
+#include "ImmersedBoundaryAccuracyBenchmark.hpp"
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+/**
+ * Time-to-accuracy benchmarks for the immersed boundary method.  A decaying Taylor-Green vortex and a relaxing
+ * elliptical membrane are each run over a range of grid sizes and time steps, and the error and wall time of each run
+ * are written to time_to_accuracy.csv.  Plotting the error against the wall time shows which configuration reaches a
+ * given accuracy most cheaply.
+ *
+ * The finest runs take several minutes, so this test is only in the profile test pack.
+ */
+class TestImmersedBoundaryTimeToAccuracy : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestConstructorExceptions() throw(Exception)
+    {
+        TS_ASSERT_THROWS_THIS(ImmersedBoundaryAccuracyBenchmark("lid_driven_cavity", 32, 0.01, 0.1),
+                              "Unknown case lid_driven_cavity: must be taylor_green or relaxing_membrane.");
+        TS_ASSERT_THROWS_THIS(ImmersedBoundaryAccuracyBenchmark("taylor_green", 33, 0.01, 0.1),
+                              "The number of grid points must be positive and even.");
+        TS_ASSERT_THROWS_THIS(ImmersedBoundaryAccuracyBenchmark("taylor_green", 32, 0.01, 0.001),
+                              "The time step must be positive and no longer than the end time.");
+
+        ImmersedBoundaryAccuracyBenchmark benchmark("taylor_green", 32, 0.01, 0.1);
+        TS_ASSERT_EQUALS(benchmark.GetNumTimeSteps(), 10u);
+        TS_ASSERT_EQUALS(benchmark.GetName(), "taylor_green_g32_s10");
+    }
+
+    void TestTimeToAccuracySweep() throw(Exception)
+    {
+        std::string output_directory = "TestImmersedBoundaryTimeToAccuracy";
+
+        std::vector<unsigned> grid_sizes;
+        for (unsigned num_grid_pts = 32; num_grid_pts <= 256; num_grid_pts *= 2)
+        {
+            grid_sizes.push_back(num_grid_pts);
+        }
+
+        // The Taylor-Green vortex has unit speed, so the finest grid needs dt < 1/256 for the upwind scheme
+        std::vector<double> taylor_green_dts;
+        for (double dt = 2e-3; dt > 2e-4; dt *= 0.5)
+        {
+            taylor_green_dts.push_back(dt);
+        }
+
+        std::vector<double> membrane_dts;
+        for (double dt = 1e-2; dt > 2e-3; dt *= 0.5)
+        {
+            membrane_dts.push_back(dt);
+        }
+
+        std::vector<ImmersedBoundaryAccuracyBenchmark> benchmarks;
+        for (unsigned i = 0; i < grid_sizes.size(); i++)
+        {
+            for (unsigned j = 0; j < taylor_green_dts.size(); j++)
+            {
+                benchmarks.push_back(ImmersedBoundaryAccuracyBenchmark("taylor_green", grid_sizes[i], taylor_green_dts[j], 0.05));
+            }
+            for (unsigned j = 0; j < membrane_dts.size(); j++)
+            {
+                benchmarks.push_back(ImmersedBoundaryAccuracyBenchmark("relaxing_membrane", grid_sizes[i], membrane_dts[j], 0.5));
+            }
+        }
+
+        for (unsigned i = 0; i < benchmarks.size(); i++)
+        {
+            benchmarks[i].Run(output_directory);
+
+            TS_ASSERT(benchmarks[i].GetWallTime() > 0.0);
+            TS_ASSERT(benchmarks[i].GetError() >= 0.0);
+        }
+
+        // For the Taylor-Green vortex, refining both the grid and the time step reduces the error
+        double coarse_error = benchmarks.front().GetError();
+        double fine_error = 0.0;
+        for (unsigned i = 0; i < benchmarks.size(); i++)
+        {
+            if (benchmarks[i].rGetCaseName() == "taylor_green")
+            {
+                fine_error = benchmarks[i].GetError();
+            }
+        }
+        TS_ASSERT_LESS_THAN(fine_error, coarse_error);
+
+        ImmersedBoundaryAccuracyBenchmark::WriteResults(benchmarks, output_directory);
+
+        OutputFileHandler output_file_handler(output_directory, false);
+        FileFinder csv_file = output_file_handler.FindFile("time_to_accuracy.csv");
+        TS_ASSERT(csv_file.Exists());
+    }
+};
@@ -0,0 +1,113 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for test framework
+#include <cxxtest/TestSuite.h>
+#include "OutputFileHandler.hpp"
+#include "FileFinder.hpp"
+
+#include <fstream>
+#include <iterator>
+
+// Includes from projects/ImmersedBoundary
+#include "ImmersedBoundaryProfiler.hpp"
+#include "ImmersedBoundaryTraceRecorder.hpp"
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+class TestImmersedBoundaryTraceRecorder : public CxxTest::TestSuite
+{
+public:
+
+    void TestRecordEvents() throw(Exception)
+    {
+        ImmersedBoundaryTraceRecorder* p_recorder = ImmersedBoundaryTraceRecorder::Instance();
+        TS_ASSERT_EQUALS(p_recorder, ImmersedBoundaryTraceRecorder::Instance());
+        TS_ASSERT_EQUALS(p_recorder->IsEnabled(), false);
+        TS_ASSERT_EQUALS(p_recorder->GetBufferCapacity(), 65536u);
+
+        TS_ASSERT_THROWS_THIS(p_recorder->SetBufferCapacity(0), "The trace buffer capacity must be positive.");
+        p_recorder->SetBufferCapacity(4);
+        TS_ASSERT_EQUALS(p_recorder->GetBufferCapacity(), 4u);
+
+        // Nothing is recorded while the recorder is disabled
+        p_recorder->BeginEvent("Ignored");
+        p_recorder->EndEvent("Ignored");
+        TS_ASSERT_EQUALS(p_recorder->GetNumEvents(), 0ul);
+
+        p_recorder->Enable();
+        TS_ASSERT_EQUALS(p_recorder->IsEnabled(), true);
+
+        p_recorder->BeginEvent("First");
+        p_recorder->EndEvent("First");
+        TS_ASSERT_EQUALS(p_recorder->GetNumEvents(), 2ul);
+        TS_ASSERT_EQUALS(p_recorder->GetNumOverwrittenEvents(), 0ul);
+
+        // Profiler phases are recorded even if the profiler itself is disabled
+        ImmersedBoundaryProfiler::Instance()->BeginPhase("Second");
+        ImmersedBoundaryProfiler::Instance()->EndPhase("Second");
+        TS_ASSERT_EQUALS(ImmersedBoundaryProfiler::Instance()->GetNumSamples("Second"), 0u);
+        TS_ASSERT_EQUALS(p_recorder->GetNumEvents(), 4ul);
+
+        // Once the buffer is full, the oldest events are overwritten
+        p_recorder->BeginEvent("Third");
+        p_recorder->EndEvent("Third");
+        TS_ASSERT_EQUALS(p_recorder->GetNumEvents(), 4ul);
+        TS_ASSERT_EQUALS(p_recorder->GetNumOverwrittenEvents(), 2ul);
+
+        p_recorder->Disable();
+        TS_ASSERT_EQUALS(p_recorder->IsEnabled(), false);
+
+        p_recorder->WriteTrace("TestImmersedBoundaryTraceRecorder");
+
+        OutputFileHandler output_file_handler("TestImmersedBoundaryTraceRecorder", false);
+        FileFinder trace_file = output_file_handler.FindFile("trace.json");
+        TS_ASSERT(trace_file.Exists());
+
+        std::ifstream trace_stream(trace_file.GetAbsolutePath().c_str());
+        std::string trace((std::istreambuf_iterator<char>(trace_stream)), std::istreambuf_iterator<char>());
+        TS_ASSERT_EQUALS(trace.find("{\"traceEvents\":["), 0u);
+        TS_ASSERT_EQUALS(trace.find("\"name\":\"First\""), std::string::npos);
+        TS_ASSERT(trace.find("{\"name\":\"Second\",\"ph\":\"B\"") < trace.find("{\"name\":\"Third\",\"ph\":\"E\""));
+
+        // Enabling the recorder again discards the events
+        p_recorder->Enable();
+        TS_ASSERT_EQUALS(p_recorder->GetNumEvents(), 0ul);
+
+        ImmersedBoundaryTraceRecorder::Destroy();
+        ImmersedBoundaryProfiler::Destroy();
+    }
+};
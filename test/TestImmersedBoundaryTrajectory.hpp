@@ -0,0 +1,181 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for test framework
+#include <cxxtest/TestSuite.h>
+#include "OutputFileHandler.hpp"
+#include "FileFinder.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+// Includes from projects/ImmersedBoundary
+#include "ImmersedBoundaryTrajectory.hpp"
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+class TestImmersedBoundaryTrajectory : public CxxTest::TestSuite
+{
+public:
+
+    void TestAddFrames() throw(Exception)
+    {
+        ImmersedBoundaryTrajectory trajectory;
+        TS_ASSERT_EQUALS(trajectory.GetNumFrames(), 0u);
+
+        std::vector<double> node_locations(4, 0.5);
+        std::vector<double> velocity_grids(8, 1.0);
+        trajectory.AddFrame(0, node_locations, velocity_grids);
+        trajectory.AddFrame(5, node_locations, velocity_grids);
+
+        TS_ASSERT_EQUALS(trajectory.GetNumFrames(), 2u);
+        TS_ASSERT_EQUALS(trajectory.GetTimeStep(1), 5u);
+        TS_ASSERT_EQUALS(trajectory.rGetNodeLocations(1).size(), 4u);
+        TS_ASSERT_EQUALS(trajectory.rGetVelocityGrids(1).size(), 8u);
+
+        TS_ASSERT_THROWS_THIS(trajectory.AddFrame(5, node_locations, velocity_grids),
+                              "Frames must be added in increasing order of time step.");
+
+        trajectory.Clear();
+        TS_ASSERT_EQUALS(trajectory.GetNumFrames(), 0u);
+    }
+
+    void TestUlp() throw(Exception)
+    {
+        TS_ASSERT_EQUALS(ImmersedBoundaryTrajectory::GetUlp(1.0), DBL_EPSILON);
+        TS_ASSERT_EQUALS(ImmersedBoundaryTrajectory::GetUlp(-1.0), DBL_EPSILON);
+        TS_ASSERT_EQUALS(ImmersedBoundaryTrajectory::GetUlp(0.75), 0.5 * DBL_EPSILON);
+        TS_ASSERT_EQUALS(ImmersedBoundaryTrajectory::GetUlp(0.0), ldexp(1.0, -1074));
+        TS_ASSERT_EQUALS(ImmersedBoundaryTrajectory::GetUlp(1e-310), ldexp(1.0, -1074));
+    }
+
+    void TestCompare() throw(Exception)
+    {
+        std::vector<double> node_locations(4, 0.5);
+        std::vector<double> velocity_grids(8, 1.0);
+
+        ImmersedBoundaryTrajectory reference;
+        reference.AddFrame(0, node_locations, velocity_grids);
+        reference.AddFrame(5, node_locations, velocity_grids);
+
+        // Perturb one node coordinate by three ULPs, and one velocity by a relative 1e-10, in the second frame only
+        std::vector<double> perturbed_locations(node_locations);
+        perturbed_locations[0] += 3.0 * ImmersedBoundaryTrajectory::GetUlp(0.5);
+        std::vector<double> perturbed_velocities(velocity_grids);
+        perturbed_velocities[1] += 1e-10;
+
+        ImmersedBoundaryTrajectory other;
+        other.AddFrame(0, node_locations, velocity_grids);
+        other.AddFrame(5, perturbed_locations, perturbed_velocities);
+
+        std::vector<ImmersedBoundaryTrajectory::FieldComparison> comparisons = reference.Compare(other);
+        TS_ASSERT_EQUALS(comparisons.size(), 2u);
+
+        TS_ASSERT_EQUALS(comparisons[0].mField, "NodeLocations");
+        TS_ASSERT_EQUALS(comparisons[0].mNumValues, 8u);
+        TS_ASSERT_EQUALS(comparisons[0].mNumDifferences, 1u);
+        TS_ASSERT_DELTA(comparisons[0].mMaxUlps, 3.0, 1e-12);
+        TS_ASSERT_DELTA(comparisons[0].mMedianUlps, 0.0, 1e-12);
+        TS_ASSERT_DELTA(comparisons[0].mMaxRelativeError, 6.0 * ImmersedBoundaryTrajectory::GetUlp(0.5), 1e-20);
+
+        TS_ASSERT_EQUALS(comparisons[1].mField, "VelocityGrids");
+        TS_ASSERT_EQUALS(comparisons[1].mNumValues, 16u);
+        TS_ASSERT_EQUALS(comparisons[1].mNumDifferences, 1u);
+        TS_ASSERT_DELTA(comparisons[1].mMaxRelativeError, 1e-10, 1e-15);
+        TS_ASSERT_DELTA(comparisons[1].mRelativeL2Error, 1e-10 / 4.0, 1e-15);
+
+        // A trajectory is identical to itself
+        comparisons = reference.Compare(reference);
+        TS_ASSERT_EQUALS(comparisons[0].mNumDifferences, 0u);
+        TS_ASSERT_EQUALS(comparisons[1].mNumDifferences, 0u);
+        TS_ASSERT_DELTA(comparisons[1].mRelativeL2Error, 0.0, 1e-15);
+
+        // Trajectories must have the same frames and field sizes
+        ImmersedBoundaryTrajectory short_trajectory;
+        short_trajectory.AddFrame(0, node_locations, velocity_grids);
+        TS_ASSERT_THROWS_THIS(reference.Compare(short_trajectory), "The trajectories have different numbers of frames.");
+
+        short_trajectory.AddFrame(10, node_locations, velocity_grids);
+        TS_ASSERT_THROWS_THIS(reference.Compare(short_trajectory), "The trajectories were sampled at different time steps.");
+
+        ImmersedBoundaryTrajectory resized;
+        resized.AddFrame(0, std::vector<double>(6, 0.5), velocity_grids);
+        resized.AddFrame(5, node_locations, velocity_grids);
+        TS_ASSERT_THROWS_THIS(reference.Compare(resized), "The field NodeLocations has a different size in frame 0.");
+
+        std::map<std::string, std::vector<ImmersedBoundaryTrajectory::FieldComparison> > all_comparisons;
+        all_comparisons["Perturbed"] = reference.Compare(other);
+        ImmersedBoundaryTrajectory::WriteComparisons(all_comparisons, "TestImmersedBoundaryTrajectory");
+
+        OutputFileHandler output_file_handler("TestImmersedBoundaryTrajectory", false);
+        FileFinder csv_file = output_file_handler.FindFile("trajectory_comparison.csv");
+        TS_ASSERT(csv_file.Exists());
+    }
+
+    void TestWriteAndLoad() throw(Exception)
+    {
+        std::vector<double> node_locations;
+        std::vector<double> velocity_grids;
+        for (unsigned i = 0; i < 6; i++)
+        {
+            node_locations.push_back(1.0 / (i + 3.0));
+            velocity_grids.push_back(-M_PI * i);
+        }
+
+        ImmersedBoundaryTrajectory trajectory;
+        trajectory.AddFrame(0, node_locations, velocity_grids);
+        trajectory.AddFrame(10, node_locations, std::vector<double>());
+        trajectory.Write("TestImmersedBoundaryTrajectory", "trajectory.bin");
+
+        OutputFileHandler output_file_handler("TestImmersedBoundaryTrajectory", false);
+        FileFinder trajectory_file = output_file_handler.FindFile("trajectory.bin");
+
+        // Values are read back exactly
+        ImmersedBoundaryTrajectory loaded;
+        loaded.Load(trajectory_file);
+        TS_ASSERT_EQUALS(loaded.GetNumFrames(), 2u);
+        TS_ASSERT_EQUALS(loaded.GetTimeStep(1), 10u);
+        TS_ASSERT_EQUALS(loaded.rGetVelocityGrids(1).size(), 0u);
+        for (unsigned i = 0; i < 6; i++)
+        {
+            TS_ASSERT_EQUALS(loaded.rGetNodeLocations(0)[i], node_locations[i]);
+            TS_ASSERT_EQUALS(loaded.rGetVelocityGrids(0)[i], velocity_grids[i]);
+        }
+
+        FileFinder missing_file = output_file_handler.FindFile("missing.bin");
+        TS_ASSERT_THROWS_CONTAINS(loaded.Load(missing_file), "Unable to open trajectory file");
+    }
+};
@@ -0,0 +1,266 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Needed for the test environment
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+// Includes from trunk
+#include "CellId.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "FileFinder.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "OutputFileHandler.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+#include "UniformlyDistributedCellCycleModel.hpp"
+
+// Includes from Immersed Boundary
+#include "ImmersedBoundaryCellCellInteractionForce.hpp"
+#include "ImmersedBoundaryCellPopulation.hpp"
+#include "ImmersedBoundaryMembraneElasticityForce.hpp"
+#include "ImmersedBoundaryPalisadeMeshGenerator.hpp"
+#include "ImmersedBoundarySimulationModifier.hpp"
+#include "ImmersedBoundaryStaticForceSimulationModifier.hpp"
+#include "ImmersedBoundaryTrajectory.hpp"
+#include "ImmersedBoundaryTrajectoryModifier.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <sstream>
+
+// This test is never run in parallel
+#include "FakePetscSetup.hpp"
+
+/**
+ * Checks that the optimised force evaluations and multi-threaded runs reproduce the trajectory of the reference
+ * implementation: the force classes evaluated one at a time on a single thread.
+ *
+ * The reference trajectory is recorded first and written to reference_trajectory.bin.  The same simulation is then
+ * replayed with each variant, from the same simulation time and random seed, and the node locations and velocity grids
+ * are compared with the reference at each sampled step.  The ULP and relative error statistics for every variant are
+ * written to trajectory_comparison.csv.  As each comparison needs the reference, all variants are run in one test.
+ */
+class TestImmersedBoundaryTrajectoryEquivalence : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Put the simulation time, random number generator and cell ids back into the state set up before each test, so
+     * that every simulation builds the same mesh and cells and runs over the same times.
+     */
+    void ResetSimulationState()
+    {
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        RandomNumberGenerator::Instance()->Reseed(0);
+        CellId::ResetMaxCellId();
+    }
+
+    /**
+     * Run a short palisade simulation with a given modifier, recording its trajectory.  The simulation state is reset
+     * first, so every run starts from the same mesh, cells and time.
+     *
+     * @param pModifier the immersed boundary modifier, to which the forces are added unless it is a static modifier
+     * @param useForceClasses whether to add the membrane elasticity and cell-cell interaction forces to the modifier
+     * @param numThreads the number of OpenMP threads
+     * @return the trajectory
+     */
+    ImmersedBoundaryTrajectory RunSimulation(boost::shared_ptr<ImmersedBoundarySimulationModifier<2> > pModifier,
+                                             bool useForceClasses,
+                                             unsigned numThreads)
+    {
+        ResetSimulationState();
+
+#ifdef _OPENMP
+        int previous_num_threads = omp_get_max_threads();
+        omp_set_num_threads(numThreads);
+#endif
+
+        ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+        ImmersedBoundaryMesh<2,2>* p_mesh = gen.GetMesh();
+        p_mesh->SetNumGridPtsXAndY(64);
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, p_mesh->GetNumElements(), p_diff_type);
+
+        ImmersedBoundaryCellPopulation<2> cell_population(*p_mesh, cells);
+        cell_population.SetIfPopulationHasActiveSources(false);
+
+        OffLatticeSimulation<2> simulator(cell_population);
+        simulator.AddSimulationModifier(pModifier);
+
+        if (useForceClasses)
+        {
+            MAKE_PTR(ImmersedBoundaryMembraneElasticityForce<2>, p_boundary_force);
+            pModifier->AddImmersedBoundaryForce(p_boundary_force);
+            p_boundary_force->SetSpringConstant(1.0 * 1e7);
+
+            MAKE_PTR(ImmersedBoundaryCellCellInteractionForce<2>, p_cell_cell_force);
+            pModifier->AddImmersedBoundaryForce(p_cell_cell_force);
+            p_cell_cell_force->SetSpringConstant(1.0 * 1e6);
+        }
+
+        // The trajectory is recorded after the fluid has been solved
+        MAKE_PTR_ARGS(ImmersedBoundaryTrajectoryModifier<2>, p_trajectory_modifier, (5));
+        simulator.AddSimulationModifier(p_trajectory_modifier);
+
+        double dt = 0.05;
+        simulator.SetOutputDirectory("TestImmersedBoundaryTrajectoryEquivalence/Simulation");
+        simulator.SetDt(dt);
+        simulator.SetSamplingTimestepMultiple(20);
+        simulator.SetEndTime(SimulationTime::Instance()->GetTime() + 20 * dt);
+        simulator.Solve();
+
+#ifdef _OPENMP
+        omp_set_num_threads(previous_num_threads);
+#endif
+
+        return p_trajectory_modifier->rGetTrajectory();
+    }
+
+    /**
+     * Compare a trajectory with a reference trajectory.
+     *
+     * @param rReference the reference trajectory
+     * @param rTrajectory the trajectory of the variant
+     * @param tolerance the largest acceptable relative L2 error of each field
+     * @return the comparison of each field
+     */
+    std::vector<ImmersedBoundaryTrajectory::FieldComparison> CompareWithReference(const ImmersedBoundaryTrajectory& rReference,
+                                                                                  const ImmersedBoundaryTrajectory& rTrajectory,
+                                                                                  double tolerance)
+    {
+        std::vector<ImmersedBoundaryTrajectory::FieldComparison> comparisons = rReference.Compare(rTrajectory);
+        for (unsigned i = 0; i < comparisons.size(); i++)
+        {
+            TS_ASSERT_LESS_THAN(comparisons[i].mRelativeL2Error, tolerance);
+        }
+        return comparisons;
+    }
+
+public:
+
+    void TestTrajectoriesMatchReference() throw(Exception)
+    {
+        std::map<std::string, std::vector<ImmersedBoundaryTrajectory::FieldComparison> > comparisons;
+
+        // Record the reference trajectory
+        MAKE_PTR(ImmersedBoundarySimulationModifier<2>, p_reference_modifier);
+        ImmersedBoundaryTrajectory recorded = RunSimulation(p_reference_modifier, true, 1);
+
+        // Frames are recorded at the start and every fifth step
+        TS_ASSERT_EQUALS(recorded.GetNumFrames(), 5u);
+        TS_ASSERT_EQUALS(recorded.GetTimeStep(4), 20u);
+        TS_ASSERT_EQUALS(recorded.rGetVelocityGrids(0).size(), 2u * 64 * 64);
+
+        // The reference is compared as read back from file, so that writing and loading is also checked
+        recorded.Write("TestImmersedBoundaryTrajectoryEquivalence", "reference_trajectory.bin");
+
+        OutputFileHandler output_file_handler("TestImmersedBoundaryTrajectoryEquivalence", false);
+        FileFinder reference_file = output_file_handler.FindFile("reference_trajectory.bin");
+        TS_ASSERT(reference_file.Exists());
+
+        ImmersedBoundaryTrajectory reference;
+        reference.Load(reference_file);
+
+        // A replay of the reference itself must be bitwise identical
+        {
+            MAKE_PTR(ImmersedBoundarySimulationModifier<2>, p_modifier);
+            comparisons["Reference"] = CompareWithReference(reference, RunSimulation(p_modifier, true, 1), 1e-15);
+            TS_ASSERT_EQUALS(comparisons["Reference"][0].mNumDifferences, 0u);
+            TS_ASSERT_EQUALS(comparisons["Reference"][1].mNumDifferences, 0u);
+        }
+
+        // The force pipeline
+        {
+            MAKE_PTR(ImmersedBoundarySimulationModifier<2>, p_modifier);
+            p_modifier->SetUseForcePipeline(true);
+            comparisons["ForcePipeline"] = CompareWithReference(reference, RunSimulation(p_modifier, true, 1), 1e-8);
+        }
+
+        // The statically dispatched forces
+        {
+            typedef MembraneElasticityForcePolicy<2> MembranePolicy;
+            typedef CellCellInteractionForcePolicy<2, LinearSpringPairLaw> CellCellPolicy;
+            typedef ImmersedBoundaryStaticForceSimulationModifier<2, MembranePolicy, CellCellPolicy> StaticModifier;
+
+            /*
+             * The cell-cell interaction force takes its rest length from the interaction distance of the population,
+             * so the population is built here from the same reset state as in RunSimulation().  RunSimulation() resets
+             * the state again, so the random numbers drawn here do not change the simulated mesh or cells.
+             */
+            ResetSimulationState();
+            ImmersedBoundaryPalisadeMeshGenerator gen(5, 100, 0.2, 2.0, 0.15, true);
+            std::vector<CellPtr> cells;
+            MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+            CellsGenerator<UniformlyDistributedCellCycleModel, 2> cells_generator;
+            cells_generator.GenerateBasicRandom(cells, gen.GetMesh()->GetNumElements(), p_diff_type);
+            ImmersedBoundaryCellPopulation<2> cell_population(*(gen.GetMesh()), cells);
+
+            LinearSpringPairLaw law(0.25 * cell_population.GetInteractionDistance());
+            boost::shared_ptr<StaticModifier> p_modifier(new StaticModifier(MembranePolicy(1.0 * 1e7), CellCellPolicy(law, 1.0 * 1e6)));
+
+            comparisons["StaticForces"] = CompareWithReference(reference, RunSimulation(p_modifier, false, 1), 1e-8);
+        }
+
+        // The force pipeline on more than one thread
+        unsigned max_num_threads = 1;
+#ifdef _OPENMP
+        max_num_threads = omp_get_max_threads();
+#endif
+
+        for (unsigned num_threads = 2; num_threads <= max_num_threads; num_threads *= 2)
+        {
+            MAKE_PTR(ImmersedBoundarySimulationModifier<2>, p_modifier);
+            p_modifier->SetUseForcePipeline(true);
+
+            std::stringstream name;
+            name << "ForcePipeline_t" << num_threads;
+            comparisons[name.str()] = CompareWithReference(reference, RunSimulation(p_modifier, true, num_threads), 1e-8);
+        }
+
+        ImmersedBoundaryTrajectory::WriteComparisons(comparisons, "TestImmersedBoundaryTrajectoryEquivalence");
+
+        FileFinder csv_file = output_file_handler.FindFile("trajectory_comparison.csv");
+        TS_ASSERT(csv_file.Exists());
+    }
+};